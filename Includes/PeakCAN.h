@@ -0,0 +1,247 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (for PEAK-System PCAN Interfaces)
+//
+//  Copyright (c) 2005-2012 Uwe Vogt, UV Software, Friedrichshafen
+//  Copyright (c) 2013-2025 Uwe Vogt, UV Software, Berlin (info@mac-can.com)
+//  All rights reserved.
+//
+//  This file is part of PCBUSB-Wrapper.
+//
+//  PCBUSB-Wrapper is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version). You can
+//  choose between one of them if you use PCBUSB-Wrapper in whole or in part.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  PCBUSB-Wrapper IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF PCBUSB-Wrapper, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  PCBUSB-Wrapper is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  PCBUSB-Wrapper is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with PCBUSB-Wrapper; if not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef PEAKCAN_H_INCLUDED
+#define PEAKCAN_H_INCLUDED
+
+#include "PeakCAN_Defines.h"
+#include "PeakCAN_Defaults.h"
+#include "CANAPI.h"
+
+#include <chrono>
+#include <functional>
+
+/// \name   PeakCAN
+/// \brief  PeakCAN dynamic library
+/// \{
+#define PEAKCAN_LIBRARY_ID  CANLIB_PCANBASIC
+#define PEAKCAN_LIBRARY_NAME  CANDLL_PCANBASIC
+#define PEAKCAN_LIBRARY_VENDOR  "UV Software, Berlin"
+#define PEAKCAN_LIBRARY_LICENSE  "BSD-2-Clause OR GPL-2.0-or-later"
+#define PEAKCAN_LIBRARY_COPYRIGHT  "Copyright (c) 2005-2025 by Uwe Vogt, UV Software, Berlin"
+#define PEAKCAN_LIBRARY_HAZARD_NOTE  "If you connect your CAN device to a real CAN network when using this library,\n" \
+                                     "you might damage your application."
+/// \}
+
+/// \name   PeakCAN API
+/// \brief  CAN API V3 driver for PEAK-System PCAN interfaces
+/// \note   See CCanApi for a description of the overridden methods
+/// \{
+class CANCPP CPeakCAN : public CCanApi {
+private:
+    CANAPI_Handle_t m_Handle;  ///< CAN interface handle
+    struct SDispatch;  ///< dispatch thread and callbacks (see SetReceiveCallback)
+    SDispatch *m_pDispatch;  ///< (created by the first callback)
+public:
+    // constructor / destructor
+    CPeakCAN();
+    ~CPeakCAN();
+    // CPeakCAN-specific error codes (CAN API V3 extension)
+    enum EErrorCodes {
+        // note: range 0...-99 is reserved by CAN API V3
+        GeneralError = VendorSpecific, ///< mapped PCAN-Basic error codes
+        RegisterTestFailed     = -201, ///< PCAN_ERROR_REGTEST: test of the CAN controller hardware registers failed (no hardware found)
+        DriverNotLoaded        = -202, ///< PCAN_ERROR_NODRIVER: driver not loaded
+        HardwareAlreadyInUse   = -203, ///< PCAN_ERROR_HWINUSE: hardware is in use by another Net
+        ClientAlreadyConnected = -204, ///< PCAN_ERROR_NETINUSE: a client is already connected to the Net
+        HardwareHandleIsWrong  = -220, ///< PCAN_ERROR_ILLHW: hardware handle is wrong
+        NetworkHandleIsWrong   = -224, ///< PCAN_ERROR_ILLNET: net handle is wrong
+        ClientHandleIsWrong    = -228, ///< PCAN_ERROR_ILLCLIENT: client handle is wrong
+        ResourceNotCreated     = -232, ///< PCAN_ERROR_RESOURCE: resource (FIFO, Client, timeout) cannot be created
+        InvalidParameterType   = -264, ///< PCAN_ERROR_ILLPARAMTYPE: invalid parameter
+        InvalidParameterValue  = -265, ///< PCAN_ERROR_ILLPARAMVAL: invalid parameter value
+        InvalidData            = -267, ///< PCAN_ERROR_ILLDATA: invalid data, function, or action
+        InvalidOperation       = -268, ///< PCAN_ERROR_ILLOPERATION: invalid operation
+        Caution                = -289, ///< PCAN_ERROR_CAUTION: an operation was successfully carried out, however, irregularities were registered
+        UnkownError            = -299  ///< PCAN_ERROR_UNKNOWN: unknown error
+    };
+    // CPeakCAN-specific callbacks (invoked by a dispatch thread of the wrapper)
+    // note: with a receive or batch callback the dispatch thread reads the messages
+    //       of the channel, so that the channel should not be read otherwise; with a
+    //       status callback only, the messages are left to the application; a callback
+    //       must not set a callback (and should not block the delivery of further messages)
+    typedef std::function<void(const CANAPI_Message_t &message, uint8_t status)> ReceiveCallback;
+    typedef std::function<void(const CANAPI_Message_t *messages, size_t count)> BatchCallback;
+    typedef std::function<void(CANAPI_Status_t status, uint8_t changed)> StatusCallback;
+    // CCanApi overrides
+    static bool GetFirstChannel(SChannelInfo &info, void *param = NULL);
+    static bool GetNextChannel(SChannelInfo &info, void *param = NULL);
+
+    static CANAPI_Return_t ProbeChannel(int32_t channel, const CANAPI_OpMode_t &opMode, const void *param, EChannelState &state);
+    static CANAPI_Return_t ProbeChannel(int32_t channel, const CANAPI_OpMode_t &opMode, EChannelState &state);
+    static CANAPI_Return_t ProbeChannels(EChannelState states[], int count);  // all channels at once
+
+    CANAPI_Return_t InitializeChannel(int32_t channel, const CANAPI_OpMode_t &opMode, const void *param = NULL);
+    CANAPI_Return_t TeardownChannel();
+    CANAPI_Return_t SignalChannel();
+
+    CANAPI_Return_t StartController(CANAPI_Bitrate_t bitrate);
+    CANAPI_Return_t ResetController();
+
+    CANAPI_Return_t WriteMessage(CANAPI_Message_t message, uint16_t timeout = 0U);
+    CANAPI_Return_t ReadMessage(CANAPI_Message_t &message, uint16_t timeout = CANWAIT_INFINITE);
+
+    CANAPI_Return_t GetStatus(CANAPI_Status_t &status);
+    CANAPI_Return_t GetBusLoad(uint8_t &load);
+
+    CANAPI_Return_t GetBitrate(CANAPI_Bitrate_t &bitrate);
+    CANAPI_Return_t GetBusSpeed(CANAPI_BusSpeed_t &speed);
+
+    CANAPI_Return_t GetProperty(uint16_t param, void *value, uint32_t nbyte);
+    CANAPI_Return_t SetProperty(uint16_t param, const void *value, uint32_t nbyte);
+
+    CANAPI_Return_t SetFilter11Bit(uint32_t code, uint32_t mask);
+    CANAPI_Return_t SetFilter29Bit(uint32_t code, uint32_t mask);
+    CANAPI_Return_t GetFilter11Bit(uint32_t &code, uint32_t &mask);
+    CANAPI_Return_t GetFilter29Bit(uint32_t &code, uint32_t &mask);
+    CANAPI_Return_t ResetFilters();
+
+    // CPeakCAN-specific extensions
+    CANAPI_Return_t WriteMessages(const CANAPI_Message_t *messages, size_t count, size_t &sent, uint16_t timeout = 0U);
+    CANAPI_Return_t ReadMessages(CANAPI_Message_t *messages, size_t max, size_t &count, uint16_t timeout = CANWAIT_INFINITE);
+    CANAPI_Return_t ReadMessage(CANAPI_Message_t &message, std::chrono::nanoseconds timeout);
+    CANAPI_Return_t ReadMessage(CANAPI_Message_t &message, CANAPI_Status_t &status, uint16_t timeout = CANWAIT_INFINITE);
+    CANAPI_Return_t GetReceiveHandle(int &fd);
+    CANAPI_Return_t AddFilter11Bit(uint32_t code, uint32_t mask);
+    CANAPI_Return_t AddFilter29Bit(uint32_t code, uint32_t mask);
+    CANAPI_Return_t AddFromTo11Bit(uint32_t from, uint32_t to);
+    CANAPI_Return_t AddFromTo29Bit(uint32_t from, uint32_t to);
+    static CANAPI_Return_t WaitAny(CPeakCAN *const channels[], int count, uint32_t &ready, uint16_t timeout = CANWAIT_INFINITE);
+    CANAPI_Return_t SetReceiveCallback(ReceiveCallback callback);
+    CANAPI_Return_t SetBatchCallback(BatchCallback callback, size_t max = 64U);
+    CANAPI_Return_t SetStatusCallback(StatusCallback callback);
+
+    char *GetHardwareVersion();  // (for compatibility reasons)
+    char *GetFirmwareVersion();  // (for compatibility reasons)
+    static char *GetVersion();  // (for compatibility reasons)
+
+    static CANAPI_Return_t MapIndex2Bitrate(int32_t index, CANAPI_Bitrate_t &bitrate);
+    static CANAPI_Return_t MapString2Bitrate(const char *string, CANAPI_Bitrate_t &bitrate, bool &data, bool &sam);
+    static CANAPI_Return_t MapBitrate2String(CANAPI_Bitrate_t bitrate, char *string, size_t length, bool data = false, bool sam = false);
+    static CANAPI_Return_t MapBitrate2Speed(CANAPI_Bitrate_t bitrate, CANAPI_BusSpeed_t &speed);
+private:
+    CANAPI_Return_t MapBitrate2Sja1000(CANAPI_Bitrate_t bitrate, uint16_t &btr0btr1);
+    CANAPI_Return_t MapSja10002Bitrate(uint16_t btr0btr1, CANAPI_Bitrate_t &bitrate);
+    CANAPI_Return_t StartDispatch();
+    void StopDispatch();
+    void Dispatch();
+public:
+    static uint8_t Dlc2Len(uint8_t dlc) { return CCanApi::Dlc2Len(dlc); }
+    static uint8_t Len2Dlc(uint8_t len) { return CCanApi::Len2Dlc(len); }
+};
+/// \}
+
+/// \name   PeakCAN Property IDs
+/// \brief  Properties that can be read (or written)
+/// \{
+#define PEAKCAN_PROPERTY_CANAPI             (CANPROP_GET_SPEC)
+#define PEAKCAN_PROPERTY_VERSION            (CANPROP_GET_VERSION)
+#define PEAKCAN_PROPERTY_PATCH_NO           (CANPROP_GET_PATCH_NO)
+#define PEAKCAN_PROPERTY_BUILD_NO           (CANPROP_GET_BUILD_NO)
+#define PEAKCAN_PROPERTY_LIBRARY_ID         (CANPROP_GET_LIBRARY_ID)
+#define PEAKCAN_PROPERTY_LIBRARY_NAME       (CANPROP_GET_LIBRARY_DLLNAME)
+#define PEAKCAN_PROPERTY_LIBRARY_VENDOR     (CANPROP_GET_LIBRARY_VENDOR)
+#define PEAKCAN_PROPERTY_DEVICE_TYPE        (CANPROP_GET_DEVICE_TYPE)
+#define PEAKCAN_PROPERTY_DEVICE_NAME        (CANPROP_GET_DEVICE_NAME)
+#define PEAKCAN_PROPERTY_DEVICE_VENDOR      (CANPROP_GET_DEVICE_VENDOR)
+#define PEAKCAN_PROPERTY_DEVICE_DRIVER      (CANPROP_GET_DEVICE_DLLNAME)
+#define PEAKCAN_PROPERTY_OP_CAPABILITY      (CANPROP_GET_OP_CAPABILITY)
+#define PEAKCAN_PROPERTY_OP_MODE            (CANPROP_GET_OP_MODE)
+#define PEAKCAN_PROPERTY_BITRATE            (CANPROP_GET_BITRATE)
+#define PEAKCAN_PROPERTY_SPEED              (CANPROP_GET_SPEED)
+#define PEAKCAN_PROPERTY_STATUS             (CANPROP_GET_STATUS)
+#define PEAKCAN_PROPERTY_BUSLOAD            (CANPROP_GET_BUSLOAD)
+//#define PEAKCAN_PROPERTY_NUM_CHANNELS       (CANPROP_GET_NUM_CHANNELS)
+//#define PEAKCAN_PROPERTY_CAN_CHANNEL        (CANPROP_GET_CAN_CHANNEL)
+//#define PEAKCAN_PROPERTY_CAN_CLOCK          (CANPROP_GET_CAN_CLOCK)
+#define PEAKCAN_PROPERTY_TX_COUNTER         (CANPROP_GET_TX_COUNTER)
+#define PEAKCAN_PROPERTY_RX_COUNTER         (CANPROP_GET_RX_COUNTER)
+#define PEAKCAN_PROPERTY_ERR_COUNTER        (CANPROP_GET_ERR_COUNTER)
+#define PEAKCAN_PROPERTY_RCV_QUEUE_SIZE     (CANPROP_GET_RCV_QUEUE_SIZE)
+#define PEAKCAN_PROPERTY_RCV_QUEUE_HIGH     (CANPROP_GET_RCV_QUEUE_HIGH)
+#define PEAKCAN_PROPERTY_RCV_QUEUE_OVFL     (CANPROP_GET_RCV_QUEUE_OVFL)
+//#define PEAKCAN_PROPERTY_TRM_QUEUE_SIZE     (CANPROP_GET_TRM_QUEUE_SIZE)
+//#define PEAKCAN_PROPERTY_TRM_QUEUE_HIGH     (CANPROP_GET_TRM_QUEUE_HIGH)
+#define PEAKCAN_PROPERTY_TRM_QUEUE_OVFL     (CANPROP_GET_TRM_QUEUE_OVFL)
+#define PEAKCAN_PROPERTY_DEVICE_ID          (CANPROP_GET_VENDOR_PROP + PCAN_DEVICE_ID)
+#define PEAKCAN_PROPERTY_API_VERSION        (CANPROP_GET_VENDOR_PROP + PCAN_API_VERSION)
+#define PEAKCAN_PROPERTY_CHANNEL_VERSION    (CANPROP_GET_VENDOR_PROP + PCAN_CHANNEL_VERSION)
+#define PEAKCAN_PROPERTY_HARDWARE_NAME      (CANPROP_GET_VENDOR_PROP + PCAN_HARDWARE_NAME)
+#define PEAKCAN_PROPERTY_CONTROLLER_NUMBER  (CANPROP_GET_VENDOR_PROP + PCAN_CONTROLLER_NUMBER)
+//#define PEAKCAN_PROPERTY_SERIAL_NUMBER      (CANPROP_GET_VENDOR_PROP + PCAN_SERIAL_NUMBER)
+//#define PEAKCAN_PROPERTY_CLOCK_DOMAINS      (CANPROP_GET_VENDOR_PROP + PCAN_CLOCK_DOMAIND)
+#define PEAKCAN_PROPERTY_RECEIVE_FD         (CANPROP_GET_RECEIVE_FD)
+#define PEAKCAN_PROPERTY_SPIN_BUDGET        (CANPROP_GET_SPIN_BUDGET)
+#define PEAKCAN_PROPERTY_SET_SPIN_BUDGET    (CANPROP_SET_SPIN_BUDGET)
+#define PEAKCAN_PROPERTY_SPIN_COUNTER       (CANPROP_GET_SPIN_COUNTER)
+#define PEAKCAN_PROPERTY_BLOCK_COUNTER      (CANPROP_GET_BLOCK_COUNTER)
+#define PEAKCAN_PROPERTY_SET_RCV_QUEUE_SIZE (CANPROP_SET_RCV_QUEUE_SIZE)
+#define PEAKCAN_PROPERTY_BUSLOAD_WINDOW     (CANPROP_GET_BUSLOAD_WINDOW)
+#define PEAKCAN_PROPERTY_SET_BUSLOAD_WINDOW (CANPROP_SET_BUSLOAD_WINDOW)
+#define PEAKCAN_PROPERTY_SET_FROMTO_11BIT   (CANPROP_SET_FROMTO_11BIT)
+#define PEAKCAN_PROPERTY_SET_FROMTO_29BIT   (CANPROP_SET_FROMTO_29BIT)
+#define PEAKCAN_PROPERTY_SET_CODEMASK_11BIT (CANPROP_SET_CODEMASK_11BIT)
+#define PEAKCAN_PROPERTY_SET_CODEMASK_29BIT (CANPROP_SET_CODEMASK_29BIT)
+#define PEAKCAN_PROPERTY_CHANNEL_STATES     (CANPROP_GET_CHANNEL_STATES)
+#define PEAKCAN_PROPERTY_TIMESTAMP_MODE     (CANPROP_GET_TIMESTAMP_MODE)
+#define PEAKCAN_PROPERTY_SET_TIMESTAMP_MODE (CANPROP_SET_TIMESTAMP_MODE)
+#define PEAKCAN_PROPERTY_INSTRUMENTATION    (CANPROP_GET_INSTRUMENTATION)
+#define PEAKCAN_PROPERTY_SET_INSTRUMENTATION (CANPROP_SET_INSTRUMENTATION)
+#define PEAKCAN_PROPERTY_SET_INSTRUMENTATION_RESET (CANPROP_SET_INSTRUMENTATION_RESET)
+#define PEAKCAN_PROPERTY_HISTOGRAM_WAIT     (CANPROP_GET_HISTOGRAM_WAIT)
+#define PEAKCAN_PROPERTY_HISTOGRAM_READ     (CANPROP_GET_HISTOGRAM_READ)
+#define PEAKCAN_PROPERTY_HISTOGRAM_WRITE    (CANPROP_GET_HISTOGRAM_WRITE)
+#define PEAKCAN_PROPERTY_HISTOGRAM_AGE      (CANPROP_GET_HISTOGRAM_AGE)
+#define PEAKCAN_PROPERTY_MESSAGE_RATES      (CANPROP_GET_MESSAGE_RATES)
+#define PEAKCAN_PROPERTY_VBUS_PACING        (CANPROP_GET_VBUS_PACING)
+#define PEAKCAN_PROPERTY_SET_VBUS_PACING    (CANPROP_SET_VBUS_PACING)
+#define PEAKCAN_PROPERTY_HISTOGRAM_CALLBACK (CANPROP_GET_HISTOGRAM_CALLBACK)
+/// \}
+#endif // PEAKCAN_H_INCLUDED
@@ -0,0 +1,442 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (for PEAK-System PCAN Interfaces)
+//
+//  Copyright (c) 2005-2012 Uwe Vogt, UV Software, Friedrichshafen
+//  Copyright (c) 2013-2025 Uwe Vogt, UV Software, Berlin (info@mac-can.com)
+//  All rights reserved.
+//
+//  This file is part of PCBUSB-Wrapper.
+//
+//  PCBUSB-Wrapper is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version). You can
+//  choose between one of them if you use PCBUSB-Wrapper in whole or in part.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  PCBUSB-Wrapper IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF PCBUSB-Wrapper, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  PCBUSB-Wrapper is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  PCBUSB-Wrapper is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with PCBUSB-Wrapper; if not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef PEAKCAN_ASYNC_H_INCLUDED
+#define PEAKCAN_ASYNC_H_INCLUDED
+
+#if !defined(__cpp_impl_coroutine) || (__cplusplus < 202002L)
+#error PeakCAN_Async.h requires C++20 (coroutines)
+#endif
+#include "PeakCAN.h"
+
+#include <coroutine>
+#include <exception>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+#include <unistd.h>
+#include <fcntl.h>
+#if defined(__APPLE__)
+#include <sys/event.h>
+#else
+#include <sys/epoll.h>
+#endif
+
+/// \name   PeakCAN Executor
+/// \brief  Adapter hook to run the awaitables of CPeakCANAsync on an event loop
+/// \note   An executor invokes each handler exactly once and always from its
+///         own thread, never from within WaitReadable() or WaitFor(). After
+///         Cancel() the handler of a token is not invoked. The handlers of
+///         one awaiter must not run concurrently (e.g. use an asio strand).
+/// \{
+class CPeakCANExecutor {
+public:
+    typedef std::function<void()> Handler;
+    typedef uint64_t Token;  ///< (0 = not registered)
+    virtual ~CPeakCANExecutor() {}
+    /// \brief  invokes the handler once when the file descriptor is readable (level-triggered)
+    virtual Token WaitReadable(int fd, Handler handler) = 0;
+    /// \brief  invokes the handler once after the given delay
+    virtual Token WaitFor(std::chrono::nanoseconds delay, Handler handler) = 0;
+    /// \brief  cancels a pending handler
+    virtual void Cancel(Token token) = 0;
+};
+/// \}
+
+/// \name   PeakCAN Event Loop
+/// \brief  Built-in single-threaded executor (epoll on Linux, kqueue on macOS)
+/// \note   If several handlers wait for the same file descriptor, only the
+///         first one is invoked per wake-up (FIFO), so that a message is not
+///         fought over by all readers of a channel.
+/// \{
+class CPeakCANLoop : public CPeakCANExecutor {
+private:
+    typedef std::chrono::steady_clock Clock;
+    struct SWait {
+        Handler handler;  ///< handler to be invoked
+        int fd;  ///< file descriptor (or -1 for a timer)
+        std::list<Token>::iterator waiter;  ///< position in the waiters of the file descriptor
+        std::multimap<Clock::time_point, Token>::iterator timer;  ///< position in the timers
+    };
+    int m_Poll;  ///< epoll resp. kqueue instance
+    int m_Wake[2];  ///< pipe to wake up Run() (see Stop)
+    Token m_Next;  ///< next token
+    std::atomic<bool> m_Stop;  ///< request to leave Run()
+    std::unordered_map<Token, SWait> m_Pending;  ///< all pending handlers
+    std::unordered_map<int, std::list<Token> > m_Waiters;  ///< handlers per file descriptor
+    std::multimap<Clock::time_point, Token> m_Timers;  ///< handlers per expiry time
+public:
+    CPeakCANLoop() : m_Poll(-1), m_Next(1U), m_Stop(false) {
+        m_Wake[0] = m_Wake[1] = -1;
+#if defined(__APPLE__)
+        m_Poll = kqueue();
+#else
+        m_Poll = epoll_create1(EPOLL_CLOEXEC);
+#endif
+        if ((m_Poll >= 0) && (pipe(m_Wake) == 0)) {
+            (void)fcntl(m_Wake[0], F_SETFL, O_NONBLOCK);
+            (void)fcntl(m_Wake[1], F_SETFL, O_NONBLOCK);
+            (void)Watch(m_Wake[0], false);
+        }
+    }
+    ~CPeakCANLoop() {
+        if (m_Wake[0] >= 0) (void)close(m_Wake[0]);
+        if (m_Wake[1] >= 0) (void)close(m_Wake[1]);
+        if (m_Poll >= 0) (void)close(m_Poll);
+    }
+    CPeakCANLoop(const CPeakCANLoop&) = delete;
+    CPeakCANLoop &operator=(const CPeakCANLoop&) = delete;
+
+    Token WaitReadable(int fd, Handler handler) override {
+        if ((m_Poll < 0) || (fd < 0))
+            return 0U;
+        auto it = m_Waiters.find(fd);
+        // note: a file descriptor without waiters stays watched until it gets
+        //       readable, so that a reader does not add and remove it per message
+        if (it == m_Waiters.end()) {
+            if (!Watch(fd, false))
+                return 0U;
+            it = m_Waiters.emplace(fd, std::list<Token>()).first;
+        }
+        else if (it->second.empty() && !Watch(fd, true))
+            return 0U;
+        std::list<Token> &waiters = it->second;
+        Token token = m_Next++;
+        SWait &wait = m_Pending[token];
+        wait.handler = std::move(handler);
+        wait.fd = fd;
+        wait.waiter = waiters.insert(waiters.end(), token);
+        return token;
+    }
+    Token WaitFor(std::chrono::nanoseconds delay, Handler handler) override {
+        Token token = m_Next++;
+        SWait &wait = m_Pending[token];
+        wait.handler = std::move(handler);
+        wait.fd = -1;
+        wait.timer = m_Timers.emplace(Clock::now() + delay, token);
+        return token;
+    }
+    void Cancel(Token token) override {
+        (void)Remove(token);
+    }
+    /// \brief  invokes the handlers until Stop() is called or nothing is pending
+    /// \returns the number of invoked handlers
+    uint64_t Run() {
+        uint64_t count = 0U;
+        m_Stop = false;
+        while (!m_Stop && !m_Pending.empty() && (m_Poll >= 0)) {
+            // (1) wait until the first timer expires or a file descriptor is readable
+            int timeout = -1;
+            if (!m_Timers.empty()) {
+                auto delay = m_Timers.begin()->first - Clock::now();
+                timeout = (delay.count() > 0) ? (int)((delay.count() + 999999) / 1000000) : 0;
+            }
+            int fds[64];
+            int n = Wait(fds, 64, timeout);
+            // (2) invoke the first waiter of each readable file descriptor
+            for (int i = 0; i < n; i++) {
+                if (fds[i] == m_Wake[0]) {
+                    char buffer[16];
+                    while (read(m_Wake[0], buffer, sizeof(buffer)) > 0);
+                    continue;
+                }
+                auto it = m_Waiters.find(fds[i]);
+                if ((it != m_Waiters.end()) && !it->second.empty()) {
+                    Handler handler = Remove(it->second.front());
+                    if (handler) { handler(); count++; }
+                }
+                else {
+                    // note: a level-triggered descriptor without waiters would spin
+                    Unwatch(fds[i]);
+                    if (it != m_Waiters.end())
+                        m_Waiters.erase(it);
+                }
+            }
+            // (3) invoke the handlers of all expired timers
+            Clock::time_point now = Clock::now();
+            while (!m_Timers.empty() && (m_Timers.begin()->first <= now)) {
+                Handler handler = Remove(m_Timers.begin()->second);
+                if (handler) { handler(); count++; }
+            }
+        }
+        return count;
+    }
+    /// \brief  signals Run() to return (can be called from any thread)
+    void Stop() {
+        m_Stop = true;
+        if (m_Wake[1] >= 0)
+            (void)!write(m_Wake[1], "", 1);
+    }
+private:
+    Handler Remove(Token token) {
+        Handler handler;
+        auto it = m_Pending.find(token);
+        if (it == m_Pending.end())
+            return handler;
+        handler = std::move(it->second.handler);
+        if (it->second.fd >= 0)
+            m_Waiters[it->second.fd].erase(it->second.waiter);
+        else
+            m_Timers.erase(it->second.timer);
+        m_Pending.erase(it);
+        return handler;
+    }
+#if defined(__APPLE__)
+    bool Watch(int fd, bool known) {
+        struct kevent event;
+        (void)known;  // (EV_ADD modifies a known event)
+        EV_SET(&event, fd, EVFILT_READ, EV_ADD, 0, 0, NULL);
+        return (kevent(m_Poll, &event, 1, NULL, 0, NULL) == 0);
+    }
+    void Unwatch(int fd) {
+        struct kevent event;
+        EV_SET(&event, fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+        (void)kevent(m_Poll, &event, 1, NULL, 0, NULL);
+    }
+    int Wait(int fds[], int max, int timeout) {
+        struct kevent events[64];
+        struct timespec ts = { timeout / 1000, (timeout % 1000) * 1000000L };
+        int n = kevent(m_Poll, NULL, 0, events, (max < 64) ? max : 64, (timeout >= 0) ? &ts : NULL);
+        for (int i = 0; i < n; i++)
+            fds[i] = (int)events[i].ident;
+        return (n > 0) ? n : 0;
+    }
+#else
+    bool Watch(int fd, bool known) {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        // note: a known descriptor is re-armed; if it has been closed in the
+        //       meantime (e.g. by a restart of the controller), it is added again
+        if (known && (epoll_ctl(m_Poll, EPOLL_CTL_MOD, fd, &event) == 0))
+            return true;
+        return (epoll_ctl(m_Poll, EPOLL_CTL_ADD, fd, &event) == 0);
+    }
+    void Unwatch(int fd) {
+        (void)epoll_ctl(m_Poll, EPOLL_CTL_DEL, fd, NULL);
+    }
+    int Wait(int fds[], int max, int timeout) {
+        struct epoll_event events[64];
+        int n = epoll_wait(m_Poll, events, (max < 64) ? max : 64, timeout);
+        for (int i = 0; i < n; i++)
+            fds[i] = events[i].data.fd;
+        return (n > 0) ? n : 0;
+    }
+#endif
+};
+/// \}
+
+/// \name   PeakCAN Task
+/// \brief  Coroutine type to spawn a detached CAN conversation on an executor
+/// \note   The coroutine starts immediately and runs until its first co_await
+///         that suspends; it is destroyed when it returns.
+/// \{
+struct CPeakCANTask {
+    struct promise_type {
+        CPeakCANTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+/// \}
+
+/// \name   PeakCAN Async
+/// \brief  Awaitable read and write operations of a CPeakCAN object
+/// \note   The awaitables complete without suspension when a message can be
+///         read resp. written right away. Otherwise a read waits for the
+///         receive event (see CANPROP_GET_RECEIVE_FD) and a write retries
+///         with a back-off timer (50us to 1ms) while the transmit queue is
+///         full. A write is completed when the message is accepted by the
+///         transmit queue (there is no transmit-complete event in PCANBasic).
+///         A time-out of 0 polls once; a read times out with CANERR_RX_EMPTY
+///         and a write with CANERR_TX_BUSY (as the blocking operations do).
+/// \{
+class CPeakCANAsync {
+private:
+    CPeakCAN &m_Can;  ///< CAN API object (initialized and started)
+    CPeakCANExecutor &m_Executor;  ///< executor of the awaitables
+public:
+    static constexpr std::chrono::nanoseconds Infinite = std::chrono::nanoseconds::max();
+
+    CPeakCANAsync(CPeakCAN &can, CPeakCANExecutor &executor) : m_Can(can), m_Executor(executor) {}
+
+    class ReadAwaiter {
+    private:
+        CPeakCAN &m_Can;
+        CPeakCANExecutor &m_Executor;
+        CANAPI_Message_t &m_Message;
+        std::chrono::nanoseconds m_Timeout;
+        CANAPI_Return_t m_Result;
+        CPeakCANExecutor::Token m_Readable;
+        CPeakCANExecutor::Token m_Timer;
+        std::coroutine_handle<> m_Waiting;
+    public:
+        ReadAwaiter(CPeakCAN &can, CPeakCANExecutor &executor, CANAPI_Message_t &message, std::chrono::nanoseconds timeout)
+            : m_Can(can), m_Executor(executor), m_Message(message), m_Timeout(timeout),
+              m_Result(CANERR_FATAL), m_Readable(0U), m_Timer(0U) {}
+        bool await_ready() {
+            m_Result = m_Can.ReadMessage(m_Message, (uint16_t)0U);
+            return (m_Result != CANERR_RX_EMPTY) || (m_Timeout.count() <= 0);
+        }
+        bool await_suspend(std::coroutine_handle<> waiting) {
+            m_Waiting = waiting;
+            if (!Arm())
+                return false;
+            if (m_Timeout != Infinite) {
+                m_Timer = m_Executor.WaitFor(m_Timeout, [this]() { Expired(); });
+                if (!m_Timer) {
+                    m_Executor.Cancel(m_Readable);
+                    m_Result = CANERR_RESOURCE;
+                    return false;
+                }
+            }
+            return true;
+        }
+        CANAPI_Return_t await_resume() const noexcept { return m_Result; }
+    private:
+        bool Arm() {
+            int fd = -1;
+            // note: the receive event changes when the controller is (re-)started
+            if ((m_Result = m_Can.GetReceiveHandle(fd)) != CANERR_NOERROR)
+                return false;
+            m_Readable = m_Executor.WaitReadable(fd, [this]() { Readable(); });
+            if (!m_Readable) {
+                m_Result = CANERR_RESOURCE;
+                return false;
+            }
+            return true;
+        }
+        void Readable() {
+            m_Readable = 0U;
+            m_Result = m_Can.ReadMessage(m_Message, (uint16_t)0U);
+            // note: CANERR_RX_EMPTY is a spurious wake-up (or another reader was faster)
+            if ((m_Result == CANERR_RX_EMPTY) && Arm())
+                return;
+            if (m_Timer)
+                m_Executor.Cancel(m_Timer);
+            m_Waiting.resume();
+        }
+        void Expired() {
+            m_Timer = 0U;
+            if (m_Readable)
+                m_Executor.Cancel(m_Readable);
+            m_Result = CANERR_RX_EMPTY;
+            m_Waiting.resume();
+        }
+    };
+
+    class WriteAwaiter {
+    private:
+        CPeakCAN &m_Can;
+        CPeakCANExecutor &m_Executor;
+        CANAPI_Message_t m_Message;
+        std::chrono::nanoseconds m_Timeout;
+        CANAPI_Return_t m_Result;
+        std::chrono::steady_clock::time_point m_Deadline;
+        std::chrono::nanoseconds m_Backoff;
+        std::coroutine_handle<> m_Waiting;
+    public:
+        WriteAwaiter(CPeakCAN &can, CPeakCANExecutor &executor, const CANAPI_Message_t &message, std::chrono::nanoseconds timeout)
+            : m_Can(can), m_Executor(executor), m_Message(message), m_Timeout(timeout),
+              m_Result(CANERR_FATAL), m_Backoff(std::chrono::microseconds(50)) {}
+        bool await_ready() {
+            m_Result = m_Can.WriteMessage(m_Message, 0U);
+            return (m_Result != CANERR_TX_BUSY) || (m_Timeout.count() <= 0);
+        }
+        bool await_suspend(std::coroutine_handle<> waiting) {
+            m_Waiting = waiting;
+            m_Deadline = (m_Timeout != Infinite) ? std::chrono::steady_clock::now() + m_Timeout
+                                                 : std::chrono::steady_clock::time_point::max();
+            return Arm();
+        }
+        CANAPI_Return_t await_resume() const noexcept { return m_Result; }
+    private:
+        bool Arm() {
+            std::chrono::nanoseconds delay = m_Backoff;
+            if (m_Deadline != std::chrono::steady_clock::time_point::max()) {
+                std::chrono::nanoseconds remaining = m_Deadline - std::chrono::steady_clock::now();
+                if (remaining < delay)
+                    delay = (remaining.count() > 0) ? remaining : std::chrono::nanoseconds(0);
+            }
+            if (!m_Executor.WaitFor(delay, [this]() { Retry(); })) {
+                m_Result = CANERR_RESOURCE;
+                return false;
+            }
+            if (m_Backoff < std::chrono::milliseconds(1))
+                m_Backoff = std::min<std::chrono::nanoseconds>(m_Backoff * 2, std::chrono::milliseconds(1));
+            return true;
+        }
+        void Retry() {
+            m_Result = m_Can.WriteMessage(m_Message, 0U);
+            if ((m_Result == CANERR_TX_BUSY) && (std::chrono::steady_clock::now() < m_Deadline) && Arm())
+                return;
+            m_Waiting.resume();
+        }
+    };
+
+    /// \brief  reads one message; co_await returns the result (as ReadMessage)
+    ReadAwaiter ReadMessageAsync(CANAPI_Message_t &message, std::chrono::nanoseconds timeout = Infinite) {
+        return ReadAwaiter(m_Can, m_Executor, message, timeout);
+    }
+    /// \brief  writes one message; co_await returns the result (as WriteMessage)
+    WriteAwaiter WriteMessageAsync(const CANAPI_Message_t &message, std::chrono::nanoseconds timeout = Infinite) {
+        return WriteAwaiter(m_Can, m_Executor, message, timeout);
+    }
+};
+/// \}
+
+#endif // PEAKCAN_ASYNC_H_INCLUDED
@@ -0,0 +1,931 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later */
+/*
+ *  PCANBasic Simulation (virtual PCAN channels on a shared CAN bus)
+ *
+ *  Copyright (c) 2013-2025 Uwe Vogt, UV Software, Berlin (info@mac-can.com)
+ *  All rights reserved.
+ *
+ *  This file is part of PCBUSB-Wrapper.
+ *
+ *  PCBUSB-Wrapper is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v2.0 (or any later version). You can
+ *  choose between one of them if you use PCBUSB-Wrapper in whole or in part.
+ *
+ *  (1) BSD 2-Clause "Simplified" License
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  PCBUSB-Wrapper IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF PCBUSB-Wrapper, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  (2) GNU General Public License v2.0 or later
+ *
+ *  PCBUSB-Wrapper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PCBUSB-Wrapper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with PCBUSB-Wrapper; if not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        PCANBasic_Sim.c
+ *
+ *  @brief       Simulated PCANBasic backend for hardware-free testing.
+ *
+ *  @note        Implements the subset of the PCANBasic API used by the
+ *               wrapper (CAN_Initialize[FD], CAN_Read[FD], CAN_Write[FD],
+ *               CAN_GetStatus, CAN_GetValue, CAN_SetValue, etc.) in-process.
+ *               The channels PCAN_USBBUS1 to PCAN_USBBUS16 are all connected
+ *               to one virtual CAN bus. A bus thread arbitrates the frames
+ *               of the transmit queues (lowest identifier first) and keeps
+ *               the bus busy for the exact bit time of each frame (incl.
+ *               stuff bits and data phase bit-rate), before it delivers the
+ *               frame with its end-of-frame time-stamp to all other channels
+ *               with the same bit-rate settings. Each channel has a receive
+ *               event (eventfd) that is readable while its receive queue is
+ *               not empty, as with the PCAN chardev driver.
+ *
+ *               A frame must be acknowledged by another channel with the
+ *               same bit-rate settings (not in listen-only mode), else it
+ *               is repeated and the transmit error counter of the sender
+ *               is incremented by 8 (up to the error passive limit). The
+ *               status of a channel reports the warning level and error
+ *               passive state from this counter.
+ *
+ *               Not modelled: other bus errors and error frames, bus off,
+ *               status frames and echo frames.
+ *
+ *               Build the libraries with 'make SIMULATION=ON' (Linux only).
+ */
+#if !defined(__linux__)
+#error Platform not supported
+#endif
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+#include "PCANBasic.h"
+#include "can_btr.h"
+#include "can_util.h"
+
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/*  -----------  defines  ------------------------------------------------
+ */
+#define SIM_VERSION_STRING      "8.20.0"
+#define SIM_CHANNEL_VERSION     "PCANBasic-Simulation " SIM_VERSION_STRING
+#define SIM_HARDWARE_NAME       "PCAN-USB FD (Simulation)"
+#define SIM_FIRMWARE_VERSION    "0.0.0"
+#define SIM_CHANNELS            (16)    // PCAN_USBBUS1 to PCAN_USBBUS16
+#define SIM_TX_QUEUE            (64)    // transmit queue size (frames)
+#define SIM_RX_QUEUE            (32768) // receive queue size (frames)
+#define SIM_ERROR_WARNING       (96U)   // error counter: warning limit
+#define SIM_ERROR_PASSIVE       (128U)  // error counter: error passive limit
+#define SIM_STD_MASK            (0x7FFU)
+#define SIM_XTD_MASK            (0x1FFFFFFFU)
+#define SIM_MSGTYPE_MASK        (PCAN_MESSAGE_EXTENDED | PCAN_MESSAGE_RTR | \
+                                 PCAN_MESSAGE_FD | PCAN_MESSAGE_BRS | PCAN_MESSAGE_ESI)
+
+#define QUEUE_COUNT(q)          ((q)->head - (q)->tail)
+#define QUEUE_SLOT(q,i)         (&(q)->frame[(i) % (q)->size])
+
+/*  -----------  types  --------------------------------------------------
+ */
+typedef struct {                        // simulated frame:
+    TPCANMsgFD msg;                     //   the message (CAN 2.0 or CAN FD)
+    uint64_t time;                      //   queued (tx) resp. received (rx) [ns]
+}   sim_frame_t;
+
+typedef struct {                        // frame queue (ring buffer):
+    sim_frame_t *frame;                 //   the frames
+    uint32_t size;                      //   number of frames
+    uint32_t head;                      //   next to be written
+    uint32_t tail;                      //   next to be read
+}   sim_queue_t;
+
+typedef struct {                        // virtual channel:
+    TPCANHandle handle;                 //   PCAN channel handle
+    int initialized;                    //   channel is initialized
+    unsigned int generation;            //   incremented on (re-)initialization
+    int fdoe;                           //   CAN FD operation enabled
+    int fdes;                           //   receive event (eventfd)
+    TPCANBaudrate btr0btr1;             //   bit-rate (CAN 2.0)
+    char bitrate[MAX_LENGTH_VERSION_STRING];  // bit-rate string (CAN FD)
+    DWORD nominal_speed;                //   nominal bus speed [bps]
+    DWORD data_speed;                   //   data phase bus speed [bps]
+    uint32_t nominal;                   //   nominal bit time [ps]
+    uint32_t data;                      //   data phase bit time [ps]
+    DWORD listen_only;                  //   PCAN_LISTEN_ONLY
+    DWORD receive_status;               //   PCAN_RECEIVE_STATUS
+    DWORD allow_status;                 //   PCAN_ALLOW_STATUS_FRAMES
+    DWORD allow_rtr;                    //   PCAN_ALLOW_RTR_FRAMES
+    DWORD allow_error;                  //   PCAN_ALLOW_ERROR_FRAMES
+    DWORD filter;                       //   PCAN_MESSAGE_FILTER
+    DWORD range[2];                     //   CAN_FilterMessages (from, to)
+    BYTE range_xtd;                     //   range for 29-bit identifier
+    UINT64 accept[2];                   //   PCAN_ACCEPTANCE_FILTER_11BIT/29BIT
+    TPCANStatus status;                 //   latched status (queue overrun)
+    uint32_t tx_err;                    //   transmit error counter
+    sim_queue_t tx;                     //   transmit queue
+    sim_queue_t rx;                     //   receive queue
+}   sim_channel_t;
+
+typedef struct {                        // virtual CAN bus:
+    pthread_mutex_t mutex;              //   one lock for the bus and channels
+    pthread_cond_t cond;                //   signals a frame to be transmitted
+    pthread_t thread;                   //   the bus thread
+    int running;                        //   bus thread is running
+    uint64_t epoch;                     //   origin of the time-stamps [ns]
+    uint64_t idle;                      //   end of the last frame [ns]
+    sim_channel_t channel[SIM_CHANNELS];  // the virtual channels
+}   sim_bus_t;
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+static sim_channel_t *sim_channel(TPCANHandle handle);
+static TPCANStatus sim_initialize(TPCANHandle handle, const btr_bitrate_t *bitrate, int fdoe, int brse,
+                                  TPCANBaudrate btr0btr1, const char *string);
+static TPCANStatus sim_uninitialize(sim_channel_t *channel);
+static void sim_reset(sim_channel_t *channel);
+static TPCANStatus sim_read(TPCANHandle handle, int fdoe, TPCANMsgFD *msg, uint64_t *time);
+static TPCANStatus sim_write(TPCANHandle handle, int fdoe, const TPCANMsgFD *msg);
+
+static void *sim_bus(void *arg);
+static sim_channel_t *sim_arbitrate(void);
+static int sim_match(const sim_channel_t *receiver, const sim_channel_t *sender, const TPCANMsgFD *msg);
+static int sim_accept(const sim_channel_t *receiver, const TPCANMsgFD *msg);
+static void sim_deliver(sim_channel_t *receiver, const TPCANMsgFD *msg, uint64_t time);
+
+static uint64_t sim_frame_time(const sim_channel_t *sender, const TPCANMsgFD *msg);
+
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+static const TPCANHandle sim_handles[SIM_CHANNELS] = {
+    PCAN_USBBUS1, PCAN_USBBUS2, PCAN_USBBUS3, PCAN_USBBUS4,
+    PCAN_USBBUS5, PCAN_USBBUS6, PCAN_USBBUS7, PCAN_USBBUS8,
+    PCAN_USBBUS9, PCAN_USBBUS10, PCAN_USBBUS11, PCAN_USBBUS12,
+    PCAN_USBBUS13, PCAN_USBBUS14, PCAN_USBBUS15, PCAN_USBBUS16
+};
+static sim_bus_t bus = {                // the virtual CAN bus
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .running = 0
+};
+
+/*  -----------  functions  ----------------------------------------------
+ */
+__attribute__((destructor))
+static void _finalizer() {
+    int i;
+
+    // uninitialize all channels and stop the bus thread
+    pthread_mutex_lock(&bus.mutex);
+    for (i = 0; i < SIM_CHANNELS; i++)
+        if (bus.channel[i].initialized)
+            (void)sim_uninitialize(&bus.channel[i]);
+    if (bus.running) {
+        bus.running = 0;
+        pthread_cond_signal(&bus.cond);
+        pthread_mutex_unlock(&bus.mutex);
+        pthread_join(bus.thread, NULL);
+        return;
+    }
+    pthread_mutex_unlock(&bus.mutex);
+}
+
+TPCANStatus CAN_Initialize(TPCANHandle Channel, TPCANBaudrate Btr0Btr1, TPCANType HwType, DWORD IOPort, WORD Interrupt)
+{
+    btr_bitrate_t bitrate;              // bit-rate settings
+
+    (void)HwType;                       // only PnP channels are simulated
+    (void)IOPort;
+    (void)Interrupt;
+
+    if (btr_sja10002bitrate((btr_sja1000_t)Btr0Btr1, &bitrate) != 0)
+        return PCAN_ERROR_ILLPARAMVAL;
+    return sim_initialize(Channel, &bitrate, 0, 0, Btr0Btr1, "");
+}
+
+TPCANStatus CAN_InitializeFD(TPCANHandle Channel, TPCANBitrateFD BitrateFD)
+{
+    btr_bitrate_t bitrate;              // bit-rate settings
+    bool data = false, sam = false;     // bit-rate string options
+
+    if (!BitrateFD)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if (btr_string2bitrate(BitrateFD, &bitrate, &data, &sam) != 0)
+        return PCAN_ERROR_ILLPARAMVAL;
+    return sim_initialize(Channel, &bitrate, 1, data ? 1 : 0, 0x0000U, BitrateFD);
+}
+
+TPCANStatus CAN_Uninitialize(TPCANHandle Channel)
+{
+    sim_channel_t *channel;             // the virtual channel
+    TPCANStatus sts = PCAN_ERROR_OK;    // represents a status
+    int i;                              // loop variable
+
+    pthread_mutex_lock(&bus.mutex);
+    if (Channel == PCAN_NONEBUS) {      // all initialized channels
+        for (i = 0; i < SIM_CHANNELS; i++)
+            if (bus.channel[i].initialized)
+                (void)sim_uninitialize(&bus.channel[i]);
+    }
+    else if ((channel = sim_channel(Channel)) != NULL)
+        sts = sim_uninitialize(channel);
+    else
+        sts = PCAN_ERROR_ILLHW;
+    pthread_mutex_unlock(&bus.mutex);
+    return sts;
+}
+
+TPCANStatus CAN_Reset(TPCANHandle Channel)
+{
+    sim_channel_t *channel;             // the virtual channel
+    TPCANStatus sts = PCAN_ERROR_OK;    // represents a status
+    int i;                              // loop variable
+
+    pthread_mutex_lock(&bus.mutex);
+    if (Channel == PCAN_NONEBUS) {      // all initialized channels
+        for (i = 0; i < SIM_CHANNELS; i++)
+            if (bus.channel[i].initialized)
+                sim_reset(&bus.channel[i]);
+    }
+    else if ((channel = sim_channel(Channel)) == NULL)
+        sts = PCAN_ERROR_ILLHW;
+    else if (!channel->initialized)
+        sts = PCAN_ERROR_INITIALIZE;
+    else
+        sim_reset(channel);
+    pthread_mutex_unlock(&bus.mutex);
+    return sts;
+}
+
+TPCANStatus CAN_GetStatus(TPCANHandle Channel)
+{
+    sim_channel_t *channel;             // the virtual channel
+    TPCANStatus sts;                    // represents a status
+
+    pthread_mutex_lock(&bus.mutex);
+    if ((channel = sim_channel(Channel)) == NULL)
+        sts = PCAN_ERROR_ILLHW;
+    else if (!channel->initialized)
+        sts = PCAN_ERROR_INITIALIZE;
+    else {
+        sts = channel->status;          // note: the overrun is latched
+        channel->status = PCAN_ERROR_OK;
+        if (channel->tx_err >= SIM_ERROR_PASSIVE)
+            sts |= PCAN_ERROR_BUSPASSIVE | PCAN_ERROR_BUSWARNING;
+        else if (channel->tx_err >= SIM_ERROR_WARNING)
+            sts |= PCAN_ERROR_BUSWARNING;
+    }
+    pthread_mutex_unlock(&bus.mutex);
+    return sts;
+}
+
+TPCANStatus CAN_Read(TPCANHandle Channel, TPCANMsg* MessageBuffer, TPCANTimestamp* TimestampBuffer)
+{
+    TPCANMsgFD msg;                     // received message
+    uint64_t time;                      // time-stamp [us]
+    TPCANStatus sts;                    // represents a status
+
+    if (!MessageBuffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((sts = sim_read(Channel, 0, &msg, &time)) != PCAN_ERROR_OK)
+        return sts;
+    MessageBuffer->ID = msg.ID;
+    MessageBuffer->MSGTYPE = msg.MSGTYPE;
+    MessageBuffer->LEN = msg.DLC;
+    memcpy(MessageBuffer->DATA, msg.DATA, 8);
+    if (TimestampBuffer) {
+        TimestampBuffer->millis = (DWORD)(time / 1000U);
+        TimestampBuffer->millis_overflow = (WORD)((time / 1000U) >> 32);
+        TimestampBuffer->micros = (WORD)(time % 1000U);
+    }
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_ReadFD(TPCANHandle Channel, TPCANMsgFD* MessageBuffer, TPCANTimestampFD *TimestampBuffer)
+{
+    uint64_t time;                      // time-stamp [us]
+    TPCANStatus sts;                    // represents a status
+
+    if (!MessageBuffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((sts = sim_read(Channel, 1, MessageBuffer, &time)) != PCAN_ERROR_OK)
+        return sts;
+    if (TimestampBuffer)
+        *TimestampBuffer = (TPCANTimestampFD)time;
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_Write(TPCANHandle Channel, TPCANMsg* MessageBuffer)
+{
+    TPCANMsgFD msg;                     // message to be sent
+
+    if (!MessageBuffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((MessageBuffer->LEN > 8U) || (MessageBuffer->MSGTYPE & (PCAN_MESSAGE_FD | PCAN_MESSAGE_BRS | PCAN_MESSAGE_ESI)))
+        return PCAN_ERROR_ILLPARAMVAL;
+    memset(&msg, 0, sizeof(TPCANMsgFD));
+    msg.ID = MessageBuffer->ID;
+    msg.MSGTYPE = MessageBuffer->MSGTYPE;
+    msg.DLC = MessageBuffer->LEN;
+    memcpy(msg.DATA, MessageBuffer->DATA, 8);
+    return sim_write(Channel, 0, &msg);
+}
+
+TPCANStatus CAN_WriteFD(TPCANHandle Channel, TPCANMsgFD* MessageBuffer)
+{
+    if (!MessageBuffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((MessageBuffer->DLC > 15U) || (!(MessageBuffer->MSGTYPE & PCAN_MESSAGE_FD) && (MessageBuffer->DLC > 8U)))
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((MessageBuffer->MSGTYPE & PCAN_MESSAGE_FD) && (MessageBuffer->MSGTYPE & PCAN_MESSAGE_RTR))
+        return PCAN_ERROR_ILLPARAMVAL;
+    if (!(MessageBuffer->MSGTYPE & PCAN_MESSAGE_FD) && (MessageBuffer->MSGTYPE & (PCAN_MESSAGE_BRS | PCAN_MESSAGE_ESI)))
+        return PCAN_ERROR_ILLPARAMVAL;
+    return sim_write(Channel, 1, MessageBuffer);
+}
+
+TPCANStatus CAN_FilterMessages(TPCANHandle Channel, DWORD FromID, DWORD ToID, TPCANMode Mode)
+{
+    sim_channel_t *channel;             // the virtual channel
+    TPCANStatus sts = PCAN_ERROR_OK;    // represents a status
+
+    if ((FromID > ToID) || (ToID > ((Mode == PCAN_MODE_EXTENDED) ? SIM_XTD_MASK : SIM_STD_MASK)))
+        return PCAN_ERROR_ILLPARAMVAL;
+    pthread_mutex_lock(&bus.mutex);
+    if ((channel = sim_channel(Channel)) == NULL)
+        sts = PCAN_ERROR_ILLHW;
+    else if (!channel->initialized)
+        sts = PCAN_ERROR_INITIALIZE;
+    else if (channel->filter != PCAN_FILTER_CUSTOM) {
+        channel->range[0] = FromID;
+        channel->range[1] = ToID;
+        channel->range_xtd = (Mode == PCAN_MODE_EXTENDED) ? 1 : 0;
+        channel->filter = PCAN_FILTER_CUSTOM;
+    }
+    else {                              // note: the range is expanded
+        if (FromID < channel->range[0])
+            channel->range[0] = FromID;
+        if (ToID > channel->range[1])
+            channel->range[1] = ToID;
+        if (Mode == PCAN_MODE_EXTENDED)
+            channel->range_xtd = 1;
+    }
+    pthread_mutex_unlock(&bus.mutex);
+    return sts;
+}
+
+TPCANStatus CAN_GetValue(TPCANHandle Channel, TPCANParameter Parameter, void* Buffer, DWORD BufferLength)
+{
+    sim_channel_t *channel;             // the virtual channel
+    TPCANStatus sts;                    // represents a status
+    DWORD value;                        // a parameter value
+
+    if (!Buffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    // parameters without a channel
+    switch (Parameter) {
+        case PCAN_API_VERSION:
+            return util_put_string(Buffer, BufferLength, SIM_VERSION_STRING);
+        case PCAN_CHANNEL_VERSION:
+            return util_put_string(Buffer, BufferLength, SIM_CHANNEL_VERSION);
+        default:
+            break;
+    }
+    pthread_mutex_lock(&bus.mutex);
+    if ((channel = sim_channel(Channel)) == NULL) {
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_ILLHW;
+    }
+    switch (Parameter) {
+        case PCAN_CHANNEL_CONDITION:
+            value = channel->initialized ? PCAN_CHANNEL_OCCUPIED : PCAN_CHANNEL_AVAILABLE;
+            sts = util_put(Buffer, BufferLength, &value, sizeof(DWORD));
+            break;
+        case PCAN_CHANNEL_FEATURES:
+            value = FEATURE_FD_CAPABLE;
+            sts = util_put(Buffer, BufferLength, &value, sizeof(DWORD));
+            break;
+        case PCAN_DEVICE_ID:
+        case PCAN_CONTROLLER_NUMBER:
+            value = 0U;                 // one device per channel
+            sts = util_put(Buffer, BufferLength, &value, sizeof(DWORD));
+            break;
+        case PCAN_HARDWARE_NAME:
+            sts = util_put_string(Buffer, BufferLength, SIM_HARDWARE_NAME);
+            break;
+        case PCAN_FIRMWARE_VERSION:
+            sts = util_put_string(Buffer, BufferLength, SIM_FIRMWARE_VERSION);
+            break;
+#ifdef PCAN_EXT_HARDWARE_VERSION
+        case PCAN_EXT_HARDWARE_VERSION:
+            sts = util_put_string(Buffer, BufferLength, SIM_HARDWARE_NAME ", Firmware " SIM_FIRMWARE_VERSION);
+            break;
+#endif
+        case PCAN_LISTEN_ONLY:
+            sts = util_put(Buffer, BufferLength, &channel->listen_only, sizeof(DWORD));
+            break;
+        case PCAN_RECEIVE_STATUS:
+            sts = util_put(Buffer, BufferLength, &channel->receive_status, sizeof(DWORD));
+            break;
+        case PCAN_ALLOW_STATUS_FRAMES:
+            sts = util_put(Buffer, BufferLength, &channel->allow_status, sizeof(DWORD));
+            break;
+        case PCAN_ALLOW_RTR_FRAMES:
+            sts = util_put(Buffer, BufferLength, &channel->allow_rtr, sizeof(DWORD));
+            break;
+        case PCAN_ALLOW_ERROR_FRAMES:
+            sts = util_put(Buffer, BufferLength, &channel->allow_error, sizeof(DWORD));
+            break;
+        default:
+            // parameters of an initialized channel
+            if (!channel->initialized) {
+                sts = ((Parameter == PCAN_RECEIVE_EVENT) || (Parameter == PCAN_MESSAGE_FILTER) ||
+                       (Parameter == PCAN_ACCEPTANCE_FILTER_11BIT) || (Parameter == PCAN_ACCEPTANCE_FILTER_29BIT) ||
+                       (Parameter == PCAN_BITRATE_INFO) || (Parameter == PCAN_BITRATE_INFO_FD) ||
+                       (Parameter == PCAN_BUSSPEED_NOMINAL) || (Parameter == PCAN_BUSSPEED_DATA)) ?
+                       PCAN_ERROR_INITIALIZE : PCAN_ERROR_ILLPARAMTYPE;
+                break;
+            }
+            switch (Parameter) {
+                case PCAN_RECEIVE_EVENT:
+                    sts = util_put(Buffer, BufferLength, &channel->fdes, sizeof(int));
+                    break;
+                case PCAN_MESSAGE_FILTER:
+                    sts = util_put(Buffer, BufferLength, &channel->filter, sizeof(DWORD));
+                    break;
+                case PCAN_ACCEPTANCE_FILTER_11BIT:
+                    sts = util_put(Buffer, BufferLength, &channel->accept[0], sizeof(UINT64));
+                    break;
+                case PCAN_ACCEPTANCE_FILTER_29BIT:
+                    sts = util_put(Buffer, BufferLength, &channel->accept[1], sizeof(UINT64));
+                    break;
+                case PCAN_BITRATE_INFO:
+                    sts = !channel->fdoe ? util_put(Buffer, BufferLength, &channel->btr0btr1, sizeof(TPCANBaudrate))
+                                         : PCAN_ERROR_ILLOPERATION;
+                    break;
+                case PCAN_BITRATE_INFO_FD:
+                    sts = channel->fdoe ? util_put_string(Buffer, BufferLength, channel->bitrate)
+                                        : PCAN_ERROR_ILLOPERATION;
+                    break;
+                case PCAN_BUSSPEED_NOMINAL:
+                    sts = util_put(Buffer, BufferLength, &channel->nominal_speed, sizeof(DWORD));
+                    break;
+                case PCAN_BUSSPEED_DATA:
+                    sts = util_put(Buffer, BufferLength, &channel->data_speed, sizeof(DWORD));
+                    break;
+                default:
+                    sts = PCAN_ERROR_ILLPARAMTYPE;
+                    break;
+            }
+            break;
+    }
+    pthread_mutex_unlock(&bus.mutex);
+    return sts;
+}
+
+TPCANStatus CAN_SetValue(TPCANHandle Channel, TPCANParameter Parameter, void* Buffer, DWORD BufferLength)
+{
+    sim_channel_t *channel;             // the virtual channel
+    TPCANStatus sts = PCAN_ERROR_OK;    // represents a status
+    UINT64 value;                       // acceptance code and mask
+
+    if (!Buffer || !BufferLength)
+        return PCAN_ERROR_ILLPARAMVAL;
+    pthread_mutex_lock(&bus.mutex);
+    if ((channel = sim_channel(Channel)) == NULL) {
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_ILLHW;
+    }
+    /* note: the reception flags can be set before the channel is initialized */
+    switch (Parameter) {
+        case PCAN_LISTEN_ONLY:
+            channel->listen_only = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            break;
+        case PCAN_RECEIVE_STATUS:
+            channel->receive_status = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            break;
+        case PCAN_ALLOW_STATUS_FRAMES:
+            channel->allow_status = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            break;
+        case PCAN_ALLOW_RTR_FRAMES:
+            channel->allow_rtr = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            break;
+        case PCAN_ALLOW_ERROR_FRAMES:
+            channel->allow_error = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            break;
+        case PCAN_MESSAGE_FILTER:
+            if (!channel->initialized)
+                sts = PCAN_ERROR_INITIALIZE;
+            else if (util_get_dword(Buffer, BufferLength) == PCAN_FILTER_OPEN)
+                channel->filter = PCAN_FILTER_OPEN;
+            else if (util_get_dword(Buffer, BufferLength) == PCAN_FILTER_CLOSE)
+                channel->filter = PCAN_FILTER_CLOSE;
+            else
+                sts = PCAN_ERROR_ILLPARAMVAL;
+            break;
+        case PCAN_ACCEPTANCE_FILTER_11BIT:
+        case PCAN_ACCEPTANCE_FILTER_29BIT:
+            if (!channel->initialized)
+                sts = PCAN_ERROR_INITIALIZE;
+            else if (BufferLength < sizeof(UINT64))
+                sts = PCAN_ERROR_ILLPARAMVAL;
+            else {
+                memcpy(&value, Buffer, sizeof(UINT64));
+                channel->accept[(Parameter == PCAN_ACCEPTANCE_FILTER_11BIT) ? 0 : 1] = value;
+            }
+            break;
+        default:
+            sts = PCAN_ERROR_ILLPARAMTYPE;
+            break;
+    }
+    pthread_mutex_unlock(&bus.mutex);
+    return sts;
+}
+
+TPCANStatus CAN_GetErrorText(TPCANStatus Error, WORD Language, LPSTR Buffer)
+{
+    const char *text;                   // error text (English only)
+
+    (void)Language;
+
+    if (!Buffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    switch (Error) {
+        case PCAN_ERROR_OK: text = "No error"; break;
+        case PCAN_ERROR_XMTFULL: text = "Transmit buffer in CAN controller is full"; break;
+        case PCAN_ERROR_OVERRUN: text = "CAN controller was read too late"; break;
+        case PCAN_ERROR_BUSLIGHT: text = "Bus error: an error counter reached the 'light' limit"; break;
+        case PCAN_ERROR_BUSHEAVY: text = "Bus error: an error counter reached the 'heavy' limit"; break;
+        case PCAN_ERROR_BUSPASSIVE: text = "Bus error: the CAN controller is error passive"; break;
+        case PCAN_ERROR_BUSOFF: text = "Bus error: the CAN controller is in bus-off state"; break;
+        case PCAN_ERROR_QRCVEMPTY: text = "Receive queue is empty"; break;
+        case PCAN_ERROR_QOVERRUN: text = "Receive queue was read too late"; break;
+        case PCAN_ERROR_QXMTFULL: text = "Transmit queue is full"; break;
+        case PCAN_ERROR_ILLHW: text = "Hardware handle is invalid"; break;
+        case PCAN_ERROR_ILLPARAMTYPE: text = "Invalid parameter"; break;
+        case PCAN_ERROR_ILLPARAMVAL: text = "Invalid parameter value"; break;
+        case PCAN_ERROR_INITIALIZE: text = "Channel is not initialized"; break;
+        case PCAN_ERROR_ILLOPERATION: text = "Invalid operation"; break;
+        default: text = "Undefined error"; break;
+    }
+    strncpy(Buffer, text, MAX_LENGTH_VERSION_STRING - 1);
+    Buffer[MAX_LENGTH_VERSION_STRING - 1] = '\0';
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_LookUpChannel(LPSTR Parameters, TPCANHandle* FoundChannel)
+{
+    (void)Parameters;
+
+    // note: the look-up of channels is not simulated
+    if (FoundChannel)
+        *FoundChannel = PCAN_NONEBUS;
+    return PCAN_ERROR_ILLOPERATION;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+static sim_channel_t *sim_channel(TPCANHandle handle)
+{
+    int i;                              // loop variable
+
+    for (i = 0; i < SIM_CHANNELS; i++) {
+        if (sim_handles[i] == handle) {
+            if (bus.channel[i].handle != handle) {
+                // first use: PCANBasic defaults
+                bus.channel[i].handle = handle;
+                bus.channel[i].allow_status = PCAN_PARAMETER_ON;
+                bus.channel[i].allow_rtr = PCAN_PARAMETER_ON;
+                bus.channel[i].allow_error = PCAN_PARAMETER_OFF;
+            }
+            return &bus.channel[i];
+        }
+    }
+    return NULL;
+}
+
+static TPCANStatus sim_initialize(TPCANHandle handle, const btr_bitrate_t *bitrate, int fdoe, int brse,
+                                  TPCANBaudrate btr0btr1, const char *string)
+{
+    sim_channel_t *channel;             // the virtual channel
+    btr_speed_t speed;                  // transmission speed
+    sim_frame_t *tx, *rx;               // frame queues
+    int fd;                             // receive event
+
+    if ((btr_bitrate2speed(bitrate, &speed) != 0) ||
+        !((speed.nominal.speed > 0.0f) && (speed.nominal.speed <= 1.0e9f)) ||
+        (brse && !((speed.data.speed > 0.0f) && (speed.data.speed <= 1.0e9f))))
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((tx = (sim_frame_t*)calloc(SIM_TX_QUEUE, sizeof(sim_frame_t))) == NULL)
+        return PCAN_ERROR_RESOURCE;
+    if ((rx = (sim_frame_t*)calloc(SIM_RX_QUEUE, sizeof(sim_frame_t))) == NULL) {
+        free(tx);
+        return PCAN_ERROR_RESOURCE;
+    }
+    if ((fd = eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        free(rx);
+        free(tx);
+        return PCAN_ERROR_RESOURCE;
+    }
+    pthread_mutex_lock(&bus.mutex);
+    if ((channel = sim_channel(handle)) == NULL) {
+        pthread_mutex_unlock(&bus.mutex);
+        close(fd), free(rx), free(tx);
+        return PCAN_ERROR_ILLHW;
+    }
+    if (channel->initialized) {
+        pthread_mutex_unlock(&bus.mutex);
+        close(fd), free(rx), free(tx);
+        return PCAN_ERROR_INITIALIZE;
+    }
+    // start the bus thread with the first channel
+    if (!bus.running) {
+        bus.epoch = util_clock();
+        bus.idle = bus.epoch;
+        bus.running = 1;
+        if (pthread_create(&bus.thread, NULL, sim_bus, NULL) != 0) {
+            bus.running = 0;
+            pthread_mutex_unlock(&bus.mutex);
+            close(fd), free(rx), free(tx);
+            return PCAN_ERROR_RESOURCE;
+        }
+    }
+    channel->fdoe = fdoe;
+    channel->fdes = fd;
+    channel->btr0btr1 = btr0btr1;
+    strncpy(channel->bitrate, string, MAX_LENGTH_VERSION_STRING - 1);
+    channel->bitrate[MAX_LENGTH_VERSION_STRING - 1] = '\0';
+    channel->nominal_speed = (DWORD)(speed.nominal.speed + 0.5f);
+    channel->data_speed = brse ? (DWORD)(speed.data.speed + 0.5f) : channel->nominal_speed;
+    channel->nominal = (uint32_t)((1.0e12f / speed.nominal.speed) + 0.5f);
+    channel->data = brse ? (uint32_t)((1.0e12f / speed.data.speed) + 0.5f) : channel->nominal;
+    channel->filter = PCAN_FILTER_OPEN;
+    channel->accept[0] = (UINT64)SIM_STD_MASK;  // code 0, all bits don't care
+    channel->accept[1] = (UINT64)SIM_XTD_MASK;  // code 0, all bits don't care
+    channel->status = PCAN_ERROR_OK;
+    channel->tx_err = 0U;
+    channel->tx.frame = tx;
+    channel->tx.size = SIM_TX_QUEUE;
+    channel->tx.head = channel->tx.tail = 0U;
+    channel->rx.frame = rx;
+    channel->rx.size = SIM_RX_QUEUE;
+    channel->rx.head = channel->rx.tail = 0U;
+    channel->generation++;
+    channel->initialized = 1;
+    pthread_mutex_unlock(&bus.mutex);
+    return PCAN_ERROR_OK;
+}
+
+static TPCANStatus sim_uninitialize(sim_channel_t *channel)
+{
+    /* note: the bus lock must be held by the caller */
+    if (!channel->initialized)
+        return PCAN_ERROR_INITIALIZE;
+    channel->initialized = 0;
+    channel->generation++;
+    close(channel->fdes);
+    channel->fdes = -1;
+    free(channel->tx.frame);
+    free(channel->rx.frame);
+    memset(&channel->tx, 0, sizeof(sim_queue_t));
+    memset(&channel->rx, 0, sizeof(sim_queue_t));
+    return PCAN_ERROR_OK;
+}
+
+static void sim_reset(sim_channel_t *channel)
+{
+    uint64_t value;                     // eventfd counter
+
+    /* note: the bus lock must be held by the caller */
+    channel->tx.head = channel->tx.tail = 0U;
+    channel->rx.head = channel->rx.tail = 0U;
+    channel->status = PCAN_ERROR_OK;
+    channel->tx_err = 0U;
+    channel->generation++;              // a frame on the bus is discarded
+    (void)!read(channel->fdes, &value, sizeof(value));
+}
+
+static TPCANStatus sim_read(TPCANHandle handle, int fdoe, TPCANMsgFD *msg, uint64_t *time)
+{
+    sim_channel_t *channel;             // the virtual channel
+    sim_frame_t *frame;                 // the received frame
+    uint64_t value;                     // eventfd counter
+
+    pthread_mutex_lock(&bus.mutex);
+    if ((channel = sim_channel(handle)) == NULL) {
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_ILLHW;
+    }
+    if (!channel->initialized) {
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_INITIALIZE;
+    }
+    if (channel->fdoe != fdoe) {        // CAN_Read resp. CAN_ReadFD
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_ILLOPERATION;
+    }
+    if (!QUEUE_COUNT(&channel->rx)) {
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_QRCVEMPTY;
+    }
+    frame = QUEUE_SLOT(&channel->rx, channel->rx.tail);
+    memcpy(msg, &frame->msg, sizeof(TPCANMsgFD));
+    *time = (frame->time - bus.epoch) / 1000U;
+    channel->rx.tail++;
+    // the receive event is signaled as long as the queue is not empty
+    if (!QUEUE_COUNT(&channel->rx))
+        (void)!read(channel->fdes, &value, sizeof(value));
+    pthread_mutex_unlock(&bus.mutex);
+    return PCAN_ERROR_OK;
+}
+
+static TPCANStatus sim_write(TPCANHandle handle, int fdoe, const TPCANMsgFD *msg)
+{
+    sim_channel_t *channel;             // the virtual channel
+    sim_frame_t *frame;                 // the frame to be sent
+
+    if (msg->MSGTYPE & ~SIM_MSGTYPE_MASK)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if (msg->ID > ((msg->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? SIM_XTD_MASK : SIM_STD_MASK))
+        return PCAN_ERROR_ILLPARAMVAL;
+    pthread_mutex_lock(&bus.mutex);
+    if ((channel = sim_channel(handle)) == NULL) {
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_ILLHW;
+    }
+    if (!channel->initialized) {
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_INITIALIZE;
+    }
+    if ((channel->fdoe != fdoe) || channel->listen_only ||
+        ((msg->MSGTYPE & PCAN_MESSAGE_BRS) && (channel->data == channel->nominal))) {
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_ILLOPERATION;
+    }
+    if (QUEUE_COUNT(&channel->tx) >= channel->tx.size) {
+        pthread_mutex_unlock(&bus.mutex);
+        return PCAN_ERROR_QXMTFULL;
+    }
+    frame = QUEUE_SLOT(&channel->tx, channel->tx.head);
+    memcpy(&frame->msg, msg, sizeof(TPCANMsgFD));
+    frame->time = util_clock();
+    if (!QUEUE_COUNT(&channel->tx))     // wake up the bus thread
+        pthread_cond_signal(&bus.cond);
+    channel->tx.head++;
+    pthread_mutex_unlock(&bus.mutex);
+    return PCAN_ERROR_OK;
+}
+
+static void *sim_bus(void *arg)
+{
+    sim_channel_t *sender;              // channel that won the arbitration
+    sim_frame_t frame;                  // the frame on the bus
+    unsigned int generation;            // of the sender
+    uint64_t start, end;                // of the frame [ns]
+    int acked;                          // frame acknowledged
+    int i;                              // loop variable
+
+    (void)arg;
+
+    pthread_mutex_lock(&bus.mutex);
+    while (bus.running) {
+        if ((sender = sim_arbitrate()) == NULL) {
+            pthread_cond_wait(&bus.cond, &bus.mutex);
+            continue;
+        }
+        memcpy(&frame, QUEUE_SLOT(&sender->tx, sender->tx.tail), sizeof(sim_frame_t));
+        generation = sender->generation;
+        /* note: back-to-back frames start at the end of the previous frame,
+         *       independent of the wake-up latency of the bus thread */
+        start = (bus.idle > frame.time) ? bus.idle : frame.time;
+        end = start + sim_frame_time(sender, &frame.msg);
+        pthread_mutex_unlock(&bus.mutex);
+        util_sleep(end);
+        pthread_mutex_lock(&bus.mutex);
+        bus.idle = end;
+        // the sender has been reset or uninitialized in the meantime
+        if (!sender->initialized || (sender->generation != generation))
+            continue;
+        // the frame is acknowledged by any other channel with the same bit-rate settings
+        for (i = 0, acked = 0; (i < SIM_CHANNELS) && !acked; i++)
+            acked = (&bus.channel[i] != sender) && bus.channel[i].initialized &&
+                    !bus.channel[i].listen_only && sim_match(&bus.channel[i], sender, &frame.msg);
+        if (!acked) {
+            /* note: the frame is repeated until it is acknowledged, an acknowledge
+             *       error of an error passive transmitter is not counted */
+            if (sender->tx_err < SIM_ERROR_PASSIVE)
+                sender->tx_err += 8U;
+            continue;
+        }
+        if (sender->tx_err)
+            sender->tx_err--;
+        sender->tx.tail++;
+        for (i = 0; i < SIM_CHANNELS; i++) {
+            if ((&bus.channel[i] != sender) && bus.channel[i].initialized &&
+                sim_match(&bus.channel[i], sender, &frame.msg) && sim_accept(&bus.channel[i], &frame.msg))
+                sim_deliver(&bus.channel[i], &frame.msg, end);
+        }
+    }
+    pthread_mutex_unlock(&bus.mutex);
+    return NULL;
+}
+
+static sim_channel_t *sim_arbitrate(void)
+{
+    sim_channel_t *winner = NULL;       // the frame with the highest priority
+    const TPCANMsgFD *msg;              // the frame of a channel
+    uint32_t key, lowest = 0U;          // arbitration field (dominant = 0)
+    int i;                              // loop variable
+
+    /* note: the bus lock must be held by the caller */
+    for (i = 0; i < SIM_CHANNELS; i++) {
+        if (!bus.channel[i].initialized || !QUEUE_COUNT(&bus.channel[i].tx))
+            continue;
+        msg = &QUEUE_SLOT(&bus.channel[i].tx, bus.channel[i].tx.tail)->msg;
+        key = util_arbitration(msg->ID, msg->MSGTYPE);
+        if (!winner || (key < lowest)) {
+            winner = &bus.channel[i];
+            lowest = key;
+        }
+    }
+    return winner;
+}
+
+static int sim_match(const sim_channel_t *receiver, const sim_channel_t *sender, const TPCANMsgFD *msg)
+{
+    return util_match(receiver->nominal, receiver->data, receiver->fdoe, msg->MSGTYPE, sender->nominal, sender->data);
+}
+
+static int sim_accept(const sim_channel_t *receiver, const TPCANMsgFD *msg)
+{
+    int xtd = (msg->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? 1 : 0;
+
+    if (!util_accept(msg->ID, msg->MSGTYPE, receiver->filter, receiver->allow_rtr, receiver->accept))
+        return 0;
+    // message filter: range of identifiers
+    if (receiver->filter == PCAN_FILTER_CUSTOM) {
+        if ((msg->ID < receiver->range[0]) || (receiver->range[1] < msg->ID))
+            return 0;
+        if (xtd && !receiver->range_xtd)
+            return 0;
+    }
+    return 1;
+}
+
+static void sim_deliver(sim_channel_t *receiver, const TPCANMsgFD *msg, uint64_t time)
+{
+    sim_frame_t *frame;                 // the received frame
+    uint64_t value = 1U;                // eventfd counter increment
+
+    /* note: the bus lock must be held by the caller */
+    if (QUEUE_COUNT(&receiver->rx) >= receiver->rx.size) {
+        receiver->status |= PCAN_ERROR_QOVERRUN;
+        return;
+    }
+    frame = QUEUE_SLOT(&receiver->rx, receiver->rx.head);
+    memcpy(&frame->msg, msg, sizeof(TPCANMsgFD));
+    frame->time = time;
+    receiver->rx.head++;
+    // the receive event is signaled when the queue becomes non-empty
+    if (QUEUE_COUNT(&receiver->rx) == 1U)
+        (void)!write(receiver->fdes, &value, sizeof(value));
+}
+
+static uint64_t sim_frame_time(const sim_channel_t *sender, const TPCANMsgFD *msg)
+{
+    /* note: returns the bus time of the frame in nanoseconds (cf. util_frame_time) */
+    return (util_frame_time(msg->ID, msg->MSGTYPE, msg->DLC, msg->DATA, sender->nominal, sender->data) + 500U) / 1000U;
+}
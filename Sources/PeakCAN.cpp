@@ -58,6 +58,7 @@
 
 #include "can_defs.h"
 #include "can_api.h"
+#include "PeakCAN_Extensions.h"
 #include "can_btr.h"
 
 #include <string.h>
@@ -66,6 +67,12 @@
 #include <assert.h>
 #include <limits.h>
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <new>
+
 #if defined(_WIN64)
 #define PLATFORM        "x64"
 #elif defined(_WIN32)
@@ -109,15 +116,68 @@ static const char version[] = "CAN API V3 for PEAK-System PCAN Interfaces, Versi
 static const char version[] = "CAN API V3 for PEAK-System PCAN USB Interfaces, Version " VERSION_STRING;
 #endif
 
+#define CALLBACK_BATCH    64U   // default number of messages per batch
+#define CALLBACK_TIMEOUT  100U  // time-out of a read to check the status [ms]
+#define CALLBACK_POLLING  10U   // interval to poll the status w/o a read [ms]
+#define CALLBACK_STATUS   (CANSTAT_BOFF | CANSTAT_EWRN | CANSTAT_QUE_OVR | CANSTAT_MSG_LST)
+
+struct CPeakCAN::SDispatch {
+    std::thread thread;  // dispatch thread (one per channel)
+    std::mutex mutex;  // protects 'quit' and 'starts'
+    std::condition_variable cond;  // signaled on quit and start
+    bool running;  // dispatch thread running
+    bool quit;  // dispatch thread shall quit
+    uint64_t starts;  // number of starts of the CAN controller
+    ReceiveCallback receive;  // a message with the status register
+    BatchCallback batch;  // up to 'max' messages at once
+    StatusCallback status;  // bus off, warning level or overrun changed
+    size_t max;  // number of messages per batch
+    std::atomic<uint64_t> count;  // histogram of the duration of a callback:
+    std::atomic<uint64_t> total;  //   (cf. can_pcan_histogram_t)
+    std::atomic<uint64_t> maximum;
+    std::atomic<uint64_t> bucket[PCAN_HISTOGRAM_BUCKETS];
+    SDispatch() : running(false), quit(false), starts(0U), max(CALLBACK_BATCH), count(0U), total(0U), maximum(0U) {
+        for (int i = 0; i < PCAN_HISTOGRAM_BUCKETS; i++)
+            bucket[i] = 0U;
+    }
+    void Record(std::chrono::steady_clock::time_point start) {
+        uint64_t sample = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - start).count();
+        int i = 0;
+        while ((i < (PCAN_HISTOGRAM_BUCKETS - 1)) && (sample >> (i + 1)))
+            i++;
+        bucket[i]++;
+        count++;
+        total += sample;
+        if (sample > maximum)  // note: only the dispatch thread records
+            maximum = sample;
+    }
+    void Copy(can_pcan_histogram_t &histogram) const {
+        histogram.count = count;
+        histogram.total = total;
+        histogram.max = maximum;
+        for (int i = 0; i < PCAN_HISTOGRAM_BUCKETS; i++)
+            histogram.bucket[i] = bucket[i];
+    }
+    void Clear() {
+        count = total = maximum = 0U;
+        for (int i = 0; i < PCAN_HISTOGRAM_BUCKETS; i++)
+            bucket[i] = 0U;
+    }
+};
+
 EXPORT
 CPeakCAN::CPeakCAN() {
     m_Handle = -1;
+    m_pDispatch = NULL;
 }
 
 EXPORT
 CPeakCAN::~CPeakCAN() {
     // set CAN contoller into INIT mode and close USB device
     (void)TeardownChannel();
+    StopDispatch();  // note: joins a thread stopped from a callback
+    delete m_pDispatch;
 }
 
 EXPORT
@@ -179,6 +239,25 @@ CANAPI_Return_t CPeakCAN::ProbeChannel(int32_t channel, const CANAPI_OpMode_t &o
     return ProbeChannel(channel, opMode, NULL, state);
 }
 
+EXPORT
+CANAPI_Return_t CPeakCAN::ProbeChannels(EChannelState states[], int count) {
+    // probe all channels of the interface list at once (the results are cached)
+    int8_t result[PCAN_BOARDS];
+    if (!states)
+        return CANERR_NULLPTR;
+    if (count <= 0)
+        return CANERR_ILLPARA;
+    for (int i = 0; i < PCAN_BOARDS; i++)
+        result[i] = (int8_t)CANBRD_NOT_TESTABLE;
+    CANAPI_Return_t rc = can_property((-1), CANPROP_GET_CHANNEL_STATES, (void*)result, sizeof(result));
+    if (CANERR_NOERROR == rc) {
+        // note: entries beyond the interface list are not testable
+        for (int i = 0; i < count; i++)
+            states[i] = (i < PCAN_BOARDS) ? (EChannelState)result[i] : CCanApi::ChannelNotTestable;
+    }
+    return rc;
+}
+
 EXPORT
 CANAPI_Return_t CPeakCAN::InitializeChannel(int32_t channel, const CANAPI_OpMode_t &opMode, const void *param) {
     // initialize the CAN interface
@@ -186,7 +265,11 @@ CANAPI_Return_t CPeakCAN::InitializeChannel(int32_t channel, const CANAPI_OpMode
     CANAPI_Handle_t hnd = can_init(channel, opMode.byte, param);
     if (0 <= hnd) {
         m_Handle = hnd;  // we got a handle
-        rc = CANERR_NOERROR;
+        rc = StartDispatch();  // note: if a callback is set
+        if (CANERR_NOERROR != rc) {
+            (void)can_exit(m_Handle);
+            m_Handle = -1;
+        }
     } else {
         rc = (CANAPI_Return_t)hnd;
     }
@@ -198,6 +281,7 @@ CANAPI_Return_t CPeakCAN::TeardownChannel() {
     // shutdown the CAN interface
     CANAPI_Return_t rc = CANERR_HANDLE;
     if (0 <= m_Handle) {  // note: -1 will close all!
+        StopDispatch();  // note: before the handle is gone
         rc = can_exit(m_Handle);
         if (CANERR_NOERROR == rc) {
             m_Handle = -1;  // invalidate the handle
@@ -219,7 +303,15 @@ CANAPI_Return_t CPeakCAN::SignalChannel() {
 EXPORT
 CANAPI_Return_t CPeakCAN::StartController(CANAPI_Bitrate_t bitrate) {
     // start the CAN controller with the given bit-rate settings
-    return can_start(m_Handle, &bitrate);
+    CANAPI_Return_t rc = can_start(m_Handle, &bitrate);
+    if ((CANERR_NOERROR == rc) && m_pDispatch) {
+        // wake up the dispatch thread and clear the histogram
+        std::lock_guard<std::mutex> lock(m_pDispatch->mutex);
+        m_pDispatch->starts++;
+        m_pDispatch->Clear();
+        m_pDispatch->cond.notify_all();
+    }
+    return rc;
 }
 
 EXPORT
@@ -278,6 +370,23 @@ CANAPI_Return_t CPeakCAN::GetProperty(uint16_t param, void *value, uint32_t nbyt
         }
         return rc;
     }
+    // histogram of the duration of a callback (answered by the C++ API)
+    if (CANPROP_GET_HISTOGRAM_CALLBACK == param) {
+        CANAPI_Return_t rc = CANERR_ILLPARA;
+        if (NULL == value) {
+            rc = CANERR_NULLPTR;
+        }
+        else if (0 > m_Handle) {
+            rc = CANERR_HANDLE;
+        }
+        else if ((size_t)nbyte >= sizeof(can_pcan_histogram_t)) {
+            memset(value, 0, sizeof(can_pcan_histogram_t));
+            if (m_pDispatch)
+                m_pDispatch->Copy(*(can_pcan_histogram_t*)value);
+            rc = CANERR_NOERROR;
+        }
+        return rc;
+    }
     // retrieve a property value of the CAN interface
     return can_property(m_Handle, param, value, nbyte);
 }
@@ -285,7 +394,10 @@ CANAPI_Return_t CPeakCAN::GetProperty(uint16_t param, void *value, uint32_t nbyt
 EXPORT
 CANAPI_Return_t CPeakCAN::SetProperty(uint16_t param, const void *value, uint32_t nbyte) {
     // modify a property value of the CAN interface
-    return can_property(m_Handle, param, (void*)value, nbyte);
+    CANAPI_Return_t rc = can_property(m_Handle, param, (void*)value, nbyte);
+    if ((CANERR_NOERROR == rc) && (CANPROP_SET_INSTRUMENTATION_RESET == param) && m_pDispatch)
+        m_pDispatch->Clear();  // note: the histogram of the callbacks too
+    return rc;
 }
 
 EXPORT
@@ -332,6 +444,261 @@ CANAPI_Return_t CPeakCAN::ResetFilters() {
     return can_property(m_Handle, CANPROP_SET_FILTER_RESET, NULL, 0U);
 }
 
+EXPORT
+CANAPI_Return_t CPeakCAN::WriteMessages(const CANAPI_Message_t *messages, size_t count, size_t &sent, uint16_t timeout) {
+    // transmit an array of messages over the CAN bus (back to back)
+    return can_write_multi(m_Handle, messages, count, &sent, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::ReadMessages(CANAPI_Message_t *messages, size_t max, size_t &count, uint16_t timeout) {
+    // read up to 'max' messages from the message queue of the CAN interface, if any
+    return can_read_multi(m_Handle, messages, max, &count, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::ReadMessage(CANAPI_Message_t &message, std::chrono::nanoseconds timeout) {
+    // read one message from the message queue of the CAN interface (time-out in nanoseconds)
+    uint64_t value = (timeout == std::chrono::nanoseconds::max()) ? CANWAIT_INFINITE_NS :
+                     (timeout.count() > 0) ? (uint64_t)timeout.count() : 0U;
+    return can_read_ns(m_Handle, &message, value);
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::ReadMessage(CANAPI_Message_t &message, CANAPI_Status_t &status, uint16_t timeout) {
+    // read one message from the message queue of the CAN interface, and the status register
+    return can_read_status(m_Handle, &message, &status.byte, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::GetReceiveHandle(int &fd) {
+    // retrieve the file descriptor of the receive event (see CANPROP_GET_RECEIVE_FD)
+    fd = -1;
+    return can_property(m_Handle, CANPROP_GET_RECEIVE_FD, (void*)&fd, sizeof(int));
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::AddFilter11Bit(uint32_t code, uint32_t mask) {
+    uint64_t filter = ((uint64_t)code << 32) | (uint64_t)mask;
+    // add an 11-bit code and mask to the software filter of the CAN interface
+    return can_property(m_Handle, CANPROP_SET_CODEMASK_11BIT, (void*)&filter, sizeof(uint64_t));
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::AddFilter29Bit(uint32_t code, uint32_t mask) {
+    uint64_t filter = ((uint64_t)code << 32) | (uint64_t)mask;
+    // add a 29-bit code and mask to the software filter of the CAN interface
+    return can_property(m_Handle, CANPROP_SET_CODEMASK_29BIT, (void*)&filter, sizeof(uint64_t));
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::AddFromTo11Bit(uint32_t from, uint32_t to) {
+    uint64_t range = ((uint64_t)from << 32) | (uint64_t)to;
+    // add an 11-bit identifier range to the software filter of the CAN interface
+    return can_property(m_Handle, CANPROP_SET_FROMTO_11BIT, (void*)&range, sizeof(uint64_t));
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::AddFromTo29Bit(uint32_t from, uint32_t to) {
+    uint64_t range = ((uint64_t)from << 32) | (uint64_t)to;
+    // add a 29-bit identifier range to the software filter of the CAN interface
+    return can_property(m_Handle, CANPROP_SET_FROMTO_29BIT, (void*)&range, sizeof(uint64_t));
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::WaitAny(CPeakCAN *const channels[], int count, uint32_t &ready, uint16_t timeout) {
+    // wait until at least one of the CAN interfaces is ready to be read
+    CANAPI_Handle_t handles[32];
+    ready = 0U;
+    if (!channels)
+        return CANERR_NULLPTR;
+    if ((count < 1) || (32 < count))
+        return CANERR_ILLPARA;
+    for (int i = 0; i < count; i++) {
+        if (!channels[i])
+            return CANERR_NULLPTR;
+        handles[i] = channels[i]->m_Handle;
+    }
+    // note: bit i of 'ready' is set if channels[i] is ready
+    return can_wait(handles, count, &ready, timeout);
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::SetReceiveCallback(ReceiveCallback callback) {
+    // deliver each received message with the status register to the callback
+    if (m_pDispatch && m_pDispatch->running && (std::this_thread::get_id() == m_pDispatch->thread.get_id()))
+        return CANERR_FATAL;  // note: not from a callback
+    if (!m_pDispatch && !(m_pDispatch = new(std::nothrow) SDispatch()))
+        return CANERR_RESOURCE;
+    StopDispatch();
+    m_pDispatch->receive = callback;
+    m_pDispatch->batch = nullptr;  // note: one way of delivery
+    return StartDispatch();
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::SetBatchCallback(BatchCallback callback, size_t max) {
+    // deliver the received messages to the callback, up to 'max' at once
+    if (max < 1U)
+        return CANERR_ILLPARA;
+    if (m_pDispatch && m_pDispatch->running && (std::this_thread::get_id() == m_pDispatch->thread.get_id()))
+        return CANERR_FATAL;  // note: not from a callback
+    if (!m_pDispatch && !(m_pDispatch = new(std::nothrow) SDispatch()))
+        return CANERR_RESOURCE;
+    StopDispatch();
+    m_pDispatch->batch = callback;
+    m_pDispatch->receive = nullptr;  // note: one way of delivery
+    m_pDispatch->max = max;
+    return StartDispatch();
+}
+
+EXPORT
+CANAPI_Return_t CPeakCAN::SetStatusCallback(StatusCallback callback) {
+    // notify changes of the bus off, the warning level and the overrun flags
+    if (m_pDispatch && m_pDispatch->running && (std::this_thread::get_id() == m_pDispatch->thread.get_id()))
+        return CANERR_FATAL;  // note: not from a callback
+    if (!m_pDispatch && !(m_pDispatch = new(std::nothrow) SDispatch()))
+        return CANERR_RESOURCE;
+    StopDispatch();
+    m_pDispatch->status = callback;
+    return StartDispatch();
+}
+
+CANAPI_Return_t CPeakCAN::StartDispatch() {
+    // start the dispatch thread (if a callback is set and the channel is open)
+    if (!m_pDispatch || m_pDispatch->running || (0 > m_Handle))
+        return CANERR_NOERROR;
+    if (!m_pDispatch->receive && !m_pDispatch->batch && !m_pDispatch->status)
+        return CANERR_NOERROR;
+    if (m_pDispatch->thread.joinable()) {
+        // note: stopped from a callback, the old thread is joined now
+        if (std::this_thread::get_id() == m_pDispatch->thread.get_id())
+            return CANERR_FATAL;  // note: not from a callback
+        m_pDispatch->thread.join();
+    }
+    m_pDispatch->quit = false;
+    try {
+        m_pDispatch->thread = std::thread(&CPeakCAN::Dispatch, this);
+    }
+    catch (...) {
+        return CANERR_RESOURCE;
+    }
+    m_pDispatch->running = true;
+    return CANERR_NOERROR;
+}
+
+void CPeakCAN::StopDispatch() {
+    // stop the dispatch thread (if running)
+    if (!m_pDispatch)
+        return;
+    if (m_pDispatch->running) {
+        {
+            std::lock_guard<std::mutex> lock(m_pDispatch->mutex);
+            m_pDispatch->quit = true;
+            m_pDispatch->cond.notify_all();
+        }
+        (void)can_kill(m_Handle);  // note: wakes up a blocking read
+        m_pDispatch->running = false;
+    }
+    // note: called from a callback, the thread quits after its return and
+    //       is joined when the dispatch is restarted or the object destroyed
+    if (m_pDispatch->thread.joinable() && (std::this_thread::get_id() != m_pDispatch->thread.get_id()))
+        m_pDispatch->thread.join();
+}
+
+void CPeakCAN::Dispatch() {
+    CANAPI_Message_t buffer[CALLBACK_BATCH];
+    CANAPI_Message_t *messages = buffer;
+    CANAPI_Status_t status, previous;
+    size_t max = m_pDispatch->batch ? m_pDispatch->max : CALLBACK_BATCH;
+    size_t count, n, i;
+    uint64_t starts;
+    uint8_t instrumented;
+    std::chrono::steady_clock::time_point start;
+    CANAPI_Return_t rc;
+
+    /* note: the callbacks are not changed while the dispatch thread is running
+     *       (it is stopped and restarted when a callback is set), they are
+     *       invoked one after the other from this thread only */
+    if ((max > CALLBACK_BATCH) && !(messages = new(std::nothrow) CANAPI_Message_t[max])) {
+        messages = buffer;
+        max = CALLBACK_BATCH;
+    }
+    previous.byte = CANSTAT_RESET;
+    (void)can_status(m_Handle, &previous.byte);  // note: once, then latched
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(m_pDispatch->mutex);
+            if (m_pDispatch->quit)
+                break;
+            starts = m_pDispatch->starts;
+        }
+        count = 0U;
+        status.byte = previous.byte;
+        if (m_pDispatch->receive || m_pDispatch->batch) {
+            // read the received messages (up to 'max' at once) and the status register
+            // note: the status register is the one latched by the read path (cf. can_read_status),
+            //       so the device is not queried per batch
+            rc = can_read_status(m_Handle, &messages[0], &status.byte, CALLBACK_TIMEOUT);
+            if (CANERR_NOERROR == rc) {
+                count = 1U;
+                if ((max > 1U) && (CANERR_NOERROR == can_read_multi(m_Handle, &messages[1], max - 1U, &n, 0U)))
+                    count += n;  // note: the rest without waiting
+            }
+            else if (CANERR_RX_EMPTY != rc) {
+                // note: not started or failed, wait for the next start (or time-out)
+                std::unique_lock<std::mutex> lock(m_pDispatch->mutex);
+                m_pDispatch->cond.wait_for(lock, std::chrono::milliseconds(CALLBACK_TIMEOUT), [&] {
+                    return m_pDispatch->quit || (starts != m_pDispatch->starts);
+                });
+                continue;
+            }
+        }
+        else {
+            // poll the status register only (the messages are left in the receive queue)
+            // note: with a status callback only, the application reads the messages itself
+            //       (e.g. by ReadMessage), so the receive queue must not be drained from here
+            {
+                std::unique_lock<std::mutex> lock(m_pDispatch->mutex);
+                if (m_pDispatch->cond.wait_for(lock, std::chrono::milliseconds(CALLBACK_POLLING), [&] {
+                    return m_pDispatch->quit;
+                }))
+                    break;
+            }
+            if (CANERR_NOERROR != can_status(m_Handle, &status.byte))
+                continue;
+        }
+        if (!count && !((status.byte ^ previous.byte) & CALLBACK_STATUS))
+            continue;
+        // invoke the callbacks (and measure their duration, if instrumented)
+        instrumented = 0U;
+        (void)can_property(m_Handle, CANPROP_GET_INSTRUMENTATION, (void*)&instrumented, sizeof(uint8_t));
+        if (count && m_pDispatch->batch) {
+            start = instrumented ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            m_pDispatch->batch(messages, count);
+            if (instrumented)
+                m_pDispatch->Record(start);
+        }
+        else if (count && m_pDispatch->receive) {
+            for (i = 0U; i < count; i++) {
+                start = instrumented ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+                m_pDispatch->receive(messages[i], status.byte);
+                if (instrumented)
+                    m_pDispatch->Record(start);
+            }
+        }
+        if (((status.byte ^ previous.byte) & CALLBACK_STATUS) && m_pDispatch->status) {
+            start = instrumented ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            m_pDispatch->status(status, (uint8_t)((status.byte ^ previous.byte) & CALLBACK_STATUS));
+            if (instrumented)
+                m_pDispatch->Record(start);
+        }
+        previous.byte = status.byte;
+    }
+    if (messages != buffer)
+        delete[] messages;
+}
+
 EXPORT
 char *CPeakCAN::GetHardwareVersion() {
     // retrieve the hardware version of the CAN controller
@@ -55,6 +55,9 @@
 #include "PeakCAN_Defaults.h"
 #include "CANAPI.h"
 
+#include <chrono>
+#include <functional>
+
 /// \name   PeakCAN
 /// \brief  PeakCAN dynamic library
 /// \{
@@ -74,6 +77,8 @@
 class CANCPP CPeakCAN : public CCanApi {
 private:
     CANAPI_Handle_t m_Handle;  ///< CAN interface handle
+    struct SDispatch;  ///< dispatch thread and callbacks (see SetReceiveCallback)
+    SDispatch *m_pDispatch;  ///< (created by the first callback)
 public:
     // constructor / destructor
     CPeakCAN();
@@ -97,12 +102,21 @@ public:
         Caution                = -289, ///< PCAN_ERROR_CAUTION: an operation was successfully carried out, however, irregularities were registered
         UnkownError            = -299  ///< PCAN_ERROR_UNKNOWN: unknown error
     };
+    // CPeakCAN-specific callbacks (invoked by a dispatch thread of the wrapper)
+    // note: with a receive or batch callback the dispatch thread reads the messages
+    //       of the channel, so that the channel should not be read otherwise; with a
+    //       status callback only, the messages are left to the application; a callback
+    //       must not set a callback (and should not block the delivery of further messages)
+    typedef std::function<void(const CANAPI_Message_t &message, uint8_t status)> ReceiveCallback;
+    typedef std::function<void(const CANAPI_Message_t *messages, size_t count)> BatchCallback;
+    typedef std::function<void(CANAPI_Status_t status, uint8_t changed)> StatusCallback;
     // CCanApi overrides
     static bool GetFirstChannel(SChannelInfo &info, void *param = NULL);
     static bool GetNextChannel(SChannelInfo &info, void *param = NULL);
 
     static CANAPI_Return_t ProbeChannel(int32_t channel, const CANAPI_OpMode_t &opMode, const void *param, EChannelState &state);
     static CANAPI_Return_t ProbeChannel(int32_t channel, const CANAPI_OpMode_t &opMode, EChannelState &state);
+    static CANAPI_Return_t ProbeChannels(EChannelState states[], int count);  // all channels at once
 
     CANAPI_Return_t InitializeChannel(int32_t channel, const CANAPI_OpMode_t &opMode, const void *param = NULL);
     CANAPI_Return_t TeardownChannel();
@@ -129,6 +143,21 @@ public:
     CANAPI_Return_t GetFilter29Bit(uint32_t &code, uint32_t &mask);
     CANAPI_Return_t ResetFilters();
 
+    // CPeakCAN-specific extensions
+    CANAPI_Return_t WriteMessages(const CANAPI_Message_t *messages, size_t count, size_t &sent, uint16_t timeout = 0U);
+    CANAPI_Return_t ReadMessages(CANAPI_Message_t *messages, size_t max, size_t &count, uint16_t timeout = CANWAIT_INFINITE);
+    CANAPI_Return_t ReadMessage(CANAPI_Message_t &message, std::chrono::nanoseconds timeout);
+    CANAPI_Return_t ReadMessage(CANAPI_Message_t &message, CANAPI_Status_t &status, uint16_t timeout = CANWAIT_INFINITE);
+    CANAPI_Return_t GetReceiveHandle(int &fd);
+    CANAPI_Return_t AddFilter11Bit(uint32_t code, uint32_t mask);
+    CANAPI_Return_t AddFilter29Bit(uint32_t code, uint32_t mask);
+    CANAPI_Return_t AddFromTo11Bit(uint32_t from, uint32_t to);
+    CANAPI_Return_t AddFromTo29Bit(uint32_t from, uint32_t to);
+    static CANAPI_Return_t WaitAny(CPeakCAN *const channels[], int count, uint32_t &ready, uint16_t timeout = CANWAIT_INFINITE);
+    CANAPI_Return_t SetReceiveCallback(ReceiveCallback callback);
+    CANAPI_Return_t SetBatchCallback(BatchCallback callback, size_t max = 64U);
+    CANAPI_Return_t SetStatusCallback(StatusCallback callback);
+
     char *GetHardwareVersion();  // (for compatibility reasons)
     char *GetFirmwareVersion();  // (for compatibility reasons)
     static char *GetVersion();  // (for compatibility reasons)
@@ -140,6 +169,9 @@ public:
 private:
     CANAPI_Return_t MapBitrate2Sja1000(CANAPI_Bitrate_t bitrate, uint16_t &btr0btr1);
     CANAPI_Return_t MapSja10002Bitrate(uint16_t btr0btr1, CANAPI_Bitrate_t &bitrate);
+    CANAPI_Return_t StartDispatch();
+    void StopDispatch();
+    void Dispatch();
 public:
     static uint8_t Dlc2Len(uint8_t dlc) { return CCanApi::Dlc2Len(dlc); }
     static uint8_t Len2Dlc(uint8_t len) { return CCanApi::Len2Dlc(len); }
@@ -172,12 +204,12 @@ public:
 #define PEAKCAN_PROPERTY_TX_COUNTER         (CANPROP_GET_TX_COUNTER)
 #define PEAKCAN_PROPERTY_RX_COUNTER         (CANPROP_GET_RX_COUNTER)
 #define PEAKCAN_PROPERTY_ERR_COUNTER        (CANPROP_GET_ERR_COUNTER)
-//#define PEAKCAN_PROPERTY_RCV_QUEUE_SIZE     (CANPROP_GET_RCV_QUEUE_SIZE)
-//#define PEAKCAN_PROPERTY_RCV_QUEUE_HIGH     (CANPROP_GET_RCV_QUEUE_HIGH)
-//#define PEAKCAN_PROPERTY_RCV_QUEUE_OVFL     (CANPROP_GET_RCV_QUEUE_OVFL)
+#define PEAKCAN_PROPERTY_RCV_QUEUE_SIZE     (CANPROP_GET_RCV_QUEUE_SIZE)
+#define PEAKCAN_PROPERTY_RCV_QUEUE_HIGH     (CANPROP_GET_RCV_QUEUE_HIGH)
+#define PEAKCAN_PROPERTY_RCV_QUEUE_OVFL     (CANPROP_GET_RCV_QUEUE_OVFL)
 //#define PEAKCAN_PROPERTY_TRM_QUEUE_SIZE     (CANPROP_GET_TRM_QUEUE_SIZE)
 //#define PEAKCAN_PROPERTY_TRM_QUEUE_HIGH     (CANPROP_GET_TRM_QUEUE_HIGH)
-//#define PEAKCAN_PROPERTY_TRM_QUEUE_OVFL     (CANPROP_GET_TRM_QUEUE_OVFL)
+#define PEAKCAN_PROPERTY_TRM_QUEUE_OVFL     (CANPROP_GET_TRM_QUEUE_OVFL)
 #define PEAKCAN_PROPERTY_DEVICE_ID          (CANPROP_GET_VENDOR_PROP + PCAN_DEVICE_ID)
 #define PEAKCAN_PROPERTY_API_VERSION        (CANPROP_GET_VENDOR_PROP + PCAN_API_VERSION)
 #define PEAKCAN_PROPERTY_CHANNEL_VERSION    (CANPROP_GET_VENDOR_PROP + PCAN_CHANNEL_VERSION)
@@ -185,5 +217,31 @@ public:
 #define PEAKCAN_PROPERTY_CONTROLLER_NUMBER  (CANPROP_GET_VENDOR_PROP + PCAN_CONTROLLER_NUMBER)
 //#define PEAKCAN_PROPERTY_SERIAL_NUMBER      (CANPROP_GET_VENDOR_PROP + PCAN_SERIAL_NUMBER)
 //#define PEAKCAN_PROPERTY_CLOCK_DOMAINS      (CANPROP_GET_VENDOR_PROP + PCAN_CLOCK_DOMAIND)
+#define PEAKCAN_PROPERTY_RECEIVE_FD         (CANPROP_GET_RECEIVE_FD)
+#define PEAKCAN_PROPERTY_SPIN_BUDGET        (CANPROP_GET_SPIN_BUDGET)
+#define PEAKCAN_PROPERTY_SET_SPIN_BUDGET    (CANPROP_SET_SPIN_BUDGET)
+#define PEAKCAN_PROPERTY_SPIN_COUNTER       (CANPROP_GET_SPIN_COUNTER)
+#define PEAKCAN_PROPERTY_BLOCK_COUNTER      (CANPROP_GET_BLOCK_COUNTER)
+#define PEAKCAN_PROPERTY_SET_RCV_QUEUE_SIZE (CANPROP_SET_RCV_QUEUE_SIZE)
+#define PEAKCAN_PROPERTY_BUSLOAD_WINDOW     (CANPROP_GET_BUSLOAD_WINDOW)
+#define PEAKCAN_PROPERTY_SET_BUSLOAD_WINDOW (CANPROP_SET_BUSLOAD_WINDOW)
+#define PEAKCAN_PROPERTY_SET_FROMTO_11BIT   (CANPROP_SET_FROMTO_11BIT)
+#define PEAKCAN_PROPERTY_SET_FROMTO_29BIT   (CANPROP_SET_FROMTO_29BIT)
+#define PEAKCAN_PROPERTY_SET_CODEMASK_11BIT (CANPROP_SET_CODEMASK_11BIT)
+#define PEAKCAN_PROPERTY_SET_CODEMASK_29BIT (CANPROP_SET_CODEMASK_29BIT)
+#define PEAKCAN_PROPERTY_CHANNEL_STATES     (CANPROP_GET_CHANNEL_STATES)
+#define PEAKCAN_PROPERTY_TIMESTAMP_MODE     (CANPROP_GET_TIMESTAMP_MODE)
+#define PEAKCAN_PROPERTY_SET_TIMESTAMP_MODE (CANPROP_SET_TIMESTAMP_MODE)
+#define PEAKCAN_PROPERTY_INSTRUMENTATION    (CANPROP_GET_INSTRUMENTATION)
+#define PEAKCAN_PROPERTY_SET_INSTRUMENTATION (CANPROP_SET_INSTRUMENTATION)
+#define PEAKCAN_PROPERTY_SET_INSTRUMENTATION_RESET (CANPROP_SET_INSTRUMENTATION_RESET)
+#define PEAKCAN_PROPERTY_HISTOGRAM_WAIT     (CANPROP_GET_HISTOGRAM_WAIT)
+#define PEAKCAN_PROPERTY_HISTOGRAM_READ     (CANPROP_GET_HISTOGRAM_READ)
+#define PEAKCAN_PROPERTY_HISTOGRAM_WRITE    (CANPROP_GET_HISTOGRAM_WRITE)
+#define PEAKCAN_PROPERTY_HISTOGRAM_AGE      (CANPROP_GET_HISTOGRAM_AGE)
+#define PEAKCAN_PROPERTY_MESSAGE_RATES      (CANPROP_GET_MESSAGE_RATES)
+#define PEAKCAN_PROPERTY_VBUS_PACING        (CANPROP_GET_VBUS_PACING)
+#define PEAKCAN_PROPERTY_SET_VBUS_PACING    (CANPROP_SET_VBUS_PACING)
+#define PEAKCAN_PROPERTY_HISTOGRAM_CALLBACK (CANPROP_GET_HISTOGRAM_CALLBACK)
 /// \}
 #endif // PEAKCAN_H_INCLUDED
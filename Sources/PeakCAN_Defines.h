@@ -77,6 +77,9 @@ extern "C" {
 /** @note  Set define OPTION_PCAN_BIT_TIMING to a non-zero value to compile
  *         with non CiA bit-timing (e.g. in the build environment).
  */
+/** @note  Set define OPTION_PCAN_VIRTUAL_BUS to zero to compile without
+ *         the virtual CAN bus over shared memory (Linux only).
+ */
 #ifndef OPTION_DISABLED
 #define OPTION_DISABLED  0  /**< if a define is not defined, it is automatically set to 0 */
 #endif
@@ -86,6 +89,11 @@ extern "C" {
 #ifndef OPTION_PCAN_BIT_TIMING
 #define OPTION_PCAN_BIT_TIMING OPTION_DISABLED
 #endif
+#if defined(__linux__) && !defined(OPTION_PCAN_VIRTUAL_BUS)
+#define OPTION_PCAN_VIRTUAL_BUS  1
+#elif !defined(OPTION_PCAN_VIRTUAL_BUS)
+#define OPTION_PCAN_VIRTUAL_BUS  OPTION_DISABLED
+#endif
 #if (OPTION_PCAN_BIT_TIMING != OPTION_DISABLED)
 #ifdef _MSC_VER
 #pragma message ( "Compilation with non CiA bit-timming!" )
@@ -117,7 +125,14 @@ extern "C" {
 #define PCAN_USB14             0x50EU   /**< PCAN-USB interface, channel 14 */
 #define PCAN_USB15             0x50FU   /**< PCAN-USB interface, channel 15 */
 #define PCAN_USB16             0x510U   /**< PCAN-USB interface, channel 16 */
+#define PCAN_VIRTUAL1          0xF01U   /**< PCAN-Virtual bus (shared memory), channel 1 */
+#define PCAN_VIRTUAL2          0xF02U   /**< PCAN-Virtual bus (shared memory), channel 2 */
+#define PCAN_VIRTUALS             2     /**< number of virtual CAN buses */
+#if (OPTION_PCAN_VIRTUAL_BUS != OPTION_DISABLED)
+#define PCAN_BOARDS              18     /**< number of PCAN interface boards (incl. virtual CAN buses) */
+#else
 #define PCAN_BOARDS              16     /**< number of PCAN interface boards */
+#endif
 
 #define PCAN_BOARD_TYPE(x)     ((((x) > 0x0FFU) ? (x) >> 8 : (x) >> 4) & 0xFU)
 /** @} */
@@ -159,6 +174,147 @@ extern "C" {
 #define PCAN_MAX_BUFFER_SIZE     256U   /**< max. buffer size for CAN_GetValue/CAN_SetValue */
 /** @} */
 
+/** @name  CAN API Property Value (driver-specific)
+ *  @brief Wrapper-specific properties (offset CANPROP_DRIVER_SPECIFIC)
+ *  @{ */
+/** @note  CANPROP_GET_RECEIVE_FD returns the file descriptor of the receive
+ *         event (int) of a started CAN channel, to register it in an external
+ *         event loop (select, poll, epoll, kqueue, libuv, asio, ...).
+ *         - The descriptor is owned by the library: it must not be read,
+ *           written or closed, and it becomes invalid when the CAN controller
+ *           is (re-)started, reset or the channel is torn down.
+ *         - Level-triggered (select, poll, epoll w/o EPOLLET): the descriptor
+ *           is readable while messages are pending. Call can_read() with
+ *           timeout 0 when it is reported as readable; CANERR_RX_EMPTY is
+ *           possible (spurious wake-up) and can be ignored.
+ *         - Edge-triggered (EPOLLET, EV_CLEAR): a notification is only given
+ *           when new messages arrive. After each notification the receive
+ *           queue must be drained with can_read(), timeout 0, until it
+ *           returns CANERR_RX_EMPTY, otherwise pending messages are stalled.
+ */
+#define CANPROP_GET_RECEIVE_FD   0x8000U  /**< file descriptor of the receive event (int) */
+/** @note  CANPROP_SET_SPIN_BUDGET sets the time in nanoseconds a blocking
+ *         can_read() busy-polls the receive queue before it blocks on the
+ *         receive event (0 = off, default). Spinning trades CPU time for
+ *         a lower wake-up latency; it is ended early by can_kill() or when
+ *         the time-out of the call expires. The counters tell how many
+ *         messages have been received while spinning and after blocking
+ *         (cleared when the CAN controller is started).
+ */
+#define CANPROP_GET_SPIN_BUDGET  0x8001U  /**< spin budget of a blocking read in [ns] (uint32_t) */
+#define CANPROP_SET_SPIN_BUDGET  0x8002U  /**< set spin budget of a blocking read in [ns] (uint32_t) */
+#define CANPROP_GET_SPIN_COUNTER 0x8003U  /**< number of messages received while spinning (uint64_t) */
+#define CANPROP_GET_BLOCK_COUNTER 0x8004U /**< number of messages received after blocking (uint64_t) */
+/** @note  CANPROP_SET_RCV_QUEUE_SIZE sets the size of a receive ring owned by
+ *         the wrapper (0 = off, default). When set, a reader thread drains
+ *         the PCAN receive queue into the ring while the CAN controller is
+ *         running, and can_read() takes the messages from the ring. The
+ *         size is rounded up to the next power of two (max. 1048576) and
+ *         can only be set while the CAN controller is stopped. The ring is
+ *         reported by CANPROP_GET_RCV_QUEUE_SIZE/HIGH/OVFL; when it is full,
+ *         new messages are dropped and counted as overflows.
+ */
+#define CANPROP_SET_RCV_QUEUE_SIZE 0x8005U /**< set size of the receive ring (uint32_t) */
+/** @note  The bus load (CANPROP_GET_BUSLOAD, can_busload) is computed from the
+ *         frames seen by the wrapper (received and transmitted) with their
+ *         exact bit lengths, including stuff bits, the data phase of CAN FD
+ *         frames at the data phase bit-rate and the interframe space. It is
+ *         measured over a sliding window, its length can be set between 16ms
+ *         and 60s (default 1s). Setting it restarts the measurement.
+ *         Frames that are not read from the receive queue are not counted,
+ *         unless a receive ring is set (CANPROP_SET_RCV_QUEUE_SIZE).
+ */
+#define CANPROP_GET_BUSLOAD_WINDOW 0x8006U /**< length of the bus load window in [ms] (uint32_t) */
+#define CANPROP_SET_BUSLOAD_WINDOW 0x8007U /**< set length of the bus load window in [ms] (uint32_t) */
+/** @note  CANPROP_SET_FROMTO_11BIT/29BIT (first identifier in the upper, last
+ *         identifier in the lower 32 bits) and CANPROP_SET_CODEMASK_11BIT/29BIT
+ *         (code in the upper, mask in the lower 32 bits) add an entry to the
+ *         software acceptance filter of the wrapper. Once an entry for 11-bit
+ *         resp. 29-bit identifiers has been added, only messages that match
+ *         one of the entries are received; the other format is not affected.
+ *         The software filter is applied behind the hardware filter, entries
+ *         can only be added while the CAN controller is stopped (up to 4096
+ *         entries for 29-bit identifiers). CANPROP_SET_FILTER_RESET clears it.
+ *
+ *         The acceptance filters for 11-bit and 29-bit identifiers (CANPROP_
+ *         SET_FILTER_11BIT/29BIT) can be active at the same time. The hardware
+ *         is set to the more selective one (more relevant bits in the mask),
+ *         the other one is enforced by the software filter.
+ *
+ *         The hardware filter is set to the tightest code and mask that accepts
+ *         all entries of the software filter (and the acceptance filter, if set)
+ *         so that most of the unwanted messages never cross the USB; the exact
+ *         matching is done by the software filter. CANPROP_GET_FILTER_11BIT/29BIT
+ *         returns the code and mask as set, not the one in the hardware.
+ */
+#define CANPROP_SET_CODEMASK_11BIT 0x8008U /**< add an 11-bit identifier code and mask to the software filter (uint64_t) */
+#define CANPROP_SET_CODEMASK_29BIT 0x8009U /**< add a 29-bit identifier code and mask to the software filter (uint64_t) */
+/** @note  CANPROP_GET_CHANNEL_STATES probes all channels of the interface list
+ *         at once (w/o a handle) and returns their states (int8_t: CANBRD_*)
+ *         in the order of the list. The channel conditions and capabilities
+ *         are cached for 500ms, can_test() and can_init() take them from there.
+ */
+#define CANPROP_GET_CHANNEL_STATES 0x800AU /**< probe all channels of the interface list (int8_t[]) */
+/** @note  CANPROP_SET_TIMESTAMP_MODE selects the time base of the time-stamps
+ *         of received messages (can only be set while the CAN controller is
+ *         stopped):
+ *         - PCAN_TIMESTAMP_DEVICE: time since start of the device (default)
+ *         - PCAN_TIMESTAMP_MONOTONIC: host time (CLOCK_MONOTONIC)
+ *         - PCAN_TIMESTAMP_REALTIME: host time (CLOCK_REALTIME)
+ *         In host time, the offset and the drift of the device clock are
+ *         estimated continuously by a linear regression of the minimum
+ *         offset of the arrival times of the last 16 windows of 250ms; the
+ *         estimate is best with a receive ring (CANPROP_SET_RCV_QUEUE_SIZE),
+ *         because the messages are fetched as soon as they arrive.
+ */
+#define CANPROP_GET_TIMESTAMP_MODE 0x800BU /**< time-stamp mode (uint8_t) */
+#define CANPROP_SET_TIMESTAMP_MODE 0x800CU /**< set time-stamp mode (uint8_t) */
+
+#define PCAN_TIMESTAMP_DEVICE      0U     /**< time-stamps from the device clock */
+#define PCAN_TIMESTAMP_MONOTONIC   1U     /**< time-stamps in host time (monotonic) */
+#define PCAN_TIMESTAMP_REALTIME    2U     /**< time-stamps in host time (real-time) */
+/** @note  CANPROP_SET_INSTRUMENTATION switches the instrumentation of a CAN
+ *         channel on or off (off by default; then it costs one branch per
+ *         call). When on, the wrapper records log2-bucketed histograms of
+ *         - the time a read has been blocked on the receive event (WAIT),
+ *         - the duration of the calls to CAN_Read[FD] (READ),
+ *         - the duration of the calls to CAN_Write[FD] (WRITE),
+ *         - the age of a data frame at its delivery, host time minus time-
+ *           stamp (AGE; only in host time, cf. CANPROP_SET_TIMESTAMP_MODE),
+ *         and the data frames and payload bytes received and transmitted
+ *         (MESSAGE_RATES; the rates are averages since the reset). All are
+ *         cleared when the CAN controller is started or by CANPROP_SET_
+ *         INSTRUMENTATION_RESET (NULL).
+ */
+#define CANPROP_GET_INSTRUMENTATION 0x800DU /**< instrumentation on/off (uint8_t) */
+#define CANPROP_SET_INSTRUMENTATION 0x800EU /**< set instrumentation on/off (uint8_t) */
+#define CANPROP_SET_INSTRUMENTATION_RESET 0x800FU /**< clear histograms and rates (NULL) */
+#define CANPROP_GET_HISTOGRAM_WAIT  0x8010U /**< histogram of the blocked time of a read (can_pcan_histogram_t) */
+#define CANPROP_GET_HISTOGRAM_READ  0x8011U /**< histogram of the duration of CAN_Read[FD] (can_pcan_histogram_t) */
+#define CANPROP_GET_HISTOGRAM_WRITE 0x8012U /**< histogram of the duration of CAN_Write[FD] (can_pcan_histogram_t) */
+#define CANPROP_GET_HISTOGRAM_AGE   0x8013U /**< histogram of the age of a frame at delivery (can_pcan_histogram_t) */
+#define CANPROP_GET_MESSAGE_RATES   0x8014U /**< frames and bytes received and transmitted (can_pcan_rates_t) */
+/** @note  The channels PCAN_VIRTUAL1 and PCAN_VIRTUAL2 are CAN buses in a
+ *         shared memory segment, which can be attached by several processes
+ *         (Linux only, cf. can_vbus.c). CANPROP_SET_VBUS_PACING switches the
+ *         bit-time pacing of the virtual CAN bus on or off (off by default):
+ *         when on, the frames are arbitrated by identifier and each frame
+ *         keeps the bus busy for its bit time. The setting applies to all
+ *         attachments of the bus (only for virtual channels).
+ */
+#define CANPROP_GET_VBUS_PACING     0x8015U /**< bit-time pacing of a virtual CAN bus on/off (uint8_t) */
+#define CANPROP_SET_VBUS_PACING     0x8016U /**< set bit-time pacing of a virtual CAN bus on/off (uint8_t) */
+/** @note  CANPROP_GET_HISTOGRAM_CALLBACK is answered by the C++ API only
+ *         (CPeakCAN::GetProperty). It returns the histogram of the duration
+ *         of the callbacks invoked by the dispatch thread of a channel (cf.
+ *         CPeakCAN::SetReceiveCallback), recorded while the instrumentation
+ *         is on. It is cleared together with the other histograms.
+ */
+#define CANPROP_GET_HISTOGRAM_CALLBACK 0x8017U /**< histogram of the duration of a callback (can_pcan_histogram_t) */
+
+#define PCAN_HISTOGRAM_BUCKETS     32     /**< buckets of a histogram (2^i to 2^(i+1)-1 nanoseconds) */
+/** @} */
+
 
 /** @name  CAN API Library ID
  *  @brief Library ID and dynamic library names
@@ -205,6 +361,29 @@ typedef struct can_pcan_param_t_ {      /* device parameters: */
 } can_pcan_param_t;
 #define _pcan_param  can_pcan_param_t_  /* for compatibility with CAN/COP API V1 */
 
+/** @brief PCAN histogram of durations (log2-bucketed)
+  */
+typedef struct can_pcan_histogram_t_ {  /* histogram: */
+    uint64_t count;                     /**<  number of samples */
+    uint64_t total;                     /**<  sum of the samples in [ns] */
+    uint64_t max;                       /**<  largest sample in [ns] */
+    uint64_t bucket[PCAN_HISTOGRAM_BUCKETS];  /**<  samples of 2^i to 2^(i+1)-1 [ns] (0 in the first, above 2^31 in the last) */
+} can_pcan_histogram_t;
+
+/** @brief PCAN message rates (since the reset)
+  */
+typedef struct can_pcan_rates_t_ {      /* message rates: */
+    uint64_t elapsed;                   /**<  time since the reset in [ns] */
+    uint64_t rx_frames;                 /**<  data frames received */
+    uint64_t rx_bytes;                  /**<  payload bytes received */
+    uint64_t tx_frames;                 /**<  data frames transmitted */
+    uint64_t tx_bytes;                  /**<  payload bytes transmitted */
+    uint32_t rx_fps;                    /**<  received frames per second */
+    uint32_t rx_bps;                    /**<  received bytes per second */
+    uint32_t tx_fps;                    /**<  transmitted frames per second */
+    uint32_t tx_bps;                    /**<  transmitted bytes per second */
+} can_pcan_rates_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,259 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later */
+/*
+ *  CAN Interface API, Version 3 (for PEAK-System PCAN Interfaces)
+ *
+ *  Copyright (c) 2005-2012 Uwe Vogt, UV Software, Friedrichshafen
+ *  Copyright (c) 2013-2025 Uwe Vogt, UV Software, Berlin (info@mac-can.com)
+ *  All rights reserved.
+ *
+ *  This file is part of PCBUSB-Wrapper.
+ *
+ *  PCBUSB-Wrapper is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v2.0 (or any later version). You can
+ *  choose between one of them if you use PCBUSB-Wrapper in whole or in part.
+ *
+ *  (1) BSD 2-Clause "Simplified" License
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  PCBUSB-Wrapper IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF PCBUSB-Wrapper, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  (2) GNU General Public License v2.0 or later
+ *
+ *  PCBUSB-Wrapper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PCBUSB-Wrapper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with PCBUSB-Wrapper; if not, see <https://www.gnu.org/licenses/>.
+ */
+/** @addtogroup  can_api
+ *  @{
+ */
+#ifndef CANAPI_PEAKCAN_EXTENSIONS_H_INCLUDED
+#define CANAPI_PEAKCAN_EXTENSIONS_H_INCLUDED
+
+/*  -----------  includes  ------------------------------------------------
+ */
+
+#include "can_api.h"                    /* CAN API V3 (generic) */
+#include "PeakCAN_Defines.h"            /* CAN API V3 (PCAN-specific defines) */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @name  Blocking Operations (nanoseconds)
+ *  @brief Control of blocking operations with nanosecond resolution
+ *  @{ */
+#define CANWAIT_INFINITE_NS     UINT64_MAX  /**< infinite time-out (blocking operation) */
+/** @} */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @note  The following functions are PCAN-specific extensions of CAN API V3
+ *         (e.g. batch transfer and multi-handle wait). In addition, functions
+ *         of the generic CAN API V3 (see can_api.h) behave as follows:
+ *         - can_kill(): on POSIX systems a blocking can_read() resp. can_wait()
+ *           in progress returns immediately: can_read() with CANERR_RX_EMPTY,
+ *           can_wait() with the signaled interface reported as ready, and
+ *           can_write() waiting for space in the transmit queue with
+ *           CANERR_TX_BUSY. A signal sent while no one is waiting has no effect
+ *           on a subsequent blocking call. The function takes no lock and can
+ *           be called from a signal handler.
+ *         - can_write(): if the transmit queue is full, the function waits for
+ *           space in the transmit queue until the time-out expires (the queue
+ *           is polled with an increasing interval of 50us up to 1ms), then it
+ *           returns CANERR_TX_BUSY.
+ *         - can_busload(): the bus-load is measured from the CAN frames received
+ *           and transmitted over a sliding window.
+ */
+
+/** @brief       transmits an array of messages over the CAN bus. All messages
+ *               are checked once against the operation mode before the first
+ *               one is sent, then they are submitted back to back. If the
+ *               transmitter gets busy, the number of messages sent so far is
+ *               returned, so that the caller can resume with the next one.
+ *               The CAN controller must be in operation state 'running'.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[in]   buffer  - pointer to an array of 'count' messages to send
+ *  @param[in]   count   - number of messages in the array
+ *  @param[out]  sent    - number of messages sent (also on error)
+ *  @param[in]   timeout - time to wait for the transmission of a message:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking write, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @note        The time-out applies to the whole call, i.e. the function waits
+ *               for space in the transmit queue until the time-out expires.
+ *
+ *  @returns     0 if all messages were sent, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal message in the array (none sent)
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TX_BUSY   - transmitter busy ('sent' messages sent)
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_write_multi(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout);
+
+
+/** @brief       read one message from the message queue of the CAN interface, if
+ *               any message was received. The time to wait for the reception of
+ *               a message is given in nanoseconds. The CAN controller must be in
+ *               operation state 'running'.
+ *
+ *  @note        The resolution of the time-out depends on the operating system,
+ *               e.g. it is rounded up to milliseconds on macOS.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  message - pointer to a message buffer
+ *  @param[in]   timeout - time to wait for the reception of a message:
+ *                              0 means the function returns immediately,
+ *                              CANWAIT_INFINITE_NS means blocking read, and
+ *                              any other value means the time to wait in
+ *                              nanoseconds
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      CANERR_QUE_OVR - receive queue overrun
+ *  @retval      CANERR_ERR_FRAME - error frame received
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read_ns(int handle, can_message_t *message, uint64_t timeout);
+
+
+/** @brief       read one message from the message queue of the CAN interface, if
+ *               any message was received, together with the status register of
+ *               the CAN interface. The CAN controller must be in operation state
+ *               'running'.
+ *
+ *  @note        The status register is latched by the read path (from status
+ *               frames and the receive queue flags) and not read from the device,
+ *               so a status-aware forwarder needs one call per message instead of
+ *               can_read() followed by can_status().
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  message - pointer to a message buffer
+ *  @param[out]  status  - 8-bit status register (after the read)
+ *  @param[in]   timeout - time to wait for the reception of a message:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     0 if successful, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read_status(int handle, can_message_t *message, uint8_t *status, uint16_t timeout);
+
+
+/** @brief       read up to 'max' messages from the message queue of the CAN
+ *               interface in one call. The message queue is drained until it
+ *               is empty or the buffer is full. The caller is blocked only as
+ *               long as no message has been received. The CAN controller must
+ *               be in operation state 'running'.
+ *
+ *  @param[in]   handle  - handle of the CAN interface
+ *  @param[out]  buffer  - pointer to an array of 'max' message buffers
+ *  @param[in]   max     - capacity of the message buffer (at least 1)
+ *  @param[out]  count   - number of messages read into the buffer
+ *  @param[in]   timeout - time to wait for the reception of the first message:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking read, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     0 if at least one message was read, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - buffer capacity is zero
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_RX_EMPTY  - message queue empty
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_read_multi(int handle, can_message_t *buffer, size_t max, size_t *count, uint16_t timeout);
+
+
+/** @brief       waits until at least one of the given CAN interfaces has received
+ *               a message, or until the timeout expires. A single thread can so
+ *               service several CAN interfaces without polling. The CAN
+ *               controllers must be in operation state 'running'.
+ *
+ *  @note        The wait is level-triggered: a CAN interface is reported as ready
+ *               as long as its receive event is signaled. It is a hint only, the
+ *               subsequent can_read() can nevertheless return CANERR_RX_EMPTY.
+ *               A CAN interface signaled by can_kill() is also reported as ready.
+ *
+ *  @param[in]   handles    - array of handles of the CAN interfaces
+ *  @param[in]   n          - number of handles in the array (1 .. 32)
+ *  @param[out]  ready_mask - bit i is set if handles[i] is ready to be read
+ *  @param[in]   timeout    - time to wait for the reception of a message:
+ *                              0 means the function returns immediately,
+ *                              65535 means blocking wait, and any other
+ *                              value means the time to wait in milliseconds
+ *
+ *  @returns     0 if at least one CAN interface is ready, or a negative value on error.
+ *
+ *  @retval      CANERR_NOTINIT   - library not initialized
+ *  @retval      CANERR_HANDLE    - invalid interface handle
+ *  @retval      CANERR_NULLPTR   - null-pointer assignment
+ *  @retval      CANERR_ILLPARA   - illegal number of handles
+ *  @retval      CANERR_OFFLINE   - interface not started
+ *  @retval      CANERR_TIMEOUT   - no interface ready within the given time
+ *  @retval      others           - vendor-specific
+ */
+CANAPI int can_wait(const int *handles, int n, uint32_t *ready_mask, uint16_t timeout);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CANAPI_PEAKCAN_EXTENSIONS_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de, Homepage: https://www.uv-software.de/
+ */
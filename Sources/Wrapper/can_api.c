@@ -59,6 +59,9 @@
 #endif
 #if defined(__linux__)
 #define PLATFORM  "Linux"
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE                     // for ppoll()
+#endif
 #elif defined(__APPLE__)
 #define PLATFORM  "macOS"
 #else
@@ -69,6 +72,7 @@
  */
 #include "can_defs.h"
 #include "can_api.h"
+#include "PeakCAN_Extensions.h"
 #include "can_btr.h"
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -76,15 +80,26 @@
 #include "PCANBasic.h"
 #else
 #include <unistd.h>
-#include <sys/select.h>
+#include <pthread.h>
+#include <poll.h>
+#include <time.h>
 #if defined(__APPLE__)
+#include <fcntl.h>
 #include "PCBUSB.h"
 #else
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include "PCANBasic.h"
+#if (OPTION_PCAN_VIRTUAL_BUS != 0)
+#include "can_vbus.h"
+#endif
 #endif
 #endif
+#include "can_util.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #include <assert.h>
 
 /*  -----------  options  ------------------------------------------------
@@ -105,6 +120,10 @@ static void _finalizer() {
 #else
 #define EXPORT
 #endif
+#define FAST_PATH  static inline __attribute__((always_inline))
+#ifndef OPTION_PCAN_GENERIC_PATH
+#define OPTION_PCAN_GENERIC_PATH  0     // 1 = one path for both operation modes (to benchmark the fast paths)
+#endif
 #if defined(__APPLE__)
 #define ISSUE_303_WORKAROUND    // PCBUSB issue #303: first transmit message will be swallowed
 /*#define ISSUE_276_UNSOLVED    // PCBUSB issue #276: parameter PCAN_RECEIVE_STATUS solved by v0.13 */
@@ -113,12 +132,45 @@ static void _finalizer() {
 /*  -----------  defines  ------------------------------------------------
  */
 #ifndef CAN_MAX_HANDLES
-#define CAN_MAX_HANDLES         (16)    // maximum number of open handles
+#define CAN_MAX_HANDLES         (1024)  // maximum number of open handles
+#endif
+#if (CAN_MAX_HANDLES > 0x8000)
+#error Maximum number of open handles out of range!
 #endif
+#define HANDLE_CHUNK            (16)    // handle slots allocated at once
+#define HANDLE_CHUNKS           ((CAN_MAX_HANDLES + HANDLE_CHUNK - 1) / HANDLE_CHUNK)
+#define HANDLE_INDEX_BITS       (16)    // handle: generation (15 bits) and slot index (16 bits)
+#define HANDLE_INDEX_MASK       (0xFFFFU)
+#define HANDLE_GENERATION_MASK  (0x7FFFU)
+#define HANDLE_INDEX(hnd)       (int)((uint32_t)(hnd) & HANDLE_INDEX_MASK)
+#define HANDLE_GENERATION(hnd)  (unsigned int)((uint32_t)(hnd) >> HANDLE_INDEX_BITS)
+#define HANDLE_MAKE(idx)        (int)(((uint32_t)SLOT(idx)->generation << HANDLE_INDEX_BITS) | (uint32_t)(idx))
+#define SLOT(idx)               (&can_table[(unsigned int)(idx) / HANDLE_CHUNK][(unsigned int)(idx) % HANDLE_CHUNK])
 #define INVALID_HANDLE          (-1)
-#define IS_HANDLE_VALID(hnd)    ((0 <= (hnd)) && ((hnd) < CAN_MAX_HANDLES))
-#define IS_HANDLE_OPENED(hnd)   (can[(hnd)].board != PCAN_NONEBUS)
+#define IS_HANDLE_VALID(idx)    ((0 <= (idx)) && ((idx) < __atomic_load_n(&can_capacity, __ATOMIC_ACQUIRE)))
+#define IS_HANDLE_OPENED(idx)   (SLOT(idx)->can.board != PCAN_NONEBUS)
 #define IS_CHANNEL_VALID(ch)    ((0 <= (ch)) && ((ch) <= 0xFFFF))
+#define LOCK_TABLE()            (void)pthread_mutex_lock(&table_lock)
+#define UNLOCK_TABLE()          (void)pthread_mutex_unlock(&table_lock)
+#define LOCK_SHARED(hnd)        (void)pthread_rwlock_rdlock(&SLOT(hnd)->lock.state)
+#define LOCK_EXCLUSIVE(hnd)     (void)pthread_rwlock_wrlock(&SLOT(hnd)->lock.state)
+#define UNLOCK(hnd)             (void)pthread_rwlock_unlock(&SLOT(hnd)->lock.state)
+#define LOCK_READER(hnd)        (void)pthread_mutex_lock(&SLOT(hnd)->lock.reader)
+#define UNLOCK_READER(hnd)      (void)pthread_mutex_unlock(&SLOT(hnd)->lock.reader)
+#define LOCK_WRITER(hnd)        (void)pthread_mutex_lock(&SLOT(hnd)->lock.writer)
+#define UNLOCK_WRITER(hnd)      (void)pthread_mutex_unlock(&SLOT(hnd)->lock.writer)
+#define LOCK_SHARE(shr)         (void)pthread_mutex_lock(&(shr)->lock)
+#define UNLOCK_SHARE(shr)       (void)pthread_mutex_unlock(&(shr)->lock)
+#define LOCK_BUSLOAD(hnd)       (void)pthread_mutex_lock(&SLOT(hnd)->lock.busload)
+#define UNLOCK_BUSLOAD(hnd)     (void)pthread_mutex_unlock(&SLOT(hnd)->lock.busload)
+#define SET_STATUS(hnd,bits)    (void)__atomic_fetch_or(&SLOT(hnd)->can.status.byte, (uint8_t)(bits), __ATOMIC_RELAXED)
+#define CLR_STATUS(hnd,bits)    (void)__atomic_fetch_and(&SLOT(hnd)->can.status.byte, (uint8_t)~(bits), __ATOMIC_RELAXED)
+#define PUT_STATUS(hnd,bits,on) do { if (on) SET_STATUS(hnd,bits); else CLR_STATUS(hnd,bits); } while (0)
+#define GET_STATUS(hnd)         __atomic_load_n(&SLOT(hnd)->can.status.byte, __ATOMIC_RELAXED)
+#define GET_SIGNAL(hnd)         __atomic_load_n(&SLOT(hnd)->signal.count, __ATOMIC_ACQUIRE)
+#define RX_EVENT(hnd)           (SLOT(hnd)->ring.running ? SLOT(hnd)->ring.event[0] : SLOT(hnd)->can.fdes)
+#define INSTRUMENTED(hnd)       __atomic_load_n(&SLOT(hnd)->can.instrument.enabled, __ATOMIC_RELAXED)
+#define RATE_PER_SECOND(n,ns)   (uint32_t)(((ns) != 0U) ? (((double)(n) * 1.0E9) / (double)(ns)) : 0.0)
 #ifndef DLC2LEN
 #define DLC2LEN(x)              dlc_table[((x) < 16) ? (x) : 15]
 #endif
@@ -144,6 +196,32 @@ static void _finalizer() {
 #define FILTER_STD_VALID_MASK   (uint64_t)(0x000007FF000007FF)
 #define FILTER_XTD_VALID_MASK   (uint64_t)(0x1FFFFFFF1FFFFFFF)
 #define FILTER_RESET_VALUE      (uint64_t)(0x0000000000000000)
+#define WAIT_MAX_HANDLES        (32)    // maximum number of handles to wait for
+#define RING_MAX_SIZE           (0x100000U)  // maximum size of the receive ring
+#define TX_BACKOFF_MIN          (50000U)     // 50us: first wait when the transmit queue is full
+#define TX_BACKOFF_MAX          (1000000U)   // 1ms: maximum wait when the transmit queue is full
+#define CACHE_LINE              (64)    // to avoid false sharing
+#define PROBE_CACHE_TTL         (500000000U) // 500ms: results of a channel probe are reused
+#define SHARE_MAX_HANDLES       (32)    // maximum number of handles of a shared channel
+#define SHARE_RING_SIZE         (4096U) // default size of the receive ring of a shared handle
+#define SHARE_MODE_MASK         (CANMODE_FDOE | CANMODE_BRSE | CANMODE_NISO | CANMODE_MON)
+#define ACCEPT_STD_WORDS        ((CAN_MAX_STD_ID + 1) / 32)  // 11-bit bitmap (2048 bits)
+#define ACCEPT_XTD_MAX          (4096U) // maximum number of 29-bit filter entries
+#define BUSLOAD_SLOTS           (16)    // number of slots of the sliding window
+#define BUSLOAD_WINDOW          (1000U) // default length of the sliding window [ms]
+#define BUSLOAD_WINDOW_MIN      (16U)   // minimum length of the sliding window [ms]
+#define BUSLOAD_WINDOW_MAX      (60000U)  // maximum length of the sliding window [ms]
+#define CLOCK_WINDOW            (250000000U) // 250ms: device time per regression point
+#define CLOCK_POINTS            (16)    // number of regression points (window minima)
+#define CLOCK_SKEW_MAX          (0.001) // 1000ppm: maximum drift of the device clock
+#if defined(__x86_64__) || defined(__i386__)
+#define SPIN_PAUSE()            __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define SPIN_PAUSE()            __asm__ __volatile__("yield")
+#else
+#define SPIN_PAUSE()            (void)0
+#endif
+#define TIMEOUT_NS(ms)          (((ms) != CANWAIT_INFINITE) ? (uint64_t)(ms) * 1000000U : CANWAIT_INFINITE_NS)
 #ifndef SYSERR_OFFSET
 #define SYSERR_OFFSET           (-10000)
 #endif
@@ -152,6 +230,26 @@ static void _finalizer() {
 #define DEV_VENDOR              PCAN_LIB_VENDOR
 #define DEV_DLLNAME             PCAN_LIB_BASIC
 #define NUM_CHANNELS            PCAN_BOARDS
+#if (OPTION_PCAN_VIRTUAL_BUS != 0)
+/* note: the calls for a virtual channel are served by the virtual CAN bus,
+ *       all other calls are passed to the PCANBasic library (w/o recursion)
+ */
+#define CAN_Initialize(ch,btr,type,port,irq)  (VBUS_CHANNEL(ch) ? VBUS_Initialize(ch,btr,type,port,irq) \
+                                                                : (CAN_Initialize)(ch,btr,type,port,irq))
+#define CAN_InitializeFD(ch,btr)  (VBUS_CHANNEL(ch) ? VBUS_InitializeFD(ch,btr) : (CAN_InitializeFD)(ch,btr))
+#define CAN_Uninitialize(ch)      (VBUS_CHANNEL(ch) ? VBUS_Uninitialize(ch) : (CAN_Uninitialize)(ch))
+#define CAN_Reset(ch)             (VBUS_CHANNEL(ch) ? VBUS_Reset(ch) : (CAN_Reset)(ch))
+#define CAN_GetStatus(ch)         (VBUS_CHANNEL(ch) ? VBUS_GetStatus(ch) : (CAN_GetStatus)(ch))
+#define CAN_Read(ch,msg,ts)       (VBUS_CHANNEL(ch) ? VBUS_Read(ch,msg,ts) : (CAN_Read)(ch,msg,ts))
+#define CAN_ReadFD(ch,msg,ts)     (VBUS_CHANNEL(ch) ? VBUS_ReadFD(ch,msg,ts) : (CAN_ReadFD)(ch,msg,ts))
+#define CAN_Write(ch,msg)         (VBUS_CHANNEL(ch) ? VBUS_Write(ch,msg) : (CAN_Write)(ch,msg))
+#define CAN_WriteFD(ch,msg)       (VBUS_CHANNEL(ch) ? VBUS_WriteFD(ch,msg) : (CAN_WriteFD)(ch,msg))
+#define CAN_GetValue(ch,par,buf,len)  (VBUS_CHANNEL(ch) ? VBUS_GetValue(ch,par,buf,len) : (CAN_GetValue)(ch,par,buf,len))
+#define CAN_SetValue(ch,par,buf,len)  (VBUS_CHANNEL(ch) ? VBUS_SetValue(ch,par,buf,len) : (CAN_SetValue)(ch,par,buf,len))
+#define IS_VIRTUAL(board)         VBUS_CHANNEL(board)
+#else
+#define IS_VIRTUAL(board)         (0)
+#endif
 
 /*  -----------  types  --------------------------------------------------
  */
@@ -162,22 +260,130 @@ typedef enum {                          // filtering mode:
 }   filtering_t;
 
 typedef struct {                        // message filtering:
-    filtering_t mode;                   //   filtering mode
-    uint64_t mask;                      //   acceptance mask
+    filtering_t mode;                   //   filtering mode (of the hardware)
+    uint64_t mask;                      //   acceptance mask (of the hardware)
+    uint64_t std;                       //   11-bit code and mask (as set)
+    uint64_t xtd;                       //   29-bit code and mask (as set)
 }   can_filter_t;
 
+typedef struct {                        // 29-bit identifier range:
+    uint32_t from;                      //   first identifier
+    uint32_t to;                        //   last identifier
+}   can_range_t;
+
+typedef struct {                        // software acceptance filter:
+    int std;                            //   11-bit identifiers filtered
+    int xtd;                            //   29-bit identifiers filtered
+    uint32_t bitmap[ACCEPT_STD_WORDS];  //   accepted 11-bit identifiers (one bit each)
+    can_range_t *ranges;                //   accepted 29-bit ranges (sorted, disjoint)
+    uint32_t count;                     //   number of 29-bit ranges
+    uint64_t *masks;                    //   29-bit code and mask (no range)
+    uint32_t masked;                    //   number of 29-bit code and mask
+}   can_accept_t;
+
 typedef struct {                        // frame counters:
     uint64_t tx;                        //   number of transmitted CAN frames
     uint64_t rx;                        //   number of received CAN frames
     uint64_t err;                       //   number of receiced error frames
 }   can_counter_t;
 
+typedef struct {                        // counter deltas (of a read resp. a drain):
+    uint64_t rx;                        //   number of received CAN frames
+    uint64_t err;                       //   number of receiced error frames
+    uint64_t busy;                      //   bus time of the CAN frames [ps]
+}   can_delta_t;
+
+typedef struct {                        // receive mode:
+    uint32_t spin;                      //   spin budget of a blocking read [ns]
+    uint64_t spun;                      //   messages received while spinning
+    uint64_t blocked;                   //   messages received after blocking
+}   can_receive_t;
+
+typedef struct {                        // transmit queue:
+    uint64_t ovfl;                      //   messages rejected (queue full)
+}   can_transmit_t;
+
+typedef struct {                        // bus load (sliding window):
+    uint32_t window;                    //   length of the window [ms]
+    uint32_t nominal;                   //   nominal bit time [ps] (0 = unknown)
+    uint32_t data;                      //   data phase bit time [ps]
+    uint64_t slot;                      //   length of a slot [ns]
+    uint64_t origin;                    //   start of the measurement [ns]
+    uint64_t start;                     //   start of the current slot [ns]
+    uint32_t index;                     //   index of the current slot
+    uint64_t busy[BUSLOAD_SLOTS];       //   bus time of the frames per slot [ps]
+}   can_busload_t;
+
+typedef struct {                        // host-correlated time-stamps:
+    uint8_t mode;                       //   time-stamp mode (PCAN_TIMESTAMP_*)
+    int started;                        //   first sample taken
+    uint64_t start;                     //   device time of the current window [ns]
+    uint64_t device;                    //   device time of the minimum offset [ns]
+    int64_t offset;                     //   minimum offset (host - device) in the window [ns]
+    uint64_t x[CLOCK_POINTS];           //   regression points: device time [ns]
+    int64_t y[CLOCK_POINTS];            //   regression points: offset [ns]
+    uint32_t count;                     //   number of regression points
+    uint32_t index;                     //   next regression point
+    uint64_t origin;                    //   device time of the estimate [ns]
+    int64_t intercept;                  //   offset at the origin [ns]
+    double skew;                        //   drift of the offset [ns/ns]
+}   can_clock_t;
+
 typedef struct {                        // error code capture:
     uint8_t lec;                        //   last error code
     uint8_t rx_err;                     //   receive error counter
     uint8_t tx_err;                     //   transmit error counter
 }   can_error_t;
 
+typedef union {                         // PCAN message (as read):
+    struct {                            //   CAN 2.0 message
+        TPCANMsg msg;                   //     the message
+        TPCANTimestamp timestamp;       //     time stamp
+    }   std;
+    struct {                            //   CAN FD message
+        TPCANMsgFD msg;                 //     the message
+        TPCANTimestampFD timestamp;     //     time stamp
+    }   fd;
+}   pcan_message_t;
+
+typedef struct {                        // fast path (selected by the operation mode):
+    int (*read)(int handle, can_message_t *buffer, size_t max, size_t *count, uint64_t timeout);
+    int (*write)(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout);
+    int (*drain)(int handle, can_delta_t *counters);
+    BYTE refuse;                        //   refused message types (nxtd, nrtr)
+    BYTE brs;                           //   bit-rate switching (brse)
+}   can_path_t;
+
+typedef struct {                        // instrumentation (optional):
+    int enabled;                        //   instrumentation on/off
+    uint64_t since;                     //   time of the last reset [ns]
+    can_pcan_histogram_t wait;          //   time blocked on the receive event
+    can_pcan_histogram_t read;          //   duration of CAN_Read[FD]
+    can_pcan_histogram_t write;         //   duration of CAN_Write[FD]
+    can_pcan_histogram_t age;           //   age of a frame at delivery
+    uint64_t rx_frames;                 //   data frames received
+    uint64_t rx_bytes;                  //   payload bytes received
+    uint64_t tx_frames;                 //   data frames transmitted
+    uint64_t tx_bytes;                  //   payload bytes transmitted
+}   can_instrument_t;
+
+typedef struct {                        // shared channel (CANMODE_SHRD):
+    TPCANHandle board;                  //   board hardware channel handle
+    uint8_t mode;                       //   operation mode of the device
+    int users;                          //   number of open handles
+    int started;                        //   number of started handles
+    int member[SHARE_MAX_HANDLES];      //   started handles (fan-out list)
+    int fdes;                           //   file descriptor for blocking read
+    uint16_t btr0btr1;                  //   bit-rate of the device (CAN 2.0)
+    char bitrate[PCAN_MAX_BUFFER_SIZE]; //   bit-rate of the device (CAN FD)
+    int running;                        //   reader thread running
+    int quit[2];                        //   quit signal for the reader thread
+    pthread_t thread;                   //   reader thread (fans out to all members)
+    pthread_mutex_t lock;               //   serializes start and stop of the members
+    pthread_mutex_t fanout;             //   protects the fan-out list
+    pthread_mutex_t writer;             //   merges the writers of all members
+}   can_share_t;
+
 typedef struct {                        // PCAN interface:
     TPCANHandle board;                  //   board hardware channel handle
     BYTE  brd_type;                     //   board type (none PnP hardware)
@@ -189,36 +395,190 @@ typedef struct {                        // PCAN interface:
     int   fdes;                         //   file descriptor for blocking read
 #endif
     can_mode_t mode;                    //   operation mode of the CAN channel
+    can_path_t path;                    //   fast path of the operation mode
     can_filter_t filter;                //   message filtering settings
+    can_accept_t accept;                //   software acceptance filter
     can_status_t status;                //   8-bit status register
     can_error_t error;                  //   error code capture
     can_counter_t counters;             //   statistical counters
+    can_receive_t receive;              //   receive mode (spin-then-block)
+    can_transmit_t transmit;            //   transmit queue statistics
+    can_busload_t busload;              //   bus load measurement
+    can_clock_t clock;                  //   host-correlated time-stamps
+    can_instrument_t instrument;        //   instrumentation (optional)
+    can_share_t *share;                 //   shared channel (or NULL)
 }   can_interface_t;
 
+typedef struct {                        // handle locks:
+    pthread_rwlock_t state;             //   shared for I/O, exclusive for state changes
+    pthread_mutex_t reader;             //   serializes the readers of a handle
+    pthread_mutex_t writer;             //   serializes the writers of a handle
+    pthread_mutex_t busload;            //   protects the bus load window
+}   can_lock_t;
+
+typedef struct {                        // wake-up signal (per handle):
+    int fdes[2];                        //   read and write end (eventfd: same)
+    unsigned int count;                 //   number of signals sent so far
+}   can_signal_t;
+
+typedef struct {                        // receive ring (single producer, single consumer):
+    can_message_t *buffer;              //   ring buffer (size messages)
+    uint32_t size;                      //   number of messages (power of two, 0 = off)
+    uint32_t high;                      //   high-water mark
+    uint64_t ovfl;                      //   overflow counter
+    int error;                          //   error of the reader thread
+    int running;                        //   reader thread running
+    int event[2];                       //   receive event (eventfd: same)
+    int quit[2];                        //   quit signal for the reader thread
+    pthread_t thread;                   //   reader thread
+    uint32_t head __attribute__((aligned(CACHE_LINE)));  // write index (reader thread)
+    uint32_t tail __attribute__((aligned(CACHE_LINE)));  // read index (reading caller)
+}   can_ring_t;
+
+typedef struct {                        // channel probe (cached):
+    DWORD condition;                    //   channel condition
+    can_mode_t capa;                    //   operation capability
+    int valid;                          //   operation capability known
+    uint64_t time;                      //   time of the probe [ns] (0 = none)
+}   can_probe_t;
+
+typedef struct {                        // handle slot:
+    can_interface_t can;                //   PCAN interface
+    can_lock_t lock;                    //   handle locks
+    can_signal_t signal;                //   wake-up signal
+    can_ring_t ring;                    //   receive ring
+    unsigned int generation;            //   generation (to detect stale handles)
+    int next;                           //   next unused slot (free list)
+}   can_slot_t;
+
+#if defined(__linux__)
+typedef struct {                        // epoll set (per thread):
+    int epfd;                           //   epoll file descriptor
+    int n;                              //   number of registered handles
+    int fdes[WAIT_MAX_HANDLES];         //   registered file descriptors
+    int sigs[WAIT_MAX_HANDLES];         //   registered wake-up signals
+    unsigned int generation;            //   generation of the handle table
+}   can_wait_set_t;
+#endif
+
 /*  -----------  prototypes  ---------------------------------------------
  */
 static void var_init(void);             // initialize all variables
 static int all_closed(void);            // check if all handles closed
 
+static int handle_index(int handle);    // slot index of a handle (or INVALID_HANDLE)
+static int handle_free(void);           // unused slot (grows the handle table)
+static void handle_reset(int index);    // reset the interface of a slot
+
+static int test_channel(int32_t board, uint8_t mode, int *result);
+static int probe_channels(int8_t *states, size_t n);
+static void *probe_thread(void *arg);   // probe a single channel
+static void probe_query(int index);     // query a channel of the interface list
+static const can_probe_t *probe_cached(int32_t board);
+static void probe_invalidate(int32_t board);
+static int init_channel(int32_t board, uint8_t mode, const void *param);
 static int exit_channel(int handle);    // teardown a single channel
 static int kill_channel(int handle);    // signal a single channel
+static int start_channel(int handle, const can_bitrate_t *bitrate);
+static int reset_channel(int handle);   // stop a single channel
+
+static int get_status(int handle, uint8_t *status);
+static int get_busload(int handle, uint16_t *load, uint8_t *status);
+static int get_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed);
+static char *get_hardware(int handle);
+static char *get_firmware(int handle);
+
+static int check_message(int handle, const can_message_t *msg);
+#if (OPTION_PCAN_GENERIC_PATH == 0)
+static int write_messages_std(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout);
+static int write_messages_fd(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout);
+#else
+static int write_messages_any(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout);
+#endif
+static int write_wait(int handle, unsigned int generation, unsigned int signals, uint64_t deadline, uint64_t *backoff);
+static int read_message(int handle, can_message_t *msg, uint8_t *status, uint64_t timeout);
+#if (OPTION_PCAN_GENERIC_PATH == 0)
+static int read_messages_std(int handle, can_message_t *buffer, size_t max, size_t *count, uint64_t timeout);
+static int read_messages_fd(int handle, can_message_t *buffer, size_t max, size_t *count, uint64_t timeout);
+#else
+static int read_messages_any(int handle, can_message_t *buffer, size_t max, size_t *count, uint64_t timeout);
+#endif
+static void path_select(int handle);    // select the fast path of the operation mode
+static int wait_events(const int *fdes, const int *sigs, int n, uint32_t *ready, uint32_t *signaled, uint16_t timeout);
+
+static int signal_open(int handle);     // create the wake-up signal
+static void signal_send(int handle);    // wake up blocked readers
+
+static int event_open(int fdes[2]);     // create an event (eventfd or self-pipe)
+static void event_send(int fd);         // signal an event
+static void event_clear(int fd);        // reset an event
+
+static int ring_open(int handle);       // allocate and clear the receive ring
+static int ring_start(int handle);      // start the reader thread
+static void ring_stop(int handle);      // stop the reader thread
+static size_t ring_read(int handle, can_message_t *buffer, size_t max);
+static void *ring_reader(void *arg);    // reader thread
+#if (OPTION_PCAN_GENERIC_PATH == 0)
+static int ring_drain_std(int handle, can_delta_t *counters);
+static int ring_drain_fd(int handle, can_delta_t *counters);
+#else
+static int ring_drain_any(int handle, can_delta_t *counters);
+#endif
+
+static can_share_t *share_create(TPCANHandle board, uint8_t mode);
+static void share_free(can_share_t *share);
+static int share_open(int32_t board, uint8_t mode);  // another handle of a shared channel
+static int share_join(int handle);      // add a started handle to the fan-out
+static void share_leave(int handle);    // remove a stopped handle from the fan-out
+static void *share_reader(void *arg);   // reader thread of a shared channel
+
+static int accept_message(int handle, DWORD id, int xtd);
+static int accept_range(int handle, uint32_t from, uint32_t to, int xtd);
+static int accept_mask(int handle, uint32_t code, uint32_t mask, int xtd);
+static void accept_reset(int handle);   // accept all identifiers
+static int accept_cover(int handle, int xtd, uint64_t *filter);
+
+static uint64_t poll_clock(void);       // monotonic time in nanoseconds
+static int poll_wait(struct pollfd *pfd, nfds_t n, uint64_t timeout);
+
+static void busload_start(int handle, const can_bitrate_t *bitrate);
+static void busload_reset(int handle, uint64_t now);
+static void busload_advance(can_busload_t *load, uint64_t now);
+static void busload_add(int handle, uint64_t busy);  // account bus time [ps]
+static uint16_t busload_get(int handle);  // bus load in [0.01 percent]
+static uint64_t busload_frame(int handle, DWORD id, BYTE type, BYTE dlc, const BYTE *data);
 
 static void can_message(const TPCANMsg *pcan_msg, can_message_t *msg);
 static void can_message_fd(const TPCANMsgFD *pcan_msg, can_message_t *msg);
-static void can_message_sts(can_status_t status, can_error_t error, can_message_t *msg);
+static void can_message_sts(uint8_t status, can_error_t error, can_message_t *msg);
 static void can_timestamp(TPCANTimestamp timestamp, can_message_t *msg);
 static void can_timestamp_fd(TPCANTimestampFD timestamp, can_message_t *msg);
 
+static void clock_reset(int handle);    // restart the clock correlation
+static uint64_t clock_host(int handle, uint64_t device);  // device time to host time [ns]
+static void clock_fit(can_clock_t *clk);  // regression of the offset
+
+static void instrument_reset(int handle);  // clear histograms and rates
+static void instrument_add(can_pcan_histogram_t *hist, uint64_t sample);
+static void instrument_clear(can_pcan_histogram_t *hist);
+static void instrument_rx(int handle, const can_message_t *buffer, size_t n);
+static void instrument_tx(int handle, const can_message_t *buffer, size_t n);
+static void instrument_copy(const can_pcan_histogram_t *hist, can_pcan_histogram_t *copy);
+
 static int pcan_error(TPCANStatus);     // PCAN specific errors
 static int pcan_compatibility(void);    // PCAN compatibility check
 
 static TPCANStatus pcan_capability(TPCANHandle board, can_mode_t *capability);
+static TPCANStatus pcan_start(int handle, uint16_t btr0btr1, char *string);
+static TPCANStatus pcan_stop(int handle);
 static TPCANStatus pcan_get_filter(int handle, uint64_t *filter, filtering_t mode);
 static TPCANStatus pcan_set_filter(int handle, uint64_t filter, filtering_t mode);
+static TPCANStatus pcan_apply_filter(int handle);
 static TPCANStatus pcan_reset_filter(int handle);
 
 static int lib_parameter(uint16_t param, void *value, size_t nbyte);
 static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte);
+static int drv_modifier(uint16_t param);  // property modifies the handle
 
 /*  -----------  variables  ----------------------------------------------
  */
@@ -256,43 +616,73 @@ can_board_t can_boards[NUM_CHANNELS+1] = {  // list of supported CAN channels
     {EOF, NULL},
     {EOF, NULL},
     {EOF, NULL},
+#endif
+#if (OPTION_PCAN_VIRTUAL_BUS != 0)
+    {PCAN_VIRTUAL1, "PCAN-Virtual1"},
+    {PCAN_VIRTUAL2, "PCAN-Virtual2"},
 #endif
     {EOF, NULL}
 };
 static const uint8_t dlc_table[16] = {  // DLC to length
     0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64
 };
-static can_interface_t can[CAN_MAX_HANDLES];  // interface handles
+static can_slot_t *can_table[HANDLE_CHUNKS];  // handle table (chunks of slots)
+static int can_capacity = 0;            // number of slots in the handle table
+static int can_free = INVALID_HANDLE;   // first unused slot (free list)
+static uint16_t can_index[0x10000];     // board to slot (index + 1, 0 = unused)
+static can_probe_t can_probe[NUM_CHANNELS];  // channel probes (interface list)
+static pthread_mutex_t table_lock = PTHREAD_MUTEX_INITIALIZER;  // open/close lock
 static int init = 0;                    // initialization flag
+#if defined(__linux__)
+static pthread_key_t wait_key;          // epoll set of the calling thread
+static pthread_once_t wait_once = PTHREAD_ONCE_INIT;
+#endif
+static unsigned int wait_generation = 0U;  // changed on start and exit
 
 /*  -----------  functions  ----------------------------------------------
  */
 EXPORT
 int can_test(int32_t board, uint8_t mode, const void *param, int *result)
 {
-    TPCANStatus sts;                    // represents a status
-    DWORD condition;                    // channel condition
-    can_mode_t capa;                    // channel capability
-    int used = 0;                       // own used channel
-    int i;                              // loop variable
+    int rc;                             // return value
 
     if (!IS_CHANNEL_VALID(board)) {     // PCAN handle is of type WORD!
         return pcan_error(PCAN_ERROR_ILLCLIENT);
     }
+    LOCK_TABLE();                       // lock the handle table
     if (!init) {                        // if not initialized:
         var_init();                     //   initialize all variables
         init = 1;                       //   set initialization flag
     }
-    // get channel condition to check for availability
-    if ((sts = CAN_GetValue((TPCANHandle)board, PCAN_CHANNEL_CONDITION,
-                           (void*)&condition, sizeof(condition))) != PCAN_ERROR_OK)
+    rc = test_channel(board, mode, result);
+    // when the music is over, turn out the lights
+#if (1)
+    if (all_closed()) {                 // if no open handle then
+        init = 0;                       //   clear initialization flag
+    }
+#endif
+    UNLOCK_TABLE();
+    (void)param;
+    return rc;
+}
+
+static int test_channel(int32_t board, uint8_t mode, int *result)
+{
+    TPCANStatus sts;                    // represents a status
+    DWORD condition;                    // channel condition
+    can_mode_t capa;                    // channel capability
+    const can_probe_t *probe;           // recent channel probe (if any)
+    int used = 0;                       // own used channel
+
+    // get channel condition to check for availability (from a recent probe, if any)
+    if ((probe = probe_cached(board)) != NULL)
+        condition = probe->condition;
+    else if ((sts = CAN_GetValue((TPCANHandle)board, PCAN_CHANNEL_CONDITION,
+                                (void*)&condition, sizeof(condition))) != PCAN_ERROR_OK)
         return pcan_error(sts);
-    for (i = 0; i < CAN_MAX_HANDLES; i++) {
-        if (can[i].board == (TPCANHandle)board) { // me, myself and I!
-            condition = PCAN_CHANNEL_OCCUPIED;
-            used = 1;
-            break;
-        }
+    if (can_index[(WORD)board]) {       // me, myself and I!
+        condition = PCAN_CHANNEL_OCCUPIED;
+        used = 1;
     }
     // check if the CAN channel is available
     if (result) {
@@ -308,8 +698,10 @@ int can_test(int32_t board, uint8_t mode, const void *param, int *result)
     // check given operation mode against the operation capability
     if (((condition == PCAN_CHANNEL_AVAILABLE) || (condition == PCAN_CHANNEL_PCANVIEW)) ||
        (/*(condition == PCAN_CHANNEL_OCCUPIED) ||*/ used)) {   // FIXME: issue TC07_47_9w - returns PCAN_ERROR_INITIALIZE if channel used by another process
-        // get operation capability from CAN board
-        if ((sts = pcan_capability((TPCANHandle)board, &capa)) != PCAN_ERROR_OK)
+        // get operation capability from CAN board (or from a recent probe)
+        if (probe && probe->valid)
+            capa = probe->capa;
+        else if ((sts = pcan_capability((TPCANHandle)board, &capa)) != PCAN_ERROR_OK)
             return pcan_error(sts);
         // check given operation mode against the operation capability
         if ((mode & ~capa.byte) != 0)
@@ -317,73 +709,169 @@ int can_test(int32_t board, uint8_t mode, const void *param, int *result)
         if (!(mode & CANMODE_FDOE) && ((mode & CANMODE_BRSE) || (mode & CANMODE_NISO)))
             return CANERR_ILLPARA;
     }
-    // when the music is over, turn out the lights
-#if (1)
-    if (all_closed()) {                 // if no open handle then
-        init = 0;                       //   clear initialization flag
+    return CANERR_NOERROR;
+}
+
+static int probe_channels(int8_t *states, size_t n)
+{
+    pthread_t thread[NUM_CHANNELS];     // one thread per channel
+    int started[NUM_CHANNELS];          // thread started
+    int i;                              // loop variable
+
+    assert(states);                     // just to make sure
+
+    /* note: the caller holds the table lock. The channels of the interface
+     *       list are queried concurrently, the results are cached for a short
+     *       time and taken by can_test() and can_init() */
+    for (i = 0; (size_t)i < n; i++)     // note: entries w/o channel are not testable
+        states[i] = (int8_t)CANBRD_NOT_TESTABLE;
+    for (i = 0; (i < NUM_CHANNELS) && (can_boards[i].type != EOF); i++) {
+        started[i] = (pthread_create(&thread[i], NULL, probe_thread, (void*)(intptr_t)i) == 0);
+        if (!started[i])                //   otherwise query it here
+            probe_query(i);
+    }
+    for (i = 0; (i < NUM_CHANNELS) && (can_boards[i].type != EOF); i++) {
+        if (started[i])
+            (void)pthread_join(thread[i], NULL);
+        if ((size_t)i >= n)
+            continue;
+        // the channel state (cf. can_test)
+        if (!can_probe[i].time)
+            states[i] = (int8_t)CANBRD_NOT_TESTABLE;
+        else if (can_index[(WORD)can_boards[i].type] || (can_probe[i].condition == PCAN_CHANNEL_OCCUPIED))
+            states[i] = (int8_t)CANBRD_OCCUPIED;
+        else if ((can_probe[i].condition == PCAN_CHANNEL_AVAILABLE) || (can_probe[i].condition == PCAN_CHANNEL_PCANVIEW))
+            states[i] = (int8_t)CANBRD_PRESENT;
+        else if (can_probe[i].condition == PCAN_CHANNEL_UNAVAILABLE)
+            states[i] = (int8_t)CANBRD_NOT_PRESENT;
+        else
+            states[i] = (int8_t)CANBRD_NOT_TESTABLE;
     }
-#endif
-    (void)param;
     return CANERR_NOERROR;
 }
 
+static void *probe_thread(void *arg)
+{
+    probe_query((int)(intptr_t)arg);
+    return NULL;
+}
+
+static void probe_query(int index)
+{
+    can_probe_t *probe = &can_probe[index];
+    TPCANHandle board = (TPCANHandle)can_boards[index].type;
+
+    // get channel condition and operation capability (when available)
+    probe->time = 0U;
+    probe->valid = 0;
+    if (CAN_GetValue(board, PCAN_CHANNEL_CONDITION, (void*)&probe->condition,
+                     sizeof(probe->condition)) != PCAN_ERROR_OK)
+        return;
+    if ((probe->condition == PCAN_CHANNEL_AVAILABLE) || (probe->condition == PCAN_CHANNEL_PCANVIEW))
+        probe->valid = (pcan_capability(board, &probe->capa) == PCAN_ERROR_OK);
+    probe->time = poll_clock();
+}
+
+static const can_probe_t *probe_cached(int32_t board)
+{
+    uint64_t now = poll_clock();
+    int i;
+
+    /* note: the caller holds the table lock */
+    for (i = 0; (i < NUM_CHANNELS) && (can_boards[i].type != EOF); i++) {
+        if (can_boards[i].type == board)
+            return (can_probe[i].time && ((now - can_probe[i].time) < PROBE_CACHE_TTL)) ? &can_probe[i] : NULL;
+    }
+    return NULL;
+}
+
+static void probe_invalidate(int32_t board)
+{
+    int i;
+
+    /* note: the caller holds the table lock */
+    for (i = 0; (i < NUM_CHANNELS) && (can_boards[i].type != EOF); i++) {
+        if (can_boards[i].type == board)
+            can_probe[i].time = 0U;
+    }
+}
+
 EXPORT
 int can_init(int32_t board, uint8_t mode, const void *param)
+{
+    int rc;                             // return value (or handle)
+
+    if (!IS_CHANNEL_VALID(board)) {     // PCAN handle is of type WORD!
+        return pcan_error(PCAN_ERROR_ILLCLIENT);
+    }
+    LOCK_TABLE();                       // lock the handle table
+    if (!init) {                        // if not initialized:
+        var_init();                     //   initialize all variables
+        init = 1;                       //   set initialization flag
+    }
+    rc = init_channel(board, mode, param);
+    UNLOCK_TABLE();
+    return rc;
+}
+
+static int init_channel(int32_t board, uint8_t mode, const void *param)
 {
     TPCANStatus sts;                    // represents a status
     DWORD value;                        // parameter value
     can_mode_t capa;                    // board capability
+    const can_probe_t *probe;           // recent channel probe (if any)
+    can_share_t *share = NULL;          // shared channel (CANMODE_SHRD)
     BYTE  type = 0;                     // board type (none PnP hardware)
     DWORD port = 0;                     // board parameter: I/O port address
     WORD  irq = 0;                      // board parameter: interrupt number
     int handle;                         // handle index
     int rc;                             // return value
 
-    if (!IS_CHANNEL_VALID(board)) {     // PCAN handle is of type WORD!
-        return pcan_error(PCAN_ERROR_ILLCLIENT);
-    }
-    if (!init) {                        // if not initialized:
-        var_init();                     //   initialize all variables
-        init = 1;                       //   set initialization flag
-    }
-    for (handle = 0; handle < CAN_MAX_HANDLES; handle++) {
-        if (can[handle].board == (TPCANHandle)board) // channel already in use
-            return CANERR_YETINIT;
-    }
-    for (handle = 0; handle < CAN_MAX_HANDLES; handle++) {
-        if (can[handle].board == PCAN_NONEBUS)  // get an unused handle, if any
-            break;
-    }
-    if (!IS_HANDLE_VALID(handle)) {     // no free handle found
+    if (can_index[(WORD)board])         // channel already in use
+        return share_open(board, mode); //   (unless it is shared)
+    if ((handle = handle_free()) == INVALID_HANDLE) {  // get an unused handle, if any
         return CANERR_NOTINIT;
     }
-    // check for minimum required library version
-    if ((rc = pcan_compatibility()) != PCAN_ERROR_OK)
+    // check for minimum required library version (not for a virtual channel)
+    if (!IS_VIRTUAL(board) && ((rc = pcan_compatibility()) != PCAN_ERROR_OK))
         return rc;
-    // get operation capability from channel and check with given operation mode
-    if ((sts = pcan_capability((TPCANHandle)board, &capa)) != PCAN_ERROR_OK)
+    // create the wake-up signal of the handle (once)
+    if ((rc = signal_open(handle)) != CANERR_NOERROR)
+        return rc;
+    // get operation capability from channel (or from a recent probe) and check with given operation mode
+    if (((probe = probe_cached(board)) != NULL) && probe->valid)
+        capa = probe->capa;
+    else if ((sts = pcan_capability((TPCANHandle)board, &capa)) != PCAN_ERROR_OK)
         return pcan_error(sts);
     if ((mode & ~capa.byte) != 0)
         return CANERR_ILLPARA;
     if (!(mode & CANMODE_FDOE) && ((mode & CANMODE_BRSE) || (mode & CANMODE_NISO)))
         return CANERR_ILLPARA;
+    // create the shared channel (the first handle opens the device)
+    if ((mode & CANMODE_SHRD) && ((share = share_create((TPCANHandle)board, mode)) == NULL))
+        return CANERR_RESOURCE;
     /* to start the CAN controller initially in reset state, we have switch OFF
      * the receiver and the transmitter and then to call CAN_Initialize[FD]() */
 #ifndef ISSUE_276_UNSOLVED
     value = PCAN_PARAMETER_OFF;         // receiver OFF
     if ((sts = CAN_SetValue((TPCANHandle)board, PCAN_RECEIVE_STATUS,
-                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK)
+                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK) {
+        share_free(share);
         return pcan_error(sts);
+    }
 #endif
     value = PCAN_PARAMETER_ON;          // transmitter OFF
     if ((sts = CAN_SetValue((TPCANHandle)board, PCAN_LISTEN_ONLY,
                            (void*)&value, sizeof(value))) != PCAN_ERROR_OK) {
+        share_free(share);
         return pcan_error(sts);
     }
     // initialize the CAN controller
     if ((mode & CANMODE_FDOE)) {        // CAN FD operation mode?
-        if ((sts = CAN_InitializeFD((TPCANHandle)board, BIT_RATE_DEFAULT)) != PCAN_ERROR_OK)
+        if ((sts = CAN_InitializeFD((TPCANHandle)board, BIT_RATE_DEFAULT)) != PCAN_ERROR_OK) {
+            share_free(share);
             return pcan_error(sts);
+        }
     }
     else {                              // CAN 2.0 operation mode
         if (param) {                    //   parameter for non-plug'n'play devices
@@ -391,42 +879,95 @@ int can_init(int32_t board, uint8_t mode, const void *param)
             port = (DWORD)((struct _pcan_param*)param)->port;
             irq  =  (WORD)((struct _pcan_param*)param)->irq;
         }
-        if ((sts = CAN_Initialize((TPCANHandle)board, BTR0BTR1_DEFAULT, type, port, irq)) != PCAN_ERROR_OK)
+        if ((sts = CAN_Initialize((TPCANHandle)board, BTR0BTR1_DEFAULT, type, port, irq)) != PCAN_ERROR_OK) {
+            share_free(share);
             return pcan_error(sts);
+        }
     }
     // store the handle and the operation mode
-    can[handle].board = (TPCANHandle)board;  // handle of the CAN channel
+    LOCK_EXCLUSIVE(handle);
+    SLOT(handle)->can.board = (TPCANHandle)board; // handle of the CAN channel
     if (param) {                        // non-plug'n'play devices:
-        can[handle].brd_type =  (BYTE)((struct _pcan_param*)param)->type;
-        can[handle].brd_port = (DWORD)((struct _pcan_param*)param)->port;
-        can[handle].brd_irq  =  (WORD)((struct _pcan_param*)param)->irq;
+        SLOT(handle)->can.brd_type =  (BYTE)((struct _pcan_param*)param)->type;
+        SLOT(handle)->can.brd_port = (DWORD)((struct _pcan_param*)param)->port;
+        SLOT(handle)->can.brd_irq  =  (WORD)((struct _pcan_param*)param)->irq;
     }
-    can[handle].mode.byte = mode;       // store selected operation mode
-    can[handle].status.byte = CANSTAT_RESET; // CAN controller not started yet
-    return handle;                      // return the handle
+    SLOT(handle)->can.mode.byte = mode; // store selected operation mode
+    SLOT(handle)->can.status.byte = CANSTAT_RESET; // CAN controller not started yet
+    SLOT(handle)->can.receive.spin = 0U; // blocking read w/o spinning
+    SLOT(handle)->ring.size = 0U;       // w/o receive ring (reader thread)
+    SLOT(handle)->can.busload.window = BUSLOAD_WINDOW; // default window length
+    SLOT(handle)->can.clock.mode = PCAN_TIMESTAMP_DEVICE; // time-stamps from the device
+    SLOT(handle)->can.instrument.enabled = 0; // w/o instrumentation
+    SLOT(handle)->can.share = share;    // shared channel (or NULL)
+    UNLOCK(handle);
+    if (share)                          // first handle of a shared channel
+        share->users = 1;
+    can_free = SLOT(handle)->next;      // remove the slot from the free list
+    can_index[(WORD)board] = (uint16_t)(handle + 1);
+    probe_invalidate(board);            // the channel is occupied now
+    return HANDLE_MAKE(handle);         // return the handle
 }
 
 static int exit_channel(int handle)
 {
+    can_share_t *share = SLOT(handle)->can.share; // shared channel (or NULL)
     TPCANStatus sts;                    // represents a status
+    int i;                              // loop variable
 
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
-        return CANERR_HANDLE;
+    /* note: the caller holds the table lock and the handle lock (exclusive) */
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
-    if (!can[handle].status.can_stopped) { // if running then go bus off
-        /* note: here we should turn off the receiver and the transmitter,
-         *       but after CAN_Uninitialize we are really (bus) OFF! */
-        (void)CAN_Reset(can[handle].board);
+    if (share && (share->users > 1)) {  // other handles of a shared channel:
+        LOCK_SHARE(share);
+        if (!(GET_STATUS(handle) & CANSTAT_RESET)) {
+            share_leave(handle);        //   leave the fan-out (the others keep on running)
+            if (!share->started)        //   stop the device with the last started handle
+                (void)pcan_stop(handle);
+        }
+        share->users--;
+        UNLOCK_SHARE(share);
+        // note: the device stays open, the channel is mapped to another handle of it
+        for (i = 0; i < can_capacity; i++) {
+            if ((i != handle) && (SLOT(i)->can.share == share)) {
+                can_index[SLOT(handle)->can.board] = (uint16_t)(i + 1);
+                break;
+            }
+        }
     }
-    if ((sts = CAN_Uninitialize(can[handle].board)) != PCAN_ERROR_OK)
-        return pcan_error(sts);
-
-    can[handle].status.byte |= CANSTAT_RESET;  // CAN controller in INIT state
-    can[handle].board = PCAN_NONEBUS; // handle can be used again
+    else {                              // last (or only) handle of a channel:
+        if (share && !(GET_STATUS(handle) & CANSTAT_RESET))
+            share_leave(handle);        //   stop the reader thread of the channel
+        else
+            ring_stop(handle);          //   stop the reader thread, if any
+        if (!(GET_STATUS(handle) & CANSTAT_RESET)) { // if running then go bus off
+            /* note: here we should turn off the receiver and the transmitter,
+             *       but after CAN_Uninitialize we are really (bus) OFF! */
+            (void)CAN_Reset(SLOT(handle)->can.board);
+        }
+        if ((sts = CAN_Uninitialize(SLOT(handle)->can.board)) != PCAN_ERROR_OK)
+            return pcan_error(sts);
+        can_index[SLOT(handle)->can.board] = 0U;
+        probe_invalidate((int32_t)SLOT(handle)->can.board);
+        share_free(share);              // release the shared channel, if any
+    }
+    SET_STATUS(handle, CANSTAT_RESET); // CAN controller in INIT state
+    SLOT(handle)->can.share = NULL;
+    SLOT(handle)->can.board = PCAN_NONEBUS; // handle can be used again
+    // note: the handle becomes stale, the slot can be used again
+    __atomic_store_n(&SLOT(handle)->generation, (SLOT(handle)->generation + 1U) & HANDLE_GENERATION_MASK, __ATOMIC_RELAXED);
+    SLOT(handle)->next = can_free;
+    can_free = handle;
+    free(SLOT(handle)->ring.buffer);    // release the receive ring, if any
+    SLOT(handle)->ring.buffer = NULL;
+    SLOT(handle)->ring.size = 0U;
+    accept_reset(handle);               // release the software filter, if any
+    memset(&SLOT(handle)->can.filter, 0, sizeof(can_filter_t));
+    SLOT(handle)->can.filter.mode = FILTER_OFF;
+    (void)__atomic_add_fetch(&wait_generation, 1U, __ATOMIC_RELEASE);
 #if defined(_WIN32) || defined(_WIN64)
-    if (can[handle].event != NULL) {  // close event handle, if any
-        if (!CloseHandle(can[handle].event))
+    if (SLOT(handle)->can.event != NULL) { // close event handle, if any
+        if (!CloseHandle(SLOT(handle)->can.event))
             return SYSERR_OFFSET - (int)GetLastError();
     }
 #endif
@@ -439,34 +980,51 @@ int can_exit(int handle)
     int rc;                             // return value
     int i;                              // loop variable
 
-    if (!init)                          // must be initialized
+    LOCK_TABLE();                       // lock the handle table
+    if (!init) {                        // must be initialized
+        UNLOCK_TABLE();
         return CANERR_NOTINIT;
+    }
     if (handle != CANEXIT_ALL) {        // close a single handle
-        if ((rc = exit_channel(handle)) != CANERR_NOERROR)
+        if ((handle = handle_index(handle)) == INVALID_HANDLE) { // must be a valid handle
+            UNLOCK_TABLE();
+            return CANERR_HANDLE;
+        }
+        LOCK_EXCLUSIVE(handle);
+        rc = exit_channel(handle);
+        UNLOCK(handle);
+        if (rc != CANERR_NOERROR) {
+            UNLOCK_TABLE();
             return rc;
+        }
     }
     else {
-        for (i = 0; i < CAN_MAX_HANDLES; i++) {
+        for (i = 0; i < can_capacity; i++) {
+            LOCK_EXCLUSIVE(i);
             (void)exit_channel(i);      // close all open handles
+            UNLOCK(i);
         }
     }
     // when the music is over, turn out the lights
     if (all_closed()) {                 // if no open handle then
         init = 0;                       //   clear initialization flag
     }
+    UNLOCK_TABLE();
     return CANERR_NOERROR;
 }
 
 static int kill_channel(int handle)
 {
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
-        return CANERR_HANDLE;
+    /* note: no lock is taken here, because the function is called from
+     *       signal handlers (and the wake-up signal is never closed) */
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
 #if defined(_WIN32) || defined(_WIN64)
-    if (can[handle].event != NULL)
-        if (!SetEvent(can[handle].event))  // signal event object
+    if (SLOT(handle)->can.event != NULL)
+        if (!SetEvent(SLOT(handle)->can.event)) // signal event object
             return SYSERR_OFFSET - (int)GetLastError();
+#else
+    signal_send(handle);                // wake up blocked readers
 #endif
     return CANERR_NOERROR;
 }
@@ -480,11 +1038,13 @@ int can_kill(int handle)
     if (!init)                          // must be initialized
         return CANERR_NOTINIT;
     if (handle != CANKILL_ALL) {        // signal a single handle
+        if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
+            return CANERR_HANDLE;
         if ((rc = kill_channel(handle)) != CANERR_NOERROR)
             return rc;
     }
     else {
-        for (i = 0; i < CAN_MAX_HANDLES; i++) {
+        for (i = 0; i < __atomic_load_n(&can_capacity, __ATOMIC_ACQUIRE); i++) {
             (void)kill_channel(i);      // signal all open handles
         }
     }
@@ -494,22 +1054,33 @@ int can_kill(int handle)
 EXPORT
 int can_start(int handle, const can_bitrate_t *bitrate)
 {
+    int rc;                             // return value
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
+        return CANERR_HANDLE;
+    LOCK_EXCLUSIVE(handle);
+    rc = start_channel(handle, bitrate);
+    UNLOCK(handle);
+    return rc;
+}
+
+static int start_channel(int handle, const can_bitrate_t *bitrate)
+{
+    can_share_t *share = SLOT(handle)->can.share; // shared channel (or NULL)
     TPCANStatus sts;                    // represents a status
     uint16_t btr0btr1 = BTR0BTR1_DEFAULT;  // btr0btr1 value
     char string[PCAN_MAX_BUFFER_SIZE];  // bit-rate string
-    DWORD value;                        // parameter value
+    int rc;                             // return value
 
     strcpy(string, "");                 // empty string
 
-    if (!init)                          // must be initialized
-        return CANERR_NOTINIT;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
-        return CANERR_HANDLE;
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
     if (bitrate == NULL)                // check for null-pointer
         return CANERR_NULLPTR;
-    if (!can[handle].status.can_stopped) // must be stopped
+    if (!(GET_STATUS(handle) & CANSTAT_RESET)) // must be stopped
         return CANERR_ONLINE;
 
     // convert CAN API bit-rate to PCANBasic bit-rate
@@ -526,10 +1097,10 @@ int can_start(int handle, const can_bitrate_t *bitrate)
             case CANBTR_INDEX_10K: btr0btr1 = PCAN_BAUD_10K; break;
             default: return CANERR_BAUDRATE;
         }
-        if (can[handle].mode.fdoe)      // note: btr0btr1 not allowed in CAN FD
+        if (SLOT(handle)->can.mode.fdoe) // note: btr0btr1 not allowed in CAN FD
             return CANERR_BAUDRATE;
     }
-    else if (!can[handle].mode.fdoe) {  // a btr0btr1 value for CAN 2.0:
+    else if (!SLOT(handle)->can.mode.fdoe) { // a btr0btr1 value for CAN 2.0:
         /* note: clock and ranges are checkes by the converter */
         if (btr_bitrate2sja1000(bitrate, &btr0btr1) != CANERR_NOERROR)
             return CANERR_BAUDRATE;
@@ -544,108 +1115,93 @@ int can_start(int handle, const can_bitrate_t *bitrate)
             case BTR_FREQ_20MHz: break;
             default: return CANERR_BAUDRATE;
         }
-        if (btr_check_bitrate(bitrate, can[handle].mode.fdoe,
-                              can[handle].mode.brse) != CANERR_NOERROR)
+        if (btr_check_bitrate(bitrate, SLOT(handle)->can.mode.fdoe,
+                              SLOT(handle)->can.mode.brse) != CANERR_NOERROR)
             return CANERR_BAUDRATE;
-        if (btr_bitrate2string(bitrate, can[handle].mode.brse, false,
+        if (btr_bitrate2string(bitrate, SLOT(handle)->can.mode.brse, false,
                                string, PCAN_MAX_BUFFER_SIZE) != CANERR_NOERROR)
             return CANERR_BAUDRATE;
     }
-    // start the CAN controller
-    /* note: to (re-)start the CAN controller, we have to reinitialize it */
-    if ((sts = CAN_Reset(can[handle].board)) != PCAN_ERROR_OK)
-        return pcan_error(sts);
-    if ((sts = CAN_Uninitialize(can[handle].board)) != PCAN_ERROR_OK)
-        return pcan_error(sts);
-#ifdef ISSUE_303_WORKAROUND
-    value = (can[handle].mode.mon) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
-    if ((sts = CAN_SetValue(can[handle].board, PCAN_LISTEN_ONLY,
-                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK) {
-        CAN_Uninitialize(can[handle].board);
-        return pcan_error(sts);
-    }
-#endif
-    /* note: the receiver is automatically switched ON by CAN_Initialize[FD]() */
-    if (can[handle].mode.fdoe) {        // CAN FD operation mode?
-        if ((sts = CAN_InitializeFD(can[handle].board, string)) != PCAN_ERROR_OK)
-            return pcan_error(sts);
-    }
-    else {                              // CAN 2.0 operation mode!
-        if ((sts = CAN_Initialize(can[handle].board, btr0btr1,
-                                  can[handle].brd_type, can[handle].brd_port,
-                                  can[handle].brd_irq)) != PCAN_ERROR_OK)
+    // start the CAN controller (or join a started shared channel)
+    if (share) {
+        LOCK_SHARE(share);
+        if (share->started) {           //   already started by another handle
+            if ((btr0btr1 != share->btr0btr1) || strcmp(string, share->bitrate)) {
+                UNLOCK_SHARE(share);
+                return CANERR_BAUDRATE; //     bit-rate must be the same
+            }
+            SLOT(handle)->can.fdes = share->fdes;
+        }
+        else if ((sts = pcan_start(handle, btr0btr1, string)) != PCAN_ERROR_OK) {
+            UNLOCK_SHARE(share);
             return pcan_error(sts);
+        }
+        else {                          //   first started handle
+            share->fdes = SLOT(handle)->can.fdes;
+            share->btr0btr1 = btr0btr1;
+            strncpy(share->bitrate, string, PCAN_MAX_BUFFER_SIZE);
+            share->bitrate[PCAN_MAX_BUFFER_SIZE - 1] = '\0';
+        }
     }
-#if !defined(_WIN32) && !defined(_WIN64)
-    // get file descriptor for blocking read (Every thing is a file in unixoid systems)
-    if ((sts = CAN_GetValue(can[handle].board, PCAN_RECEIVE_EVENT,
-                           &can[handle].fdes, sizeof(int))) != PCAN_ERROR_OK) {
-        CAN_Uninitialize(can[handle].board);
-        return pcan_error(sts);
-    }
-#endif
-#ifndef ISSUE_303_WORKAROUND
-    // set listen-only mode if selected
-    value = (can[handle].mode.mon) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
-    if ((sts = CAN_SetValue(can[handle].board, PCAN_LISTEN_ONLY,
-                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK) {
-        CAN_Uninitialize(can[handle].board);
+    else if ((sts = pcan_start(handle, btr0btr1, string)) != PCAN_ERROR_OK)
         return pcan_error(sts);
+    // clear old status, errors and counters
+    CLR_STATUS(handle, ~CANSTAT_RESET);  // (stopped until the reader runs)
+    SLOT(handle)->can.error.lec = 0x00u;
+    SLOT(handle)->can.error.rx_err = 0u;
+    SLOT(handle)->can.error.tx_err = 0u;
+    SLOT(handle)->can.counters.tx = 0ull;
+    SLOT(handle)->can.counters.rx = 0ull;
+    SLOT(handle)->can.counters.err = 0ull;
+    SLOT(handle)->can.receive.spun = 0ull;
+    SLOT(handle)->can.receive.blocked = 0ull;
+    SLOT(handle)->can.transmit.ovfl = 0ull;
+    busload_start(handle, bitrate);
+    clock_reset(handle);
+    instrument_reset(handle);
+    path_select(handle);
+    if (share) {                        // join the fan-out of the shared channel
+        rc = share_join(handle);
+        if ((rc != CANERR_NOERROR) && !share->started)
+            (void)pcan_stop(handle);
+        UNLOCK_SHARE(share);
+        if (rc != CANERR_NOERROR)
+            return rc;
     }
-#endif
-    // set acceptance filter as selected
-    switch(can[handle].filter.mode) {
-        case FILTER_STD:                // 11-bit identifier
-            if ((sts = CAN_SetValue(can[handle].board, PCAN_ACCEPTANCE_FILTER_11BIT,
-                                   (void*)&can[handle].filter.mask,
-                                    sizeof(UINT64))) != PCAN_ERROR_OK) {
-                CAN_Uninitialize(can[handle].board);
-                return pcan_error(sts);
-            }
-            break;
-        case FILTER_XTD:                // 29-bit identifier
-            if ((sts = CAN_SetValue(can[handle].board, PCAN_ACCEPTANCE_FILTER_29BIT,
-                                   (void*)&can[handle].filter.mask,
-                                    sizeof(UINT64))) != PCAN_ERROR_OK) {
-                CAN_Uninitialize(can[handle].board);
-                return pcan_error(sts);
-            }
-            break;
-        default:                        // no filtering
-            value = PCAN_FILTER_OPEN;
-            if ((sts = CAN_SetValue(can[handle].board, PCAN_MESSAGE_FILTER,
-                                   (void*)&value, sizeof(value))) != PCAN_ERROR_OK) {
-                CAN_Uninitialize(can[handle].board);
-                return pcan_error(sts);
-            }
-            break;
+    // start the reader thread (if a receive ring is configured)
+    else if ((rc = ring_start(handle)) != CANERR_NOERROR) {
+        CAN_Uninitialize(SLOT(handle)->can.board);
+        return rc;
     }
-    // clear old status, errors and counters
-    can[handle].status.byte = 0x00u;
-    can[handle].error.lec = 0x00u;
-    can[handle].error.rx_err = 0u;
-    can[handle].error.tx_err = 0u;
-    can[handle].counters.tx = 0ull;
-    can[handle].counters.rx = 0ull;
-    can[handle].counters.err = 0ull;
     // CAN controller started!
-    can[handle].status.can_stopped = 0;
+    CLR_STATUS(handle, CANSTAT_RESET);
+    (void)__atomic_add_fetch(&wait_generation, 1U, __ATOMIC_RELEASE);
     return CANERR_NOERROR;
 }
 
 EXPORT
 int can_reset(int handle)
 {
-    TPCANStatus sts;                    // represents a status
-    DWORD value;                        // parameter value
+    int rc;                             // return value
 
     if (!init)                          // must be initialized
         return CANERR_NOTINIT;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
         return CANERR_HANDLE;
+    LOCK_EXCLUSIVE(handle);
+    rc = reset_channel(handle);
+    UNLOCK(handle);
+    return rc;
+}
+
+static int reset_channel(int handle)
+{
+    can_share_t *share = SLOT(handle)->can.share; // shared channel (or NULL)
+    TPCANStatus sts;                    // represents a status
+
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
-    if (can[handle].status.can_stopped) // must be running
+    if ((GET_STATUS(handle) & CANSTAT_RESET)) // must be running
 #if (OPTION_CANAPI_RETVALS == OPTION_DISABLED)
         return CANERR_OFFLINE;
 #else
@@ -653,320 +1209,333 @@ int can_reset(int handle)
         //       the CAN controller has not been started
         return CANERR_NOERROR;
 #endif
-    // stop the CAN controller (INIT state)
-    /* note: we turn off the receiver and the transmitter to do that! */
-#ifndef ISSUE_276_UNSOLVED
-    value = PCAN_PARAMETER_OFF;         //   receiver off
-    if ((sts = CAN_SetValue(can[handle].board, PCAN_RECEIVE_STATUS,
-                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK)
-        return pcan_error(sts);
-#endif
-    value = PCAN_PARAMETER_ON;          //   transmitter off
-    if ((sts = CAN_SetValue(can[handle].board, PCAN_LISTEN_ONLY,
-                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK)
-        return pcan_error(sts);
+    if (share) {                        // shared channel:
+        LOCK_SHARE(share);
+        share_leave(handle);            //   leave the fan-out
+        // stop the CAN controller with the last started handle (INIT state)
+        sts = !share->started ? pcan_stop(handle) : PCAN_ERROR_OK;
+        UNLOCK_SHARE(share);
+        if (sts != PCAN_ERROR_OK)
+            return pcan_error(sts);
+    }
+    else {
+        // stop the reader thread, if any
+        ring_stop(handle);
+        // stop the CAN controller (INIT state)
+        if ((sts = pcan_stop(handle)) != PCAN_ERROR_OK)
+            return pcan_error(sts);
+    }
     // CAN controller stopped!
-    can[handle].status.can_stopped = 1;
+    SET_STATUS(handle, CANSTAT_RESET);
     return CANERR_NOERROR;
 }
 
 EXPORT
 int can_write(int handle, const can_message_t *msg, uint16_t timeout)
 {
-    TPCANStatus sts;                    // represents a status
-    TPCANMsg can_msg;                   // the message (CAN 2.0)
-    TPCANMsgFD can_msg_fd;              // the message (CAN FD)
-    (void)timeout;
+    size_t count = 0U;                  // number of messages sent
+    int rc;                             // return value
 
     if (!init)                          // must be initialized
         return CANERR_NOTINIT;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
         return CANERR_HANDLE;
+    LOCK_SHARED(handle);
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
-        return CANERR_HANDLE;
-    if (msg == NULL)                    // check for null-pointer
-        return CANERR_NULLPTR;
-    if (can[handle].status.can_stopped) // must be running
-        return CANERR_OFFLINE;
-
-    if (msg->id > (uint32_t)(msg->xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID))
-        return CANERR_ILLPARA;          // invalid identifier
-    if (msg->xtd && can[handle].mode.nxtd)
-        return CANERR_ILLPARA;          // suppress extended frames
-    if (msg->rtr && can[handle].mode.nrtr)
-        return CANERR_ILLPARA;          // suppress remote frames
-    if (msg->fdf && !can[handle].mode.fdoe)
-        return CANERR_ILLPARA;          // long frames only with CAN FD
-    if (msg->brs && !can[handle].mode.brse)
-        return CANERR_ILLPARA;          // fast frames only with CAN FD
-    if (msg->brs && !msg->fdf)
-        return CANERR_ILLPARA;          // bit-rate switching only with CAN FD
-    if (msg->sts)
-        return CANERR_ILLPARA;          // error frames cannot be sent
-
-    if (!can[handle].mode.fdoe) {
-        if (msg->dlc > CAN_MAX_LEN)     //   data length 0 .. 8
-            return CANERR_ILLPARA;
-        if (msg->xtd)                   //   29-bit identifier
-            can_msg.MSGTYPE = PCAN_MESSAGE_EXTENDED;
-        else                            //   11-bit identifier
-            can_msg.MSGTYPE = PCAN_MESSAGE_STANDARD;
-        if (msg->rtr)                   //   request a message
-            can_msg.MSGTYPE |= PCAN_MESSAGE_RTR;
-        can_msg.ID = (DWORD)(msg->id);
-        can_msg.LEN = (BYTE)(msg->dlc);
-        memcpy(can_msg.DATA, msg->data, msg->dlc);
-        // CAN 2.0: transmit the message
-        sts = CAN_Write(can[handle].board, &can_msg);
+        rc = CANERR_HANDLE;
+    else if (msg == NULL)               // check for null-pointer
+        rc = CANERR_NULLPTR;
+    else if ((GET_STATUS(handle) & CANSTAT_RESET)) // must be running
+        rc = CANERR_OFFLINE;
+    // check the message against the operation mode
+    else if ((rc = check_message(handle, msg)) == CANERR_NOERROR) {
+        // transmit the message
+        LOCK_WRITER(handle);
+        rc = SLOT(handle)->can.path.write(handle, msg, 1U, &count, timeout);
+        UNLOCK_WRITER(handle);
     }
-    else {
-        if (msg->dlc > CANFD_MAX_DLC)   //   data length 0 .. 0Fh
-            return CANERR_ILLPARA;
-        if (msg->xtd)                   //   29-bit identifier
-            can_msg_fd.MSGTYPE = PCAN_MESSAGE_EXTENDED;
-        else                            //   11-bit identifier
-            can_msg_fd.MSGTYPE = PCAN_MESSAGE_STANDARD;
-        if (msg->rtr)                   //   request a message
-            can_msg_fd.MSGTYPE |= PCAN_MESSAGE_RTR;
-        if (msg->fdf)                   //   CAN FD format
-            can_msg_fd.MSGTYPE |= PCAN_MESSAGE_FD;
-        if (msg->brs && can[handle].mode.brse) //   bit-rate switching
-            can_msg_fd.MSGTYPE |= PCAN_MESSAGE_BRS;
-        can_msg_fd.ID = (DWORD)(msg->id);
-        can_msg_fd.DLC = (BYTE)(msg->dlc);
-        memcpy(can_msg_fd.DATA, msg->data, DLC2LEN(msg->dlc));
-        // CAN FD: transmit the message
-        sts = CAN_WriteFD(can[handle].board, &can_msg_fd);
-    }
-    // check for errors
-    if (sts != PCAN_ERROR_OK) {
-        if ((sts & PCAN_ERROR_QXMTFULL)) {  // transmit queue full?
-            can[handle].status.transmitter_busy = 1;
-            return CANERR_TX_BUSY;      //     transmitter busy
-        }
-        if ((sts & PCAN_ERROR_XMTFULL)) {  // transmission pending?
-            can[handle].status.transmitter_busy = 1;
-            return CANERR_TX_BUSY;      //     transmitter busy
+    UNLOCK(handle);
+    return rc;
+}
+
+EXPORT
+int can_write_multi(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout)
+{
+    size_t n = 0U;                      // number of messages sent
+    size_t i;                           // loop variable
+    int rc;                             // return value
+
+    if (sent)                           // nothing sent so far
+        *sent = 0U;
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
+        return CANERR_HANDLE;
+    LOCK_SHARED(handle);
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        rc = CANERR_HANDLE;
+    else if ((buffer == NULL) || (sent == NULL))  // check for null-pointer
+        rc = CANERR_NULLPTR;
+    else if ((GET_STATUS(handle) & CANSTAT_RESET)) // must be running
+        rc = CANERR_OFFLINE;
+    else {
+        // check all messages against the operation mode (once)
+        for (i = 0U, rc = CANERR_NOERROR; (i < count) && (rc == CANERR_NOERROR); i++)
+            rc = check_message(handle, &buffer[i]);
+        if (rc == CANERR_NOERROR) {
+            // transmit the messages back to back
+            LOCK_WRITER(handle);
+            rc = SLOT(handle)->can.path.write(handle, buffer, count, &n, timeout);
+            UNLOCK_WRITER(handle);
+            *sent = n;
         }
-        return pcan_error(sts);         //   PCAN specific error
     }
-    // message transmitted: increment transmit counter
-    can[handle].status.transmitter_busy = 0;
-    can[handle].counters.tx++;
-    return CANERR_NOERROR;
+    UNLOCK(handle);
+    return rc;
 }
 
 EXPORT
 int can_read(int handle, can_message_t *msg, uint16_t timeout)
 {
-    TPCANStatus sts;                    // represents a status
-    TPCANMsg can_msg;                   // the message (CAN 2.0)
-    TPCANTimestamp timestamp;           // time stamp (CAN 2.0)
-    TPCANMsgFD can_msg_fd;              // the message (CAN FD)
-    TPCANTimestampFD timestamp_fd;      // time stamp (CAN FD)
+    // time-out in milliseconds (65535 means blocking read)
+    return can_read_ns(handle, msg, TIMEOUT_NS(timeout));
+}
+
+EXPORT
+int can_read_ns(int handle, can_message_t *msg, uint64_t timeout)
+{
+    // read one message w/o the status register
+    return read_message(handle, msg, NULL, timeout);
+}
+
+EXPORT
+int can_read_status(int handle, can_message_t *msg, uint8_t *status, uint16_t timeout)
+{
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if (status == NULL)                 // check for null-pointer
+        return CANERR_NULLPTR;
+    // read one message and the latched status register
+    return read_message(handle, msg, status, TIMEOUT_NS(timeout));
+}
 
-    memset(&can_msg, 0, sizeof(TPCANMsg));
-    memset(&timestamp, 0, sizeof(TPCANTimestamp));
-    memset(&can_msg_fd, 0, sizeof(TPCANMsgFD));
-    memset(&timestamp_fd, 0, sizeof(TPCANTimestampFD));
+static int read_message(int handle, can_message_t *msg, uint8_t *status, uint64_t timeout)
+{
+    size_t count = 0U;                  // number of messages read
+    int rc;                             // return value
 
     if (!init)                          // must be initialized
         return CANERR_NOTINIT;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
         return CANERR_HANDLE;
+    LOCK_SHARED(handle);
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        rc = CANERR_HANDLE;
+    else if (msg == NULL)               // check for null-pointer
+        rc = CANERR_NULLPTR;
+    else if ((GET_STATUS(handle) & CANSTAT_RESET)) // must be running
+        rc = CANERR_OFFLINE;
+    else {
+        // read one message from the receive queue
+        LOCK_READER(handle);
+        if ((rc = SLOT(handle)->can.path.read(handle, msg, 1U, &count, timeout)) != CANERR_NOERROR) {
+            memset(msg, 0, sizeof(can_message_t));
+            msg->id = 0xFFFFFFFFu;
+            msg->sts = 1;
+        }
+        UNLOCK_READER(handle);
+        /* note: the status register is not read from the device (cf. can_status()),
+         *       it is maintained from the status frames and the queue flags the
+         *       read path has seen, so that no further call is required */
+        if (status)
+            *status = GET_STATUS(handle);
+    }
+    UNLOCK(handle);
+    return rc;
+}
+
+EXPORT
+int can_read_multi(int handle, can_message_t *buffer, size_t max, size_t *count, uint16_t timeout)
+{
+    size_t n = 0U;                      // number of messages read
+    int rc;                             // return value
+
+    if (count)                          // nothing read so far
+        *count = 0U;
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
         return CANERR_HANDLE;
-    if (msg == NULL)                    // check for null-pointer
-        return CANERR_NULLPTR;
-    if (can[handle].status.can_stopped) // must be running
-        return CANERR_OFFLINE;
+    LOCK_SHARED(handle);
+    if (!IS_HANDLE_OPENED(handle))      // must be an open handle
+        rc = CANERR_HANDLE;
+    else if ((buffer == NULL) || (count == NULL))  // check for null-pointer
+        rc = CANERR_NULLPTR;
+    else if (max == 0U)                 // at least one message
+        rc = CANERR_ILLPARA;
+    else if ((GET_STATUS(handle) & CANSTAT_RESET)) // must be running
+        rc = CANERR_OFFLINE;
+    else {
+        // read up to 'max' messages from the receive queue
+        LOCK_READER(handle);
+        rc = SLOT(handle)->can.path.read(handle, buffer, max, &n, TIMEOUT_NS(timeout));
+        UNLOCK_READER(handle);
+        *count = n;
+    }
+    UNLOCK(handle);
+    return rc;
+}
 
-    memset(msg, 0, sizeof(can_message_t));
-    msg->id = 0xFFFFFFFFu;
-    msg->sts = 1;
+EXPORT
+int can_wait(const int *handles, int n, uint32_t *ready_mask, uint16_t timeout)
+{
+    int index[WAIT_MAX_HANDLES];        // slot indexes of the handles
+    int fdes[WAIT_MAX_HANDLES];         // file descriptors for blocking read
+    int sigs[WAIT_MAX_HANDLES];         // file descriptors of wake-up signals
+    unsigned int signals[WAIT_MAX_HANDLES];  // wake-up signals sent so far
+    uint32_t ready = 0x00000000U;       // ready handles (bit mask)
+    uint32_t signaled = 0x00000000U;    // signaled handles (bit mask)
+    uint64_t deadline = 0U;             // end of the wait (monotonic clock)
+    uint64_t now;                       // current time (monotonic clock)
+    uint16_t wait = timeout;            // remaining time to wait [ms]
+    int rc = CANERR_NOERROR;            // return value
+    int i;                              // loop variable
 
-    // blocking read
-#if !defined(_WIN32) && !defined(_WIN64)
-    fd_set rdfs;
-    FD_ZERO(&rdfs);
-    FD_SET(can[handle].fdes, &rdfs);
-    struct timeval tv;
-    tv.tv_sec = (time_t)(timeout / 1000u);
-    tv.tv_usec = (suseconds_t)(timeout % 1000u) * (suseconds_t)1000;
-repeat:
-    // try to read a message
-    if (!can[handle].mode.fdoe)
-        sts = CAN_Read(can[handle].board, &can_msg, &timestamp);
-    else
-        sts = CAN_ReadFD(can[handle].board, &can_msg_fd, &timestamp_fd);
-    if (sts == PCAN_ERROR_QRCVEMPTY) {
-        // blocking read (via system call select())
-        if(timeout == 65535u) {
-            if(select(can[handle].fdes+1, &rdfs, NULL, NULL, NULL) > 0)
-                goto repeat;
-        }
-        else if(timeout != 0) {
-            if(select(can[handle].fdes+1, &rdfs, NULL, NULL, &tv) > 0)
-                goto repeat;
+    if (ready_mask)                     // nothing ready so far
+        *ready_mask = 0x00000000U;
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if ((handles == NULL) || (ready_mask == NULL))  // check for null-pointer
+        return CANERR_NULLPTR;
+    if ((n < 1) || (WAIT_MAX_HANDLES < n))  // 1 .. 32 handles
+        return CANERR_ILLPARA;
+
+    // get the file descriptors of the handles
+    for (i = 0; (i < n) && (rc == CANERR_NOERROR); i++) {
+        if ((index[i] = handle_index(handles[i])) == INVALID_HANDLE)  // must be a valid handle
+            return CANERR_HANDLE;
+        LOCK_SHARED(index[i]);
+        if (!IS_HANDLE_OPENED(index[i]))  // must be an open handle
+            rc = CANERR_HANDLE;
+        else if ((GET_STATUS(index[i]) & CANSTAT_RESET)) // must be running
+            rc = CANERR_OFFLINE;
+        else {
+            fdes[i] = RX_EVENT(index[i]);
+            sigs[i] = SLOT(index[i])->signal.fdes[0];
+            signals[i] = GET_SIGNAL(index[i]);
         }
-        // polling or select() failed
-        can[handle].status.receiver_empty = 1;
-        return CANERR_RX_EMPTY;         //   receiver empty!
+        UNLOCK(index[i]);
     }
-#endif
-    // check for errors
-    if ((sts & PCAN_ERROR_OVERRUN)) {
-        can[handle].status.message_lost = 1;
-        /* note: at least one message got lost, but we have a message */
-    }
-    if ((sts & PCAN_ERROR_QOVERRUN)) {
-        can[handle].status.queue_overrun = 1;
-        /* note: queue has overrun, but we have a message */
-    }
-    if ((sts & PCAN_ERROR_QRCVEMPTY)) {  // receice queue empty?
-        can[handle].status.receiver_empty = 1;
-        if ((sts & 0xFF00u))  // TODO: explain this
-            return pcan_error(sts);      //   something went wrong
-        else
-            return CANERR_RX_EMPTY;     //   receiver empty!
-    }
-    // convert PCAN message to CAN API message
-    // TODO: move this into separate functions if possible
-    if (!can[handle].mode.fdoe) {       // CAN 2.0 message:
-        if ((can_msg.MSGTYPE & PCAN_MESSAGE_EXTENDED) && can[handle].mode.nxtd)
-            goto repeat;                //   refuse extended frames
-        if ((can_msg.MSGTYPE & PCAN_MESSAGE_RTR) && can[handle].mode.nrtr)
-            goto repeat;                //   refuse remote frames
-        if ((can_msg.MSGTYPE & PCAN_MESSAGE_STATUS)) {
-            // update status register from status frame
-            can[handle].status.bus_off = ((can_msg.DATA[3] & PCAN_ERROR_BUSOFF) != PCAN_ERROR_OK) ? 1 : 0;
-            can[handle].status.warning_level = ((can_msg.DATA[3] & PCAN_ERROR_BUSHEAVY) != PCAN_ERROR_OK) ? 1 : 0;
-            // refuse status message if suppressed by user
-            if (!can[handle].mode.err)
-                goto repeat;
-            // status message: ID=000h, DLC=4 (status, lec, rx errors, tx errors)
-            can_message_sts(can[handle].status, can[handle].error, msg);
-            can[handle].counters.err++;
-        }
-        else if ((can_msg.MSGTYPE & PCAN_MESSAGE_ERRFRAME))  {
-            // update error and status register from error frame
-            can[handle].error.lec = (uint8_t)can_msg.ID;
-            can[handle].error.rx_err = can_msg.DATA[2];
-            can[handle].error.tx_err = can_msg.DATA[3];
-            can[handle].status.bus_error = can[handle].error.lec ? 1 : 0;
-            // refuse status message if suppressed by user
-            if (!can[handle].mode.err)
-                goto repeat;
-            // status message: ID=000h, DLC=4 (status, lec, rx errors, tx errors)
-            can_message_sts(can[handle].status, can[handle].error, msg);
-            can[handle].counters.err++;
+    if (rc != CANERR_NOERROR)
+        return rc;
+    if (timeout != CANWAIT_INFINITE)    // one deadline for the whole call
+        deadline = poll_clock() + TIMEOUT_NS(timeout);
+    // wait until at least one of them is ready (or has been signaled)
+    for (;;) {
+        for (i = 0; i < n; i++) {
+            if (GET_SIGNAL(index[i]) != signals[i])
+                ready |= (uint32_t)1 << i;  //   signaled by can_kill()
         }
-        else {
-            // decode PEAK CAN 2.0 message and increment receive counter
-            can_message(&can_msg, msg);
-            can[handle].counters.rx++;
-        }
-        // time-stamp in nanoseconds since start of Windows
-        can_timestamp(timestamp, msg);
-    }
-    else {                              // CAN FD message:
-        if ((can_msg_fd.MSGTYPE & PCAN_MESSAGE_EXTENDED) && can[handle].mode.nxtd)
-            goto repeat;                //   refuse extended frames
-        if ((can_msg_fd.MSGTYPE & PCAN_MESSAGE_RTR) && can[handle].mode.nrtr)
-            goto repeat;                //   refuse remote frames (n/a w/ fdoe)
-        if ((can_msg_fd.MSGTYPE & PCAN_MESSAGE_STATUS)) {
-            // update status register from status frame
-            can[handle].status.bus_off = ((can_msg_fd.DATA[3] & PCAN_ERROR_BUSOFF) != PCAN_ERROR_OK) ? 1 : 0;
-            can[handle].status.warning_level = ((can_msg_fd.DATA[3] & PCAN_ERROR_BUSWARNING) != PCAN_ERROR_OK) ? 1 : 0;
-            // refuse status message if suppressed by user
-            if (!can[handle].mode.err)
-                goto repeat;
-            // status message: ID=000h, DLC=4 (status, lec, rx errors, tx errors)
-            can_message_sts(can[handle].status, can[handle].error, msg);
-            can[handle].counters.err++;
-        }
-        else if ((can_msg_fd.MSGTYPE & PCAN_MESSAGE_ERRFRAME)) {
-            // update error and status register from error frame
-            can[handle].error.lec = (uint8_t)can_msg_fd.ID;
-            can[handle].error.rx_err = can_msg_fd.DATA[2];
-            can[handle].error.tx_err = can_msg_fd.DATA[3];
-            can[handle].status.bus_error = can[handle].error.lec ? 1 : 0;
-            // refuse status message if suppressed by user
-            if (!can[handle].mode.err)
-                goto repeat;
-            // status message: ID=000h, DLC=4 (status, lec, rx errors, tx errors)
-            can_message_sts(can[handle].status, can[handle].error, msg);
-            can[handle].counters.err++;
+        if (ready != 0x00000000U)
+            break;
+        if (timeout != CANWAIT_INFINITE) {  //   remaining time (rounded up)
+            now = poll_clock();
+            wait = (now < deadline) ? (uint16_t)((deadline - now + 999999U) / 1000000U) : 0U;
         }
-        else {
-            // decode PEAK CAN FD message and increment receive counter
-            can_message_fd(&can_msg_fd, msg);
-            can[handle].counters.rx++;
+        if ((rc = wait_events(fdes, sigs, n, &ready, &signaled, wait)) != CANERR_NOERROR)
+            return rc;
+        for (i = 0; i < n; i++) {
+            /* note: a wake-up signal sent before we started to wait is stale */
+            if ((signaled & ((uint32_t)1 << i)) && (GET_SIGNAL(index[i]) == signals[i]))
+                event_clear(sigs[i]);
         }
-        // time-stamp in nanoseconds since start of Windows
-        can_timestamp_fd(timestamp_fd, msg);
     }
-    // one message read from receive queue
-    can[handle].status.receiver_empty = 0;
+    *ready_mask = ready;
     return CANERR_NOERROR;
 }
 
 EXPORT
 int can_status(int handle, uint8_t *status)
 {
-    TPCANStatus sts;                    // represents a status
+    int rc;                             // return value
 
     if (!init)                          // must be initialized
         return CANERR_NOTINIT;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
         return CANERR_HANDLE;
+    LOCK_SHARED(handle);
+    rc = get_status(handle, status);
+    UNLOCK(handle);
+    return rc;
+}
+
+static int get_status(int handle, uint8_t *status)
+{
+    TPCANStatus sts;                    // represents a status
+
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
 
     // TODO: check if running condition is required
-    if (!can[handle].status.can_stopped) { // if running get bus status
+    if (!(GET_STATUS(handle) & CANSTAT_RESET)) { // if running get bus status
         // get status from device
-        sts = CAN_GetStatus(can[handle].board);
+        sts = CAN_GetStatus(SLOT(handle)->can.board);
         if ((sts & ~(PCAN_ERROR_ANYBUSERR |
                    PCAN_ERROR_OVERRUN | PCAN_ERROR_QOVERRUN |
                    PCAN_ERROR_XMTFULL | PCAN_ERROR_QXMTFULL)))
             return pcan_error(sts);
         // update status-register (some are latched)
-        can[handle].status.bus_off = ((sts & PCAN_ERROR_BUSOFF) != PCAN_ERROR_OK) ? 1 : 0;
-        can[handle].status.bus_error = can[handle].error.lec ? 1 : 0;  // last eror code from error code capture (ECC)
-        can[handle].status.warning_level = ((sts & (PCAN_ERROR_BUSWARNING/*PCAN_ERROR_BUSHEAVY*/)) != PCAN_ERROR_OK) ? 1 : 0;
-        can[handle].status.transmitter_busy |= ((sts & (PCAN_ERROR_XMTFULL | PCAN_ERROR_QXMTFULL)) != PCAN_ERROR_OK) ? 1 : 0;
-        can[handle].status.message_lost |= ((sts & PCAN_ERROR_OVERRUN) != PCAN_ERROR_OK) ? 1 : 0;
-        can[handle].status.queue_overrun |= ((sts & PCAN_ERROR_QOVERRUN) != PCAN_ERROR_OK) ? 1 : 0;
+        PUT_STATUS(handle, CANSTAT_BOFF, (sts & PCAN_ERROR_BUSOFF) != PCAN_ERROR_OK);
+        PUT_STATUS(handle, CANSTAT_BERR, SLOT(handle)->can.error.lec); // last eror code from error code capture (ECC)
+        PUT_STATUS(handle, CANSTAT_EWRN, (sts & (PCAN_ERROR_BUSWARNING/*PCAN_ERROR_BUSHEAVY*/)) != PCAN_ERROR_OK);
+        if ((sts & (PCAN_ERROR_XMTFULL | PCAN_ERROR_QXMTFULL)) != PCAN_ERROR_OK)
+            SET_STATUS(handle, CANSTAT_TX_BUSY);
+        if ((sts & PCAN_ERROR_OVERRUN) != PCAN_ERROR_OK)
+            SET_STATUS(handle, CANSTAT_MSG_LST);
+        if ((sts & PCAN_ERROR_QOVERRUN) != PCAN_ERROR_OK)
+            SET_STATUS(handle, CANSTAT_QUE_OVR);
     }
     if (status)                         // status-register
-        *status = can[handle].status.byte;
+        *status = GET_STATUS(handle);
     return CANERR_NOERROR;
 }
 
 EXPORT
 int can_busload(int handle, uint8_t *load, uint8_t *status)
 {
-    int rc = CANERR_FATAL;              // return value
-    float busLoad = 0.0;                // bus-load (in [percent])
+    uint16_t busLoad = 0U;              // bus-load (in [0.01 percent])
+    int rc;                             // return value
 
     if (!init)                          // must be initialized
         return CANERR_NOTINIT;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
         return CANERR_HANDLE;
+    LOCK_SHARED(handle);
+    rc = get_busload(handle, &busLoad, status);
+    UNLOCK(handle);
+    if (load)                           // bus-load (in [percent], rounded)
+        *load = (uint8_t)((busLoad + 50U) / 100U);
+    return rc;
+}
+
+static int get_busload(int handle, uint16_t *load, uint8_t *status)
+{
+    int rc = CANERR_FATAL;              // return value
+    uint16_t busLoad = 0U;              // bus-load (in [0.01 percent])
+
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
 
-    if (!can[handle].status.can_stopped) { // if running get bus load
-        (void)busLoad; //  TODO: measure bus load
+    if (!(GET_STATUS(handle) & CANSTAT_RESET)) { // if running get bus load
+        busLoad = busload_get(handle);  //   from the frames seen
     }
-    if (load)                           // bus-load (in [percent])
-        *load = (uint8_t)busLoad;
+    if (load)                           // bus-load (in [0.01 percent])
+        *load = busLoad;
     // get status-register from device
-    rc = can_status(handle, status);
+    rc = get_status(handle, status);
 #if (OPTION_CANAPI_RETVALS == OPTION_DISABLED)
     if (rc == CANERR_NOERROR)
-        rc = !can[handle].status.can_stopped ? CANERR_NOERROR : CANERR_OFFLINE;
+        rc = !(GET_STATUS(handle) & CANSTAT_RESET) ? CANERR_NOERROR : CANERR_OFFLINE;
 #else
     // note: can_busload shall return CANERR_NOERROR if
     //       the CAN controller has not been started
@@ -976,6 +1545,20 @@ int can_busload(int handle, uint8_t *load, uint8_t *status)
 
 EXPORT
 int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
+{
+    int rc;                             // return value
+
+    if (!init)                          // must be initialized
+        return CANERR_NOTINIT;
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
+        return CANERR_HANDLE;
+    LOCK_SHARED(handle);
+    rc = get_bitrate(handle, bitrate, speed);
+    UNLOCK(handle);
+    return rc;
+}
+
+static int get_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
 {
     int rc = CANERR_FATAL;              // return value
     can_bitrate_t tmpBitrate;           // bit-rate settings
@@ -989,23 +1572,19 @@ int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
     memset(&tmpBitrate, 0, sizeof(can_bitrate_t));
     memset(&tmpSpeed, 0, sizeof(can_speed_t));
 
-    if (!init)                          // must be initialized
-        return CANERR_NOTINIT;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
-        return CANERR_HANDLE;
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return CANERR_HANDLE;
 
     // get bit-rate settings from device
-    if (!can[handle].mode.fdoe) {       // CAN 2.0: read BTR0BTR1 register
-        if ((sts = CAN_GetValue(can[handle].board, PCAN_BITRATE_INFO,
+    if (!SLOT(handle)->can.mode.fdoe) { // CAN 2.0: read BTR0BTR1 register
+        if ((sts = CAN_GetValue(SLOT(handle)->can.board, PCAN_BITRATE_INFO,
                                (void*)&btr0btr1, sizeof(TPCANBaudrate))) != PCAN_ERROR_OK)
             return pcan_error(sts);
         if ((rc = btr_sja10002bitrate(btr0btr1, &tmpBitrate)) == CANERR_NOERROR)
             rc = btr_bitrate2speed(&tmpBitrate, &tmpSpeed);
     }
     else {                              // CAN FD: read PCAN bit-rate string
-        if ((sts = CAN_GetValue(can[handle].board, PCAN_BITRATE_INFO_FD,
+        if ((sts = CAN_GetValue(SLOT(handle)->can.board, PCAN_BITRATE_INFO_FD,
                                (void*)string, PCAN_MAX_BUFFER_SIZE)) != PCAN_ERROR_OK)
             return pcan_error(sts);
         if ((rc = btr_string2bitrate(string, &tmpBitrate, &data, &sam)) == CANERR_NOERROR)
@@ -1018,7 +1597,7 @@ int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
         memcpy(speed, &tmpSpeed, sizeof(can_speed_t));
 #if (OPTION_CANAPI_RETVALS == OPTION_DISABLED)
     if (rc == CANERR_NOERROR)
-        rc = !can[handle].status.can_stopped ? CANERR_NOERROR : CANERR_OFFLINE;
+        rc = !(GET_STATUS(handle) & CANSTAT_RESET) ? CANERR_NOERROR : CANERR_OFFLINE;
 #else
     // note: can_bitrate shall return CANERR_NOERROR if
     //       the CAN controller has not been started
@@ -1029,40 +1608,58 @@ int can_bitrate(int handle, can_bitrate_t *bitrate, can_speed_t *speed)
 EXPORT
 int can_property(int handle, uint16_t param, void *value, uint32_t nbyte)
 {
-    if (!init || !IS_HANDLE_VALID(handle)) {
+    int rc;                             // return value
+
+    if (!init || ((handle = handle_index(handle)) == INVALID_HANDLE)) {
         // note: library properties can be queried w/o a handle
         return lib_parameter(param, value, (size_t)nbyte);
     }
     // note: library is initialized and handle is valid
-
+    if (drv_modifier(param))            // lock the handle exclusive
+        LOCK_EXCLUSIVE(handle);         //   if the property modifies it
+    else
+        LOCK_SHARED(handle);
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
-        return CANERR_HANDLE;
-    // note: device properties must be queried with a valid handle
-    return drv_parameter(handle, param, value, (size_t)nbyte);
+        rc = CANERR_HANDLE;
+    else
+        // note: device properties must be queried with a valid handle
+        rc = drv_parameter(handle, param, value, (size_t)nbyte);
+    UNLOCK(handle);
+    return rc;
 }
 
 EXPORT
 char *can_hardware(int handle)
 {
-    static char hardware[CANPROP_MAX_BUFFER_SIZE+1] = "";
-    char str[MAX_LENGTH_HARDWARE_NAME] = "", *ptr = NULL;
-    DWORD dev = 0x0000ul;               // device number
+    char *ptr;                          // return value
 
     if (!init)                          // must be initialized
         return NULL;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
         return NULL;
+    LOCK_SHARED(handle);
+    ptr = get_hardware(handle);
+    UNLOCK(handle);
+    return ptr;
+}
+
+static char *get_hardware(int handle)
+{
+    static char hardware[CANPROP_MAX_BUFFER_SIZE+1] = "";
+    char str[MAX_LENGTH_HARDWARE_NAME] = "", *ptr = NULL;
+    DWORD dev = 0x0000ul;               // device number
+
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return NULL;
 
     // return hardware version (zero-terminated string)
-    if (CAN_GetValue(can[handle].board, PCAN_HARDWARE_NAME, (void*)str, MAX_LENGTH_HARDWARE_NAME) != PCAN_ERROR_OK)
+    if (CAN_GetValue(SLOT(handle)->can.board, PCAN_HARDWARE_NAME, (void*)str, MAX_LENGTH_HARDWARE_NAME) != PCAN_ERROR_OK)
         return NULL;
     if ((ptr = strchr(str, '\n')) != NULL)
        *ptr = '\0';
-    if (PCAN_BOARD_TYPE(can[handle].board) == PCAN_USB) {
+    if (PCAN_BOARD_TYPE(SLOT(handle)->can.board) == PCAN_USB) {
         // get device id. from device (USB only!)
-        if (CAN_GetValue(can[handle].board, PCAN_DEVICE_ID, (void*)&dev, sizeof(DWORD)) != PCAN_ERROR_OK)
+        if (CAN_GetValue(SLOT(handle)->can.board, PCAN_DEVICE_ID, (void*)&dev, sizeof(DWORD)) != PCAN_ERROR_OK)
             return NULL;
         snprintf(hardware, CANPROP_MAX_BUFFER_SIZE, "%s, Device-Id. %02Xh", str, dev);
     }
@@ -1076,14 +1673,24 @@ char *can_hardware(int handle)
 EXPORT
 char *can_firmware(int handle)
 {
-    static char firmware[CANPROP_MAX_BUFFER_SIZE+1] = "";
-    char str[MAX_LENGTH_HARDWARE_NAME] = "", *ptr = NULL;
-    char ver[MAX_LENGTH_VERSION_STRING] = "";
+    char *ptr;                          // return value
 
     if (!init)                          // must be initialized
         return NULL;
-    if (!IS_HANDLE_VALID(handle))       // must be a valid handle
+    if ((handle = handle_index(handle)) == INVALID_HANDLE)  // must be a valid handle
         return NULL;
+    LOCK_SHARED(handle);
+    ptr = get_firmware(handle);
+    UNLOCK(handle);
+    return ptr;
+}
+
+static char *get_firmware(int handle)
+{
+    static char firmware[CANPROP_MAX_BUFFER_SIZE+1] = "";
+    char str[MAX_LENGTH_HARDWARE_NAME] = "", *ptr = NULL;
+    char ver[MAX_LENGTH_VERSION_STRING] = "";
+
     if (!IS_HANDLE_OPENED(handle))      // must be an open handle
         return NULL;
 
@@ -1091,11 +1698,11 @@ char *can_firmware(int handle)
 #ifndef PCAN_EXT_HARDWARE_VERSION
     // TODO: activate this code snippet once parameter PCAN_FIRMWARE_VERSION is realized
     //       if so, don't forget to update the compatibility check!
-    if (CAN_GetValue(can[handle].board, PCAN_HARDWARE_NAME, (void*)str, MAX_LENGTH_HARDWARE_NAME) != PCAN_ERROR_OK)
+    if (CAN_GetValue(SLOT(handle)->can.board, PCAN_HARDWARE_NAME, (void*)str, MAX_LENGTH_HARDWARE_NAME) != PCAN_ERROR_OK)
         return NULL;
     if ((ptr = strchr(str, '\n')) != NULL)
         *ptr = '\0';
-    if (CAN_GetValue(can[handle].board, PCAN_FIRMWARE_VERSION, (void*)ver, MAX_LENGTH_VERSION_STRING) != PCAN_ERROR_OK)
+    if (CAN_GetValue(SLOT(handle)->can.board, PCAN_FIRMWARE_VERSION, (void*)ver, MAX_LENGTH_VERSION_STRING) != PCAN_ERROR_OK)
         return NULL;
     strncpy(firmware, str, CANPROP_MAX_BUFFER_SIZE);
     firmware[CANPROP_MAX_BUFFER_SIZE] = '\0';
@@ -1104,7 +1711,7 @@ char *can_firmware(int handle)
     strncat(firmware, ver, CANPROP_MAX_BUFFER_SIZE);
     firmware[CANPROP_MAX_BUFFER_SIZE] = '\0';
 #else
-    if(CAN_GetValue(can[handle].board, PCAN_EXT_HARDWARE_VERSION, (void*)ver, 256) != PCAN_ERROR_OK)
+    if(CAN_GetValue(SLOT(handle)->can.board, PCAN_EXT_HARDWARE_VERSION, (void*)ver, 256) != PCAN_ERROR_OK)
         return NULL;
     (void)str;
     (void)ptr;
@@ -1120,26 +1727,11 @@ static void var_init(void)
 {
     int i;
 
-    for (i = 0; i < CAN_MAX_HANDLES; i++) {
-        memset(&can[i], 0, sizeof(can_interface_t));
-        can[i].board = PCAN_NONEBUS;
-        can[i].brd_type = 0u;
-        can[i].brd_port = 0u;
-        can[i].brd_irq = 0u;
-#if defined(_WIN32) || defined(_WIN64)
-        can[i].event = NULL;
-#else
-        can[i].fdes = -1;
-#endif
-        can[i].mode.byte = CANMODE_DEFAULT;
-        can[i].status.byte = CANSTAT_RESET;
-        can[i].filter.mode = FILTER_OFF;
-        can[i].error.lec = 0x00u;
-        can[i].error.rx_err = 0u;
-        can[i].error.tx_err = 0u;
-        can[i].counters.tx = 0ull;
-        can[i].counters.rx = 0ull;
-        can[i].counters.err = 0ull;
+    can_free = INVALID_HANDLE;          // all slots unused (lowest first)
+    for (i = can_capacity - 1; i >= 0; i--) {
+        handle_reset(i);
+        SLOT(i)->next = can_free;
+        can_free = i;
     }
 }
 
@@ -1149,73 +1741,1813 @@ static int all_closed(void)
 
     if (!init)
         return 1;
-    for (handle = 0; handle < CAN_MAX_HANDLES; handle++) {
+    for (handle = 0; handle < can_capacity; handle++) {
         if (IS_HANDLE_OPENED(handle))
             return 0;
     }
     return 1;
 }
 
-static void can_message(const TPCANMsg *pcan_msg, can_message_t *msg)
+static int handle_index(int handle)
 {
-    assert(msg);
-    assert(pcan_msg);
-    msg->id = (int32_t)pcan_msg->ID;
-    msg->xtd = (pcan_msg->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? 1 : 0;
-    msg->rtr = (pcan_msg->MSGTYPE & PCAN_MESSAGE_RTR) ? 1 : 0;
-    msg->fdf = 0;
-    msg->brs = 0;
-    msg->esi = 0;
-    msg->sts = 0;
-    msg->dlc = (uint8_t)pcan_msg->LEN;
-    memcpy(msg->data, pcan_msg->DATA, CAN_MAX_LEN);
+    int index = HANDLE_INDEX(handle);   // slot index
+
+    /* note: a handle is valid if its slot exists and it is of the current
+     *       generation of the slot (the generation changes when the handle
+     *       is closed, so that stale handles are rejected after reuse) */
+    if ((handle < 0) || (index >= __atomic_load_n(&can_capacity, __ATOMIC_ACQUIRE)) ||
+        (__atomic_load_n(&SLOT(index)->generation, __ATOMIC_RELAXED) != HANDLE_GENERATION(handle)))
+        return INVALID_HANDLE;
+    return index;
 }
 
-static void can_message_fd(const TPCANMsgFD *pcan_msg, can_message_t *msg)
+static int handle_free(void)
 {
-    assert(msg);
-    assert(pcan_msg);
-    msg->id = (int32_t)pcan_msg->ID;
-    msg->xtd = (pcan_msg->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? 1 : 0;
-    msg->rtr = (pcan_msg->MSGTYPE & PCAN_MESSAGE_RTR) ? 1 : 0;
-    msg->fdf = (pcan_msg->MSGTYPE & PCAN_MESSAGE_FD) ? 1 : 0;
-    msg->brs = (pcan_msg->MSGTYPE & PCAN_MESSAGE_BRS) ? 1 : 0;
-    msg->esi = 0;  // FIXME: ESI?
-    msg->sts = 0;
-    msg->dlc = (uint8_t)pcan_msg->DLC;
-    memcpy(msg->data, pcan_msg->DATA, CANFD_MAX_LEN);
+    can_slot_t *chunk;                  // new chunk of slots
+    int i;                              // loop variable
+
+    /* note: the caller holds the table lock */
+    if (can_free != INVALID_HANDLE)     // unused slot available
+        return can_free;
+    if (can_capacity >= (HANDLE_CHUNKS * HANDLE_CHUNK))
+        return INVALID_HANDLE;          // maximum number of handles reached
+    // grow the handle table by a chunk of slots (the slots are never moved)
+    if (posix_memalign((void**)&chunk, CACHE_LINE, HANDLE_CHUNK * sizeof(can_slot_t)) != 0)
+        return INVALID_HANDLE;
+    memset(chunk, 0, HANDLE_CHUNK * sizeof(can_slot_t));
+    for (i = 0; i < HANDLE_CHUNK; i++) {
+        (void)pthread_rwlock_init(&chunk[i].lock.state, NULL);
+        (void)pthread_mutex_init(&chunk[i].lock.reader, NULL);
+        (void)pthread_mutex_init(&chunk[i].lock.writer, NULL);
+        (void)pthread_mutex_init(&chunk[i].lock.busload, NULL);
+        chunk[i].signal.fdes[0] = chunk[i].signal.fdes[1] = -1;
+        chunk[i].ring.event[0] = chunk[i].ring.event[1] = -1;
+        chunk[i].ring.quit[0] = chunk[i].ring.quit[1] = -1;
+        chunk[i].next = (i < (HANDLE_CHUNK - 1)) ? (can_capacity + i + 1) : INVALID_HANDLE;
+    }
+    can_table[can_capacity / HANDLE_CHUNK] = chunk;
+    for (i = 0; i < HANDLE_CHUNK; i++)
+        handle_reset(can_capacity + i);
+    can_free = can_capacity;
+    __atomic_store_n(&can_capacity, can_capacity + HANDLE_CHUNK, __ATOMIC_RELEASE);
+    return can_free;
+}
+
+static void handle_reset(int index)
+{
+    memset(&SLOT(index)->can, 0, sizeof(can_interface_t));
+    SLOT(index)->can.board = PCAN_NONEBUS;
+    SLOT(index)->can.brd_type = 0u;
+    SLOT(index)->can.brd_port = 0u;
+    SLOT(index)->can.brd_irq = 0u;
+#if defined(_WIN32) || defined(_WIN64)
+    SLOT(index)->can.event = NULL;
+#else
+    SLOT(index)->can.fdes = -1;
+#endif
+    SLOT(index)->can.mode.byte = CANMODE_DEFAULT;
+    SLOT(index)->can.status.byte = CANSTAT_RESET;
+    SLOT(index)->can.filter.mode = FILTER_OFF;
+    SLOT(index)->can.error.lec = 0x00u;
+    SLOT(index)->can.error.rx_err = 0u;
+    SLOT(index)->can.error.tx_err = 0u;
+    SLOT(index)->can.counters.tx = 0ull;
+    SLOT(index)->can.counters.rx = 0ull;
+    SLOT(index)->can.counters.err = 0ull;
+    SLOT(index)->can.receive.spin = 0U;
+    SLOT(index)->can.receive.spun = 0ull;
+    SLOT(index)->can.receive.blocked = 0ull;
+    SLOT(index)->can.transmit.ovfl = 0ull;
+    SLOT(index)->can.share = NULL;
 }
 
-static void can_message_sts(can_status_t status, can_error_t error, can_message_t *msg)
+static int check_message(int handle, const can_message_t *msg)
 {
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
     assert(msg);
-    msg->id = (int32_t)0;
-    msg->xtd = 0;
-    msg->rtr = 0;
-    msg->fdf = 0;
-    msg->brs = 0;
-    msg->esi = 0;
-    msg->sts = 1;
-    msg->dlc = (uint8_t)4;
-    msg->data[0] = (uint8_t)status.byte;
-    msg->data[1] = (uint8_t)error.lec;
-    msg->data[2] = (uint8_t)error.rx_err;
-    msg->data[4] = (uint8_t)error.tx_err;
+
+    if (msg->id > (uint32_t)(msg->xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID))
+        return CANERR_ILLPARA;          // invalid identifier
+    if (msg->xtd && SLOT(handle)->can.mode.nxtd)
+        return CANERR_ILLPARA;          // suppress extended frames
+    if (msg->rtr && SLOT(handle)->can.mode.nrtr)
+        return CANERR_ILLPARA;          // suppress remote frames
+    if (msg->fdf && !SLOT(handle)->can.mode.fdoe)
+        return CANERR_ILLPARA;          // long frames only with CAN FD
+    if (msg->brs && !SLOT(handle)->can.mode.brse)
+        return CANERR_ILLPARA;          // fast frames only with CAN FD
+    if (msg->brs && !msg->fdf)
+        return CANERR_ILLPARA;          // bit-rate switching only with CAN FD
+    if (msg->sts)
+        return CANERR_ILLPARA;          // error frames cannot be sent
+    if (msg->dlc > (uint8_t)(!SLOT(handle)->can.mode.fdoe ? CAN_MAX_LEN : CANFD_MAX_DLC))
+        return CANERR_ILLPARA;          // data length 0 .. 8 resp. 0 .. 0Fh
+    return CANERR_NOERROR;
 }
 
-static void can_timestamp(TPCANTimestamp timestamp, can_message_t *msg)
+FAST_PATH int write_frames(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout, const int fdoe)
+{
+    TPCANStatus sts = PCAN_ERROR_OK;    // represents a status
+    TPCANMsg can_msg;                   // the message (CAN 2.0)
+    TPCANMsgFD can_msg_fd;              // the message (CAN FD)
+    const can_message_t *msg;           // the message (CAN API)
+    unsigned int generation = __atomic_load_n(&SLOT(handle)->generation, __ATOMIC_RELAXED);  // generation of the handle
+    can_share_t *share = SLOT(handle)->can.share; // shared channel (or NULL)
+    unsigned int signals = GET_SIGNAL(handle);  // wake-up signals sent so far
+    uint64_t deadline = 0U;             // end of the wait (monotonic clock)
+    uint64_t backoff = 0U;              // time to wait when the queue is full
+    uint64_t busy = 0U;                 // bus time of the messages [ps]
+    uint64_t start;                     // start of the call (instrumentation)
+    size_t n;                           // number of messages sent
+    int rc = CANERR_NOERROR;            // return value
+
+    /* note: the caller holds the handle lock (shared) and the writer lock */
+    /* note: 'fdoe' is a constant in the instances below, so that the message
+     *       conversion compiles to straight-line code for each operation mode */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(buffer || !count);
+    assert(sent);
+
+    /* note: the messages have been checked by the caller */
+    for (n = 0U; n < count; n++) {
+        msg = &buffer[n];
+        if (!fdoe) {
+            if (msg->xtd)               //   29-bit identifier
+                can_msg.MSGTYPE = PCAN_MESSAGE_EXTENDED;
+            else                        //   11-bit identifier
+                can_msg.MSGTYPE = PCAN_MESSAGE_STANDARD;
+            if (msg->rtr)               //   request a message
+                can_msg.MSGTYPE |= PCAN_MESSAGE_RTR;
+            can_msg.ID = (DWORD)(msg->id);
+            can_msg.LEN = (BYTE)(msg->dlc);
+            memcpy(can_msg.DATA, msg->data, msg->dlc);
+        }
+        else {
+            if (msg->xtd)               //   29-bit identifier
+                can_msg_fd.MSGTYPE = PCAN_MESSAGE_EXTENDED;
+            else                        //   11-bit identifier
+                can_msg_fd.MSGTYPE = PCAN_MESSAGE_STANDARD;
+            if (msg->rtr)               //   request a message
+                can_msg_fd.MSGTYPE |= PCAN_MESSAGE_RTR;
+            if (msg->fdf)               //   CAN FD format
+                can_msg_fd.MSGTYPE |= PCAN_MESSAGE_FD;
+            if (msg->brs)               //   bit-rate switching (if enabled)
+                can_msg_fd.MSGTYPE |= SLOT(handle)->can.path.brs;
+            can_msg_fd.ID = (DWORD)(msg->id);
+            can_msg_fd.DLC = (BYTE)(msg->dlc);
+            memcpy(can_msg_fd.DATA, msg->data, DLC2LEN(msg->dlc));
+        }
+        // transmit the message (wait and retry while the transmit queue is full)
+        for (;;) {
+            start = INSTRUMENTED(handle) ? poll_clock() : 0U;
+            if (share)                  //   merge the writers of a shared channel
+                (void)pthread_mutex_lock(&share->writer);
+            if (!fdoe)
+                sts = CAN_Write(SLOT(handle)->can.board, &can_msg);
+            else
+                sts = CAN_WriteFD(SLOT(handle)->can.board, &can_msg_fd);
+            if (share)
+                (void)pthread_mutex_unlock(&share->writer);
+            if (start)
+                instrument_add(&SLOT(handle)->can.instrument.write, poll_clock() - start);
+            if (!(sts & (PCAN_ERROR_QXMTFULL | PCAN_ERROR_XMTFULL)) || (timeout == 0U))
+                break;
+            if (backoff == 0U) {        //   first time: calculate the deadline
+                deadline = poll_clock();
+                deadline = (timeout != CANWAIT_INFINITE) ? deadline + TIMEOUT_NS(timeout) : CANWAIT_INFINITE_NS;
+                backoff = TX_BACKOFF_MIN;
+            }
+            if ((rc = write_wait(handle, generation, signals, deadline, &backoff)) != CANERR_NOERROR)
+                break;
+        }
+        if ((sts != PCAN_ERROR_OK) || (rc != CANERR_NOERROR))
+            break;
+        if (!fdoe)
+            busy += busload_frame(handle, can_msg.ID, can_msg.MSGTYPE, can_msg.LEN, can_msg.DATA);
+        else
+            busy += busload_frame(handle, can_msg_fd.ID, can_msg_fd.MSGTYPE, can_msg_fd.DLC, can_msg_fd.DATA);
+    }
+    // check for errors
+    if ((sts != PCAN_ERROR_OK) && (rc == CANERR_NOERROR)) {
+        if ((sts & PCAN_ERROR_QXMTFULL))    // transmit queue full?
+            rc = CANERR_TX_BUSY;        //     transmitter busy
+        else if ((sts & PCAN_ERROR_XMTFULL))  // transmission pending?
+            rc = CANERR_TX_BUSY;        //     transmitter busy
+        else
+            rc = pcan_error(sts);       //   PCAN specific error
+    }
+    if ((rc == CANERR_HANDLE) || (rc == CANERR_OFFLINE)) {
+        // the handle has been closed or stopped meanwhile
+        *sent = n;
+        return rc;
+    }
+    // messages transmitted: update transmit counter (once per call)
+    if ((rc == CANERR_TX_BUSY) && (GET_SIGNAL(handle) == signals)) {
+        /* note: a write terminated by can_kill() is not a queue overflow */
+        SET_STATUS(handle, CANSTAT_TX_BUSY);
+        SLOT(handle)->can.transmit.ovfl += (uint64_t)(count - n);  //   messages rejected
+    }
+    else if (rc == CANERR_NOERROR)
+        CLR_STATUS(handle, CANSTAT_TX_BUSY);
+    SLOT(handle)->can.counters.tx += (uint64_t)n;
+    if (INSTRUMENTED(handle))
+        instrument_tx(handle, buffer, n);
+    if (busy)
+        busload_add(handle, busy);
+    *sent = n;
+    return rc;
+}
+
+#if (OPTION_PCAN_GENERIC_PATH == 0)
+static int write_messages_std(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout)
+{
+    return write_frames(handle, buffer, count, sent, timeout, 0);  // CAN 2.0
+}
+
+static int write_messages_fd(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout)
+{
+    return write_frames(handle, buffer, count, sent, timeout, 1);  // CAN FD
+}
+#else
+static int write_messages_any(int handle, const can_message_t *buffer, size_t count, size_t *sent, uint16_t timeout)
+{
+    return write_frames(handle, buffer, count, sent, timeout, SLOT(handle)->can.mode.fdoe);  // at run-time
+}
+#endif
+
+static int write_wait(int handle, unsigned int generation, unsigned int signals, uint64_t deadline, uint64_t *backoff)
+{
+    struct pollfd pfd;                  // wake-up signal
+    uint64_t now;                       // current time (monotonic clock)
+    uint64_t wait;                      // time to wait
+
+    /* note: the caller holds the handle lock (shared) and the writer lock */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(backoff);
+
+    /* note: PCANBasic has no event for free space in the transmit queue,
+     *       so we sleep with an exponential back-off (on the wake-up signal,
+     *       so that the wait can be terminated by can_kill()) */
+    if (GET_SIGNAL(handle) != signals)
+        return CANERR_TX_BUSY;          //   signaled by can_kill()
+    if ((now = poll_clock()) >= deadline)
+        return CANERR_TX_BUSY;          //   timed out
+    wait = ((deadline - now) < *backoff) ? (deadline - now) : *backoff;
+    if (*backoff < TX_BACKOFF_MAX)
+        *backoff = ((*backoff << 1) < TX_BACKOFF_MAX) ? (*backoff << 1) : TX_BACKOFF_MAX;
+    pfd.fd = SLOT(handle)->signal.fdes[0];
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    /* note: the locks are released while waiting, so that the handle
+     *       can be stopped or closed by another thread meanwhile */
+    UNLOCK_WRITER(handle);
+    UNLOCK(handle);
+    (void)poll_wait(&pfd, 1, wait);
+    LOCK_SHARED(handle);
+    LOCK_WRITER(handle);
+    // the handle could have been closed (and the slot reused) or stopped meanwhile
+    if (__atomic_load_n(&SLOT(handle)->generation, __ATOMIC_RELAXED) != generation)
+        return CANERR_HANDLE;
+    if ((GET_STATUS(handle) & CANSTAT_RESET))
+        return CANERR_OFFLINE;
+    if ((pfd.revents & POLLIN) && (GET_SIGNAL(handle) == signals))
+        event_clear(pfd.fd);            //   stale wake-up signal
+    return CANERR_NOERROR;
+}
+
+FAST_PATH int decode_frame(int handle, const pcan_message_t *pcan_msg, can_message_t *msg, can_delta_t *counters, const int fdoe)
 {
+    BYTE type;                          // message type
+    DWORD id;                           // message identifier
+    const BYTE *data;                   // message data
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(pcan_msg);
     assert(msg);
-    uint64_t msec = ((uint64_t)timestamp.millis_overflow << 32) + (uint64_t)timestamp.millis;
-    msg->timestamp.tv_sec = (time_t)(msec / 1000ull);
-    msg->timestamp.tv_nsec = ((((long)(msec % 1000ull)) * 1000L) + (long)timestamp.micros) * (long)1000;
+    assert(counters);
+
+    if (!fdoe) { // CAN 2.0 message
+        type = pcan_msg->std.msg.MSGTYPE;
+        id = pcan_msg->std.msg.ID;
+        data = pcan_msg->std.msg.DATA;
+    }
+    else {                              // CAN FD message
+        type = pcan_msg->fd.msg.MSGTYPE;
+        id = pcan_msg->fd.msg.ID;
+        data = pcan_msg->fd.msg.DATA;
+    }
+    if (!(type & (PCAN_MESSAGE_STATUS | PCAN_MESSAGE_ERRFRAME))) {
+        // bus time of the frame (also if suppressed)
+        if (!fdoe)
+            counters->busy += busload_frame(handle, id, type, pcan_msg->std.msg.LEN, data);
+        else
+            counters->busy += busload_frame(handle, id, type, pcan_msg->fd.msg.DLC, data);
+        // software acceptance filter (before the message is converted)
+        if (!accept_message(handle, id, (type & PCAN_MESSAGE_EXTENDED) ? 1 : 0))
+            return 0;
+    }
+    if ((type & SLOT(handle)->can.path.refuse))
+        return 0;                       //   refuse extended resp. remote frames
+    if ((type & PCAN_MESSAGE_STATUS)) {
+        // update status register from status frame
+        PUT_STATUS(handle, CANSTAT_BOFF, (data[3] & PCAN_ERROR_BUSOFF) != PCAN_ERROR_OK);
+        if (!fdoe)
+            PUT_STATUS(handle, CANSTAT_EWRN, (data[3] & PCAN_ERROR_BUSHEAVY) != PCAN_ERROR_OK);
+        else
+            PUT_STATUS(handle, CANSTAT_EWRN, (data[3] & PCAN_ERROR_BUSWARNING) != PCAN_ERROR_OK);
+        // refuse status message if suppressed by user
+        if (!SLOT(handle)->can.mode.err)
+            return 0;
+        // status message: ID=000h, DLC=4 (status, lec, rx errors, tx errors)
+        can_message_sts(GET_STATUS(handle), SLOT(handle)->can.error, msg);
+        counters->err++;
+    }
+    else if ((type & PCAN_MESSAGE_ERRFRAME)) {
+        // update error and status register from error frame
+        SLOT(handle)->can.error.lec = (uint8_t)id;
+        SLOT(handle)->can.error.rx_err = data[2];
+        SLOT(handle)->can.error.tx_err = data[3];
+        PUT_STATUS(handle, CANSTAT_BERR, SLOT(handle)->can.error.lec);
+        // refuse status message if suppressed by user
+        if (!SLOT(handle)->can.mode.err)
+            return 0;
+        // status message: ID=000h, DLC=4 (status, lec, rx errors, tx errors)
+        can_message_sts(GET_STATUS(handle), SLOT(handle)->can.error, msg);
+        counters->err++;
+    }
+    else if (!fdoe) {
+        // decode PEAK CAN 2.0 message and increment receive counter
+        can_message(&pcan_msg->std.msg, msg);
+        counters->rx++;
+    }
+    else {
+        // decode PEAK CAN FD message and increment receive counter
+        can_message_fd(&pcan_msg->fd.msg, msg);
+        counters->rx++;
+    }
+    // time-stamp in nanoseconds since start of Windows
+    if (!fdoe)
+        can_timestamp(pcan_msg->std.timestamp, msg);
+    else
+        can_timestamp_fd(pcan_msg->fd.timestamp, msg);
+    // or in host time (correlated with the device clock)
+    if (SLOT(handle)->can.clock.mode != PCAN_TIMESTAMP_DEVICE) {
+        uint64_t ns = clock_host(handle, ((uint64_t)msg->timestamp.tv_sec * 1000000000ULL) + (uint64_t)msg->timestamp.tv_nsec);
+        msg->timestamp.tv_sec = (time_t)(ns / 1000000000ULL);
+        msg->timestamp.tv_nsec = (long)(ns % 1000000000ULL);
+    }
+    return 1;
+}
+
+FAST_PATH int read_frames(int handle, can_message_t *buffer, size_t max, size_t *count, uint64_t timeout, const int fdoe)
+{
+    TPCANStatus sts;                    // represents a status
+    pcan_message_t pcan_msg;            // the message (CAN 2.0 or CAN FD)
+    can_delta_t counters = { 0ull, 0ull, 0ull };  // counter deltas
+    size_t n = 0U;                      // number of messages read
+    int rc = CANERR_RX_EMPTY;           // return value
+    uint64_t start;                     // start of the call (instrumentation)
+#if !defined(_WIN32) && !defined(_WIN64)
+    unsigned int generation = __atomic_load_n(&SLOT(handle)->generation, __ATOMIC_RELAXED);  // generation of the handle
+    unsigned int signals = GET_SIGNAL(handle);  // wake-up signals sent so far
+    struct pollfd pfd[2];               // receive event and wake-up signal
+    uint64_t deadline = 0U;             // end of the wait (monotonic clock)
+    uint64_t spinning = 0U;             // end of the spinning (monotonic clock)
+    uint64_t now = 0U;                  // current time (monotonic clock)
+    int waiting = 0;                    // waiting for a message (1 = spinning, 2 = blocked)
+    int ready;                          // result of poll()
+    size_t k;                           // messages from the receive ring
+#endif
+    /* note: the caller holds the handle lock (shared) and the reader lock */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(buffer);
+    assert(count);
+
+    /* note: the receive queue is drained until it is empty or the buffer is full,
+     *       the caller is blocked only as long as no message has been read yet */
+    while (n < max) {
+#if !defined(_WIN32) && !defined(_WIN64)
+        if (SLOT(handle)->ring.running) {
+            // take messages from the receive ring (decoded by the reader thread)
+            if ((k = ring_read(handle, &buffer[n], max - n)) != 0U) {
+                n += k;
+                continue;
+            }
+            if (__atomic_load_n(&SLOT(handle)->ring.error, __ATOMIC_ACQUIRE) != CANERR_NOERROR) {
+                rc = __atomic_load_n(&SLOT(handle)->ring.error, __ATOMIC_ACQUIRE);
+                break;                  //   reader thread failed
+            }
+            sts = PCAN_ERROR_QRCVEMPTY;
+        }
+        else {
+#endif
+            // try to read a message
+            start = INSTRUMENTED(handle) ? poll_clock() : 0U;
+            if (!fdoe)
+                sts = CAN_Read(SLOT(handle)->can.board, &pcan_msg.std.msg, &pcan_msg.std.timestamp);
+            else
+                sts = CAN_ReadFD(SLOT(handle)->can.board, &pcan_msg.fd.msg, &pcan_msg.fd.timestamp);
+            if (start)
+                instrument_add(&SLOT(handle)->can.instrument.read, poll_clock() - start);
+#if !defined(_WIN32) && !defined(_WIN64)
+        }
+        if ((sts == PCAN_ERROR_QRCVEMPTY) && (n == 0U) && (timeout != 0U)) {
+            // blocking read (via system call ppoll() resp. poll())
+            if (!waiting) {
+                pfd[0].fd = RX_EVENT(handle);
+                pfd[0].events = POLLIN;
+                pfd[1].fd = SLOT(handle)->signal.fdes[0];
+                pfd[1].events = POLLIN;
+                now = poll_clock();
+                if (timeout != CANWAIT_INFINITE_NS)
+                    deadline = (timeout < (CANWAIT_INFINITE_NS - now)) ? (now + timeout) : CANWAIT_INFINITE_NS;
+                spinning = now + (uint64_t)SLOT(handle)->can.receive.spin;
+                waiting = 1;
+            }
+            if (GET_SIGNAL(handle) != signals)
+                break;                  //   signaled by can_kill()
+            now = poll_clock();
+            if ((timeout != CANWAIT_INFINITE_NS) && (now >= deadline))
+                break;                  //   timed out
+            if (now < spinning) {
+                /* note: busy-polling within the spin budget (w/o releasing the locks) */
+                SPIN_PAUSE();
+                continue;
+            }
+            waiting = 2;
+            pfd[0].revents = 0;
+            pfd[1].revents = 0;
+            /* note: the locks are released while waiting, so that the handle
+             *       can be stopped or closed by another thread meanwhile */
+            UNLOCK_READER(handle);
+            UNLOCK(handle);
+            ready = poll_wait(pfd, 2, (timeout != CANWAIT_INFINITE_NS) ? (deadline - now) : CANWAIT_INFINITE_NS);
+            LOCK_SHARED(handle);
+            LOCK_READER(handle);
+            // the handle could have been closed (and the slot reused) or stopped meanwhile
+            if (__atomic_load_n(&SLOT(handle)->generation, __ATOMIC_RELAXED) != generation) {
+                *count = 0U;
+                return CANERR_HANDLE;
+            }
+            if ((GET_STATUS(handle) & CANSTAT_RESET)) {
+                *count = 0U;
+                return CANERR_OFFLINE;
+            }
+            if (INSTRUMENTED(handle))  // time blocked on the receive event
+                instrument_add(&SLOT(handle)->can.instrument.wait, poll_clock() - now);
+            if ((ready > 0) && (pfd[1].revents & POLLIN) && (GET_SIGNAL(handle) == signals))
+                event_clear(pfd[1].fd);  //   stale wake-up signal
+            if (ready > 0)
+                continue;
+            // timed out or poll() failed
+            break;
+        }
+#endif
+        // check for errors
+        if ((sts & PCAN_ERROR_OVERRUN)) {
+            SET_STATUS(handle, CANSTAT_MSG_LST);
+            /* note: at least one message got lost, but we have a message */
+        }
+        if ((sts & PCAN_ERROR_QOVERRUN)) {
+            SET_STATUS(handle, CANSTAT_QUE_OVR);
+            /* note: queue has overrun, but we have a message */
+        }
+        if ((sts & PCAN_ERROR_QRCVEMPTY)) {  // receice queue empty?
+            if ((sts & 0xFF00u))  // TODO: explain this
+                rc = pcan_error(sts);   //   something went wrong
+            break;
+        }
+        // convert PCAN message to CAN API message (if not suppressed)
+        if (decode_frame(handle, &pcan_msg, &buffer[n], &counters, fdoe))
+            n++;
+    }
+    // update counters and status register (once per call)
+    /* note: the counters are also updated by the reader thread of a receive
+     *       ring or of a shared channel, so they are added atomically */
+    if (counters.rx)
+        (void)__atomic_add_fetch(&SLOT(handle)->can.counters.rx, counters.rx, __ATOMIC_RELAXED);
+    if (counters.err)
+        (void)__atomic_add_fetch(&SLOT(handle)->can.counters.err, counters.err, __ATOMIC_RELAXED);
+    if (counters.busy)
+        busload_add(handle, counters.busy);
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (waiting == 1)                   // received while spinning
+        SLOT(handle)->can.receive.spun += (uint64_t)n;
+    else if (waiting == 2)              // received after blocking
+        SLOT(handle)->can.receive.blocked += (uint64_t)n;
+#endif
+    if (INSTRUMENTED(handle) && n)
+        instrument_rx(handle, buffer, n);
+    PUT_STATUS(handle, CANSTAT_RX_EMPTY, n == 0U);
+    *count = n;
+    return (n != 0U) ? CANERR_NOERROR : rc;
+}
+
+#if (OPTION_PCAN_GENERIC_PATH == 0)
+static int read_messages_std(int handle, can_message_t *buffer, size_t max, size_t *count, uint64_t timeout)
+{
+    return read_frames(handle, buffer, max, count, timeout, 0);  // CAN 2.0
+}
+
+static int read_messages_fd(int handle, can_message_t *buffer, size_t max, size_t *count, uint64_t timeout)
+{
+    return read_frames(handle, buffer, max, count, timeout, 1);  // CAN FD
+}
+#else
+static int read_messages_any(int handle, can_message_t *buffer, size_t max, size_t *count, uint64_t timeout)
+{
+    return read_frames(handle, buffer, max, count, timeout, SLOT(handle)->can.mode.fdoe);  // at run-time
+}
+#endif
+
+static void path_select(int handle)
+{
+    can_path_t *path = &SLOT(handle)->can.path;  // fast path of the handle
+
+    /* note: the caller holds the handle lock (exclusive) and the operation
+     *       mode cannot be changed while the CAN controller is started */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    // the mode flags are evaluated once per start and not per message
+    path->refuse = 0x00U;
+    if (SLOT(handle)->can.mode.nxtd)    // suppress extended frames
+        path->refuse |= PCAN_MESSAGE_EXTENDED;
+    if (SLOT(handle)->can.mode.nrtr)    // suppress remote frames
+        path->refuse |= PCAN_MESSAGE_RTR;
+    path->brs = SLOT(handle)->can.mode.brse ? PCAN_MESSAGE_BRS : 0x00U;
+#if (OPTION_PCAN_GENERIC_PATH != 0)
+    /* note: the operation mode is evaluated per call (to benchmark the fast paths) */
+    path->read = read_messages_any;
+    path->write = write_messages_any;
+    path->drain = ring_drain_any;
+#else
+    if (!SLOT(handle)->can.mode.fdoe) {  // CAN 2.0 operation mode
+        path->read = read_messages_std;
+        path->write = write_messages_std;
+        path->drain = ring_drain_std;
+    }
+    else {                              // CAN FD operation mode
+        path->read = read_messages_fd;
+        path->write = write_messages_fd;
+        path->drain = ring_drain_fd;
+    }
+#endif
+}
+
+#if defined(__linux__)
+static void wait_set_free(void *ptr)
+{
+    can_wait_set_t *set = (can_wait_set_t*)ptr;
+
+    if (set) {                          // close the epoll set of a thread
+        if (set->epfd != -1)
+            (void)close(set->epfd);
+        free(set);
+    }
+}
+
+static void wait_key_create(void)
+{
+    (void)pthread_key_create(&wait_key, wait_set_free);
+}
+#endif
+
+static int wait_events(const int *fdes, const int *sigs, int n, uint32_t *ready, uint32_t *signaled, uint16_t timeout)
+{
+#if defined(__linux__)
+    struct epoll_event events[2 * WAIT_MAX_HANDLES];
+    struct epoll_event event;           // event to register
+    can_wait_set_t *set;                // epoll set of the calling thread
+    unsigned int generation;            // generation of the handle table
+    int i, k;                           // loop variables
+
+    assert(fdes);                       // just to make sure
+    assert(sigs);
+    assert(ready);
+    assert(signaled);
+    assert((0 < n) && (n <= WAIT_MAX_HANDLES));
+
+    /* note: the epoll set is cached per thread and reused as long as the same
+     *       handles are waited for and no handle has been started or closed */
+    (void)pthread_once(&wait_once, wait_key_create);
+    if ((set = (can_wait_set_t*)pthread_getspecific(wait_key)) == NULL) {
+        if ((set = (can_wait_set_t*)calloc(1U, sizeof(can_wait_set_t))) == NULL)
+            return CANERR_RESOURCE;
+        set->epfd = -1;
+        if (pthread_setspecific(wait_key, (void*)set) != 0) {
+            free(set);
+            return CANERR_RESOURCE;
+        }
+    }
+    generation = __atomic_load_n(&wait_generation, __ATOMIC_ACQUIRE);
+    if ((set->epfd == -1) || (set->generation != generation) ||
+        (set->n != n) || memcmp(set->fdes, fdes, (size_t)n * sizeof(int)) ||
+        memcmp(set->sigs, sigs, (size_t)n * sizeof(int))) {
+        // (re-)build the epoll set
+        if (set->epfd != -1)
+            (void)close(set->epfd);
+        set->n = 0;
+        if ((set->epfd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+            set->epfd = -1;
+            return SYSERR_OFFSET - errno;
+        }
+        for (i = 0; i < n; i++) {
+            memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;     //   level-triggered
+            event.data.u32 = (uint32_t)i;
+            if (epoll_ctl(set->epfd, EPOLL_CTL_ADD, fdes[i], &event) < 0) {
+                (void)close(set->epfd);
+                set->epfd = -1;
+                return SYSERR_OFFSET - errno;
+            }
+            event.data.u32 = (uint32_t)(WAIT_MAX_HANDLES + i);
+            if (epoll_ctl(set->epfd, EPOLL_CTL_ADD, sigs[i], &event) < 0) {
+                (void)close(set->epfd);
+                set->epfd = -1;
+                return SYSERR_OFFSET - errno;
+            }
+            set->fdes[i] = fdes[i];
+            set->sigs[i] = sigs[i];
+        }
+        set->n = n;
+        set->generation = generation;
+    }
+    // wait for events (via system call epoll_wait())
+    if ((k = epoll_wait(set->epfd, events, 2 * n, (timeout != CANWAIT_INFINITE) ? (int)timeout : -1)) < 0) {
+        if (errno != EINTR)
+            return SYSERR_OFFSET - errno;
+        *ready = *signaled = 0x00000000U;  // interrupted: the caller
+        return CANERR_NOERROR;          //   waits for the remaining time
+    }
+    for (i = 0, *ready = *signaled = 0x00000000U; i < k; i++) {
+        if (events[i].data.u32 < (uint32_t)WAIT_MAX_HANDLES)
+            *ready |= (uint32_t)1 << events[i].data.u32;
+        else
+            *signaled |= (uint32_t)1 << (events[i].data.u32 - (uint32_t)WAIT_MAX_HANDLES);
+    }
+#else
+    struct pollfd pfd[2 * WAIT_MAX_HANDLES];
+    int i, k;                           // loop variables
+
+    assert(fdes);                       // just to make sure
+    assert(sigs);
+    assert(ready);
+    assert(signaled);
+    assert((0 < n) && (n <= WAIT_MAX_HANDLES));
+
+    for (i = 0; i < n; i++) {
+        pfd[i].fd = fdes[i];
+        pfd[i].events = POLLIN;
+        pfd[i].revents = 0;
+        pfd[n + i].fd = sigs[i];
+        pfd[n + i].events = POLLIN;
+        pfd[n + i].revents = 0;
+    }
+    // wait for events (via system call poll())
+    if ((k = poll(pfd, (nfds_t)(2 * n), (timeout != CANWAIT_INFINITE) ? (int)timeout : -1)) < 0) {
+        if (errno != EINTR)
+            return SYSERR_OFFSET - errno;
+        *ready = *signaled = 0x00000000U;  // interrupted: the caller
+        return CANERR_NOERROR;          //   waits for the remaining time
+    }
+    for (i = 0, *ready = *signaled = 0x00000000U; (i < n) && (k > 0); i++) {
+        if (pfd[i].revents & (POLLIN | POLLERR | POLLHUP))
+            *ready |= (uint32_t)1 << i;
+        if (pfd[n + i].revents & POLLIN)
+            *signaled |= (uint32_t)1 << i;
+    }
+#endif
+    return ((*ready | *signaled) != 0x00000000U) ? CANERR_NOERROR : CANERR_TIMEOUT;
+}
+
+static int signal_open(int handle)
+{
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    /* note: the wake-up signal is created once per handle and then kept open
+     *       for the lifetime of the process, so that can_kill() can use it
+     *       without taking a lock (e.g. from a signal handler) */
+    if (SLOT(handle)->signal.fdes[0] != -1)
+        return CANERR_NOERROR;
+    return event_open(SLOT(handle)->signal.fdes);
+}
+
+static void signal_send(int handle)
+{
+    int fd = __atomic_load_n(&SLOT(handle)->signal.fdes[1], __ATOMIC_ACQUIRE);
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    /* note: only async-signal-safe operations are permitted here */
+    (void)__atomic_add_fetch(&SLOT(handle)->signal.count, 1U, __ATOMIC_RELEASE);
+    if (fd != -1)
+        event_send(fd);
+}
+
+static int event_open(int fdes[2])
+{
+#if !defined(__linux__)
+    int pfds[2];                        // self-pipe (read and write end)
+    int err;                            // error number
+#endif
+    assert(fdes);                       // just to make sure
+
+#if defined(__linux__)
+    if ((fdes[0] = eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        fdes[0] = -1;
+        return SYSERR_OFFSET - errno;
+    }
+    __atomic_store_n(&fdes[1], fdes[0], __ATOMIC_RELEASE);
+#else
+    if (pipe(pfds) < 0)
+        return SYSERR_OFFSET - errno;
+    if ((fcntl(pfds[0], F_SETFL, O_NONBLOCK) < 0) || (fcntl(pfds[1], F_SETFL, O_NONBLOCK) < 0) ||
+        (fcntl(pfds[0], F_SETFD, FD_CLOEXEC) < 0) || (fcntl(pfds[1], F_SETFD, FD_CLOEXEC) < 0)) {
+        err = errno;
+        (void)close(pfds[0]);
+        (void)close(pfds[1]);
+        return SYSERR_OFFSET - err;
+    }
+    fdes[0] = pfds[0];
+    __atomic_store_n(&fdes[1], pfds[1], __ATOMIC_RELEASE);
+#endif
+    return CANERR_NOERROR;
+}
+
+static void event_send(int fd)
+{
+#if defined(__linux__)
+    uint64_t value = 1U;                // eventfd counter increment
+#else
+    char value = 0;                     // a byte into the self-pipe
+#endif
+    /* note: this function is async-signal-safe */
+    (void)!write(fd, &value, sizeof(value));
+}
+
+static int accept_message(int handle, DWORD id, int xtd)
+{
+    const can_accept_t *accept = &SLOT(handle)->can.accept; // software filter
+    const can_filter_t *filter = &SLOT(handle)->can.filter; // code and mask
+    uint32_t lo, hi, mid;               // binary search
+    uint32_t i;                         // loop variable
+
+    /* note: the code and mask of the other format is not in the hardware */
+    if (!xtd) {                         // 11-bit identifier: code and mask, one bit
+        if (((id ^ (uint32_t)(filter->std >> 32)) & (uint32_t)filter->std) != 0U)
+            return 0;
+        return !accept->std || (accept->bitmap[(id & CAN_MAX_STD_ID) >> 5] & (1U << (id & 31U)));
+    }
+    if (((id ^ (uint32_t)(filter->xtd >> 32)) & (uint32_t)filter->xtd) != 0U)
+        return 0;                       // 29-bit identifier: code and mask
+    if (!accept->xtd)                   //   not filtered
+        return 1;
+    lo = 0U;
+    hi = accept->count;
+    while (lo < hi) {                   // 29-bit identifier: in a range?
+        mid = lo + ((hi - lo) >> 1);
+        if (id < accept->ranges[mid].from)
+            hi = mid;
+        else if (id > accept->ranges[mid].to)
+            lo = mid + 1U;
+        else
+            return 1;
+    }
+    for (i = 0U; i < accept->masked; i++) {  // or matches a code and mask?
+        if (((id ^ (uint32_t)(accept->masks[i] >> 32)) & (uint32_t)accept->masks[i]) == 0U)
+            return 1;
+    }
+    return 0;
+}
+
+static int accept_range(int handle, uint32_t from, uint32_t to, int xtd)
+{
+    can_accept_t *accept = &SLOT(handle)->can.accept; // software filter
+    can_range_t *ranges;                // new range table
+    uint32_t i, j;                      // loop variables
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(from <= to);
+
+    if (!xtd) {                         // 11-bit identifier: set the bits
+        for (i = from; i <= to; i++)
+            accept->bitmap[i >> 5] |= (1U << (i & 31U));
+        accept->std = 1;
+        return CANERR_NOERROR;
+    }
+    if ((accept->count + accept->masked) >= ACCEPT_XTD_MAX)
+        return CANERR_RESOURCE;
+    if ((ranges = (can_range_t*)realloc(accept->ranges, (accept->count + 1U) * sizeof(can_range_t))) == NULL)
+        return CANERR_RESOURCE;
+    accept->ranges = ranges;
+    // insert the range sorted by its first identifier
+    for (i = accept->count; (i > 0U) && (ranges[i-1U].from > from); i--)
+        ranges[i] = ranges[i-1U];
+    ranges[i].from = from;
+    ranges[i].to = to;
+    accept->count++;
+    // merge overlapping and adjacent ranges
+    for (i = 0U, j = 1U; j < accept->count; j++) {
+        if (ranges[j].from <= (ranges[i].to + 1U)) {
+            if (ranges[j].to > ranges[i].to)
+                ranges[i].to = ranges[j].to;
+        }
+        else
+            ranges[++i] = ranges[j];
+    }
+    accept->count = i + 1U;
+    accept->xtd = 1;
+    return CANERR_NOERROR;
+}
+
+static int accept_mask(int handle, uint32_t code, uint32_t mask, int xtd)
+{
+    can_accept_t *accept = &SLOT(handle)->can.accept; // software filter
+    uint64_t *masks;                    // new code and mask list
+    uint32_t open;                      // don't care bits
+    uint32_t i;                         // loop variable
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    if (!xtd) {                         // 11-bit identifier: set the bits
+        for (i = 0U; i <= CAN_MAX_STD_ID; i++) {
+            if (((i ^ code) & mask) == 0U)
+                accept->bitmap[i >> 5] |= (1U << (i & 31U));
+        }
+        accept->std = 1;
+        return CANERR_NOERROR;
+    }
+    // note: if the don't care bits are the lowest bits, then it is a range
+    open = ~mask & CAN_MAX_XTD_ID;
+    if ((open & (open + 1U)) == 0U)
+        return accept_range(handle, code & mask, (code & mask) | open, xtd);
+    if ((accept->count + accept->masked) >= ACCEPT_XTD_MAX)
+        return CANERR_RESOURCE;
+    if ((masks = (uint64_t*)realloc(accept->masks, (accept->masked + 1U) * sizeof(uint64_t))) == NULL)
+        return CANERR_RESOURCE;
+    accept->masks = masks;
+    accept->masks[accept->masked++] = ((uint64_t)(code & mask) << 32) | (uint64_t)mask;
+    accept->xtd = 1;
+    return CANERR_NOERROR;
+}
+
+static void accept_reset(int handle)
+{
+    can_accept_t *accept = &SLOT(handle)->can.accept; // software filter
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    free(accept->ranges);
+    free(accept->masks);
+    memset(accept, 0, sizeof(can_accept_t));
+}
+
+static int accept_cover(int handle, int xtd, uint64_t *filter)
+{
+    const can_accept_t *accept = &SLOT(handle)->can.accept; // software filter
+    uint32_t ones = 0xFFFFFFFFU;        // bits that are 1 in all identifiers
+    uint32_t any = 0x00000000U;         // bits that are 1 in any identifier
+    uint32_t bits, low, code, mask;     // (temporary)
+    uint32_t i;                         // loop variable
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(filter);
+
+    /* note: the tightest code and mask that accepts all identifiers of the
+     *       software filter: the relevant bits are those that are the same
+     *       in all identifiers (this minimizes the false accepts) */
+    if (!xtd) {
+        if (!accept->std)               // 11-bit identifiers not filtered
+            return 0;
+        for (i = 0U; i < ACCEPT_STD_WORDS; i++) {
+            for (bits = accept->bitmap[i]; bits; bits &= bits - 1U) {
+                code = (i << 5) | (uint32_t)__builtin_ctz(bits);
+                ones &= code;
+                any |= code;
+            }
+        }
+        mask = ~(ones ^ any) & CAN_MAX_STD_ID;
+    }
+    else {
+        if (!accept->xtd)               // 29-bit identifiers not filtered
+            return 0;
+        for (i = 0U; i < accept->count; i++) {
+            // note: all bits below the highest different bit of 'from' and 'to' vary
+            bits = accept->ranges[i].from ^ accept->ranges[i].to;
+            low = bits ? ((2U << (31 - __builtin_clz(bits))) - 1U) : 0U;
+            ones &= accept->ranges[i].from & ~low;
+            any |= accept->ranges[i].to | low;
+        }
+        for (i = 0U; i < accept->masked; i++) {
+            code = (uint32_t)(accept->masks[i] >> 32);
+            mask = (uint32_t)accept->masks[i];
+            ones &= code & mask;
+            any |= code | (~mask & CAN_MAX_XTD_ID);
+        }
+        mask = ~(ones ^ any) & CAN_MAX_XTD_ID;
+    }
+    code = ones & mask;
+    *filter = ((uint64_t)code << 32) | (uint64_t)mask;
+    return 1;
+}
+
+static uint64_t poll_clock(void)
+{
+    struct timespec ts;                 // monotonic clock
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static int poll_wait(struct pollfd *pfd, nfds_t n, uint64_t timeout)
+{
+#if defined(__linux__)
+    struct timespec ts;                 // time to wait
+
+    /* note: ppoll() takes the time-out with nanosecond resolution */
+    if (timeout != CANWAIT_INFINITE_NS) {
+        ts.tv_sec = (time_t)(timeout / 1000000000U);
+        ts.tv_nsec = (long)(timeout % 1000000000U);
+    }
+    return ppoll(pfd, n, (timeout != CANWAIT_INFINITE_NS) ? &ts : NULL, NULL);
+#else
+    uint64_t msec;                      // time to wait (rounded up)
+
+    /* note: poll() takes the time-out in milliseconds, rounded up here */
+    if (timeout != CANWAIT_INFINITE_NS) {
+        msec = (timeout / 1000000U) + ((timeout % 1000000U) ? 1U : 0U);
+        return poll(pfd, n, (msec < (uint64_t)INT32_MAX) ? (int)msec : INT32_MAX);
+    }
+    return poll(pfd, n, -1);
+#endif
+}
+
+static void event_clear(int fd)
+{
+#if defined(__linux__)
+    uint64_t value;                     // eventfd counter value
+
+    (void)!read(fd, &value, sizeof(value));
+#else
+    char buffer[64];                    // bytes from the self-pipe
+
+    while (read(fd, buffer, sizeof(buffer)) > 0)
+        ;
+#endif
+}
+
+static int ring_open(int handle)
+{
+    can_ring_t *ring = &SLOT(handle)->ring; // receive ring of the handle
+    int rc;                             // return value
+
+    /* note: the caller holds the handle lock (exclusive) */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(!ring->running);
+    assert(ring->size != 0U);
+
+    // allocate the ring buffer and create the event (once)
+    if (ring->buffer == NULL) {
+        if ((ring->buffer = (can_message_t*)calloc((size_t)ring->size, sizeof(can_message_t))) == NULL)
+            return CANERR_RESOURCE;
+    }
+    if ((ring->event[0] == -1) && ((rc = event_open(ring->event)) != CANERR_NOERROR))
+        return rc;
+    event_clear(ring->event[0]);
+    // clear the ring and its statistics
+    ring->head = ring->tail = 0U;
+    ring->high = 0U;
+    ring->ovfl = 0ull;
+    ring->error = CANERR_NOERROR;
+    return CANERR_NOERROR;
+}
+
+static int ring_start(int handle)
+{
+    can_ring_t *ring = &SLOT(handle)->ring; // receive ring of the handle
+    int rc;                             // return value
+
+    /* note: the caller holds the handle lock (exclusive) */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(!ring->running);
+
+    if (ring->size == 0U)               // no receive ring configured
+        return CANERR_NOERROR;
+    // allocate the ring buffer and create the events (once)
+    if ((rc = ring_open(handle)) != CANERR_NOERROR)
+        return rc;
+    if ((ring->quit[0] == -1) && ((rc = event_open(ring->quit)) != CANERR_NOERROR))
+        return rc;
+    event_clear(ring->quit[0]);
+    // start the reader thread
+    if (pthread_create(&ring->thread, NULL, ring_reader, (void*)(intptr_t)handle) != 0)
+        return CANERR_RESOURCE;
+    ring->running = 1;
+    return CANERR_NOERROR;
+}
+
+static void ring_stop(int handle)
+{
+    can_ring_t *ring = &SLOT(handle)->ring; // receive ring of the handle
+
+    /* note: the caller holds the handle lock (exclusive) */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    if (!ring->running)                 // no reader thread running
+        return;
+    event_send(ring->quit[1]);          // stop the reader thread
+    (void)pthread_join(ring->thread, NULL);
+    ring->running = 0;
+    // wake up blocked readers (they will notice that the handle is stopped)
+    event_send(ring->event[1]);
+}
+
+static size_t ring_read(int handle, can_message_t *buffer, size_t max)
+{
+    can_ring_t *ring = &SLOT(handle)->ring; // receive ring of the handle
+    uint32_t tail = ring->tail;         // read index (owned by the caller)
+    uint32_t head;                      // write index (of the reader thread)
+    size_t n = 0U;                      // number of messages taken
+
+    /* note: the caller holds the handle lock (shared) and the reader lock */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(buffer);
+
+    if ((head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) == tail) {
+        /* note: the receive event is cleared when the ring is found empty and
+         *       the ring is checked once more, since the reader thread signals
+         *       the event after each batch (no lost wake-up) */
+        event_clear(ring->event[0]);
+        head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    }
+    while ((tail != head) && (n < max)) {
+        buffer[n++] = ring->buffer[tail & (ring->size - 1U)];
+        tail++;
+    }
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    return n;
+}
+
+static void *ring_reader(void *arg)
+{
+    int handle = (int)(intptr_t)arg;    // handle of the CAN interface
+    can_ring_t *ring = &SLOT(handle)->ring; // receive ring of the handle
+    can_delta_t counters;               // counter deltas
+    struct pollfd pfd[2];               // receive event and quit signal
+    int pushed;                         // messages put into the ring
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    /* note: the reader thread takes no lock, it is started and stopped by
+     *       the owner of the handle lock (exclusive) and it is the only one
+     *       who reads from the PCAN receive queue while it is running */
+    pfd[0].fd = SLOT(handle)->can.fdes;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = ring->quit[0];
+    pfd[1].events = POLLIN;
+    for (;;) {
+        counters.rx = counters.err = counters.busy = 0ull;
+        // drain the PCAN receive queue into the ring
+        pushed = SLOT(handle)->can.path.drain(handle, &counters);
+        if (counters.rx)
+            (void)__atomic_add_fetch(&SLOT(handle)->can.counters.rx, counters.rx, __ATOMIC_RELAXED);
+        if (counters.err)
+            (void)__atomic_add_fetch(&SLOT(handle)->can.counters.err, counters.err, __ATOMIC_RELAXED);
+        if (counters.busy)
+            busload_add(handle, counters.busy);
+        // signal the receive event (once per batch)
+        if (pushed || (ring->error != CANERR_NOERROR))
+            event_send(ring->event[1]);
+        if (ring->error != CANERR_NOERROR)
+            break;
+        // wait for the next messages or the quit signal
+        pfd[0].revents = 0;
+        pfd[1].revents = 0;
+        if ((poll(pfd, 2, -1) < 0) && (errno != EINTR)) {
+            __atomic_store_n(&ring->error, SYSERR_OFFSET - errno, __ATOMIC_RELEASE);
+            event_send(ring->event[1]);
+            break;
+        }
+        if ((pfd[1].revents & POLLIN))
+            break;
+    }
+    return NULL;
+}
+
+FAST_PATH int ring_push(int handle, const can_message_t *msg)
+{
+    can_ring_t *ring = &SLOT(handle)->ring; // receive ring of the handle
+    uint32_t head, used;                // write index and ring level
+
+    /* note: called by the reader thread (the only producer of the ring) */
+    head = ring->head;
+    used = head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (used >= ring->size) {           // ring full: drop the message
+        __atomic_store_n(&ring->ovfl, ring->ovfl + 1ull, __ATOMIC_RELAXED);
+        SET_STATUS(handle, CANSTAT_QUE_OVR);
+        return 0;
+    }
+    ring->buffer[head & (ring->size - 1U)] = *msg;
+    __atomic_store_n(&ring->head, head + 1U, __ATOMIC_RELEASE);
+    if (used + 1U > ring->high)
+        __atomic_store_n(&ring->high, used + 1U, __ATOMIC_RELAXED);
+    return 1;
+}
+
+FAST_PATH int ring_drain(int handle, can_delta_t *counters, const int fdoe)
+{
+    can_ring_t *ring = &SLOT(handle)->ring; // receive ring of the handle
+    TPCANStatus sts;                    // represents a status
+    pcan_message_t pcan_msg;            // the message (CAN 2.0 or CAN FD)
+    can_message_t msg;                  // the message (CAN API)
+    uint64_t start;                     // start of the call (instrumentation)
+    int pushed = 0;                     // messages put into the ring
+
+    /* note: called by the reader thread ('fdoe' is a constant in the instances below) */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(counters);
+
+    for (;;) {
+        start = INSTRUMENTED(handle) ? poll_clock() : 0U;
+        if (!fdoe)
+            sts = CAN_Read(SLOT(handle)->can.board, &pcan_msg.std.msg, &pcan_msg.std.timestamp);
+        else
+            sts = CAN_ReadFD(SLOT(handle)->can.board, &pcan_msg.fd.msg, &pcan_msg.fd.timestamp);
+        if (start)
+            instrument_add(&SLOT(handle)->can.instrument.read, poll_clock() - start);
+        if ((sts & PCAN_ERROR_OVERRUN))
+            SET_STATUS(handle, CANSTAT_MSG_LST);
+        if ((sts & PCAN_ERROR_QOVERRUN))
+            SET_STATUS(handle, CANSTAT_QUE_OVR);
+        if ((sts & PCAN_ERROR_QRCVEMPTY)) {
+            if ((sts & 0xFF00u))        //   something went wrong
+                __atomic_store_n(&ring->error, pcan_error(sts), __ATOMIC_RELEASE);
+            break;
+        }
+        if (!decode_frame(handle, &pcan_msg, &msg, counters, fdoe))
+            continue;                   //   suppressed
+        pushed += ring_push(handle, &msg);
+    }
+    return pushed;
+}
+
+#if (OPTION_PCAN_GENERIC_PATH == 0)
+static int ring_drain_std(int handle, can_delta_t *counters)
+{
+    return ring_drain(handle, counters, 0);  // CAN 2.0
+}
+
+static int ring_drain_fd(int handle, can_delta_t *counters)
+{
+    return ring_drain(handle, counters, 1);  // CAN FD
+}
+#else
+static int ring_drain_any(int handle, can_delta_t *counters)
+{
+    return ring_drain(handle, counters, SLOT(handle)->can.mode.fdoe);  // at run-time
+}
+#endif
+
+static can_share_t *share_create(TPCANHandle board, uint8_t mode)
+{
+    can_share_t *share;                 // shared channel
+
+    /* note: the caller holds the table lock */
+    if ((share = (can_share_t*)calloc(1U, sizeof(can_share_t))) == NULL)
+        return NULL;
+    share->board = board;
+    share->mode = mode;
+    share->fdes = -1;
+    share->quit[0] = share->quit[1] = -1;
+    (void)pthread_mutex_init(&share->lock, NULL);
+    (void)pthread_mutex_init(&share->fanout, NULL);
+    (void)pthread_mutex_init(&share->writer, NULL);
+    return share;
+}
+
+static void share_free(can_share_t *share)
+{
+    /* note: the caller holds the table lock */
+    if (share == NULL)                  // nothing to do
+        return;
+    assert(!share->running);            // just to make sure
+    if (share->quit[0] != -1)
+        (void)close(share->quit[0]);
+    if ((share->quit[1] != -1) && (share->quit[1] != share->quit[0]))
+        (void)close(share->quit[1]);
+    (void)pthread_mutex_destroy(&share->lock);
+    (void)pthread_mutex_destroy(&share->fanout);
+    (void)pthread_mutex_destroy(&share->writer);
+    free(share);
+}
+
+static int share_open(int32_t board, uint8_t mode)
+{
+    int owner = (int)can_index[(WORD)board] - 1; // a handle of the channel
+    can_share_t *share = SLOT(owner)->can.share; // shared channel (or NULL)
+    can_mode_t capa;                    // board capability
+    TPCANStatus sts;                    // represents a status
+    int handle;                         // handle index
+    int rc;                             // return value
+
+    /* note: the caller holds the table lock */
+    if (!share || !(mode & CANMODE_SHRD)) // channel already in use (exclusively)
+        return CANERR_YETINIT;
+    // check the operation mode (the device settings must be the same for all handles)
+    if ((sts = pcan_capability(share->board, &capa)) != PCAN_ERROR_OK)
+        return pcan_error(sts);
+    if ((mode & ~capa.byte) != 0)
+        return CANERR_ILLPARA;
+    if ((mode & SHARE_MODE_MASK) != (share->mode & SHARE_MODE_MASK))
+        return CANERR_ILLPARA;
+    if (share->users >= SHARE_MAX_HANDLES) // too many handles of the channel
+        return CANERR_RESOURCE;
+    if ((handle = handle_free()) == INVALID_HANDLE) {  // get an unused handle, if any
+        return CANERR_NOTINIT;
+    }
+    // create the wake-up signal of the handle (once)
+    if ((rc = signal_open(handle)) != CANERR_NOERROR)
+        return rc;
+    // store the handle and the operation mode (the device is already open)
+    LOCK_EXCLUSIVE(handle);
+    SLOT(handle)->can.board = share->board; // handle of the CAN channel
+    SLOT(handle)->can.brd_type = SLOT(owner)->can.brd_type;
+    SLOT(handle)->can.brd_port = SLOT(owner)->can.brd_port;
+    SLOT(handle)->can.brd_irq = SLOT(owner)->can.brd_irq;
+    SLOT(handle)->can.mode.byte = mode; // store selected operation mode
+    SLOT(handle)->can.status.byte = CANSTAT_RESET; // CAN controller not started yet
+    SLOT(handle)->can.receive.spin = 0U; // blocking read w/o spinning
+    SLOT(handle)->ring.size = 0U;       // default receive ring (see share_join)
+    SLOT(handle)->can.busload.window = BUSLOAD_WINDOW; // default window length
+    SLOT(handle)->can.clock.mode = PCAN_TIMESTAMP_DEVICE; // time-stamps from the device
+    SLOT(handle)->can.instrument.enabled = 0; // w/o instrumentation
+    SLOT(handle)->can.share = share;    // shared channel
+    UNLOCK(handle);
+    share->users++;
+    can_free = SLOT(handle)->next;      // remove the slot from the free list
+    return HANDLE_MAKE(handle);         // return the handle
+}
+
+static int share_join(int handle)
+{
+    can_share_t *share = SLOT(handle)->can.share; // shared channel
+    can_ring_t *ring = &SLOT(handle)->ring; // receive ring of the handle
+    int rc;                             // return value
+
+    /* note: the caller holds the handle lock (exclusive) and the share lock */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(share);
+    assert(share->started < SHARE_MAX_HANDLES);
+
+    /* note: a shared handle always reads from its receive ring, which is
+     *       filled by the reader thread of the channel (no thread of its own) */
+    if (ring->size == 0U)
+        ring->size = SHARE_RING_SIZE;
+    if ((rc = ring_open(handle)) != CANERR_NOERROR)
+        return rc;
+    if ((share->quit[0] == -1) && ((rc = event_open(share->quit)) != CANERR_NOERROR))
+        return rc;
+    // add the handle to the fan-out list
+    (void)pthread_mutex_lock(&share->fanout);
+    share->member[share->started++] = handle;
+    ring->running = 1;
+    (void)pthread_mutex_unlock(&share->fanout);
+    // start the reader thread of the channel with its first member
+    if (!share->running) {
+        event_clear(share->quit[0]);
+        if (pthread_create(&share->thread, NULL, share_reader, (void*)share) != 0) {
+            (void)pthread_mutex_lock(&share->fanout);
+            share->started--;
+            ring->running = 0;
+            (void)pthread_mutex_unlock(&share->fanout);
+            return CANERR_RESOURCE;
+        }
+        share->running = 1;
+    }
+    return CANERR_NOERROR;
+}
+
+static void share_leave(int handle)
+{
+    can_share_t *share = SLOT(handle)->can.share; // shared channel
+    can_ring_t *ring = &SLOT(handle)->ring; // receive ring of the handle
+    int i;                              // loop variable
+
+    /* note: the caller holds the handle lock (exclusive) and the share lock */
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(share);
+
+    if (!ring->running)                 // not a member of the fan-out
+        return;
+    // remove the handle from the fan-out list
+    (void)pthread_mutex_lock(&share->fanout);
+    for (i = 0; i < share->started; i++) {
+        if (share->member[i] == handle) {
+            share->member[i] = share->member[--share->started];
+            break;
+        }
+    }
+    ring->running = 0;
+    (void)pthread_mutex_unlock(&share->fanout);
+    // stop the reader thread of the channel with its last member
+    if (!share->started && share->running) {
+        event_send(share->quit[1]);
+        (void)pthread_join(share->thread, NULL);
+        share->running = 0;
+    }
+    // wake up blocked readers (they will notice that the handle is stopped)
+    event_send(ring->event[1]);
+}
+
+FAST_PATH uint32_t share_drain(can_share_t *share, int *error, const int fdoe)
+{
+    can_delta_t counters[SHARE_MAX_HANDLES]; // counter deltas (per member)
+    TPCANStatus sts;                    // represents a status
+    pcan_message_t pcan_msg;            // the message (CAN 2.0 or CAN FD)
+    can_message_t msg;                  // the message (CAN API)
+    uint32_t pushed = 0x00000000U;      // members with new messages (bit mask)
+    int handle;                         // handle of a member
+    int i;                              // loop variable
+
+    /* note: called by the reader thread with the fan-out lock held, each
+     *       frame is decoded once per member (own filter, time-stamps, etc.) */
+    assert(share);
+    assert(error);
+
+    memset(counters, 0, (size_t)share->started * sizeof(can_delta_t));
+    for (;;) {
+        if (!fdoe)
+            sts = CAN_Read(share->board, &pcan_msg.std.msg, &pcan_msg.std.timestamp);
+        else
+            sts = CAN_ReadFD(share->board, &pcan_msg.fd.msg, &pcan_msg.fd.timestamp);
+        for (i = 0; (i < share->started) && (sts & (PCAN_ERROR_OVERRUN | PCAN_ERROR_QOVERRUN)); i++) {
+            if ((sts & PCAN_ERROR_OVERRUN))
+                SET_STATUS(share->member[i], CANSTAT_MSG_LST);
+            if ((sts & PCAN_ERROR_QOVERRUN))
+                SET_STATUS(share->member[i], CANSTAT_QUE_OVR);
+        }
+        if ((sts & PCAN_ERROR_QRCVEMPTY)) {
+            if ((sts & 0xFF00u))        //   something went wrong
+                *error = pcan_error(sts);
+            break;
+        }
+        for (i = 0; i < share->started; i++) {
+            handle = share->member[i];
+            if (decode_frame(handle, &pcan_msg, &msg, &counters[i], fdoe) && ring_push(handle, &msg))
+                pushed |= (uint32_t)1 << i;
+        }
+    }
+    for (i = 0; i < share->started; i++) {
+        handle = share->member[i];
+        if (counters[i].rx)
+            (void)__atomic_add_fetch(&SLOT(handle)->can.counters.rx, counters[i].rx, __ATOMIC_RELAXED);
+        if (counters[i].err)
+            (void)__atomic_add_fetch(&SLOT(handle)->can.counters.err, counters[i].err, __ATOMIC_RELAXED);
+        if (counters[i].busy)
+            busload_add(handle, counters[i].busy);
+    }
+    return pushed;
+}
+
+static void *share_reader(void *arg)
+{
+    can_share_t *share = (can_share_t*)arg; // shared channel
+    struct pollfd pfd[2];               // receive event and quit signal
+    uint32_t pushed;                    // members with new messages (bit mask)
+    int error = CANERR_NOERROR;         // error of the reader thread
+    int i;                              // loop variable
+
+    assert(share);                      // just to make sure
+
+    /* note: the reader thread of a shared channel is the only one who reads
+     *       from the PCAN receive queue, it fans out each message into the
+     *       receive rings of all started handles (members) of the channel */
+    pfd[0].fd = share->fdes;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = share->quit[0];
+    pfd[1].events = POLLIN;
+    for (;;) {
+        (void)pthread_mutex_lock(&share->fanout);
+        // drain the PCAN receive queue into the rings of all members
+        if (!(share->mode & CANMODE_FDOE))
+            pushed = share_drain(share, &error, 0);
+        else
+            pushed = share_drain(share, &error, 1);
+        // signal the receive events (once per batch)
+        for (i = 0; i < share->started; i++) {
+            if (error != CANERR_NOERROR)
+                __atomic_store_n(&SLOT(share->member[i])->ring.error, error, __ATOMIC_RELEASE);
+            if ((pushed & ((uint32_t)1 << i)) || (error != CANERR_NOERROR))
+                event_send(SLOT(share->member[i])->ring.event[1]);
+        }
+        (void)pthread_mutex_unlock(&share->fanout);
+        if (error != CANERR_NOERROR)
+            break;
+        // wait for the next messages or the quit signal
+        pfd[0].revents = 0;
+        pfd[1].revents = 0;
+        if ((poll(pfd, 2, -1) < 0) && (errno != EINTR)) {
+            error = SYSERR_OFFSET - errno;
+            (void)pthread_mutex_lock(&share->fanout);
+            for (i = 0; i < share->started; i++) {
+                __atomic_store_n(&SLOT(share->member[i])->ring.error, error, __ATOMIC_RELEASE);
+                event_send(SLOT(share->member[i])->ring.event[1]);
+            }
+            (void)pthread_mutex_unlock(&share->fanout);
+            break;
+        }
+        if ((pfd[1].revents & POLLIN))
+            break;
+    }
+    return NULL;
+}
+
+static void busload_start(int handle, const can_bitrate_t *bitrate)
+{
+    can_busload_t *load = &SLOT(handle)->can.busload; // bus load of the handle
+    can_speed_t speed;                  // transmission speed
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(bitrate);
+
+    /* note: the bit times are taken from the bit-rate settings, in picoseconds
+     *       to keep the accounting in integer arithmetic (0 = not measured) */
+    load->nominal = load->data = 0U;
+    if (btr_bitrate2speed(bitrate, &speed) == CANERR_NOERROR) {
+        if ((speed.nominal.speed > 0.0f) && (speed.nominal.speed <= 1.0e9f))
+            load->nominal = (uint32_t)((1.0e12f / speed.nominal.speed) + 0.5f);
+        if (SLOT(handle)->can.mode.fdoe && SLOT(handle)->can.mode.brse &&
+            (speed.data.speed > 0.0f) && (speed.data.speed <= 1.0e9f))
+            load->data = (uint32_t)((1.0e12f / speed.data.speed) + 0.5f);
+        else
+            load->data = load->nominal;
+    }
+    if ((load->window < BUSLOAD_WINDOW_MIN) || (BUSLOAD_WINDOW_MAX < load->window))
+        load->window = BUSLOAD_WINDOW;
+    busload_reset(handle, poll_clock());
+}
+
+static void busload_reset(int handle, uint64_t now)
+{
+    can_busload_t *load = &SLOT(handle)->can.busload; // bus load of the handle
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    LOCK_BUSLOAD(handle);
+    memset(load->busy, 0, sizeof(load->busy));
+    load->slot = ((uint64_t)load->window * 1000000U) / BUSLOAD_SLOTS;
+    load->origin = now;
+    load->start = now;
+    load->index = 0U;
+    UNLOCK_BUSLOAD(handle);
+}
+
+static void busload_advance(can_busload_t *load, uint64_t now)
+{
+    /* note: the window is made up of BUSLOAD_SLOTS slots, the oldest slot is
+     *       dropped (cleared) when the current slot has expired */
+    if ((now - load->start) >= (load->slot * BUSLOAD_SLOTS)) {
+        memset(load->busy, 0, sizeof(load->busy));
+        load->start = now;
+        load->index = 0U;
+        return;
+    }
+    while ((now - load->start) >= load->slot) {
+        load->index = (load->index + 1U) % BUSLOAD_SLOTS;
+        load->busy[load->index] = 0U;
+        load->start += load->slot;
+    }
+}
+
+static void busload_add(int handle, uint64_t busy)
+{
+    uint64_t now = poll_clock();        // current time (monotonic clock)
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    /* note: the frames are accounted when they are seen by the wrapper
+     *       (received from the PCAN receive queue or put into the PCAN
+     *       transmit queue), at most once per call resp. batch */
+    LOCK_BUSLOAD(handle);
+    busload_advance(&SLOT(handle)->can.busload, now);
+    SLOT(handle)->can.busload.busy[SLOT(handle)->can.busload.index] += busy;
+    UNLOCK_BUSLOAD(handle);
+}
+
+static uint16_t busload_get(int handle)
+{
+    can_busload_t *load = &SLOT(handle)->can.busload; // bus load of the handle
+    uint64_t now = poll_clock();        // current time (monotonic clock)
+    uint64_t busy = 0U;                 // bus time of the frames [ps]
+    uint64_t span;                      // time covered by the window [ns]
+    uint64_t percent;                   // bus load in [0.01 percent]
+    int i;                              // loop variable
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    LOCK_BUSLOAD(handle);
+    busload_advance(load, now);
+    for (i = 0; i < BUSLOAD_SLOTS; i++)
+        busy += load->busy[i];
+    // the window covers the past slots and the current one (up to now)
+    span = (load->slot * (BUSLOAD_SLOTS - 1)) + (now - load->start);
+    if ((now - load->origin) < span)    // measurement just started
+        span = now - load->origin;
+    UNLOCK_BUSLOAD(handle);
+    if (span == 0U)
+        return 0U;
+    percent = (busy * 10U) / span;      // [ps] / [ns] * 10000 / 1000
+    return (percent < 10000U) ? (uint16_t)percent : 10000U;
+}
+
+static uint64_t busload_frame(int handle, DWORD id, BYTE type, BYTE dlc, const BYTE *data)
+{
+    const can_busload_t *load = &SLOT(handle)->can.busload; // bus load of the handle
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(data);
+
+    /* note: returns the bus time of the frame in picoseconds (cf. util_frame_time) */
+    if (!load->nominal)                 // bit-rate unknown
+        return 0U;
+    return util_frame_time(id, type, dlc, data, load->nominal, load->data);
+}
+
+static void can_message(const TPCANMsg *pcan_msg, can_message_t *msg)
+{
+    assert(msg);
+    assert(pcan_msg);
+    msg->id = (int32_t)pcan_msg->ID;
+    msg->xtd = (pcan_msg->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? 1 : 0;
+    msg->rtr = (pcan_msg->MSGTYPE & PCAN_MESSAGE_RTR) ? 1 : 0;
+    msg->fdf = 0;
+    msg->brs = 0;
+    msg->esi = 0;
+    msg->sts = 0;
+    msg->dlc = (uint8_t)pcan_msg->LEN;
+    memcpy(msg->data, pcan_msg->DATA, CAN_MAX_LEN);
+    memset(&msg->data[CAN_MAX_LEN], 0, CANFD_MAX_LEN - CAN_MAX_LEN);
+}
+
+static void can_message_fd(const TPCANMsgFD *pcan_msg, can_message_t *msg)
+{
+    assert(msg);
+    assert(pcan_msg);
+    msg->id = (int32_t)pcan_msg->ID;
+    msg->xtd = (pcan_msg->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? 1 : 0;
+    msg->rtr = (pcan_msg->MSGTYPE & PCAN_MESSAGE_RTR) ? 1 : 0;
+    msg->fdf = (pcan_msg->MSGTYPE & PCAN_MESSAGE_FD) ? 1 : 0;
+    msg->brs = (pcan_msg->MSGTYPE & PCAN_MESSAGE_BRS) ? 1 : 0;
+    msg->esi = 0;  // FIXME: ESI?
+    msg->sts = 0;
+    msg->dlc = (uint8_t)pcan_msg->DLC;
+    memcpy(msg->data, pcan_msg->DATA, CANFD_MAX_LEN);
+}
+
+static void can_message_sts(uint8_t status, can_error_t error, can_message_t *msg)
+{
+    assert(msg);
+    msg->id = (int32_t)0;
+    msg->xtd = 0;
+    msg->rtr = 0;
+    msg->fdf = 0;
+    msg->brs = 0;
+    msg->esi = 0;
+    msg->sts = 1;
+    msg->dlc = (uint8_t)4;
+    memset(msg->data, 0, CANFD_MAX_LEN);
+    msg->data[0] = status;
+    msg->data[1] = (uint8_t)error.lec;
+    msg->data[2] = (uint8_t)error.rx_err;
+    msg->data[4] = (uint8_t)error.tx_err;
+}
+
+static void can_timestamp(TPCANTimestamp timestamp, can_message_t *msg)
+{
+    assert(msg);
+    uint64_t msec = ((uint64_t)timestamp.millis_overflow << 32) + (uint64_t)timestamp.millis;
+    msg->timestamp.tv_sec = (time_t)(msec / 1000ull);
+    msg->timestamp.tv_nsec = ((((long)(msec % 1000ull)) * 1000L) + (long)timestamp.micros) * (long)1000;
+}
+
+static void can_timestamp_fd(TPCANTimestampFD timestamp, can_message_t *msg)
+{
+    assert(msg);
+    msg->timestamp.tv_sec = (time_t)(timestamp / 1000000ull);
+    msg->timestamp.tv_nsec = (long)(timestamp % 1000000ull) * (long)1000;
+}
+
+static void clock_reset(int handle)
+{
+    can_clock_t *clk = &SLOT(handle)->can.clock;
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    // note: the device clock starts again when the CAN controller is started
+    clk->started = 0;
+    clk->count = 0U;
+    clk->index = 0U;
+    clk->skew = 0.0;
+}
+
+static uint64_t clock_host(int handle, uint64_t device)
+{
+    can_clock_t *clk = &SLOT(handle)->can.clock;
+    struct timespec ts;                 // arrival time (host)
+    int64_t offset;                     // host time - device time [ns]
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    /* note: the arrival time of a message is the device time plus the offset
+     *       of the clocks plus a latency (USB, driver, scheduling) that is
+     *       never negative. The minimum offset of a window of device time is
+     *       the best guess, a linear regression of the minima of the last
+     *       windows gives the offset and the drift of the device clock. The
+     *       caller serializes the readers (reader lock or reader thread). */
+    (void)clock_gettime((clk->mode == PCAN_TIMESTAMP_REALTIME) ? CLOCK_REALTIME : CLOCK_MONOTONIC, &ts);
+    offset = (int64_t)(((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec - device);
+    if (!clk->started || (device < clk->start)) {
+        // first sample (or device clock restarted)
+        clk->started = 1;
+        clk->start = device;
+        clk->device = device;
+        clk->offset = offset;
+        clk->count = 0U;
+        clk->index = 0U;
+        clk->origin = device;
+        clk->intercept = offset;
+        clk->skew = 0.0;
+    }
+    else if ((device - clk->start) >= CLOCK_WINDOW) {
+        // end of the window: take its minimum as regression point
+        clk->x[clk->index] = clk->device;
+        clk->y[clk->index] = clk->offset;
+        clk->index = (clk->index + 1U) % CLOCK_POINTS;
+        if (clk->count < CLOCK_POINTS)
+            clk->count++;
+        clock_fit(clk);
+        // start the next window with this sample
+        clk->start = device;
+        clk->device = device;
+        clk->offset = offset;
+    }
+    else if (offset < clk->offset) {
+        // new minimum in the window
+        clk->device = device;
+        clk->offset = offset;
+        if (!clk->count) {              //   no regression point yet
+            clk->origin = device;
+            clk->intercept = offset;
+        }
+    }
+    return device + (uint64_t)(clk->intercept + (int64_t)(clk->skew * (double)(int64_t)(device - clk->origin)));
+}
+
+static void clock_fit(can_clock_t *clk)
+{
+    uint32_t newest = (clk->index + CLOCK_POINTS - 1U) % CLOCK_POINTS;
+    double mx = 0.0, my = 0.0;          // mean values
+    double sxx = 0.0, sxy = 0.0;        // sums of the squares
+    double dx, dy;                      // relative to the newest point
+    uint32_t i;                         // loop variable
+
+    assert(clk);
+    assert(clk->count);
+
+    // least squares (relative to the newest point for precision)
+    for (i = 0U; i < clk->count; i++) {
+        mx += (double)(int64_t)(clk->x[i] - clk->x[newest]);
+        my += (double)(clk->y[i] - clk->y[newest]);
+    }
+    mx /= (double)clk->count;
+    my /= (double)clk->count;
+    for (i = 0U; i < clk->count; i++) {
+        dx = (double)(int64_t)(clk->x[i] - clk->x[newest]) - mx;
+        dy = (double)(clk->y[i] - clk->y[newest]) - my;
+        sxx += dx * dx;
+        sxy += dx * dy;
+    }
+    clk->skew = (sxx > 0.0) ? (sxy / sxx) : 0.0;
+    if ((clk->skew < -CLOCK_SKEW_MAX) || (CLOCK_SKEW_MAX < clk->skew))
+        clk->skew = 0.0;                // implausible drift
+    // offset at the newest point
+    clk->origin = clk->x[newest];
+    clk->intercept = clk->y[newest] + (int64_t)(my - (clk->skew * mx));
+}
+
+static void instrument_reset(int handle)
+{
+    can_instrument_t *ins = &SLOT(handle)->can.instrument;
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    /* note: the caller holds the handle lock (exclusive), but the reader
+     *       thread of a receive ring or of a shared channel could record a
+     *       sample meanwhile, so each field is cleared atomically */
+    instrument_clear(&ins->wait);
+    instrument_clear(&ins->read);
+    instrument_clear(&ins->write);
+    instrument_clear(&ins->age);
+    __atomic_store_n(&ins->rx_frames, 0ull, __ATOMIC_RELAXED);
+    __atomic_store_n(&ins->rx_bytes, 0ull, __ATOMIC_RELAXED);
+    __atomic_store_n(&ins->tx_frames, 0ull, __ATOMIC_RELAXED);
+    __atomic_store_n(&ins->tx_bytes, 0ull, __ATOMIC_RELAXED);
+    __atomic_store_n(&ins->since, poll_clock(), __ATOMIC_RELAXED);
+}
+
+static void instrument_clear(can_pcan_histogram_t *hist)
+{
+    int i;                              // loop variable
+
+    assert(hist);
+
+    for (i = 0; i < PCAN_HISTOGRAM_BUCKETS; i++)
+        __atomic_store_n(&hist->bucket[i], 0ull, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->count, 0ull, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->total, 0ull, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->max, 0ull, __ATOMIC_RELAXED);
+}
+
+static void instrument_add(can_pcan_histogram_t *hist, uint64_t sample)
+{
+    uint64_t max;                       // largest sample so far
+    int i = 0;                          // bucket (log2 of the sample)
+
+    assert(hist);
+
+    /* note: readers, writers and the reader thread record concurrently */
+    if (sample > 1U)
+        i = 63 - __builtin_clzll(sample);
+    if (i >= PCAN_HISTOGRAM_BUCKETS)
+        i = PCAN_HISTOGRAM_BUCKETS - 1;
+    (void)__atomic_fetch_add(&hist->bucket[i], 1ull, __ATOMIC_RELAXED);
+    (void)__atomic_fetch_add(&hist->count, 1ull, __ATOMIC_RELAXED);
+    (void)__atomic_fetch_add(&hist->total, sample, __ATOMIC_RELAXED);
+    max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+    while ((sample > max) &&
+           !__atomic_compare_exchange_n(&hist->max, &max, sample, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+static void instrument_rx(int handle, const can_message_t *buffer, size_t n)
+{
+    can_instrument_t *ins = &SLOT(handle)->can.instrument;
+    struct timespec ts;                 // time of delivery (host time)
+    uint64_t now = 0U;                  // time of delivery [ns]
+    uint64_t stamp;                     // time-stamp of a message [ns]
+    uint64_t frames = 0U;               // data frames delivered
+    uint64_t bytes = 0U;                // payload bytes delivered
+    size_t i;                           // loop variable
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(buffer);
+
+    /* note: the age of a frame can only be taken when the time-stamps are
+     *       in host time (one clock reading for all messages of a call) */
+    if (SLOT(handle)->can.clock.mode != PCAN_TIMESTAMP_DEVICE) {
+        (void)clock_gettime((SLOT(handle)->can.clock.mode == PCAN_TIMESTAMP_REALTIME) ? CLOCK_REALTIME : CLOCK_MONOTONIC, &ts);
+        now = ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+    }
+    for (i = 0U; i < n; i++) {
+        if (buffer[i].sts)              //   status message
+            continue;
+        frames++;
+        bytes += !buffer[i].rtr ? (uint64_t)DLC2LEN(buffer[i].dlc) : 0U;
+        if (now) {
+            stamp = ((uint64_t)buffer[i].timestamp.tv_sec * 1000000000ULL) + (uint64_t)buffer[i].timestamp.tv_nsec;
+            instrument_add(&ins->age, (now > stamp) ? (now - stamp) : 0U);
+        }
+    }
+    (void)__atomic_fetch_add(&ins->rx_frames, frames, __ATOMIC_RELAXED);
+    (void)__atomic_fetch_add(&ins->rx_bytes, bytes, __ATOMIC_RELAXED);
+}
+
+static void instrument_tx(int handle, const can_message_t *buffer, size_t n)
+{
+    can_instrument_t *ins = &SLOT(handle)->can.instrument;
+    uint64_t bytes = 0U;                // payload bytes transmitted
+    size_t i;                           // loop variable
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(buffer || !n);
+
+    for (i = 0U; i < n; i++)
+        bytes += !buffer[i].rtr ? (uint64_t)DLC2LEN(buffer[i].dlc) : 0U;
+    (void)__atomic_fetch_add(&ins->tx_frames, (uint64_t)n, __ATOMIC_RELAXED);
+    (void)__atomic_fetch_add(&ins->tx_bytes, bytes, __ATOMIC_RELAXED);
 }
 
-static void can_timestamp_fd(TPCANTimestampFD timestamp, can_message_t *msg)
+static void instrument_copy(const can_pcan_histogram_t *hist, can_pcan_histogram_t *copy)
 {
-    assert(msg);
-    msg->timestamp.tv_sec = (time_t)(timestamp / 1000000ull);
-    msg->timestamp.tv_nsec = (long)(timestamp % 1000000ull) * (long)1000;
+    int i;                              // loop variable
+
+    assert(hist);
+    assert(copy);
+
+    copy->count = __atomic_load_n(&hist->count, __ATOMIC_RELAXED);
+    copy->total = __atomic_load_n(&hist->total, __ATOMIC_RELAXED);
+    copy->max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+    for (i = 0; i < PCAN_HISTOGRAM_BUCKETS; i++)
+        copy->bucket[i] = __atomic_load_n(&hist->bucket[i], __ATOMIC_RELAXED);
 }
 
 #define PCAN_ERROR_MASK  (PCAN_ERROR_REGTEST | PCAN_ERROR_NODRIVER | PCAN_ERROR_HWINUSE | PCAN_ERROR_NETINUSE | \
@@ -1296,7 +3628,7 @@ static TPCANStatus pcan_capability(TPCANHandle board, can_mode_t *capability)
     capability->fdoe = (features & FEATURE_FD_CAPABLE) ? 1 : 0;
     capability->brse = (features & FEATURE_FD_CAPABLE) ? 1 : 0;
     capability->niso = 0; // this can not be determined (FIXME)
-    capability->shrd = 0; // this feature is not supported (PCANBasic)
+    capability->shrd = 1; // shared access within the process (software solution)
 #if (0)
     capability->nxtd = 0; // PCAN_ACCEPTANCE_FILTER_29BIT not supported (PCBUSB Gen. 1)
     capability->nrtr = 0; // PCAN_ALLOW_RTR_FRAMES not supported (PCBUSB Gen. 1)
@@ -1310,6 +3642,107 @@ static TPCANStatus pcan_capability(TPCANHandle board, can_mode_t *capability)
     return PCAN_ERROR_OK;
 }
 
+static TPCANStatus pcan_start(int handle, uint16_t btr0btr1, char *string)
+{
+    TPCANStatus sts;                    // represents a status
+    DWORD value;                        // parameter value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+    assert(string);
+
+    /* note: to (re-)start the CAN controller, we have to reinitialize it */
+    if ((sts = CAN_Reset(SLOT(handle)->can.board)) != PCAN_ERROR_OK)
+        return sts;
+    if ((sts = CAN_Uninitialize(SLOT(handle)->can.board)) != PCAN_ERROR_OK)
+        return sts;
+#ifdef ISSUE_303_WORKAROUND
+    value = (SLOT(handle)->can.mode.mon) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+    if ((sts = CAN_SetValue(SLOT(handle)->can.board, PCAN_LISTEN_ONLY,
+                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK) {
+        CAN_Uninitialize(SLOT(handle)->can.board);
+        return sts;
+    }
+#endif
+    /* note: the receiver is automatically switched ON by CAN_Initialize[FD]() */
+    if (SLOT(handle)->can.mode.fdoe) {  // CAN FD operation mode?
+        if ((sts = CAN_InitializeFD(SLOT(handle)->can.board, string)) != PCAN_ERROR_OK)
+            return sts;
+    }
+    else {                              // CAN 2.0 operation mode!
+        if ((sts = CAN_Initialize(SLOT(handle)->can.board, btr0btr1,
+                                  SLOT(handle)->can.brd_type, SLOT(handle)->can.brd_port,
+                                  SLOT(handle)->can.brd_irq)) != PCAN_ERROR_OK)
+            return sts;
+    }
+#if !defined(_WIN32) && !defined(_WIN64)
+    // get file descriptor for blocking read (Every thing is a file in unixoid systems)
+    if ((sts = CAN_GetValue(SLOT(handle)->can.board, PCAN_RECEIVE_EVENT,
+                           &SLOT(handle)->can.fdes, sizeof(int))) != PCAN_ERROR_OK) {
+        CAN_Uninitialize(SLOT(handle)->can.board);
+        return sts;
+    }
+#endif
+#ifndef ISSUE_303_WORKAROUND
+    // set listen-only mode if selected
+    value = (SLOT(handle)->can.mode.mon) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+    if ((sts = CAN_SetValue(SLOT(handle)->can.board, PCAN_LISTEN_ONLY,
+                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK) {
+        CAN_Uninitialize(SLOT(handle)->can.board);
+        return sts;
+    }
+#endif
+    // set acceptance filter as selected
+    /* note: the filter of a shared channel is always open (see pcan_apply_filter) */
+    switch(SLOT(handle)->can.filter.mode) {
+        case FILTER_STD:                // 11-bit identifier
+            if ((sts = CAN_SetValue(SLOT(handle)->can.board, PCAN_ACCEPTANCE_FILTER_11BIT,
+                                   (void*)&SLOT(handle)->can.filter.mask,
+                                    sizeof(UINT64))) != PCAN_ERROR_OK) {
+                CAN_Uninitialize(SLOT(handle)->can.board);
+                return sts;
+            }
+            break;
+        case FILTER_XTD:                // 29-bit identifier
+            if ((sts = CAN_SetValue(SLOT(handle)->can.board, PCAN_ACCEPTANCE_FILTER_29BIT,
+                                   (void*)&SLOT(handle)->can.filter.mask,
+                                    sizeof(UINT64))) != PCAN_ERROR_OK) {
+                CAN_Uninitialize(SLOT(handle)->can.board);
+                return sts;
+            }
+            break;
+        default:                        // no filtering
+            value = PCAN_FILTER_OPEN;
+            if ((sts = CAN_SetValue(SLOT(handle)->can.board, PCAN_MESSAGE_FILTER,
+                                   (void*)&value, sizeof(value))) != PCAN_ERROR_OK) {
+                CAN_Uninitialize(SLOT(handle)->can.board);
+                return sts;
+            }
+            break;
+    }
+    return PCAN_ERROR_OK;
+}
+
+static TPCANStatus pcan_stop(int handle)
+{
+    TPCANStatus sts;                    // represents a status
+    DWORD value;                        // parameter value
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    /* note: we turn off the receiver and the transmitter to do that! */
+#ifndef ISSUE_276_UNSOLVED
+    value = PCAN_PARAMETER_OFF;         //   receiver off
+    if ((sts = CAN_SetValue(SLOT(handle)->can.board, PCAN_RECEIVE_STATUS,
+                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK)
+        return sts;
+#endif
+    value = PCAN_PARAMETER_ON;          //   transmitter off
+    if ((sts = CAN_SetValue(SLOT(handle)->can.board, PCAN_LISTEN_ONLY,
+                           (void*)&value, sizeof(value))) != PCAN_ERROR_OK)
+        return sts;
+    return PCAN_ERROR_OK;
+}
+
 static TPCANStatus pcan_get_filter(int handle, uint64_t *filter, filtering_t mode)
 {
     TPCANStatus sts;                    // represents a status
@@ -1320,30 +3753,14 @@ static TPCANStatus pcan_get_filter(int handle, uint64_t *filter, filtering_t mod
     // get the filter value from device
     switch (mode) {
         case FILTER_STD:                // 11-bit identifier
-            if (can[handle].filter.mode != FILTER_XTD) {
-                if ((sts = CAN_GetValue(can[handle].board, PCAN_ACCEPTANCE_FILTER_11BIT,
-                                       (void*)filter, sizeof(UINT64))) == PCAN_ERROR_OK) {
-                    *filter ^= FILTER_STD_XOR_MASK;  // SJA100 has inverted masks bits!
-                }
-            }
-            else {
-                // note: there is only one filter for both modes
-                *filter = FILTER_RESET_VALUE;
-                sts = PCAN_ERROR_OK;
-            }
+            // note: the code and mask as set (the hardware may have a combined one)
+            *filter = SLOT(handle)->can.filter.std;
+            sts = PCAN_ERROR_OK;
             break;
         case FILTER_XTD:                // 29-bit identifier
-            if (can[handle].filter.mode != FILTER_STD) {
-                if ((sts = CAN_GetValue(can[handle].board, PCAN_ACCEPTANCE_FILTER_29BIT,
-                                       (void*)filter, sizeof(UINT64))) == PCAN_ERROR_OK) {
-                    *filter ^= FILTER_XTD_XOR_MASK;   // SJA100 has inverted masks bits!
-                }
-            }
-            else {
-                // note: there is only one filter for both modes
-                *filter = FILTER_RESET_VALUE;
-                sts = PCAN_ERROR_OK;
-            }
+            // note: the code and mask as set (the hardware may have a combined one)
+            *filter = SLOT(handle)->can.filter.xtd;
+            sts = PCAN_ERROR_OK;
             break;
         default:                        // should not happen
             *filter = FILTER_RESET_VALUE;
@@ -1354,28 +3771,95 @@ static TPCANStatus pcan_get_filter(int handle, uint64_t *filter, filtering_t mod
 }
 
 static TPCANStatus pcan_set_filter(int handle, uint64_t filter, filtering_t mode)
+{
+    TPCANStatus sts;                    // represents a status
+    can_filter_t previous = SLOT(handle)->can.filter; // to restore on error
+
+    assert(IS_HANDLE_VALID(handle));    // just to make sure
+
+    // store the filter value (11-bit and 29-bit filter can be active at the same time)
+    switch (mode) {
+        case FILTER_STD:                // 11-bit identifier
+            SLOT(handle)->can.filter.std = filter;
+            break;
+        case FILTER_XTD:                // 29-bit identifier
+            SLOT(handle)->can.filter.xtd = filter;
+            break;
+        default:                        // no filtering
+            SLOT(handle)->can.filter.std = FILTER_RESET_VALUE;
+            SLOT(handle)->can.filter.xtd = FILTER_RESET_VALUE;
+            break;
+    }
+    // set the hardware filter
+    if ((sts = pcan_apply_filter(handle)) != PCAN_ERROR_OK) {
+        SLOT(handle)->can.filter.std = previous.std;
+        SLOT(handle)->can.filter.xtd = previous.xtd;
+    }
+    return sts;
+}
+
+static TPCANStatus pcan_apply_filter(int handle)
 {
     TPCANStatus sts;                    // represents a status
     UINT64 value = 0x0ull;              // PCAN filter value
+    uint64_t filter[2];                 // 11-bit and 29-bit code and mask
+    uint32_t code, mask;                // code and mask of the software filter
+    uint64_t cover;                     // (combined) code and mask
+    filtering_t select = FILTER_OFF;    // filter for the hardware
+    int bits[2];                        // selectivity (relevant bits)
+    int i;                              // loop variable
 
     assert(IS_HANDLE_VALID(handle));    // just to make sure
 
+    /* note: the hardware filter of a shared channel stays open, each handle
+     *       of it is filtered by its own software filter (see accept_message) */
+    if (SLOT(handle)->can.share)
+        return PCAN_ERROR_OK;
+    /* note: the code and mask for the hardware is the tightest one that
+     *       accepts all identifiers of the software filter (if any) and
+     *       of the code and mask set by the user; the exact matching is
+     *       done by the software filter (see accept_message) */
+    filter[0] = SLOT(handle)->can.filter.std;
+    filter[1] = SLOT(handle)->can.filter.xtd;
+    for (i = 0; i < 2; i++) {
+        if (accept_cover(handle, i, &cover)) {
+            code = (uint32_t)(cover >> 32);
+            mask = (uint32_t)cover;
+            // both must match: relevant bits of both (if they don't contradict)
+            if (!((code ^ (uint32_t)(filter[i] >> 32)) & mask & (uint32_t)filter[i])) {
+                code = (code & mask) | ((uint32_t)(filter[i] >> 32) & (uint32_t)filter[i]);
+                mask |= (uint32_t)filter[i];
+                filter[i] = ((uint64_t)code << 32) | (uint64_t)mask;
+            }
+        }
+        bits[i] = (uint32_t)filter[i] ? __builtin_popcount((uint32_t)filter[i]) : -1;
+    }
+    /* note: the hardware has only one acceptance filter (for 11-bit or 29-bit
+     *       identifier). It is set to the more selective one (more relevant
+     *       bits in the mask), both are enforced by the software filter. */
+    if ((bits[0] >= 0) || (bits[1] >= 0))
+        select = (bits[1] >= bits[0]) ? FILTER_XTD : FILTER_STD;
+    // reset the hardware filter when the other one is selected
+    if ((SLOT(handle)->can.filter.mode != FILTER_OFF) && (SLOT(handle)->can.filter.mode != select)) {
+        if ((sts = pcan_reset_filter(handle)) != PCAN_ERROR_OK)
+            return sts;
+    }
     // set the filter value to device
-    switch (mode) {
+    switch (select) {
         case FILTER_STD:                // 11-bit identifier
-            value = (filter ^ FILTER_STD_XOR_MASK);   // SJA100 has inverted masks bits!
-            if ((sts = CAN_SetValue(can[handle].board, PCAN_ACCEPTANCE_FILTER_11BIT,
+            value = (filter[0] ^ FILTER_STD_XOR_MASK);   // SJA100 has inverted masks bits!
+            if ((sts = CAN_SetValue(SLOT(handle)->can.board, PCAN_ACCEPTANCE_FILTER_11BIT,
                                    (void*)&value, sizeof(value))) == PCAN_ERROR_OK) {
-                can[handle].filter.mode = FILTER_STD;
-                can[handle].filter.mask = (uint64_t)value;
+                SLOT(handle)->can.filter.mode = FILTER_STD;
+                SLOT(handle)->can.filter.mask = (uint64_t)value;
             }
             break;
         case FILTER_XTD:                // 29-bit identifier
-            value = (filter ^ FILTER_XTD_XOR_MASK);   // SJA100 has inverted masks bits!
-            if ((sts = CAN_SetValue(can[handle].board, PCAN_ACCEPTANCE_FILTER_29BIT,
+            value = (filter[1] ^ FILTER_XTD_XOR_MASK);   // SJA100 has inverted masks bits!
+            if ((sts = CAN_SetValue(SLOT(handle)->can.board, PCAN_ACCEPTANCE_FILTER_29BIT,
                                    (void*)&value, sizeof(value))) == PCAN_ERROR_OK) {
-                can[handle].filter.mode = FILTER_XTD;
-                can[handle].filter.mask = (uint64_t)value;
+                SLOT(handle)->can.filter.mode = FILTER_XTD;
+                SLOT(handle)->can.filter.mask = (uint64_t)value;
             }
             break;
         default:                        // no filtering
@@ -1396,23 +3880,23 @@ static TPCANStatus pcan_reset_filter(int handle)
     UINT64 value = 0x0ull;              // PCAN filter value
 
     // note: it seems that the hardware filter is not resetted by 'PCAN_MESSAGE_FILTER' := 'PCAN_FILTER_OPEN'
-    switch (can[handle].filter.mode) {
+    switch (SLOT(handle)->can.filter.mode) {
         case FILTER_STD:                // 11-bit identifier
             value = (FILTER_RESET_VALUE ^ FILTER_STD_XOR_MASK);   // SJA100 has inverted masks bits!
-            (void)CAN_SetValue(can[handle].board, PCAN_ACCEPTANCE_FILTER_11BIT, (void*)&value, sizeof(value));
+            (void)CAN_SetValue(SLOT(handle)->can.board, PCAN_ACCEPTANCE_FILTER_11BIT, (void*)&value, sizeof(value));
             break;
         case FILTER_XTD:                // 29-bit identifier
             value = (FILTER_RESET_VALUE ^ FILTER_XTD_XOR_MASK);   // SJA100 has inverted masks bits!
-            (void)CAN_SetValue(can[handle].board, PCAN_ACCEPTANCE_FILTER_29BIT, (void*)&value, sizeof(value));
+            (void)CAN_SetValue(SLOT(handle)->can.board, PCAN_ACCEPTANCE_FILTER_29BIT, (void*)&value, sizeof(value));
             break;
         default:                        // no filtering
             break;
     }
 #endif
     // reset the filter value to device
-    if ((sts = CAN_SetValue(can[handle].board, (BYTE)PCAN_MESSAGE_FILTER,
+    if ((sts = CAN_SetValue(SLOT(handle)->can.board, (BYTE)PCAN_MESSAGE_FILTER,
                            (void*)&filter, (DWORD)sizeof(uint8_t))) == PCAN_ERROR_OK) {
-        can[handle].filter.mode = FILTER_OFF;
+        SLOT(handle)->can.filter.mode = FILTER_OFF;
     }
     return sts;
 }
@@ -1428,7 +3912,8 @@ static int lib_parameter(uint16_t param, void *value, size_t nbyte)
     if (value == NULL) {                // check for null-pointer
         if ((param != CANPROP_SET_FIRST_CHANNEL) &&
             (param != CANPROP_SET_NEXT_CHANNEL) &&
-            (param != CANPROP_SET_FILTER_RESET))
+            (param != CANPROP_SET_FILTER_RESET) &&
+            (param != CANPROP_SET_INSTRUMENTATION_RESET))
             return CANERR_NULLPTR;
     }
     // query or modify a CAN library property
@@ -1563,6 +4048,13 @@ static int lib_parameter(uint16_t param, void *value, size_t nbyte)
                 rc = CANERR_RESOURCE;
         }
         break;
+    case CANPROP_GET_CHANNEL_STATES:    // probe all channels of the interface list (int8_t[])
+        if (nbyte >= sizeof(int8_t)) {
+            LOCK_TABLE();
+            rc = probe_channels((int8_t*)value, nbyte / sizeof(int8_t));
+            UNLOCK_TABLE();
+        }
+        break;
     case CANPROP_GET_DEVICE_TYPE:       // device type of the CAN interface (int32_t)
     case CANPROP_GET_DEVICE_NAME:       // device name of the CAN interface (char[])
     case CANPROP_GET_OP_CAPABILITY:     // supported operation modes of the CAN controller (uint8_t)
@@ -1585,6 +4077,30 @@ static int lib_parameter(uint16_t param, void *value, size_t nbyte)
     case CANPROP_SET_FILTER_11BIT:      // set value for acceptance filter code and mask for 11-bit identifier (uint64_t)
     case CANPROP_SET_FILTER_29BIT:      // set value for acceptance filter code and mask for 29-bit identifier (uint64_t)
     case CANPROP_SET_FILTER_RESET:      // reset acceptance filter code and mask to default values (NULL)
+    case CANPROP_GET_RECEIVE_FD:        // file descriptor of the receive event (int)
+    case CANPROP_GET_SPIN_BUDGET:       // spin budget of a blocking read in [ns] (uint32_t)
+    case CANPROP_SET_SPIN_BUDGET:       // set spin budget of a blocking read in [ns] (uint32_t)
+    case CANPROP_GET_SPIN_COUNTER:      // number of messages received while spinning (uint64_t)
+    case CANPROP_GET_BLOCK_COUNTER:     // number of messages received after blocking (uint64_t)
+    case CANPROP_SET_RCV_QUEUE_SIZE:    // set size of the receive ring (uint32_t)
+    case CANPROP_GET_BUSLOAD_WINDOW:    // length of the bus load window in [ms] (uint32_t)
+    case CANPROP_SET_BUSLOAD_WINDOW:    // set length of the bus load window in [ms] (uint32_t)
+    case CANPROP_SET_FROMTO_11BIT:      // add an 11-bit identifier range to the from-to filter list (uint64_t)
+    case CANPROP_SET_FROMTO_29BIT:      // add a 29-bit identifier range to the from-to filter list (uint64_t)
+    case CANPROP_SET_CODEMASK_11BIT:    // add an 11-bit identifier code and mask to the software filter (uint64_t)
+    case CANPROP_SET_CODEMASK_29BIT:    // add a 29-bit identifier code and mask to the software filter (uint64_t)
+    case CANPROP_GET_TIMESTAMP_MODE:    // time-stamp mode (uint8_t)
+    case CANPROP_SET_TIMESTAMP_MODE:    // set time-stamp mode (uint8_t)
+    case CANPROP_GET_INSTRUMENTATION:   // instrumentation on/off (uint8_t)
+    case CANPROP_SET_INSTRUMENTATION:   // set instrumentation on/off (uint8_t)
+    case CANPROP_SET_INSTRUMENTATION_RESET:  // clear histograms and rates (NULL)
+    case CANPROP_GET_HISTOGRAM_WAIT:    // histogram of the blocked time of a read (can_pcan_histogram_t)
+    case CANPROP_GET_HISTOGRAM_READ:    // histogram of the duration of CAN_Read[FD] (can_pcan_histogram_t)
+    case CANPROP_GET_HISTOGRAM_WRITE:   // histogram of the duration of CAN_Write[FD] (can_pcan_histogram_t)
+    case CANPROP_GET_HISTOGRAM_AGE:     // histogram of the age of a frame at delivery (can_pcan_histogram_t)
+    case CANPROP_GET_MESSAGE_RATES:     // frames and bytes received and transmitted (can_pcan_rates_t)
+    case CANPROP_GET_VBUS_PACING:       // bit-time pacing of a virtual CAN bus on/off (uint8_t)
+    case CANPROP_SET_VBUS_PACING:       // set bit-time pacing of a virtual CAN bus on/off (uint8_t)
         // note: a device parameter requires a valid handle.
         if (!init)
             rc = CANERR_NOTINIT;
@@ -1622,8 +4138,10 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
     can_speed_t speed;                  // current bus speed
     can_mode_t mode;                    // current operation mode
     uint8_t status = 0u;                // status register
-    uint8_t load = 0u;                  // bus load
+    uint16_t load = 0u;                 // bus load
     char str[MAX_LENGTH_HARDWARE_NAME+1];  // device name
+    uint32_t from, to;                  // identifier range
+    int xtd;                            // 29-bit identifier
     TPCANStatus sts;                    // represents a status
 
     assert(IS_HANDLE_VALID(handle));    // just to make sure
@@ -1631,20 +4149,21 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
     if (value == NULL) {                // check for null-pointer
         if ((param != CANPROP_SET_FIRST_CHANNEL) &&
             (param != CANPROP_SET_NEXT_CHANNEL) &&
-            (param != CANPROP_SET_FILTER_RESET))
+            (param != CANPROP_SET_FILTER_RESET) &&
+            (param != CANPROP_SET_INSTRUMENTATION_RESET))
             return CANERR_NULLPTR;
     }
     // query or modify a CAN interface property
     switch (param) {
     case CANPROP_GET_DEVICE_TYPE:       // device type of the CAN interface (int32_t)
         if (nbyte >= sizeof(int32_t)) {
-            *(int32_t*)value = (int32_t)PCAN_BOARD_TYPE(can[handle].board);
+            *(int32_t*)value = (int32_t)PCAN_BOARD_TYPE(SLOT(handle)->can.board);
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_DEVICE_NAME:       // device name of the CAN interface (char[])
         if (nbyte >= 1u) {
-            if ((sts = CAN_GetValue(can[handle].board, (BYTE)PCAN_HARDWARE_NAME,
+            if ((sts = CAN_GetValue(SLOT(handle)->can.board, (BYTE)PCAN_HARDWARE_NAME,
                 (void*)str, (DWORD)MAX_LENGTH_HARDWARE_NAME)) == PCAN_ERROR_OK) {
                 str[MAX_LENGTH_HARDWARE_NAME] = '\0';
                 strncpy((char*)value, str, nbyte);
@@ -1670,15 +4189,15 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_DEVICE_PARAM:      // device parameter of the CAN interface (can_pcan_param_t)
         if (nbyte >= sizeof(can_pcan_param_t)) {
-            ((can_pcan_param_t*)value)->type = (uint8_t)can[handle].brd_type;
-            ((can_pcan_param_t*)value)->port = (uint32_t)can[handle].brd_port;
-            ((can_pcan_param_t*)value)->irq = (uint16_t)can[handle].brd_irq;
+            ((can_pcan_param_t*)value)->type = (uint8_t)SLOT(handle)->can.brd_type;
+            ((can_pcan_param_t*)value)->port = (uint32_t)SLOT(handle)->can.brd_port;
+            ((can_pcan_param_t*)value)->irq = (uint16_t)SLOT(handle)->can.brd_irq;
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_OP_CAPABILITY:     // supported operation modes of the CAN controller (uint8_t)
         if (nbyte >= sizeof(uint8_t)) {
-            if ((sts = pcan_capability(can[handle].board, &mode)) == PCAN_ERROR_OK) {
+            if ((sts = pcan_capability(SLOT(handle)->can.board, &mode)) == PCAN_ERROR_OK) {
                 *(uint8_t*)value = (uint8_t)mode.byte;
                 rc = CANERR_NOERROR;
             } else
@@ -1687,13 +4206,13 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_OP_MODE:           // active operation mode of the CAN controller (uint8_t)
         if (nbyte >= sizeof(uint8_t)) {
-            *(uint8_t*)value = (uint8_t)can[handle].mode.byte;
+            *(uint8_t*)value = (uint8_t)SLOT(handle)->can.mode.byte;
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_BITRATE:           // active bit-rate of the CAN controller (can_bitrate_t)
         if (nbyte >= sizeof(can_bitrate_t)) {
-            if (((rc = can_bitrate(handle, &bitrate, NULL)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
+            if (((rc = get_bitrate(handle, &bitrate, NULL)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
                 memcpy(value, &bitrate, sizeof(can_bitrate_t));
                 rc = CANERR_NOERROR;
             }
@@ -1701,7 +4220,7 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_SPEED:             // active bus speed of the CAN controller (can_speed_t)
         if (nbyte >= sizeof(can_speed_t)) {
-            if (((rc = can_bitrate(handle, NULL, &speed)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
+            if (((rc = get_bitrate(handle, NULL, &speed)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
                 memcpy(value, &speed, sizeof(can_speed_t));
                 rc = CANERR_NOERROR;
             }
@@ -1709,7 +4228,7 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_STATUS:            // current status register of the CAN controller (uint8_t)
         if (nbyte >= sizeof(uint8_t)) {
-            if ((rc = can_status(handle, &status)) == CANERR_NOERROR) {
+            if ((rc = get_status(handle, &status)) == CANERR_NOERROR) {
                 *(uint8_t*)value = (uint8_t)status;
                 rc = CANERR_NOERROR;
             }
@@ -1717,11 +4236,11 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_BUSLOAD:           // current bus load of the CAN controller (uint16_t)
         if (nbyte >= sizeof(uint8_t)) {
-            if (((rc = can_busload(handle, &load, NULL)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
+            if (((rc = get_busload(handle, &load, NULL)) == CANERR_NOERROR) || (rc == CANERR_OFFLINE)) {
                 if (nbyte > sizeof(uint8_t))
-                    *(uint16_t*)value = (uint16_t)load * 100u;  // 0..10000 ==> 0.00%..100.00%
+                    *(uint16_t*)value = (uint16_t)load;         // 0..10000 ==> 0.00%..100.00%
                 else
-                    *(uint8_t*)value = (uint8_t)load;           // 0..100% (note: legacy resolution)
+                    *(uint8_t*)value = (uint8_t)((load + 50u) / 100u);  // 0..100% (note: legacy resolution)
                 rc = CANERR_NOERROR;
             }
         }
@@ -1739,27 +4258,66 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_GET_TX_COUNTER:        // total number of sent messages (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
-            *(uint64_t*)value = (uint64_t)can[handle].counters.tx;
+            *(uint64_t*)value = (uint64_t)SLOT(handle)->can.counters.tx;
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_RX_COUNTER:        // total number of reveiced messages (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
-            *(uint64_t*)value = (uint64_t)can[handle].counters.rx;
+            *(uint64_t*)value = __atomic_load_n(&SLOT(handle)->can.counters.rx, __ATOMIC_RELAXED);
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_ERR_COUNTER:       // total number of reveiced error frames (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
-            *(uint64_t*)value = (uint64_t)can[handle].counters.err;
+            *(uint64_t*)value = __atomic_load_n(&SLOT(handle)->can.counters.err, __ATOMIC_RELAXED);
             rc = CANERR_NOERROR;
         }
         break;
     case CANPROP_GET_RCV_QUEUE_SIZE:    // maximum number of message the receive queue can hold (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            // note: can only be determined for the receive ring of the wrapper
+            if (SLOT(handle)->ring.size != 0U) {
+                *(uint32_t*)value = SLOT(handle)->ring.size;
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = CANERR_NOTSUPP;
+        }
+        break;
     case CANPROP_GET_RCV_QUEUE_HIGH:    // maximum number of message the receive queue has hold (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            // note: can only be determined for the receive ring of the wrapper
+            if (SLOT(handle)->ring.size != 0U) {
+                *(uint32_t*)value = __atomic_load_n(&SLOT(handle)->ring.high, __ATOMIC_RELAXED);
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = CANERR_NOTSUPP;
+        }
+        break;
     case CANPROP_GET_RCV_QUEUE_OVFL:    // overflow counter of the receive queue (uint64_t)
-        // note: cannot be determined
-        rc = CANERR_NOTSUPP;  // TODO: check UVS parameter extension
+        if (nbyte >= sizeof(uint64_t)) {
+            // note: can only be determined for the receive ring of the wrapper
+            if (SLOT(handle)->ring.size != 0U) {
+                *(uint64_t*)value = __atomic_load_n(&SLOT(handle)->ring.ovfl, __ATOMIC_RELAXED);
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = CANERR_NOTSUPP;
+        }
+        break;
+    case CANPROP_GET_TRM_QUEUE_SIZE:    // maximum number of message the transmit queue can hold (uint32_t)
+    case CANPROP_GET_TRM_QUEUE_HIGH:    // maximum number of message the transmit queue has hold (uint32_t)
+        // note: cannot be determined (PCANBasic does not report the transmit queue level)
+        rc = CANERR_NOTSUPP;
+        break;
+    case CANPROP_GET_TRM_QUEUE_OVFL:    // overflow counter of the transmit queue (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            // note: number of messages rejected with CANERR_TX_BUSY
+            *(uint64_t*)value = (uint64_t)SLOT(handle)->can.transmit.ovfl;
+            rc = CANERR_NOERROR;
+        }
         break;
     case CANPROP_GET_FILTER_11BIT:      // acceptance filter code and mask for 11-bit identifier (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
@@ -1781,7 +4339,7 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         if (nbyte >= sizeof(uint64_t)) {
             if (!(*(uint64_t*)value & ~FILTER_STD_VALID_MASK)) {
                 // note: code and mask must not exceed 11-bit identifier
-                if (can[handle].status.can_stopped) {
+                if ((GET_STATUS(handle) & CANSTAT_RESET)) {
                     // note: set filter only if the CAN controller is in INIT mode
                     if ((sts = pcan_set_filter(handle, *(uint64_t*)value, FILTER_STD)) == PCAN_ERROR_OK)
                         rc = CANERR_NOERROR;
@@ -1797,10 +4355,10 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         break;
     case CANPROP_SET_FILTER_29BIT:      // set value for acceptance filter code and mask for 29-bit identifier (uint64_t)
         if (nbyte >= sizeof(uint64_t)) {
-            if (!(*(uint64_t*)value & ~FILTER_XTD_VALID_MASK) && !can[handle].mode.nxtd) {
+            if (!(*(uint64_t*)value & ~FILTER_XTD_VALID_MASK) && !SLOT(handle)->can.mode.nxtd) {
                 // note: code and mask must not exceed 29-bit identifier and
                 //       extended frame format mode must not be suppressed
-                if (can[handle].status.can_stopped) {
+                if ((GET_STATUS(handle) & CANSTAT_RESET)) {
                     // note: set filter only if the CAN controller is in INIT mode
                     if ((sts = pcan_set_filter(handle, *(uint64_t*)value, FILTER_XTD)) == PCAN_ERROR_OK)
                         rc = CANERR_NOERROR;
@@ -1815,9 +4373,10 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         }
         break;
     case CANPROP_SET_FILTER_RESET:      // reset acceptance filter code and mask to default values (NULL)
-        if (can[handle].status.can_stopped) {
+        if ((GET_STATUS(handle) & CANSTAT_RESET)) {
             // note: reset filter only if the CAN controller is in INIT mode
-            if ((sts = pcan_reset_filter(handle)) == PCAN_ERROR_OK)
+            accept_reset(handle);       //   the software filter
+            if ((sts = pcan_set_filter(handle, FILTER_RESET_VALUE, FILTER_OFF)) == PCAN_ERROR_OK)
                 rc = CANERR_NOERROR;
             else
                 rc = pcan_error(sts);
@@ -1825,10 +4384,245 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         else
             rc = CANERR_ONLINE;
         break;
+    case CANPROP_SET_FROMTO_11BIT:      // add an 11-bit identifier range to the from-to filter list (uint64_t)
+    case CANPROP_SET_FROMTO_29BIT:      // add a 29-bit identifier range to the from-to filter list (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            // note: first identifier in the upper, last identifier in the lower 32 bits
+            from = (uint32_t)(*(uint64_t*)value >> 32);
+            to = (uint32_t)(*(uint64_t*)value);
+            xtd = (param == CANPROP_SET_FROMTO_29BIT) ? 1 : 0;
+            if ((from <= to) && (to <= (xtd ? CAN_MAX_XTD_ID : CAN_MAX_STD_ID)) && !(xtd && SLOT(handle)->can.mode.nxtd)) {
+                if ((GET_STATUS(handle) & CANSTAT_RESET)) {
+                    // note: the software filter is applied to received messages
+                    //       behind the hardware filter, which is set to the
+                    //       tightest code and mask for all entries
+                    if ((rc = accept_range(handle, from, to, xtd)) == CANERR_NOERROR) {
+                        if ((sts = pcan_apply_filter(handle)) != PCAN_ERROR_OK)
+                            rc = pcan_error(sts);
+                    }
+                }
+                else
+                    rc = CANERR_ONLINE;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case CANPROP_SET_CODEMASK_11BIT:    // add an 11-bit identifier code and mask to the software filter (uint64_t)
+    case CANPROP_SET_CODEMASK_29BIT:    // add a 29-bit identifier code and mask to the software filter (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            xtd = (param == CANPROP_SET_CODEMASK_29BIT) ? 1 : 0;
+            if (!(*(uint64_t*)value & ~(xtd ? FILTER_XTD_VALID_MASK : FILTER_STD_VALID_MASK)) && !(xtd && SLOT(handle)->can.mode.nxtd)) {
+                if ((GET_STATUS(handle) & CANSTAT_RESET)) {
+                    // note: code in the upper, mask in the lower 32 bits (as the hardware filter)
+                    if ((rc = accept_mask(handle, (uint32_t)(*(uint64_t*)value >> 32), (uint32_t)(*(uint64_t*)value), xtd)) == CANERR_NOERROR) {
+                        if ((sts = pcan_apply_filter(handle)) != PCAN_ERROR_OK)
+                            rc = pcan_error(sts);
+                    }
+                }
+                else
+                    rc = CANERR_ONLINE;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case CANPROP_GET_RECEIVE_FD:        // file descriptor of the receive event (int)
+        if (nbyte >= sizeof(int)) {
+            if (!(GET_STATUS(handle) & CANSTAT_RESET)) {
+                // note: the file descriptor is valid only while the CAN controller is running
+                *(int*)value = RX_EVENT(handle);
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = CANERR_OFFLINE;
+        }
+        break;
+    case CANPROP_GET_SPIN_BUDGET:       // spin budget of a blocking read in [ns] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = SLOT(handle)->can.receive.spin;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_SET_SPIN_BUDGET:       // set spin budget of a blocking read in [ns] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            // note: the spin budget can be changed at any time
+            SLOT(handle)->can.receive.spin = *(uint32_t*)value;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_SPIN_COUNTER:      // number of messages received while spinning (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            *(uint64_t*)value = SLOT(handle)->can.receive.spun;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_BLOCK_COUNTER:     // number of messages received after blocking (uint64_t)
+        if (nbyte >= sizeof(uint64_t)) {
+            *(uint64_t*)value = SLOT(handle)->can.receive.blocked;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_SET_RCV_QUEUE_SIZE:    // set size of the receive ring (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if (*(uint32_t*)value <= RING_MAX_SIZE) {
+                if ((GET_STATUS(handle) & CANSTAT_RESET)) {
+                    // note: the ring is (re-)allocated when the CAN controller is started,
+                    //       its size is rounded up to the next power of two (0 = off)
+                    free(SLOT(handle)->ring.buffer);
+                    SLOT(handle)->ring.buffer = NULL;
+                    SLOT(handle)->ring.size = (*(uint32_t*)value != 0U) ? 1U : 0U;
+                    while ((SLOT(handle)->ring.size != 0U) && (SLOT(handle)->ring.size < *(uint32_t*)value))
+                        SLOT(handle)->ring.size <<= 1;
+                    rc = CANERR_NOERROR;
+                }
+                else
+                    rc = CANERR_ONLINE;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case CANPROP_GET_BUSLOAD_WINDOW:    // length of the bus load window in [ms] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            *(uint32_t*)value = SLOT(handle)->can.busload.window;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_SET_BUSLOAD_WINDOW:    // set length of the bus load window in [ms] (uint32_t)
+        if (nbyte >= sizeof(uint32_t)) {
+            if ((BUSLOAD_WINDOW_MIN <= *(uint32_t*)value) && (*(uint32_t*)value <= BUSLOAD_WINDOW_MAX)) {
+                // note: the measurement is restarted with the new window length
+                SLOT(handle)->can.busload.window = *(uint32_t*)value;
+                busload_reset(handle, poll_clock());
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case CANPROP_GET_TIMESTAMP_MODE:    // time-stamp mode (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = SLOT(handle)->can.clock.mode;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_SET_TIMESTAMP_MODE:    // set time-stamp mode (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (*(uint8_t*)value <= PCAN_TIMESTAMP_REALTIME) {
+                if ((GET_STATUS(handle) & CANSTAT_RESET)) {
+                    // note: the correlation starts when the CAN controller is started
+                    SLOT(handle)->can.clock.mode = *(uint8_t*)value;
+                    rc = CANERR_NOERROR;
+                }
+                else
+                    rc = CANERR_ONLINE;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case CANPROP_GET_INSTRUMENTATION:   // instrumentation on/off (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            *(uint8_t*)value = INSTRUMENTED(handle) ? 1U : 0U;
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_SET_INSTRUMENTATION:   // set instrumentation on/off (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+            if (*(uint8_t*)value <= 1U) {
+                // note: it can be switched on and off at any time (w/o reset)
+                __atomic_store_n(&SLOT(handle)->can.instrument.enabled, (int)*(uint8_t*)value, __ATOMIC_RELAXED);
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = CANERR_ILLPARA;
+        }
+        break;
+    case CANPROP_SET_INSTRUMENTATION_RESET:  // clear histograms and rates (NULL)
+        instrument_reset(handle);
+        rc = CANERR_NOERROR;
+        break;
+    case CANPROP_GET_HISTOGRAM_WAIT:    // histogram of the blocked time of a read (can_pcan_histogram_t)
+        if (nbyte >= sizeof(can_pcan_histogram_t)) {
+            instrument_copy(&SLOT(handle)->can.instrument.wait, (can_pcan_histogram_t*)value);
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_HISTOGRAM_READ:    // histogram of the duration of CAN_Read[FD] (can_pcan_histogram_t)
+        if (nbyte >= sizeof(can_pcan_histogram_t)) {
+            instrument_copy(&SLOT(handle)->can.instrument.read, (can_pcan_histogram_t*)value);
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_HISTOGRAM_WRITE:   // histogram of the duration of CAN_Write[FD] (can_pcan_histogram_t)
+        if (nbyte >= sizeof(can_pcan_histogram_t)) {
+            instrument_copy(&SLOT(handle)->can.instrument.write, (can_pcan_histogram_t*)value);
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_HISTOGRAM_AGE:     // histogram of the age of a frame at delivery (can_pcan_histogram_t)
+        if (nbyte >= sizeof(can_pcan_histogram_t)) {
+            instrument_copy(&SLOT(handle)->can.instrument.age, (can_pcan_histogram_t*)value);
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_MESSAGE_RATES:     // frames and bytes received and transmitted (can_pcan_rates_t)
+        if (nbyte >= sizeof(can_pcan_rates_t)) {
+            can_pcan_rates_t *rates = (can_pcan_rates_t*)value;
+            rates->elapsed = poll_clock() - __atomic_load_n(&SLOT(handle)->can.instrument.since, __ATOMIC_RELAXED);
+            rates->rx_frames = __atomic_load_n(&SLOT(handle)->can.instrument.rx_frames, __ATOMIC_RELAXED);
+            rates->rx_bytes = __atomic_load_n(&SLOT(handle)->can.instrument.rx_bytes, __ATOMIC_RELAXED);
+            rates->tx_frames = __atomic_load_n(&SLOT(handle)->can.instrument.tx_frames, __ATOMIC_RELAXED);
+            rates->tx_bytes = __atomic_load_n(&SLOT(handle)->can.instrument.tx_bytes, __ATOMIC_RELAXED);
+            // note: the rates are averages since the reset (resp. the start)
+            rates->rx_fps = RATE_PER_SECOND(rates->rx_frames, rates->elapsed);
+            rates->rx_bps = RATE_PER_SECOND(rates->rx_bytes, rates->elapsed);
+            rates->tx_fps = RATE_PER_SECOND(rates->tx_frames, rates->elapsed);
+            rates->tx_bps = RATE_PER_SECOND(rates->tx_bytes, rates->elapsed);
+            rc = CANERR_NOERROR;
+        }
+        break;
+    case CANPROP_GET_VBUS_PACING:       // bit-time pacing of a virtual CAN bus on/off (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+#if (OPTION_PCAN_VIRTUAL_BUS != 0)
+            DWORD pacing = PCAN_PARAMETER_OFF;
+            if (!IS_VIRTUAL(SLOT(handle)->can.board))
+                rc = CANERR_NOTSUPP;
+            else if ((sts = CAN_GetValue(SLOT(handle)->can.board, (BYTE)VBUS_PACING,
+                (void*)&pacing, sizeof(pacing))) == PCAN_ERROR_OK) {
+                *(uint8_t*)value = (pacing != PCAN_PARAMETER_OFF) ? 1U : 0U;
+                rc = CANERR_NOERROR;
+            }
+            else
+                rc = pcan_error(sts);
+#else
+            rc = CANERR_NOTSUPP;
+#endif
+        }
+        break;
+    case CANPROP_SET_VBUS_PACING:       // set bit-time pacing of a virtual CAN bus on/off (uint8_t)
+        if (nbyte >= sizeof(uint8_t)) {
+#if (OPTION_PCAN_VIRTUAL_BUS != 0)
+            DWORD pacing = (*(uint8_t*)value != 0U) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            if (!IS_VIRTUAL(SLOT(handle)->can.board))
+                rc = CANERR_NOTSUPP;
+            else if (*(uint8_t*)value > 1U)
+                rc = CANERR_ILLPARA;
+            else if ((sts = CAN_SetValue(SLOT(handle)->can.board, (BYTE)VBUS_PACING,
+                (void*)&pacing, sizeof(pacing))) == PCAN_ERROR_OK)
+                rc = CANERR_NOERROR;
+            else
+                rc = pcan_error(sts);
+#else
+            rc = CANERR_NOTSUPP;
+#endif
+        }
+        break;
     default:
         if ((CANPROP_GET_VENDOR_PROP <= param) &&  // get a vendor-specific property value (void*)
            (param < (CANPROP_GET_VENDOR_PROP + CANPROP_VENDOR_PROP_RANGE))) {
-            if ((sts = CAN_GetValue(can[handle].board, (BYTE)(param - CANPROP_GET_VENDOR_PROP),
+            if ((sts = CAN_GetValue(SLOT(handle)->can.board, (BYTE)(param - CANPROP_GET_VENDOR_PROP),
                 (void*)value, (DWORD)nbyte)) == PCAN_ERROR_OK)
                 rc = CANERR_NOERROR;
             else
@@ -1836,7 +4630,7 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
         }
         else if ((CANPROP_SET_VENDOR_PROP <= param) &&  // set a vendor-specific property value (void*)
                 (param < (CANPROP_SET_VENDOR_PROP + CANPROP_VENDOR_PROP_RANGE))) {
-            if ((sts = CAN_SetValue(can[handle].board, (BYTE)(param - CANPROP_SET_VENDOR_PROP),
+            if ((sts = CAN_SetValue(SLOT(handle)->can.board, (BYTE)(param - CANPROP_SET_VENDOR_PROP),
                 (void*)value, (DWORD)nbyte)) == PCAN_ERROR_OK)
                 rc = CANERR_NOERROR;
             else
@@ -1849,6 +4643,30 @@ static int drv_parameter(int handle, uint16_t param, void *value, size_t nbyte)
     return rc;
 }
 
+static int drv_modifier(uint16_t param)
+{
+    // properties that modify the handle state require exclusive access
+    switch (param) {
+    case CANPROP_SET_FILTER_11BIT:      // set value for acceptance filter code and mask for 11-bit identifier (uint64_t)
+    case CANPROP_SET_FILTER_29BIT:      // set value for acceptance filter code and mask for 29-bit identifier (uint64_t)
+    case CANPROP_SET_FILTER_RESET:      // reset acceptance filter code and mask to default values (NULL)
+    case CANPROP_SET_SPIN_BUDGET:       // set spin budget of a blocking read in [ns] (uint32_t)
+    case CANPROP_SET_RCV_QUEUE_SIZE:    // set size of the receive ring (uint32_t)
+    case CANPROP_SET_BUSLOAD_WINDOW:    // set length of the bus load window in [ms] (uint32_t)
+    case CANPROP_SET_FROMTO_11BIT:      // add an 11-bit identifier range to the from-to filter list (uint64_t)
+    case CANPROP_SET_FROMTO_29BIT:      // add a 29-bit identifier range to the from-to filter list (uint64_t)
+    case CANPROP_SET_CODEMASK_11BIT:    // add an 11-bit identifier code and mask to the software filter (uint64_t)
+    case CANPROP_SET_CODEMASK_29BIT:    // add a 29-bit identifier code and mask to the software filter (uint64_t)
+    case CANPROP_SET_TIMESTAMP_MODE:    // set time-stamp mode (uint8_t)
+    case CANPROP_SET_INSTRUMENTATION:   // set instrumentation on/off (uint8_t)
+    case CANPROP_SET_INSTRUMENTATION_RESET:  // clear histograms and rates (NULL)
+        return 1;
+    default:
+        return ((CANPROP_SET_VENDOR_PROP <= param) &&  // set a vendor-specific property value (void*)
+                (param < (CANPROP_SET_VENDOR_PROP + CANPROP_VENDOR_PROP_RANGE))) ? 1 : 0;
+    }
+}
+
 /*  -----------  revision control  ---------------------------------------
  */
 EXPORT
@@ -0,0 +1,340 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later */
+/*
+ *  CAN Interface API, Version 3 (for PEAK-System PCAN Interfaces)
+ *
+ *  Copyright (c) 2005-2012 Uwe Vogt, UV Software, Friedrichshafen
+ *  Copyright (c) 2013-2025 Uwe Vogt, UV Software, Berlin (info@mac-can.com)
+ *  All rights reserved.
+ *
+ *  This file is part of PCBUSB-Wrapper.
+ *
+ *  PCBUSB-Wrapper is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v2.0 (or any later version). You can
+ *  choose between one of them if you use PCBUSB-Wrapper in whole or in part.
+ *
+ *  (1) BSD 2-Clause "Simplified" License
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  PCBUSB-Wrapper IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF PCBUSB-Wrapper, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  (2) GNU General Public License v2.0 or later
+ *
+ *  PCBUSB-Wrapper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PCBUSB-Wrapper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with PCBUSB-Wrapper; if not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        can_util.h
+ *
+ *  @brief       Helpers shared by the wrapper, the virtual CAN bus and the
+ *               PCANBasic simulation.
+ *
+ *  @note        The bus time of a CAN frame (exact number of stuff bits and
+ *               CRC-15) is needed by the bus load of the wrapper as well as
+ *               by the bit-time pacing of the virtual CAN bus and of the
+ *               simulation. The parameter buffer helpers implement the
+ *               CAN_GetValue/CAN_SetValue conventions of PCANBasic for the
+ *               latter two, and so do the arbitration and the acceptance of
+ *               a frame on their CAN bus. The functions are static inline, so
+ *               no object file has to be added to the builds.
+ *
+ *  @addtogroup  can_api
+ *  @{
+ */
+#ifndef CAN_UTIL_H_INCLUDED
+#define CAN_UTIL_H_INCLUDED
+
+/*  -----------  includes  ------------------------------------------------
+ */
+
+#if defined(__APPLE__)
+#include "PCBUSB.h"
+#else
+#include "PCANBasic.h"
+#endif
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define UTIL_CRC15_POLY  (0x4599U)  ///< CRC-15 polynomial (CAN 2.0)
+#define UTIL_STD_MASK  (0x7FFU)  ///< 11-bit identifier mask
+#define UTIL_XTD_MASK  (0x1FFFFFFFU)  ///< 29-bit identifier mask
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+typedef struct {                        // bit stream of a CAN frame:
+    uint32_t bits;                      //   number of bits (w/o stuff bits)
+    uint32_t stuff;                     //   number of (dynamic) stuff bits
+    uint32_t run;                       //   number of bits of equal level
+    uint32_t level;                     //   level of the last bit (2 = none)
+    uint32_t crc;                       //   CRC-15 of the bits (CAN 2.0)
+}   util_bitstream_t;
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+/** @brief       appends 'n' bits of a value (MSB first) to a bit stream and
+ *               counts the stuff bits and the CRC-15 of CAN 2.0.
+ */
+static inline void util_bits(util_bitstream_t *stream, uint32_t value, int n)
+{
+    uint32_t bit;                       // the next bit (MSB first)
+
+    while (n-- > 0) {
+        bit = (value >> n) & 1U;
+        // CRC-15 of CAN 2.0 (over the unstuffed bits)
+        stream->crc = ((stream->crc << 1) ^ ((((stream->crc >> 14) & 1U) != bit) ? UTIL_CRC15_POLY : 0U)) & 0x7FFFU;
+        // a complementary stuff bit after five bits of equal level
+        if (bit == stream->level)
+            stream->run++;
+        else {
+            stream->level = bit;
+            stream->run = 1U;
+        }
+        if (stream->run == 5U) {
+            stream->stuff++;
+            stream->level = bit ^ 1U;
+            stream->run = 1U;
+        }
+        stream->bits++;
+    }
+}
+
+/** @brief       returns the bus time of a CAN frame in picoseconds.
+ *
+ *  @param[in]   id      - CAN identifier
+ *  @param[in]   type    - PCAN message type (PCAN_MESSAGE_xyz)
+ *  @param[in]   dlc     - data length code
+ *  @param[in]   data    - payload
+ *  @param[in]   nominal - nominal bit time [ps]
+ *  @param[in]   phase   - data phase bit time [ps]
+ *
+ *  @note        With the exact number of stuff bits, 3 bits interframe space
+ *               and the data phase of a CAN FD frame with BRS at the data
+ *               phase bit-rate.
+ */
+static inline uint64_t util_frame_time(DWORD id, BYTE type, BYTE dlc, const BYTE *data, uint32_t nominal, uint32_t phase)
+{
+    static const uint8_t dlc_table[16] = {  // DLC to length
+        0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64
+    };
+    util_bitstream_t stream = { 0U, 0U, 0U, 2U, 0U };  // bit stream of the frame
+    uint32_t xtd = (type & PCAN_MESSAGE_EXTENDED) ? 1U : 0U;  // extended format
+    uint32_t rtr = (type & PCAN_MESSAGE_RTR) ? 1U : 0U;       // remote frame
+    uint32_t brs = (type & PCAN_MESSAGE_BRS) ? 1U : 0U;       // bit-rate switching
+    uint32_t esi = (type & PCAN_MESSAGE_ESI) ? 1U : 0U;       // error state indicator
+    uint32_t arbitration;               // bits of the arbitration phase
+    uint32_t bits;                      // bits of the data phase
+    uint8_t len;                        // payload length
+    uint8_t i;                          // loop variable
+
+    util_bits(&stream, 0U, 1);          // SOF
+    if (!(type & PCAN_MESSAGE_FD)) {
+        // CAN 2.0 frame: stuff bits from SOF to the end of the CRC field
+        if (!xtd) {
+            util_bits(&stream, id, 11);  // identifier
+            util_bits(&stream, rtr, 1);  // RTR
+            util_bits(&stream, 0U, 2);   // IDE, r0
+        }
+        else {
+            util_bits(&stream, id >> 18, 11);  // base identifier
+            util_bits(&stream, 3U, 2);         // SRR, IDE
+            util_bits(&stream, id, 18);        // identifier extension
+            util_bits(&stream, rtr, 1);        // RTR
+            util_bits(&stream, 0U, 2);         // r1, r0
+        }
+        util_bits(&stream, dlc, 4);     // DLC
+        len = !rtr ? ((dlc < 8U) ? dlc : 8U) : 0U;
+        for (i = 0U; i < len; i++)
+            util_bits(&stream, data[i], 8);
+        util_bits(&stream, stream.crc, 15);  // CRC sequence
+        // CRC delimiter, ACK slot, ACK delimiter, EOF (7 bits) and IFS (3 bits)
+        return (uint64_t)(stream.bits + stream.stuff + 13U) * nominal;
+    }
+    // CAN FD frame: dynamic stuff bits from SOF to the end of the data field
+    if (!xtd) {
+        util_bits(&stream, id, 11);     // identifier
+        util_bits(&stream, 0U, 2);      // RRS, IDE
+    }
+    else {
+        util_bits(&stream, id >> 18, 11);  // base identifier
+        util_bits(&stream, 3U, 2);         // SRR, IDE
+        util_bits(&stream, id, 18);        // identifier extension
+        util_bits(&stream, 0U, 1);         // RRS
+    }
+    util_bits(&stream, 2U, 2);          // FDF, res
+    util_bits(&stream, brs, 1);         // BRS
+    arbitration = stream.bits + stream.stuff;
+    util_bits(&stream, esi, 1);         // ESI
+    util_bits(&stream, dlc, 4);         // DLC
+    len = dlc_table[dlc & 0xFU];
+    for (i = 0U; i < len; i++)
+        util_bits(&stream, data[i], 8);
+    // stuff count (4 bits) and CRC-17 resp. CRC-21 with fixed stuff bits
+    bits = (stream.bits + stream.stuff) - arbitration;
+    bits += (len <= 16U) ? (4U + 17U + 6U) : (4U + 21U + 7U);
+    // CRC delimiter, ACK slot, ACK delimiter, EOF (7 bits) and IFS (3 bits)
+    arbitration += 13U;
+    return ((uint64_t)arbitration * nominal) + ((uint64_t)bits * (brs ? phase : nominal));
+}
+
+/** @brief       returns the arbitration field of a CAN frame (dominant = 0),
+ *               i.e. the frame with the lowest value wins the arbitration.
+ *
+ *  @param[in]   id      - CAN identifier
+ *  @param[in]   type    - PCAN message type (PCAN_MESSAGE_xyz)
+ */
+static inline uint32_t util_arbitration(DWORD id, BYTE type)
+{
+    // base identifier, RTR/SRR, IDE, identifier extension and RTR
+    if (!(type & PCAN_MESSAGE_EXTENDED))
+        return ((id & UTIL_STD_MASK) << 21) | ((type & PCAN_MESSAGE_RTR) ? (1U << 20) : 0U);
+    return (((id >> 18) & UTIL_STD_MASK) << 21) | (3U << 19) | ((id & 0x3FFFFU) << 1) |
+           ((type & PCAN_MESSAGE_RTR) ? 1U : 0U);
+}
+
+/** @brief       returns 1 if a receiver can receive a CAN frame of a sender,
+ *               or 0 if it would see an error frame.
+ *
+ *  @param[in]   nominal - nominal bit time of the receiver [ps]
+ *  @param[in]   phase   - data phase bit time of the receiver [ps]
+ *  @param[in]   fdoe    - CAN FD operation enabled at the receiver
+ *  @param[in]   type    - PCAN message type (PCAN_MESSAGE_xyz)
+ *  @param[in]   sender_nominal - nominal bit time of the sender [ps]
+ *  @param[in]   sender_phase   - data phase bit time of the sender [ps]
+ */
+static inline int util_match(uint32_t nominal, uint32_t phase, int fdoe, BYTE type,
+                             uint32_t sender_nominal, uint32_t sender_phase)
+{
+    // a receiver with different bit-rate settings would see an error frame
+    if (nominal != sender_nominal)
+        return 0;
+    if ((type & PCAN_MESSAGE_FD) && !fdoe)
+        return 0;
+    if ((type & PCAN_MESSAGE_BRS) && (phase != sender_phase))
+        return 0;
+    return 1;
+}
+
+/** @brief       returns 1 if a CAN frame passes the message filter and the
+ *               acceptance filter of a receiver, otherwise 0.
+ *
+ *  @param[in]   id        - CAN identifier
+ *  @param[in]   type      - PCAN message type (PCAN_MESSAGE_xyz)
+ *  @param[in]   filter    - PCAN_MESSAGE_FILTER of the receiver
+ *  @param[in]   allow_rtr - PCAN_ALLOW_RTR_FRAMES of the receiver
+ *  @param[in]   accept    - PCAN_ACCEPTANCE_FILTER_11BIT/29BIT of the receiver
+ */
+static inline int util_accept(DWORD id, BYTE type, DWORD filter, DWORD allow_rtr, const UINT64 accept[2])
+{
+    int xtd = (type & PCAN_MESSAGE_EXTENDED) ? 1 : 0;
+    uint32_t code = (uint32_t)(accept[xtd] >> 32);
+    uint32_t mask = (uint32_t)(accept[xtd]);
+
+    if (filter == PCAN_FILTER_CLOSE)
+        return 0;
+    if ((type & PCAN_MESSAGE_RTR) && !allow_rtr)
+        return 0;
+    // acceptance filter: mask bits set are don't care (SJA1000)
+    if ((id ^ code) & ~mask & (xtd ? UTIL_XTD_MASK : UTIL_STD_MASK))
+        return 0;
+    return 1;
+}
+
+/** @brief       returns the monotonic time in nanoseconds.
+ */
+static inline uint64_t util_clock(void)
+{
+    struct timespec now;                // current time
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+#if defined(__linux__)
+/** @brief       sleeps until the given monotonic time [ns].
+ */
+static inline void util_sleep(uint64_t until)
+{
+    struct timespec ts;                 // absolute time
+
+    ts.tv_sec = (time_t)(until / 1000000000U);
+    ts.tv_nsec = (long)(until % 1000000000U);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+#endif
+
+/** @brief       copies a parameter value into the buffer of CAN_GetValue.
+ *
+ *  @note        Numeric parameters can be read into a smaller buffer (little endian).
+ */
+static inline TPCANStatus util_put(void *buffer, DWORD length, const void *value, DWORD size)
+{
+    if (!length)
+        return PCAN_ERROR_ILLPARAMVAL;
+    memcpy(buffer, value, (length < size) ? length : size);
+    return PCAN_ERROR_OK;
+}
+
+/** @brief       copies a string parameter into the buffer of CAN_GetValue.
+ */
+static inline TPCANStatus util_put_string(void *buffer, DWORD length, const char *string)
+{
+    if (!length)
+        return PCAN_ERROR_ILLPARAMVAL;
+    strncpy((char*)buffer, string, (size_t)length);
+    ((char*)buffer)[length - 1U] = '\0';
+    return PCAN_ERROR_OK;
+}
+
+/** @brief       returns a DWORD parameter from the buffer of CAN_SetValue.
+ */
+static inline DWORD util_get_dword(const void *buffer, DWORD length)
+{
+    DWORD value = 0U;                   // note: little endian
+
+    memcpy(&value, buffer, (length < sizeof(DWORD)) ? length : sizeof(DWORD));
+    return value;
+}
+
+#endif /* CAN_UTIL_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de, Homepage: https://www.uv-software.de/
+ */
@@ -0,0 +1,1020 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later */
+/*
+ *  CAN Interface API, Version 3 (for PEAK-System PCAN Interfaces)
+ *
+ *  Copyright (c) 2005-2012 Uwe Vogt, UV Software, Friedrichshafen
+ *  Copyright (c) 2013-2025 Uwe Vogt, UV Software, Berlin (info@mac-can.com)
+ *  All rights reserved.
+ *
+ *  This file is part of PCBUSB-Wrapper.
+ *
+ *  PCBUSB-Wrapper is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v2.0 (or any later version). You can
+ *  choose between one of them if you use PCBUSB-Wrapper in whole or in part.
+ *
+ *  (1) BSD 2-Clause "Simplified" License
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  PCBUSB-Wrapper IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF PCBUSB-Wrapper, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  (2) GNU General Public License v2.0 or later
+ *
+ *  PCBUSB-Wrapper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PCBUSB-Wrapper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with PCBUSB-Wrapper; if not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        can_vbus.c
+ *
+ *  @brief       Virtual CAN bus over shared memory (pseudo-channels).
+ *
+ *  @note        The channels PCAN_VIRTUAL1 and PCAN_VIRTUAL2 of the interface
+ *               list are CAN buses in a shared memory segment (/peakcan-vbus1
+ *               resp. /peakcan-vbus2), which can be attached by up to 32
+ *               processes of the same user at a time. No hardware, driver
+ *               or PCANBasic library is required.
+ *
+ *               The frames are broadcast through a lock-free ring of 4096
+ *               slots: a sender reserves a slot by an atomic increment of the
+ *               ring head, writes the frame and commits it with a sequence
+ *               number. Each attachment reads the ring with its own cursor;
+ *               if it is overtaken by the senders, the overwritten frames
+ *               are lost (receive queue overrun). A receiver gets the frames
+ *               of all other attachments with the same bit-rate settings
+ *               (no echo), time-stamped in host time (CLOCK_MONOTONIC).
+ *
+ *               Without pacing (default) the bus has no bit time: a frame is
+ *               put into the ring when it is written, in the order of the
+ *               reservation. With bit-time pacing (VBUS_PACING, cf. property
+ *               CANPROP_SET_VBUS_PACING) the frames are queued per attachment
+ *               and one attachment is the bus master: its bus thread
+ *               arbitrates the queued frames by identifier (lowest wins),
+ *               keeps the bus busy for the exact bit time of each frame (incl.
+ *               stuff bits and data phase bit-rate) and then puts it into the
+ *               ring with its end-of-frame time-stamp. When the bus master
+ *               detaches or dies, another attachment takes over.
+ *
+ *               Not modelled: bus errors and error frames, acknowledge (a
+ *               frame is sent even if no other node is attached). The segment
+ *               persists after the last detach (/dev/shm/peakcan-vbus*).
+ *
+ *  @addtogroup  can_api
+ *  @{
+ */
+#if !defined(__linux__)
+#error Platform not supported
+#endif
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+#include "can_vbus.h"
+#include "can_btr.h"
+#include "can_util.h"
+
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/*  -----------  defines  ------------------------------------------------
+ */
+#define VBUS_HARDWARE_NAME      "PCAN-Virtual (Shared Memory)"
+#define VBUS_FIRMWARE_VERSION   "1.0.0"
+#define VBUS_SEGMENT_NAME       "/peakcan-vbus%u"
+#define VBUS_MAGIC              (0x53554256U)  // 'VBUS'
+#define VBUS_LAYOUT             (1U)    // version of the segment layout
+#define VBUS_RING_SIZE          (4096U) // broadcast ring (frames, power of two)
+#define VBUS_RING_MASK          (VBUS_RING_SIZE - 1U)
+#define VBUS_NODES              (32)    // attachments per bus
+#define VBUS_TX_QUEUE           (64U)   // transmit queue per attachment (pacing)
+#define VBUS_WAIT_NS            (100000000U)  // 100ms: wake-up period of the bus thread
+#define VBUS_MASTER_TTL         (250000000U)  // 250ms: heart-beat of the bus master
+#define VBUS_STALL_NS           (100000000U)  // 100ms: a slot is never committed
+#define VBUS_ATTACH_NS          (1000000000U) // 1s: wait for the creator of a segment
+#define VBUS_STD_MASK           (0x7FFU)
+#define VBUS_XTD_MASK           (0x1FFFFFFFU)
+#define VBUS_MSGTYPE_MASK       (PCAN_MESSAGE_EXTENDED | PCAN_MESSAGE_RTR | \
+                                 PCAN_MESSAGE_FD | PCAN_MESSAGE_BRS | PCAN_MESSAGE_ESI)
+#define CACHE_LINE              (64)    // to avoid false sharing
+
+#define SEQ_WRITING(idx)        ((uint64_t)(idx) * 2U + 1U)  // slot is being written
+#define SEQ_COMMITTED(idx)      ((uint64_t)(idx) * 2U + 2U)  // slot holds frame idx
+
+/*  -----------  types  --------------------------------------------------
+ */
+typedef struct {                        // frame on the virtual bus:
+    uint64_t time;                      //   end of frame resp. written [ns]
+    uint32_t id;                        //   identifier
+    uint32_t nominal;                   //   nominal bit time of the sender [ps]
+    uint32_t data;                      //   data phase bit time of the sender [ps]
+    uint8_t type;                       //   PCAN message type
+    uint8_t dlc;                        //   data length code
+    uint8_t node;                       //   attachment of the sender
+    uint8_t reserved;                   //   (alignment)
+    uint8_t payload[64];                //   data field
+}   vbus_frame_t;
+
+typedef struct {                        // slot of the broadcast ring:
+    uint64_t seq;                       //   sequence number (odd while written)
+    vbus_frame_t frame;                 //   the frame
+}   vbus_slot_t;
+
+typedef struct {                        // attachment (in the segment):
+    int32_t pid;                        //   process id (0 = unused)
+    uint32_t head;                      //   transmit queue: next to be written
+    uint32_t tail;                      //   transmit queue: next to be sent
+    uint32_t reserved;                  //   (alignment)
+    vbus_frame_t queue[VBUS_TX_QUEUE];  //   transmit queue (bit-time pacing)
+}   __attribute__((aligned(CACHE_LINE))) vbus_node_t;
+
+typedef struct {                        // shared memory segment:
+    uint32_t magic;                     //   'VBUS' when initialized
+    uint32_t layout;                    //   version of the layout
+    uint64_t head __attribute__((aligned(CACHE_LINE)));  // next slot to be reserved
+    uint32_t events __attribute__((aligned(CACHE_LINE)));  // futex: frames put or queued
+    uint32_t sleepers;                  //   threads waiting on the futex
+    uint32_t pacing __attribute__((aligned(CACHE_LINE)));  // bit-time pacing on/off
+    int32_t master;                     //   bus master (attachment + 1, 0 = none)
+    uint64_t heartbeat;                 //   of the bus master [ns]
+    uint64_t idle;                      //   end of the last frame [ns]
+    vbus_node_t node[VBUS_NODES];       //   the attachments
+    vbus_slot_t ring[VBUS_RING_SIZE];   //   the broadcast ring
+}   vbus_shm_t;
+
+typedef struct {                        // virtual channel (of this process):
+    pthread_mutex_t mutex;              //   serializes (un-)initialization and settings
+    int initialized;                    //   channel is attached
+    int defaults;                       //   PCANBasic defaults are set
+    vbus_shm_t *shm;                    //   the shared memory segment
+    int node;                           //   own attachment
+    uint64_t cursor;                    //   next slot to be read
+    uint64_t stall;                     //   slot at the cursor not committed since [ns]
+    int fdes;                           //   receive event (eventfd)
+    pthread_t thread;                   //   bus thread
+    int running;                        //   bus thread is running
+    int fdoe;                           //   CAN FD operation enabled
+    TPCANBaudrate btr0btr1;             //   bit-rate (CAN 2.0)
+    char bitrate[MAX_LENGTH_VERSION_STRING];  // bit-rate string (CAN FD)
+    DWORD nominal_speed;                //   nominal bus speed [bps]
+    DWORD data_speed;                   //   data phase bus speed [bps]
+    uint32_t nominal;                   //   nominal bit time [ps]
+    uint32_t data;                      //   data phase bit time [ps]
+    DWORD listen_only;                  //   PCAN_LISTEN_ONLY
+    DWORD receive_status;               //   PCAN_RECEIVE_STATUS
+    DWORD allow_status;                 //   PCAN_ALLOW_STATUS_FRAMES
+    DWORD allow_rtr;                    //   PCAN_ALLOW_RTR_FRAMES
+    DWORD allow_error;                  //   PCAN_ALLOW_ERROR_FRAMES
+    DWORD filter;                       //   PCAN_MESSAGE_FILTER
+    UINT64 accept[2];                   //   PCAN_ACCEPTANCE_FILTER_11BIT/29BIT
+    TPCANStatus status;                 //   latched status (queue overrun)
+}   vbus_channel_t;
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+static vbus_channel_t *vbus_channel(TPCANHandle handle);
+static TPCANStatus vbus_initialize(TPCANHandle handle, const btr_bitrate_t *bitrate, int fdoe, int brse,
+                                   TPCANBaudrate btr0btr1, const char *string);
+static TPCANStatus vbus_uninitialize(vbus_channel_t *channel);
+static TPCANStatus vbus_read(TPCANHandle handle, int fdoe, TPCANMsgFD *msg, uint64_t *time);
+static TPCANStatus vbus_write(TPCANHandle handle, int fdoe, const TPCANMsgFD *msg);
+
+static vbus_shm_t *vbus_attach(unsigned int bus, int *node);
+static void vbus_detach(vbus_shm_t *shm, int node);
+static void *vbus_thread(void *arg);    // bus thread (receive event and bus master)
+static int vbus_master(vbus_channel_t *channel, uint64_t now);
+static int vbus_arbitrate(vbus_channel_t *channel);
+static void vbus_publish(vbus_shm_t *shm, const vbus_frame_t *frame);
+static int vbus_fetch(vbus_channel_t *channel, vbus_frame_t *frame);
+static int vbus_pending(vbus_channel_t *channel);
+static int vbus_match(const vbus_channel_t *receiver, const vbus_frame_t *frame);
+static int vbus_accept(const vbus_channel_t *receiver, const vbus_frame_t *frame);
+static void vbus_notify(vbus_shm_t *shm);  // wake up the bus threads
+static void vbus_wait(vbus_shm_t *shm, uint32_t events, uint64_t timeout);
+
+static uint64_t vbus_frame_time(const vbus_frame_t *frame);
+
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+static const uint8_t dlc_table[16] = {  // DLC to length
+    0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64
+};
+static vbus_channel_t vbus[PCAN_VIRTUALS] = {  // the virtual channels
+    [0 ... (PCAN_VIRTUALS - 1)] = { .mutex = PTHREAD_MUTEX_INITIALIZER, .fdes = -1 }
+};
+
+/*  -----------  functions  ----------------------------------------------
+ */
+TPCANStatus VBUS_Initialize(TPCANHandle Channel, TPCANBaudrate Btr0Btr1, TPCANType HwType, DWORD IOPort, WORD Interrupt)
+{
+    btr_bitrate_t bitrate;              // bit-rate settings
+
+    (void)HwType;                       // virtual channels are PnP
+    (void)IOPort;
+    (void)Interrupt;
+
+    if (btr_sja10002bitrate((btr_sja1000_t)Btr0Btr1, &bitrate) != 0)
+        return PCAN_ERROR_ILLPARAMVAL;
+    return vbus_initialize(Channel, &bitrate, 0, 0, Btr0Btr1, "");
+}
+
+TPCANStatus VBUS_InitializeFD(TPCANHandle Channel, TPCANBitrateFD BitrateFD)
+{
+    btr_bitrate_t bitrate;              // bit-rate settings
+    bool data = false, sam = false;     // bit-rate string options
+
+    if (!BitrateFD)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if (btr_string2bitrate(BitrateFD, &bitrate, &data, &sam) != 0)
+        return PCAN_ERROR_ILLPARAMVAL;
+    return vbus_initialize(Channel, &bitrate, 1, data ? 1 : 0, 0x0000U, BitrateFD);
+}
+
+TPCANStatus VBUS_Uninitialize(TPCANHandle Channel)
+{
+    vbus_channel_t *channel;            // the virtual channel
+    TPCANStatus sts;                    // represents a status
+
+    if ((channel = vbus_channel(Channel)) == NULL)
+        return PCAN_ERROR_ILLHW;
+    pthread_mutex_lock(&channel->mutex);
+    sts = vbus_uninitialize(channel);
+    pthread_mutex_unlock(&channel->mutex);
+    return sts;
+}
+
+TPCANStatus VBUS_Reset(TPCANHandle Channel)
+{
+    vbus_channel_t *channel;            // the virtual channel
+    vbus_node_t *node;                  // own attachment
+    TPCANStatus sts = PCAN_ERROR_OK;    // represents a status
+    uint64_t value;                     // eventfd counter
+
+    if ((channel = vbus_channel(Channel)) == NULL)
+        return PCAN_ERROR_ILLHW;
+    pthread_mutex_lock(&channel->mutex);
+    if (channel->initialized) {
+        // discard the received and the queued frames
+        node = &channel->shm->node[channel->node];
+        __atomic_store_n(&node->tail, node->head, __ATOMIC_RELEASE);
+        __atomic_store_n(&channel->cursor, __atomic_load_n(&channel->shm->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+        __atomic_store_n(&channel->status, PCAN_ERROR_OK, __ATOMIC_RELAXED);
+        (void)!read(channel->fdes, &value, sizeof(value));
+    }
+    else
+        sts = PCAN_ERROR_INITIALIZE;
+    pthread_mutex_unlock(&channel->mutex);
+    return sts;
+}
+
+TPCANStatus VBUS_GetStatus(TPCANHandle Channel)
+{
+    vbus_channel_t *channel;            // the virtual channel
+
+    if ((channel = vbus_channel(Channel)) == NULL)
+        return PCAN_ERROR_ILLHW;
+    if (!__atomic_load_n(&channel->initialized, __ATOMIC_ACQUIRE))
+        return PCAN_ERROR_INITIALIZE;
+    // note: the overrun is latched
+    return __atomic_exchange_n(&channel->status, PCAN_ERROR_OK, __ATOMIC_RELAXED);
+}
+
+TPCANStatus VBUS_Read(TPCANHandle Channel, TPCANMsg* MessageBuffer, TPCANTimestamp* TimestampBuffer)
+{
+    TPCANMsgFD msg;                     // received message
+    uint64_t time;                      // time-stamp [us]
+    TPCANStatus sts;                    // represents a status
+
+    if (!MessageBuffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((sts = vbus_read(Channel, 0, &msg, &time)) != PCAN_ERROR_OK)
+        return sts;
+    MessageBuffer->ID = msg.ID;
+    MessageBuffer->MSGTYPE = msg.MSGTYPE;
+    MessageBuffer->LEN = msg.DLC;
+    memcpy(MessageBuffer->DATA, msg.DATA, 8);
+    if (TimestampBuffer) {
+        TimestampBuffer->millis = (DWORD)(time / 1000U);
+        TimestampBuffer->millis_overflow = (WORD)((time / 1000U) >> 32);
+        TimestampBuffer->micros = (WORD)(time % 1000U);
+    }
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus VBUS_ReadFD(TPCANHandle Channel, TPCANMsgFD* MessageBuffer, TPCANTimestampFD *TimestampBuffer)
+{
+    uint64_t time;                      // time-stamp [us]
+    TPCANStatus sts;                    // represents a status
+
+    if (!MessageBuffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((sts = vbus_read(Channel, 1, MessageBuffer, &time)) != PCAN_ERROR_OK)
+        return sts;
+    if (TimestampBuffer)
+        *TimestampBuffer = (TPCANTimestampFD)time;
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus VBUS_Write(TPCANHandle Channel, TPCANMsg* MessageBuffer)
+{
+    TPCANMsgFD msg;                     // message to be sent
+
+    if (!MessageBuffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((MessageBuffer->LEN > 8U) || (MessageBuffer->MSGTYPE & (PCAN_MESSAGE_FD | PCAN_MESSAGE_BRS | PCAN_MESSAGE_ESI)))
+        return PCAN_ERROR_ILLPARAMVAL;
+    memset(&msg, 0, sizeof(TPCANMsgFD));
+    msg.ID = MessageBuffer->ID;
+    msg.MSGTYPE = MessageBuffer->MSGTYPE;
+    msg.DLC = MessageBuffer->LEN;
+    memcpy(msg.DATA, MessageBuffer->DATA, 8);
+    return vbus_write(Channel, 0, &msg);
+}
+
+TPCANStatus VBUS_WriteFD(TPCANHandle Channel, TPCANMsgFD* MessageBuffer)
+{
+    if (!MessageBuffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((MessageBuffer->DLC > 15U) || (!(MessageBuffer->MSGTYPE & PCAN_MESSAGE_FD) && (MessageBuffer->DLC > 8U)))
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((MessageBuffer->MSGTYPE & PCAN_MESSAGE_FD) && (MessageBuffer->MSGTYPE & PCAN_MESSAGE_RTR))
+        return PCAN_ERROR_ILLPARAMVAL;
+    if (!(MessageBuffer->MSGTYPE & PCAN_MESSAGE_FD) && (MessageBuffer->MSGTYPE & (PCAN_MESSAGE_BRS | PCAN_MESSAGE_ESI)))
+        return PCAN_ERROR_ILLPARAMVAL;
+    return vbus_write(Channel, 1, MessageBuffer);
+}
+
+TPCANStatus VBUS_GetValue(TPCANHandle Channel, TPCANParameter Parameter, void* Buffer, DWORD BufferLength)
+{
+    vbus_channel_t *channel;            // the virtual channel
+    TPCANStatus sts;                    // represents a status
+    DWORD value;                        // a parameter value
+
+    if (!Buffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((channel = vbus_channel(Channel)) == NULL)
+        return PCAN_ERROR_ILLHW;
+    pthread_mutex_lock(&channel->mutex);
+    switch (Parameter) {
+        case PCAN_CHANNEL_CONDITION:
+            // note: a virtual CAN bus can be attached by other processes
+            value = channel->initialized ? PCAN_CHANNEL_OCCUPIED : PCAN_CHANNEL_AVAILABLE;
+            sts = util_put(Buffer, BufferLength, &value, sizeof(DWORD));
+            break;
+        case PCAN_CHANNEL_FEATURES:
+            value = FEATURE_FD_CAPABLE;
+            sts = util_put(Buffer, BufferLength, &value, sizeof(DWORD));
+            break;
+        case PCAN_DEVICE_ID:
+        case PCAN_CONTROLLER_NUMBER:
+            value = (DWORD)(channel - vbus);
+            sts = util_put(Buffer, BufferLength, &value, sizeof(DWORD));
+            break;
+        case PCAN_HARDWARE_NAME:
+            sts = util_put_string(Buffer, BufferLength, VBUS_HARDWARE_NAME);
+            break;
+        case PCAN_FIRMWARE_VERSION:
+            sts = util_put_string(Buffer, BufferLength, VBUS_FIRMWARE_VERSION);
+            break;
+#ifdef PCAN_EXT_HARDWARE_VERSION
+        case PCAN_EXT_HARDWARE_VERSION:
+            sts = util_put_string(Buffer, BufferLength, VBUS_HARDWARE_NAME ", Firmware " VBUS_FIRMWARE_VERSION);
+            break;
+#endif
+        case PCAN_LISTEN_ONLY:
+            sts = util_put(Buffer, BufferLength, &channel->listen_only, sizeof(DWORD));
+            break;
+        case PCAN_RECEIVE_STATUS:
+            sts = util_put(Buffer, BufferLength, &channel->receive_status, sizeof(DWORD));
+            break;
+        case PCAN_ALLOW_STATUS_FRAMES:
+            sts = util_put(Buffer, BufferLength, &channel->allow_status, sizeof(DWORD));
+            break;
+        case PCAN_ALLOW_RTR_FRAMES:
+            sts = util_put(Buffer, BufferLength, &channel->allow_rtr, sizeof(DWORD));
+            break;
+        case PCAN_ALLOW_ERROR_FRAMES:
+            sts = util_put(Buffer, BufferLength, &channel->allow_error, sizeof(DWORD));
+            break;
+        default:
+            // parameters of an attached channel
+            if (!channel->initialized) {
+                sts = ((Parameter == PCAN_RECEIVE_EVENT) || (Parameter == PCAN_MESSAGE_FILTER) ||
+                       (Parameter == PCAN_ACCEPTANCE_FILTER_11BIT) || (Parameter == PCAN_ACCEPTANCE_FILTER_29BIT) ||
+                       (Parameter == PCAN_BITRATE_INFO) || (Parameter == PCAN_BITRATE_INFO_FD) ||
+                       (Parameter == PCAN_BUSSPEED_NOMINAL) || (Parameter == PCAN_BUSSPEED_DATA) ||
+                       (Parameter == VBUS_PACING)) ? PCAN_ERROR_INITIALIZE : PCAN_ERROR_ILLPARAMTYPE;
+                break;
+            }
+            switch (Parameter) {
+                case PCAN_RECEIVE_EVENT:
+                    sts = util_put(Buffer, BufferLength, &channel->fdes, sizeof(int));
+                    break;
+                case PCAN_MESSAGE_FILTER:
+                    sts = util_put(Buffer, BufferLength, &channel->filter, sizeof(DWORD));
+                    break;
+                case PCAN_ACCEPTANCE_FILTER_11BIT:
+                    sts = util_put(Buffer, BufferLength, &channel->accept[0], sizeof(UINT64));
+                    break;
+                case PCAN_ACCEPTANCE_FILTER_29BIT:
+                    sts = util_put(Buffer, BufferLength, &channel->accept[1], sizeof(UINT64));
+                    break;
+                case PCAN_BITRATE_INFO:
+                    sts = !channel->fdoe ? util_put(Buffer, BufferLength, &channel->btr0btr1, sizeof(TPCANBaudrate))
+                                         : PCAN_ERROR_ILLOPERATION;
+                    break;
+                case PCAN_BITRATE_INFO_FD:
+                    sts = channel->fdoe ? util_put_string(Buffer, BufferLength, channel->bitrate)
+                                        : PCAN_ERROR_ILLOPERATION;
+                    break;
+                case PCAN_BUSSPEED_NOMINAL:
+                    sts = util_put(Buffer, BufferLength, &channel->nominal_speed, sizeof(DWORD));
+                    break;
+                case PCAN_BUSSPEED_DATA:
+                    sts = util_put(Buffer, BufferLength, &channel->data_speed, sizeof(DWORD));
+                    break;
+                case VBUS_PACING:
+                    value = __atomic_load_n(&channel->shm->pacing, __ATOMIC_RELAXED) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+                    sts = util_put(Buffer, BufferLength, &value, sizeof(DWORD));
+                    break;
+                default:
+                    sts = PCAN_ERROR_ILLPARAMTYPE;
+                    break;
+            }
+            break;
+    }
+    pthread_mutex_unlock(&channel->mutex);
+    return sts;
+}
+
+TPCANStatus VBUS_SetValue(TPCANHandle Channel, TPCANParameter Parameter, void* Buffer, DWORD BufferLength)
+{
+    vbus_channel_t *channel;            // the virtual channel
+    TPCANStatus sts = PCAN_ERROR_OK;    // represents a status
+    UINT64 value;                       // acceptance code and mask
+    DWORD on;                           // receiver on/off
+
+    if (!Buffer || !BufferLength)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if ((channel = vbus_channel(Channel)) == NULL)
+        return PCAN_ERROR_ILLHW;
+    pthread_mutex_lock(&channel->mutex);
+    /* note: the reception flags can be set before the channel is initialized */
+    switch (Parameter) {
+        case PCAN_LISTEN_ONLY:
+            channel->listen_only = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            break;
+        case PCAN_RECEIVE_STATUS:
+            on = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            // the receiver starts with the frames put on the bus from now on
+            if (channel->initialized && on && !channel->receive_status)
+                __atomic_store_n(&channel->cursor, __atomic_load_n(&channel->shm->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+            __atomic_store_n(&channel->receive_status, on, __ATOMIC_RELEASE);
+            break;
+        case PCAN_ALLOW_STATUS_FRAMES:
+            channel->allow_status = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            break;
+        case PCAN_ALLOW_RTR_FRAMES:
+            channel->allow_rtr = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            break;
+        case PCAN_ALLOW_ERROR_FRAMES:
+            channel->allow_error = util_get_dword(Buffer, BufferLength) ? PCAN_PARAMETER_ON : PCAN_PARAMETER_OFF;
+            break;
+        case PCAN_MESSAGE_FILTER:
+            if (!channel->initialized)
+                sts = PCAN_ERROR_INITIALIZE;
+            else if (util_get_dword(Buffer, BufferLength) == PCAN_FILTER_OPEN)
+                channel->filter = PCAN_FILTER_OPEN;
+            else if (util_get_dword(Buffer, BufferLength) == PCAN_FILTER_CLOSE)
+                channel->filter = PCAN_FILTER_CLOSE;
+            else
+                sts = PCAN_ERROR_ILLPARAMVAL;
+            break;
+        case PCAN_ACCEPTANCE_FILTER_11BIT:
+        case PCAN_ACCEPTANCE_FILTER_29BIT:
+            if (!channel->initialized)
+                sts = PCAN_ERROR_INITIALIZE;
+            else if (BufferLength < sizeof(UINT64))
+                sts = PCAN_ERROR_ILLPARAMVAL;
+            else {
+                memcpy(&value, Buffer, sizeof(UINT64));
+                channel->accept[(Parameter == PCAN_ACCEPTANCE_FILTER_11BIT) ? 0 : 1] = value;
+            }
+            break;
+        case VBUS_PACING:
+            if (!channel->initialized)
+                sts = PCAN_ERROR_INITIALIZE;
+            else {
+                // note: the bus threads of all attachments notice the change
+                __atomic_store_n(&channel->shm->pacing, util_get_dword(Buffer, BufferLength) ? 1U : 0U, __ATOMIC_RELEASE);
+                vbus_notify(channel->shm);
+            }
+            break;
+        default:
+            sts = PCAN_ERROR_ILLPARAMTYPE;
+            break;
+    }
+    pthread_mutex_unlock(&channel->mutex);
+    return sts;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+static vbus_channel_t *vbus_channel(TPCANHandle handle)
+{
+    vbus_channel_t *channel;            // the virtual channel
+
+    if (!VBUS_CHANNEL(handle))
+        return NULL;
+    channel = &vbus[handle - PCAN_VIRTUAL1];
+    pthread_mutex_lock(&channel->mutex);
+    if (!channel->defaults) {           // first use: PCANBasic defaults
+        channel->receive_status = PCAN_PARAMETER_ON;
+        channel->allow_status = PCAN_PARAMETER_ON;
+        channel->allow_rtr = PCAN_PARAMETER_ON;
+        channel->allow_error = PCAN_PARAMETER_OFF;
+        channel->defaults = 1;
+    }
+    pthread_mutex_unlock(&channel->mutex);
+    return channel;
+}
+
+static TPCANStatus vbus_initialize(TPCANHandle handle, const btr_bitrate_t *bitrate, int fdoe, int brse,
+                                   TPCANBaudrate btr0btr1, const char *string)
+{
+    vbus_channel_t *channel;            // the virtual channel
+    btr_speed_t speed;                  // transmission speed
+    vbus_shm_t *shm;                    // the shared memory segment
+    int node;                           // own attachment
+    int fd;                             // receive event
+
+    if ((channel = vbus_channel(handle)) == NULL)
+        return PCAN_ERROR_ILLHW;
+    if ((btr_bitrate2speed(bitrate, &speed) != 0) ||
+        !((speed.nominal.speed > 0.0f) && (speed.nominal.speed <= 1.0e9f)) ||
+        (brse && !((speed.data.speed > 0.0f) && (speed.data.speed <= 1.0e9f))))
+        return PCAN_ERROR_ILLPARAMVAL;
+    pthread_mutex_lock(&channel->mutex);
+    if (channel->initialized) {
+        pthread_mutex_unlock(&channel->mutex);
+        return PCAN_ERROR_INITIALIZE;
+    }
+    if ((fd = eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        pthread_mutex_unlock(&channel->mutex);
+        return PCAN_ERROR_RESOURCE;
+    }
+    if ((shm = vbus_attach((unsigned int)(handle - PCAN_VIRTUAL1), &node)) == NULL) {
+        pthread_mutex_unlock(&channel->mutex);
+        close(fd);
+        return PCAN_ERROR_RESOURCE;
+    }
+    channel->shm = shm;
+    channel->node = node;
+    channel->cursor = __atomic_load_n(&shm->head, __ATOMIC_ACQUIRE);
+    channel->stall = 0U;
+    channel->fdes = fd;
+    channel->fdoe = fdoe;
+    channel->btr0btr1 = btr0btr1;
+    strncpy(channel->bitrate, string, MAX_LENGTH_VERSION_STRING - 1);
+    channel->bitrate[MAX_LENGTH_VERSION_STRING - 1] = '\0';
+    channel->nominal_speed = (DWORD)(speed.nominal.speed + 0.5f);
+    channel->data_speed = brse ? (DWORD)(speed.data.speed + 0.5f) : channel->nominal_speed;
+    channel->nominal = (uint32_t)((1.0e12f / speed.nominal.speed) + 0.5f);
+    channel->data = brse ? (uint32_t)((1.0e12f / speed.data.speed) + 0.5f) : channel->nominal;
+    channel->receive_status = PCAN_PARAMETER_ON;  // note: switched on by CAN_Initialize[FD]
+    channel->filter = PCAN_FILTER_OPEN;
+    channel->accept[0] = (UINT64)VBUS_STD_MASK;  // code 0, all bits don't care
+    channel->accept[1] = (UINT64)VBUS_XTD_MASK;  // code 0, all bits don't care
+    channel->status = PCAN_ERROR_OK;
+    // start the bus thread of the attachment
+    channel->running = 1;
+    if (pthread_create(&channel->thread, NULL, vbus_thread, (void*)channel) != 0) {
+        channel->running = 0;
+        vbus_detach(shm, node);
+        channel->shm = NULL;
+        channel->fdes = -1;
+        pthread_mutex_unlock(&channel->mutex);
+        close(fd);
+        return PCAN_ERROR_RESOURCE;
+    }
+    __atomic_store_n(&channel->initialized, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&channel->mutex);
+    return PCAN_ERROR_OK;
+}
+
+static TPCANStatus vbus_uninitialize(vbus_channel_t *channel)
+{
+    /* note: the channel lock must be held by the caller */
+    if (!channel->initialized)
+        return PCAN_ERROR_INITIALIZE;
+    __atomic_store_n(&channel->initialized, 0, __ATOMIC_RELEASE);
+    // stop the bus thread
+    __atomic_store_n(&channel->running, 0, __ATOMIC_RELEASE);
+    vbus_notify(channel->shm);
+    pthread_join(channel->thread, NULL);
+    // detach from the virtual CAN bus
+    vbus_detach(channel->shm, channel->node);
+    channel->shm = NULL;
+    close(channel->fdes);
+    channel->fdes = -1;
+    return PCAN_ERROR_OK;
+}
+
+static TPCANStatus vbus_read(TPCANHandle handle, int fdoe, TPCANMsgFD *msg, uint64_t *time)
+{
+    vbus_channel_t *channel;            // the virtual channel
+    vbus_frame_t frame;                 // the frame from the bus
+    uint64_t value;                     // eventfd counter
+
+    /* note: the caller serializes the reads of a channel (as the wrapper does) */
+    if (!VBUS_CHANNEL(handle))
+        return PCAN_ERROR_ILLHW;
+    channel = &vbus[handle - PCAN_VIRTUAL1];
+    if (!__atomic_load_n(&channel->initialized, __ATOMIC_ACQUIRE))
+        return PCAN_ERROR_INITIALIZE;
+    if (channel->fdoe != fdoe)          // CAN_Read resp. CAN_ReadFD
+        return PCAN_ERROR_ILLOPERATION;
+    while (vbus_fetch(channel, &frame)) {
+        // no echo, and the frames the receiver would not see or shall not get
+        if ((frame.node == (uint8_t)channel->node) || !vbus_match(channel, &frame) ||
+            !vbus_accept(channel, &frame))
+            continue;
+        msg->ID = frame.id;
+        msg->MSGTYPE = frame.type;
+        msg->DLC = frame.dlc;
+        memcpy(msg->DATA, frame.payload, sizeof(msg->DATA));
+        *time = frame.time / 1000U;
+        return PCAN_ERROR_OK;
+    }
+    // the receive event is signaled as long as frames are pending
+    (void)!read(channel->fdes, &value, sizeof(value));
+    if (vbus_pending(channel)) {
+        value = 1U;
+        (void)!write(channel->fdes, &value, sizeof(value));
+    }
+    return PCAN_ERROR_QRCVEMPTY;
+}
+
+static TPCANStatus vbus_write(TPCANHandle handle, int fdoe, const TPCANMsgFD *msg)
+{
+    vbus_channel_t *channel;            // the virtual channel
+    vbus_node_t *node;                  // own attachment
+    vbus_frame_t frame;                 // the frame to be sent
+    uint32_t head;                      // of the transmit queue
+
+    /* note: the caller serializes the writes of a channel (as the wrapper does) */
+    if (msg->MSGTYPE & ~VBUS_MSGTYPE_MASK)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if (msg->ID > ((msg->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? VBUS_XTD_MASK : VBUS_STD_MASK))
+        return PCAN_ERROR_ILLPARAMVAL;
+    if (!VBUS_CHANNEL(handle))
+        return PCAN_ERROR_ILLHW;
+    channel = &vbus[handle - PCAN_VIRTUAL1];
+    if (!__atomic_load_n(&channel->initialized, __ATOMIC_ACQUIRE))
+        return PCAN_ERROR_INITIALIZE;
+    if ((channel->fdoe != fdoe) || channel->listen_only ||
+        ((msg->MSGTYPE & PCAN_MESSAGE_BRS) && (channel->data == channel->nominal)))
+        return PCAN_ERROR_ILLOPERATION;
+    memset(&frame, 0, sizeof(vbus_frame_t));
+    frame.time = util_clock();
+    frame.id = msg->ID;
+    frame.nominal = channel->nominal;
+    frame.data = channel->data;
+    frame.type = msg->MSGTYPE;
+    frame.dlc = msg->DLC;
+    frame.node = (uint8_t)channel->node;
+    memcpy(frame.payload, msg->DATA, dlc_table[msg->DLC & 0xFU]);
+    node = &channel->shm->node[channel->node];
+    head = node->head;
+    // with pacing (or frames still queued) the bus master sends the frame
+    if (__atomic_load_n(&channel->shm->pacing, __ATOMIC_ACQUIRE) ||
+        (__atomic_load_n(&node->tail, __ATOMIC_ACQUIRE) != head)) {
+        if ((head - __atomic_load_n(&node->tail, __ATOMIC_ACQUIRE)) >= VBUS_TX_QUEUE)
+            return PCAN_ERROR_QXMTFULL;
+        memcpy(&node->queue[head % VBUS_TX_QUEUE], &frame, sizeof(vbus_frame_t));
+        __atomic_store_n(&node->head, head + 1U, __ATOMIC_RELEASE);
+        vbus_notify(channel->shm);
+    }
+    else
+        vbus_publish(channel->shm, &frame);
+    return PCAN_ERROR_OK;
+}
+
+static vbus_shm_t *vbus_attach(unsigned int bus, int *node)
+{
+    char name[32];                      // name of the segment
+    struct stat st;                     // size of the segment
+    vbus_shm_t *shm;                    // the shared memory segment
+    uint64_t deadline;                  // wait for the creator of the segment
+    int32_t pid = (int32_t)getpid(), owner;  // process ids
+    int created = 0;                    // segment created
+    int fd, i;                          // file descriptor, loop variable
+
+    snprintf(name, sizeof(name), VBUS_SEGMENT_NAME, bus + 1U);
+    // create the segment (or open an existing one)
+    if ((fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR)) >= 0) {
+        if (ftruncate(fd, (off_t)sizeof(vbus_shm_t)) < 0) {
+            close(fd);
+            (void)shm_unlink(name);
+            return NULL;
+        }
+        created = 1;
+    }
+    else if ((errno != EEXIST) || ((fd = shm_open(name, O_RDWR, 0)) < 0))
+        return NULL;
+    // the creator sizes the segment (zero-filled) and then initializes it
+    deadline = util_clock() + VBUS_ATTACH_NS;
+    while ((fstat(fd, &st) == 0) && (st.st_size == 0) && (util_clock() < deadline))
+        (void)usleep(1000U);
+    if (st.st_size != (off_t)sizeof(vbus_shm_t)) {  // other layout
+        close(fd);
+        return NULL;
+    }
+    shm = (vbus_shm_t*)mmap(NULL, sizeof(vbus_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED)
+        return NULL;
+    if (created) {
+        shm->layout = VBUS_LAYOUT;
+        shm->idle = util_clock();
+        __atomic_store_n(&shm->magic, VBUS_MAGIC, __ATOMIC_RELEASE);
+    }
+    while ((__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != VBUS_MAGIC) && (util_clock() < deadline))
+        (void)usleep(1000U);
+    if ((__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != VBUS_MAGIC) || (shm->layout != VBUS_LAYOUT)) {
+        (void)munmap(shm, sizeof(vbus_shm_t));
+        return NULL;
+    }
+    // take an unused attachment (or one of a process that is gone)
+    for (i = 0; i < VBUS_NODES; i++) {
+        owner = __atomic_load_n(&shm->node[i].pid, __ATOMIC_ACQUIRE);
+        if ((owner != 0) && !((kill((pid_t)owner, 0) < 0) && (errno == ESRCH)))
+            continue;
+        if (__atomic_compare_exchange_n(&shm->node[i].pid, &owner, pid, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            // note: the frames of a process that is gone are discarded
+            __atomic_store_n(&shm->node[i].tail, shm->node[i].head, __ATOMIC_RELEASE);
+            *node = i;
+            return shm;
+        }
+    }
+    (void)munmap(shm, sizeof(vbus_shm_t));
+    return NULL;
+}
+
+static void vbus_detach(vbus_shm_t *shm, int node)
+{
+    int32_t master = node + 1;          // own attachment as bus master
+
+    // hand over the bus master and release the attachment
+    if (__atomic_compare_exchange_n(&shm->master, &master, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        vbus_notify(shm);
+    __atomic_store_n(&shm->node[node].tail, shm->node[node].head, __ATOMIC_RELEASE);
+    __atomic_store_n(&shm->node[node].pid, 0, __ATOMIC_RELEASE);
+    (void)munmap(shm, sizeof(vbus_shm_t));
+}
+
+static void *vbus_thread(void *arg)
+{
+    vbus_channel_t *channel = (vbus_channel_t*)arg;
+    vbus_shm_t *shm = channel->shm;     // the shared memory segment
+    uint64_t value = 1U;                // eventfd counter increment
+    uint32_t events;                    // frames put or queued
+
+    /* note: the bus thread signals the receive event when frames are pending
+     *       for the attachment, and it acts as bus master if required */
+    while (__atomic_load_n(&channel->running, __ATOMIC_ACQUIRE)) {
+        events = __atomic_load_n(&shm->events, __ATOMIC_SEQ_CST);
+        if (vbus_pending(channel))
+            (void)!write(channel->fdes, &value, sizeof(value));
+        if (vbus_master(channel, util_clock()) && vbus_arbitrate(channel))
+            continue;
+        vbus_wait(shm, events, VBUS_WAIT_NS);
+    }
+    return NULL;
+}
+
+static int vbus_master(vbus_channel_t *channel, uint64_t now)
+{
+    vbus_shm_t *shm = channel->shm;     // the shared memory segment
+    int32_t master;                     // current bus master
+    int i;                              // loop variable
+
+    // a bus master is required with pacing or while frames are queued
+    if (!__atomic_load_n(&shm->pacing, __ATOMIC_ACQUIRE)) {
+        for (i = 0; i < VBUS_NODES; i++)
+            if (__atomic_load_n(&shm->node[i].head, __ATOMIC_ACQUIRE) !=
+                __atomic_load_n(&shm->node[i].tail, __ATOMIC_ACQUIRE))
+                break;
+        if (i == VBUS_NODES)
+            return 0;
+    }
+    // take over, if there is no bus master (or it is gone)
+    master = __atomic_load_n(&shm->master, __ATOMIC_ACQUIRE);
+    if (master != (channel->node + 1)) {
+        if ((master != 0) && ((now - __atomic_load_n(&shm->heartbeat, __ATOMIC_ACQUIRE)) < VBUS_MASTER_TTL))
+            return 0;
+        if (!__atomic_compare_exchange_n(&shm->master, &master, channel->node + 1, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return 0;
+    }
+    __atomic_store_n(&shm->heartbeat, now, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static int vbus_arbitrate(vbus_channel_t *channel)
+{
+    vbus_shm_t *shm = channel->shm;     // the shared memory segment
+    vbus_node_t *winner = NULL;         // the frame with the highest priority
+    vbus_frame_t frame;                 // the frame on the bus
+    uint32_t key, lowest = 0U;          // arbitration field (dominant = 0)
+    uint32_t tail = 0U, i;              // of the transmit queue, loop variable
+    uint64_t start, end;                // of the frame [ns]
+    const vbus_frame_t *head;           // the next frame of an attachment
+
+    for (i = 0U; i < (uint32_t)VBUS_NODES; i++) {
+        if (__atomic_load_n(&shm->node[i].head, __ATOMIC_ACQUIRE) ==
+            __atomic_load_n(&shm->node[i].tail, __ATOMIC_ACQUIRE))
+            continue;
+        head = &shm->node[i].queue[__atomic_load_n(&shm->node[i].tail, __ATOMIC_ACQUIRE) % VBUS_TX_QUEUE];
+        key = util_arbitration(head->id, head->type);
+        if (!winner || (key < lowest)) {
+            winner = &shm->node[i];
+            lowest = key;
+        }
+    }
+    if (!winner)
+        return 0;
+    tail = __atomic_load_n(&winner->tail, __ATOMIC_ACQUIRE);
+    memcpy(&frame, &winner->queue[tail % VBUS_TX_QUEUE], sizeof(vbus_frame_t));
+    /* note: back-to-back frames start at the end of the previous frame,
+     *       independent of the wake-up latency of the bus thread */
+    if (__atomic_load_n(&shm->pacing, __ATOMIC_ACQUIRE)) {
+        start = (shm->idle > frame.time) ? shm->idle : frame.time;
+        end = start + vbus_frame_time(&frame);
+        util_sleep(end);
+    }
+    else
+        end = util_clock();
+    shm->idle = end;
+    // the sender has been reset or detached in the meantime
+    if (!__atomic_compare_exchange_n(&winner->tail, &tail, tail + 1U, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        return 1;
+    frame.time = end;
+    vbus_publish(shm, &frame);
+    return 1;
+}
+
+static void vbus_publish(vbus_shm_t *shm, const vbus_frame_t *frame)
+{
+    uint64_t idx = __atomic_fetch_add(&shm->head, 1U, __ATOMIC_ACQ_REL);
+    vbus_slot_t *slot = &shm->ring[idx & VBUS_RING_MASK];
+
+    // reserve the slot, write the frame and commit it (seqlock)
+    __atomic_store_n(&slot->seq, SEQ_WRITING(idx), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&slot->frame, frame, sizeof(vbus_frame_t));
+    __atomic_store_n(&slot->seq, SEQ_COMMITTED(idx), __ATOMIC_RELEASE);
+    vbus_notify(shm);
+}
+
+static int vbus_fetch(vbus_channel_t *channel, vbus_frame_t *frame)
+{
+    vbus_shm_t *shm = channel->shm;     // the shared memory segment
+    vbus_slot_t *slot;                  // the slot at the cursor
+    uint64_t cursor, seq, head, now;    // positions and sequence numbers
+
+    for (;;) {
+        cursor = __atomic_load_n(&channel->cursor, __ATOMIC_RELAXED);
+        head = __atomic_load_n(&shm->head, __ATOMIC_ACQUIRE);
+        // the receiver is switched off: frames are discarded
+        if (!__atomic_load_n(&channel->receive_status, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&channel->cursor, head, __ATOMIC_RELEASE);
+            return 0;
+        }
+        slot = &shm->ring[cursor & VBUS_RING_MASK];
+        seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (seq < SEQ_COMMITTED(cursor)) {
+            /* note: a slot that has been reserved, but is never committed
+             *       (the sender died), is skipped after a while */
+            if (head <= (cursor + 1U))
+                return 0;
+            now = util_clock();
+            if (!channel->stall)
+                channel->stall = now;
+            if ((now - channel->stall) < VBUS_STALL_NS)
+                return 0;
+            channel->stall = 0U;
+            __atomic_store_n(&channel->cursor, cursor + 1U, __ATOMIC_RELEASE);
+            continue;
+        }
+        channel->stall = 0U;
+        if (seq == SEQ_COMMITTED(cursor)) {
+            memcpy(frame, &slot->frame, sizeof(vbus_frame_t));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq) {
+                __atomic_store_n(&channel->cursor, cursor + 1U, __ATOMIC_RELEASE);
+                return 1;
+            }
+        }
+        // overtaken by the senders: continue with the newer half of the ring
+        __atomic_fetch_or(&channel->status, PCAN_ERROR_QOVERRUN, __ATOMIC_RELAXED);
+        head = __atomic_load_n(&shm->head, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&channel->cursor, (head > (VBUS_RING_SIZE / 2U)) ? (head - (VBUS_RING_SIZE / 2U)) : 0U,
+                         __ATOMIC_RELEASE);
+    }
+}
+
+static int vbus_pending(vbus_channel_t *channel)
+{
+    uint64_t cursor = __atomic_load_n(&channel->cursor, __ATOMIC_ACQUIRE);
+
+    // note: the own frames are pending too (skipped when read)
+    if (!__atomic_load_n(&channel->receive_status, __ATOMIC_ACQUIRE))
+        return 0;
+    return (__atomic_load_n(&channel->shm->ring[cursor & VBUS_RING_MASK].seq, __ATOMIC_ACQUIRE) >=
+            SEQ_COMMITTED(cursor)) ? 1 : 0;
+}
+
+static int vbus_match(const vbus_channel_t *receiver, const vbus_frame_t *frame)
+{
+    // note: the bit-rate settings of the sender are sent with the frame
+    return util_match(receiver->nominal, receiver->data, receiver->fdoe, frame->type, frame->nominal, frame->data);
+}
+
+static int vbus_accept(const vbus_channel_t *receiver, const vbus_frame_t *frame)
+{
+    return util_accept(frame->id, frame->type, receiver->filter, receiver->allow_rtr, receiver->accept);
+}
+
+static void vbus_notify(vbus_shm_t *shm)
+{
+    /* note: the futex is only woken up when a bus thread is waiting on it
+     *       (seq_cst ordering with the registration in vbus_wait) */
+    (void)__atomic_add_fetch(&shm->events, 1U, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&shm->sleepers, __ATOMIC_SEQ_CST))
+        (void)syscall(SYS_futex, &shm->events, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static void vbus_wait(vbus_shm_t *shm, uint32_t events, uint64_t timeout)
+{
+    struct timespec ts;                 // relative time-out
+
+    ts.tv_sec = (time_t)(timeout / 1000000000U);
+    ts.tv_nsec = (long)(timeout % 1000000000U);
+    (void)__atomic_add_fetch(&shm->sleepers, 1U, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&shm->events, __ATOMIC_SEQ_CST) == events)
+        (void)syscall(SYS_futex, &shm->events, FUTEX_WAIT, events, &ts, NULL, 0);
+    (void)__atomic_sub_fetch(&shm->sleepers, 1U, __ATOMIC_SEQ_CST);
+}
+
+static uint64_t vbus_frame_time(const vbus_frame_t *frame)
+{
+    /* note: returns the bus time of the frame in nanoseconds (cf. util_frame_time) */
+    return (util_frame_time(frame->id, frame->type, frame->dlc, frame->payload, frame->nominal, frame->data) + 500U) / 1000U;
+}
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de, Homepage: https://www.uv-software.de/
+ */
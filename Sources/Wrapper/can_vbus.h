@@ -0,0 +1,117 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later */
+/*
+ *  CAN Interface API, Version 3 (for PEAK-System PCAN Interfaces)
+ *
+ *  Copyright (c) 2005-2012 Uwe Vogt, UV Software, Friedrichshafen
+ *  Copyright (c) 2013-2025 Uwe Vogt, UV Software, Berlin (info@mac-can.com)
+ *  All rights reserved.
+ *
+ *  This file is part of PCBUSB-Wrapper.
+ *
+ *  PCBUSB-Wrapper is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v2.0 (or any later version). You can
+ *  choose between one of them if you use PCBUSB-Wrapper in whole or in part.
+ *
+ *  (1) BSD 2-Clause "Simplified" License
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  PCBUSB-Wrapper IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF PCBUSB-Wrapper, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  (2) GNU General Public License v2.0 or later
+ *
+ *  PCBUSB-Wrapper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PCBUSB-Wrapper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with PCBUSB-Wrapper; if not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        can_vbus.h
+ *
+ *  @brief       Virtual CAN bus over shared memory (pseudo-channels).
+ *
+ *  @note        The channels PCAN_VIRTUAL1 and PCAN_VIRTUAL2 are served by
+ *               the wrapper itself (cf. can_vbus.c). The functions have the
+ *               signature of their PCANBasic counterparts, so the wrapper
+ *               can route the calls of a virtual channel to them.
+ *
+ *  @addtogroup  can_api
+ *  @{
+ */
+#ifndef CAN_VBUS_H_INCLUDED
+#define CAN_VBUS_H_INCLUDED
+
+/*  -----------  includes  ------------------------------------------------
+ */
+
+#include "PeakCAN_Defines.h"
+#include "PCANBasic.h"
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+/** @brief  check if a PCAN channel handle is a virtual CAN bus
+ */
+#define VBUS_CHANNEL(ch)  ((PCAN_VIRTUAL1 <= (TPCANHandle)(ch)) && ((TPCANHandle)(ch) < (PCAN_VIRTUAL1 + PCAN_VIRTUALS)))
+
+/** @brief  parameter: bit-time pacing of the virtual CAN bus (DWORD: ON/OFF)
+ *
+ *  @note   The value is a property of the bus, it applies to all attached
+ *          channels of all processes.
+ */
+#define VBUS_PACING  0xF0U
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+TPCANStatus VBUS_Initialize(TPCANHandle Channel, TPCANBaudrate Btr0Btr1, TPCANType HwType, DWORD IOPort, WORD Interrupt);
+TPCANStatus VBUS_InitializeFD(TPCANHandle Channel, TPCANBitrateFD BitrateFD);
+TPCANStatus VBUS_Uninitialize(TPCANHandle Channel);
+TPCANStatus VBUS_Reset(TPCANHandle Channel);
+TPCANStatus VBUS_GetStatus(TPCANHandle Channel);
+TPCANStatus VBUS_Read(TPCANHandle Channel, TPCANMsg* MessageBuffer, TPCANTimestamp* TimestampBuffer);
+TPCANStatus VBUS_ReadFD(TPCANHandle Channel, TPCANMsgFD* MessageBuffer, TPCANTimestampFD *TimestampBuffer);
+TPCANStatus VBUS_Write(TPCANHandle Channel, TPCANMsg* MessageBuffer);
+TPCANStatus VBUS_WriteFD(TPCANHandle Channel, TPCANMsgFD* MessageBuffer);
+TPCANStatus VBUS_GetValue(TPCANHandle Channel, TPCANParameter Parameter, void* Buffer, DWORD BufferLength);
+TPCANStatus VBUS_SetValue(TPCANHandle Channel, TPCANParameter Parameter, void* Buffer, DWORD BufferLength);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CAN_VBUS_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de, Homepage: https://www.uv-software.de/
+ */
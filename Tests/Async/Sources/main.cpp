@@ -0,0 +1,154 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (for PEAK-System PCAN Interfaces)
+//
+//  Copyright (c) 2005-2012 Uwe Vogt, UV Software, Friedrichshafen
+//  Copyright (c) 2013-2025 Uwe Vogt, UV Software, Berlin (info@mac-can.com)
+//  All rights reserved.
+//
+//  This file is part of PCBUSB-Wrapper.
+//
+//  PCBUSB-Wrapper is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version). You can
+//  choose between one of them if you use PCBUSB-Wrapper in whole or in part.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  PCBUSB-Wrapper IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF PCBUSB-Wrapper, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  PCBUSB-Wrapper is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  PCBUSB-Wrapper is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with PCBUSB-Wrapper; if not, see <https://www.gnu.org/licenses/>.
+//
+//  Test of the awaitable read and write operations (PeakCAN_Async.h)
+//
+//  note: runs on the simulated PCANBasic (no hardware), PCAN_USB1 sends
+//        and PCAN_USB2 receives; the coroutines run on a CPeakCANLoop.
+//
+#include "PeakCAN_Async.h"
+
+#include <iostream>
+#include <cstring>
+
+#define TEST_FRAMES  1000  // number of frames
+
+using namespace std::chrono_literals;
+
+static CPeakCANTask Sender(CPeakCANAsync &can, int frames, int &sent, CANAPI_Return_t &result);
+static CPeakCANTask Receiver(CPeakCANAsync &can, int frames, int &received, CANAPI_Return_t &result);
+static CPeakCANTask Idle(CPeakCANAsync &can, std::chrono::milliseconds timeout, std::chrono::nanoseconds &elapsed, CANAPI_Return_t &result);
+
+int main(int argc, const char *argv[]) {
+    CPeakCAN dut1, dut2;
+    CANAPI_OpMode_t opMode = {};
+    CANAPI_Bitrate_t bitrate = {};
+    CANAPI_Return_t retVal;
+    int failed = 0;
+
+    (void)argc;
+    (void)argv;
+    std::cout << CPeakCAN::GetVersion() << std::endl;
+    opMode.byte = CANMODE_DEFAULT;
+    bitrate.index = CANBTR_INDEX_250K;
+    if (((retVal = dut1.InitializeChannel(PCAN_USB1, opMode)) != CCanApi::NoError) ||
+        ((retVal = dut2.InitializeChannel(PCAN_USB2, opMode)) != CCanApi::NoError)) {
+        std::cerr << "+++ error: interface could not be initialized (" << retVal << ")" << std::endl;
+        return 1;
+    }
+    if (((retVal = dut1.StartController(bitrate)) != CCanApi::NoError) ||
+        ((retVal = dut2.StartController(bitrate)) != CCanApi::NoError)) {
+        std::cerr << "+++ error: CAN controller could not be started (" << retVal << ")" << std::endl;
+        return 1;
+    }
+    CPeakCANLoop loop;
+    CPeakCANAsync tx(dut1, loop);
+    CPeakCANAsync rx(dut2, loop);
+
+    // (1) write and read TEST_FRAMES frames (in order)
+    int sent = 0, received = 0;
+    CANAPI_Return_t txResult = CANERR_FATAL, rxResult = CANERR_FATAL;
+    Receiver(rx, TEST_FRAMES, received, rxResult);
+    Sender(tx, TEST_FRAMES, sent, txResult);
+    (void)loop.Run();
+    std::cout << "WriteMessageAsync: " << sent << " frame(s) sent (" << txResult << ")" << std::endl;
+    std::cout << "ReadMessageAsync:  " << received << " frame(s) received (" << rxResult << ")" << std::endl;
+    if ((txResult != CCanApi::NoError) || (sent != TEST_FRAMES) ||
+        (rxResult != CCanApi::NoError) || (received != TEST_FRAMES))
+        failed++;
+
+    // (2) read with time-out from an idle bus
+    std::chrono::nanoseconds elapsed(0);
+    CANAPI_Return_t idleResult = CANERR_FATAL;
+    Idle(rx, 200ms, elapsed, idleResult);
+    (void)loop.Run();
+    std::cout << "ReadMessageAsync:  time-out after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms (" << idleResult << ")" << std::endl;
+    if ((idleResult != CCanApi::ReceiverEmpty) || (elapsed < 200ms))
+        failed++;
+
+    (void)dut1.TeardownChannel();
+    (void)dut2.TeardownChannel();
+    std::cout << (failed ? "FAILED" : "PASSED") << std::endl;
+    return failed ? 1 : 0;
+}
+
+static CPeakCANTask Sender(CPeakCANAsync &can, int frames, int &sent, CANAPI_Return_t &result) {
+    CANAPI_Message_t message = {};
+    message.dlc = 4U;
+    for (sent = 0; sent < frames; sent++) {
+        message.id = (uint32_t)sent & CAN_MAX_STD_ID;
+        memcpy(message.data, &sent, sizeof(int));
+        if ((result = co_await can.WriteMessageAsync(message, 1s)) != CCanApi::NoError)
+            co_return;
+    }
+}
+
+static CPeakCANTask Receiver(CPeakCANAsync &can, int frames, int &received, CANAPI_Return_t &result) {
+    CANAPI_Message_t message = {};
+    int sequence;
+    for (received = 0; received < frames; received++) {
+        if ((result = co_await can.ReadMessageAsync(message, 1s)) != CCanApi::NoError)
+            co_return;
+        memcpy(&sequence, message.data, sizeof(int));
+        if (sequence != received) {
+            std::cerr << "+++ error: frame " << sequence << " received, " << received << " expected" << std::endl;
+            result = CANERR_FATAL;
+            co_return;
+        }
+    }
+}
+
+static CPeakCANTask Idle(CPeakCANAsync &can, std::chrono::milliseconds timeout, std::chrono::nanoseconds &elapsed, CANAPI_Return_t &result) {
+    CANAPI_Message_t message = {};
+    auto start = std::chrono::steady_clock::now();
+    result = co_await can.ReadMessageAsync(message, timeout);
+    elapsed = std::chrono::steady_clock::now() - start;
+}
@@ -0,0 +1,261 @@
+/*  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later */
+/*
+ *  CAN Interface API, Version 3 (for PEAK-System PCAN Interfaces)
+ *
+ *  Copyright (c) 2005-2012 Uwe Vogt, UV Software, Friedrichshafen
+ *  Copyright (c) 2013-2025 Uwe Vogt, UV Software, Berlin (info@mac-can.com)
+ *  All rights reserved.
+ *
+ *  This file is part of PCBUSB-Wrapper.
+ *
+ *  PCBUSB-Wrapper is dual-licensed under the BSD 2-Clause "Simplified" License
+ *  and under the GNU General Public License v2.0 (or any later version). You can
+ *  choose between one of them if you use PCBUSB-Wrapper in whole or in part.
+ *
+ *  (1) BSD 2-Clause "Simplified" License
+ * 
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *  PCBUSB-Wrapper IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF PCBUSB-Wrapper, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  (2) GNU General Public License v2.0 or later
+ *
+ *  PCBUSB-Wrapper is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  PCBUSB-Wrapper is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with PCBUSB-Wrapper; if not, see <https://www.gnu.org/licenses/>.
+ */
+/** @file        main.c
+ *
+ *  @brief       Throughput and latency benchmark of the CAN API V3 wrapper.
+ *
+ *  @note        Runs on the simulated PCANBasic (no hardware): PCAN_USB1
+ *               sends, PCAN_USB2 receives. The latency is measured from
+ *               can_write() to can_read() of one frame at a time, the
+ *               throughput with can_write_multi() and can_read_multi()
+ *               while the transmit queue is kept full.
+ *
+ *               The simulated bus paces the frames by their bit time, so
+ *               the throughput is bounded by the bit-rate, and the latency
+ *               includes the frame time on the bus.
+ */
+#include "can_api.h"
+#include "PeakCAN_Defines.h"
+#include "PeakCAN_Extensions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+
+#define DEFAULT_FRAMES  10000U          // number of frames per test
+#define DEFAULT_DLC     8U              // payload length (time-stamp)
+#define BATCH_SIZE      64U             // frames per write resp. read call
+#define READ_TIMEOUT    1000U           // [ms] (end of test)
+
+typedef struct {                        // sender thread:
+    int handle;                         //   handle of the sender
+    uint32_t frames;                    //   number of frames to send
+    uint8_t dlc;                        //   payload length
+    int result;                         //   return value
+}   sender_t;
+
+static uint64_t now_ns(void);
+static void stamp(can_message_t *msg, uint32_t seq, uint8_t dlc);
+static int compare(const void *a, const void *b);
+static void *sender(void *arg);
+static int latency(int tx, int rx, uint32_t frames, uint8_t dlc);
+static int throughput(int tx, int rx, uint32_t frames, uint8_t dlc);
+
+int main(int argc, const char *argv[])
+{
+    can_bitrate_t bitrate;              // bit-rate settings
+    uint32_t frames = DEFAULT_FRAMES;   // number of frames
+    uint8_t dlc = DEFAULT_DLC;          // payload length
+    int tx = -1, rx = -1;               // handles
+    int rc = CANERR_NOERROR;            // return value
+    int i;                              // loop variable
+
+    memset(&bitrate, 0, sizeof(can_bitrate_t));
+    bitrate.index = CANBTR_INDEX_1M;
+    for (i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "FRAMES=", 7))
+            frames = (uint32_t)strtoul(&argv[i][7], NULL, 10);
+        else if (!strncmp(argv[i], "DLC=", 4))
+            dlc = (uint8_t)strtoul(&argv[i][4], NULL, 10);
+        else if (!strncmp(argv[i], "BAUD=", 5))
+            bitrate.index = -(int32_t)strtoul(&argv[i][5], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [FRAMES=<n>] [DLC=<0..8>] [BAUD=<0..8>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if ((frames == 0U) || (dlc > CAN_MAX_DLC) || (bitrate.index < CANBTR_INDEX_10K)) {
+        fprintf(stderr, "+++ error: invalid argument\n");
+        return 1;
+    }
+    printf("%s\n", can_version());
+    printf("Bit-rate index %" PRIi32 ", %" PRIu32 " frame(s) with DLC %u\n", -bitrate.index, frames, dlc);
+    if ((tx = can_init(PCAN_USB1, CANMODE_DEFAULT, NULL)) < 0) {
+        fprintf(stderr, "+++ error: sender not initialized (%i)\n", tx);
+        return 1;
+    }
+    if ((rx = can_init(PCAN_USB2, CANMODE_DEFAULT, NULL)) < 0) {
+        fprintf(stderr, "+++ error: receiver not initialized (%i)\n", rx);
+        (void)can_exit(tx);
+        return 1;
+    }
+    if (((rc = can_start(tx, &bitrate)) != CANERR_NOERROR) ||
+        ((rc = can_start(rx, &bitrate)) != CANERR_NOERROR))
+        fprintf(stderr, "+++ error: controller not started (%i)\n", rc);
+    else if ((rc = latency(tx, rx, frames, dlc)) == CANERR_NOERROR)
+        rc = throughput(tx, rx, frames, dlc);
+    (void)can_exit(CANEXIT_ALL);
+    return (rc == CANERR_NOERROR) ? 0 : 1;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;                // current time
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+static void stamp(can_message_t *msg, uint32_t seq, uint8_t dlc)
+{
+    uint64_t now = now_ns();            // time of transmission
+
+    memset(msg, 0, sizeof(can_message_t));
+    msg->id = seq & CAN_MAX_STD_ID;
+    msg->dlc = dlc;
+    memcpy(msg->data, &now, (dlc < sizeof(uint64_t)) ? dlc : sizeof(uint64_t));
+}
+
+static int compare(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+static int latency(int tx, int rx, uint32_t frames, uint8_t dlc)
+{
+    can_message_t msg;                  // the frame
+    uint64_t *sample;                   // latencies [ns]
+    uint64_t start, total = 0U;         // time measurement
+    uint32_t i;                         // loop variable
+    int rc;                             // return value
+
+    if ((sample = (uint64_t*)malloc(frames * sizeof(uint64_t))) == NULL) {
+        fprintf(stderr, "+++ error: out of memory\n");
+        return CANERR_RESOURCE;
+    }
+    /* note: one frame at a time, from the call of can_write() to the return of can_read() */
+    for (i = 0U; i < frames; i++) {
+        stamp(&msg, i, dlc);
+        start = now_ns();
+        if ((rc = can_write(tx, &msg, 0U)) != CANERR_NOERROR) {
+            fprintf(stderr, "+++ error: can_write failed (%i)\n", rc);
+            free(sample);
+            return rc;
+        }
+        if ((rc = can_read(rx, &msg, READ_TIMEOUT)) != CANERR_NOERROR) {
+            fprintf(stderr, "+++ error: can_read failed (%i)\n", rc);
+            free(sample);
+            return rc;
+        }
+        sample[i] = now_ns() - start;
+        total += sample[i];
+    }
+    qsort(sample, frames, sizeof(uint64_t), compare);
+    printf("Latency [us]:    min %.1f, avg %.1f, 50%% %.1f, 99%% %.1f, max %.1f\n",
+           (double)sample[0] / 1000.0, (double)total / (double)frames / 1000.0,
+           (double)sample[frames / 2U] / 1000.0, (double)sample[(frames * 99U) / 100U] / 1000.0,
+           (double)sample[frames - 1U] / 1000.0);
+    free(sample);
+    return CANERR_NOERROR;
+}
+
+static void *sender(void *arg)
+{
+    sender_t *param = (sender_t*)arg;
+    can_message_t buffer[BATCH_SIZE];   // frames to be sent
+    uint32_t seq = 0U;                  // sequence number
+    size_t count, sent, i;              // number of frames
+
+    param->result = CANERR_NOERROR;
+    while (seq < param->frames) {
+        count = ((param->frames - seq) < BATCH_SIZE) ? (size_t)(param->frames - seq) : BATCH_SIZE;
+        for (i = 0U; i < count; i++)
+            stamp(&buffer[i], seq + (uint32_t)i, param->dlc);
+        /* note: the write time-out applies while the transmit queue is full */
+        param->result = can_write_multi(param->handle, buffer, count, &sent, CANWAIT_INFINITE);
+        seq += (uint32_t)sent;
+        if (param->result != CANERR_NOERROR)
+            break;
+    }
+    return NULL;
+}
+
+static int throughput(int tx, int rx, uint32_t frames, uint8_t dlc)
+{
+    can_message_t buffer[BATCH_SIZE];   // received frames
+    sender_t param;                     // sender thread
+    pthread_t thread;                   // its thread id
+    uint64_t start, elapsed;            // time measurement
+    uint32_t received = 0U;             // number of frames
+    size_t count;                       // frames per call
+    int rc = CANERR_NOERROR;            // return value
+
+    param.handle = tx;
+    param.frames = frames;
+    param.dlc = dlc;
+    start = now_ns();
+    if (pthread_create(&thread, NULL, sender, &param) != 0) {
+        fprintf(stderr, "+++ error: sender not started\n");
+        return CANERR_FATAL;
+    }
+    while (received < frames) {
+        if ((rc = can_read_multi(rx, buffer, BATCH_SIZE, &count, READ_TIMEOUT)) != CANERR_NOERROR)
+            break;
+        received += (uint32_t)count;
+    }
+    elapsed = now_ns() - start;
+    (void)pthread_join(thread, NULL);
+    if (param.result != CANERR_NOERROR) {
+        fprintf(stderr, "+++ error: can_write_multi failed (%i)\n", param.result);
+        return param.result;
+    }
+    printf("Throughput:      %" PRIu32 " of %" PRIu32 " frame(s) in %.3f ms, %.0f frames/s\n",
+           received, frames, (double)elapsed / 1000000.0,
+           (double)received * 1000000000.0 / (double)elapsed);
+    return (received == frames) ? CANERR_NOERROR : rc;
+}
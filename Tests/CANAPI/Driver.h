@@ -76,7 +76,7 @@ typedef CPeakCAN  CCanDriver;
 #define FEATURE_ERROR_FRAMES         FEATURE_UNSUPPORTED
 #define FEATURE_ERROR_CODE_CAPTURE   FEATURE_UNSUPPORTED
 #define FEATURE_BLOCKING_READ        FEATURE_SUPPORTED
-#define FEATURE_BLOCKING_WRITE       FEATURE_UNSUPPORTED
+#define FEATURE_BLOCKING_WRITE       FEATURE_SUPPORTED  // note: the write time-out applies while the transmit queue is full
 #ifdef __APPLE__
 #define FEATURE_SIZE_RECEIVE_QUEUE   65536U
 #define FEATURE_SIZE_TRANSMIT_QUEUE  0U
@@ -104,12 +104,9 @@ typedef CPeakCAN  CCanDriver;
 #define TC04_3_ISSUE_PCBUSB_BUFFERED_MSGS  WORKAROUND_ENABLED  // 2024-04-29: buffered messages from device (PCAN-USB [Pro] FD)
 #define TC04_8_ISSUE_PCBUSB_QUEUE_SIZE  WORKAROUND_ENABLED  // 2023-08-20: last element of receive queue is not accessible (PCAN-USB)
 #define TC09_8_ISSUE_BUS_OFF  WORKAROUND_ENABLED  // 2023-08-29: no bus off from device (general issue)
-#ifdef __linux__
+#if defined(__linux__) && (OPTION_PCAN_SIMULATION == 0)
 #define TC04_15_ISSUE_PCBUSB_WARNING_LEVEL WORKAROUND_ENABLED  // 2023-09-13: no warning level from device (Linux)
 #define TC09_9_ISSUE_PCBUSB_WARNING_LEVEL  WORKAROUND_ENABLED  // 2023-09-13: no warning level from device (Linux)
-#define TC23_X_ISSUE_PCBUSB_FILTER_CODE  WORKAROUND_ENABLED  // 2024-07-31: code is bit-wise ANDed with mask (Linux)
-#define TC25_X_ISSUE_PCBUSB_FILTER_CODE  WORKAROUND_ENABLED  // 2024-07-31: code is bit-wise ANDed with mask (Linux)
-#define TC27_X_ISSUE_PCBUSB_FILTER_CODE  WORKAROUND_ENABLED  // 2024-07-31: code is bit-wise ANDed with mask (Linux)
 #endif
 //#define TC0x_y_ISSUE_  WORKAROUND_ENABLED
 #endif
@@ -123,8 +123,8 @@ static struct SProperty {
     { CANPROP_SET_FILTER_11BIT    , sizeof(uint64_t),        DRV_PARAM, PROP_SETTER, PROP_FILTERING, MODE_STOPPED, "CANPROP_SET_FILTER_11BIT", "set value for acceptance filter code and mask for 11-bit identifier (uint64_t)" },
     { CANPROP_SET_FILTER_29BIT    , sizeof(uint64_t),        DRV_PARAM, PROP_SETTER, PROP_FILTERING, MODE_STOPPED, "CANPROP_SET_FILTER_29BIT", "set value for acceptance filter code and mask for 29-bit identifier (uint64_t)" },
     { CANPROP_SET_FILTER_RESET    , 0U /* NULL pointer*/,    DRV_PARAM, PROP_SETTER, PROP_FILTERING, MODE_STOPPED, "CANPROP_SET_FILTER_RESET", "reset acceptance filter code and mask to default values (NULL)" },
-    { CANPROP_SET_FROMTO_11BIT    , sizeof(uint64_t),        DRV_PARAM, PROP_SETTER, PROP_OPTIONAL,  MODE_STOPPED, "CANPROP_SET_FROMTO_11BIT", "add an 11-bit identifier range to the from-to filter list (uint64_t)" },
-    { CANPROP_SET_FROMTO_29BIT    , sizeof(uint64_t),        DRV_PARAM, PROP_SETTER, PROP_OPTIONAL,  MODE_STOPPED, "CANPROP_SET_FROMTO_29BIT", "add an 11-bit identifier range to the from-to filter list (uint64_t)" },
+    { CANPROP_SET_FROMTO_11BIT    , sizeof(uint64_t),        DRV_PARAM, PROP_SETTER, PROP_FILTERING, MODE_STOPPED, "CANPROP_SET_FROMTO_11BIT", "add an 11-bit identifier range to the from-to filter list (uint64_t)" },
+    { CANPROP_SET_FROMTO_29BIT    , sizeof(uint64_t),        DRV_PARAM, PROP_SETTER, PROP_FILTERING, MODE_STOPPED, "CANPROP_SET_FROMTO_29BIT", "add an 11-bit identifier range to the from-to filter list (uint64_t)" },
     { CANPROP_GET_TRACE_ACTIVE    , sizeof(uint8_t),         DRV_PARAM, PROP_GETTER, PROP_TRACEFILE, MODE_RUNNING, "CANPROP_GET_TRACE_ACTIVE", "trace file activation state: STOPPED/RUNNING (uint8_t)" },
     { CANPROP_GET_TRACE_FOLDER    , CANPROP_MAX_BUFFER_SIZE, DRV_PARAM, PROP_GETTER, PROP_TRACEFILE, MODE_RUNNING, "CANPROP_GET_TRACE_FOLDER", "trace file folder location (directory only) (char[])" },
     { CANPROP_GET_TRACE_TYPE      , sizeof(uint8_t),         DRV_PARAM, PROP_GETTER, PROP_TRACEFILE, MODE_RUNNING, "CANPROP_GET_TRACE_TYPE", "trace file type (for possible values see below) (uint8_t)" },
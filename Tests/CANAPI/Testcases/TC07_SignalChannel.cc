@@ -0,0 +1,241 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#include <thread>
+
+#define TC07_BATCH_SIZE  256
+
+class SignalChannel : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    // ...
+};
+
+// @gtest TC07.1: Signal a CAN channel while a read is blocked (by another thread)
+//
+// @expected: CANERR_RX_EMPTY before the time-out has expired
+//
+TEST_F(SignalChannel, GTEST_TESTCASE(WhenReadIsBlocked, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @test:
+    struct timespec t0 = {}, t1 = {};
+    double dt;
+    // @- signal DUT1 after 50ms (by another thread)
+    std::thread killer([&dut1]() {
+        CTimer::Delay(50U * CTimer::MSEC);
+        (void)dut1.SignalChannel();
+    });
+    t0 = CTimer::GetTime();
+    // @- DUT1 read a message with time-out 1000ms
+    retVal = dut1.ReadMessage(rcvMsg, 1000U);
+    t1 = CTimer::GetTime();
+    killer.join();
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    // @- check if the read was terminated by the signal (not by the time-out)
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.040, dt);
+    EXPECT_GT((double)0.900, dt);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC07.2: Signal a CAN channel while a write is blocked (by another thread)
+//
+// @expected: CANERR_TX_BUSY before the time-out has expired
+//
+TEST_F(SignalChannel, GTEST_TESTCASE(WhenWriteIsBlocked, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Message_t batch[TC07_BATCH_SIZE] = {};
+    CANAPI_Return_t retVal;
+    size_t sent = 0U;
+    // CAN messages
+    for (int i = 0; i < TC07_BATCH_SIZE; i++) {
+        batch[i].id = 0x070U;
+        batch[i].xtd = 0;
+        batch[i].rtr = 0;
+        batch[i].sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        batch[i].fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        batch[i].brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        batch[i].esi = 0;
+#endif
+        batch[i].dlc = 0U;
+    }
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- fill the transmit queue of DUT1 (w/o acknowledge, nothing is sent)
+    retVal = dut1.WriteMessages(batch, TC07_BATCH_SIZE, sent, 0U);
+    if (retVal == CCanApi::NoError) {
+        // @- note: the transmit queue can hold all messages -> skip the test
+        (void)dut1.TeardownChannel();
+        GTEST_SKIP() << "The transmit queue can hold " << TC07_BATCH_SIZE << " messages!";
+    }
+    EXPECT_EQ(CCanApi::TransmitterBusy, retVal);
+    // @test:
+    struct timespec t0 = {}, t1 = {};
+    double dt;
+    // @- signal DUT1 after 50ms (by another thread)
+    std::thread killer([&dut1]() {
+        CTimer::Delay(50U * CTimer::MSEC);
+        (void)dut1.SignalChannel();
+    });
+    t0 = CTimer::GetTime();
+    // @- DUT1 write a message with time-out 1000ms
+    retVal = dut1.WriteMessage(batch[0], 1000U);
+    t1 = CTimer::GetTime();
+    killer.join();
+    EXPECT_EQ(CCanApi::TransmitterBusy, retVal);
+    // @- check if the write was terminated by the signal (not by the time-out)
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.040, dt);
+    EXPECT_GT((double)0.900, dt);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC07.3: Signal a CAN channel when no read or write is blocked
+//
+// @expected: CANERR_NOERROR and no effect on the following read and write
+//
+TEST_F(SignalChannel, GTEST_TESTCASE(WhenNothingIsBlocked, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Return_t retVal;
+    // CAN message
+    trmMsg.id = 0x071U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+#endif
+    trmMsg.dlc = 0U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    struct timespec t0 = {}, t1 = {};
+    double dt;
+    // @- signal DUT1 (nobody is waiting)
+    retVal = dut1.SignalChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT1 read a message with time-out 100ms (not terminated by the signal)
+    t0 = CTimer::GetTime();
+    retVal = dut1.ReadMessage(rcvMsg, 100U);
+    t1 = CTimer::GetTime();
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.099, dt);
+    // @- signal DUT1 again (nobody is waiting)
+    retVal = dut1.SignalChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT1 send a message to DUT2
+    retVal = dut1.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 read the message
+    retVal = dut2.ReadMessage(rcvMsg, TEST_READ_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(trmMsg.id, rcvMsg.id);
+    // @- DUT2 send a message to DUT1
+    retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT1 read the message (not terminated by the signal)
+    retVal = dut1.ReadMessage(rcvMsg, TEST_READ_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(trmMsg.id, rcvMsg.id);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
@@ -110,6 +110,9 @@ TEST_F(GetProperty, GTEST_TESTCASE(SunnydayScenario, GTEST_SUNNYDAY)) {
         param = testcase.GetNextEntry();
     }
     counter.Clear();
+    // @- reset acceptance filter (the from-to setters have added an entry)
+    retVal = dut1.SetProperty(CANPROP_SET_FILTER_RESET, NULL, 0U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
     // @post:
     // @- start DUT1 with configured bit-rate settings
     retVal = dut1.StartController();
@@ -475,6 +478,9 @@ TEST_F(GetProperty, GTEST_TESTCASE(IfChannelInitialized, GTEST_ENABLED)) {
     EXPECT_TRUE(status.can_stopped);
     // @post:
     counter.Clear();
+    // @- reset acceptance filter (the from-to setters have added an entry)
+    retVal = dut1.SetProperty(CANPROP_SET_FILTER_RESET, NULL, 0U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
     // @- start DUT1 with configured bit-rate settings
     retVal = dut1.StartController();
     EXPECT_EQ(CCanApi::NoError, retVal);
@@ -0,0 +1,306 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+//  @note: This test suite tests the following methods:
+//  @      - CPeakCAN::AddFromTo29Bit()  [TC29.*]
+//  @      - CPeakCAN::AddFilter29Bit()  [TC29.*]
+//  @
+#ifndef FEATURE_FILTERING
+#define FEATURE_FILTERING  FEATURE_UNSUPPORTED
+#ifdef _MSC_VER
+#pragma message ( "FEATURE_FILTERING not set, default = FEATURE_UNSUPPORTED" )
+#else
+#warning FEATURE_FILTERING not set, default = FEATURE_UNSUPPORTED
+#endif
+#endif
+#if (FEATURE_FILTERING != FEATURE_UNSUPPORTED)
+
+#define COUNT(array)  (sizeof(array) / sizeof(array[0]))
+
+class AddFilter29Bit : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    void CheckReceived(CCanDevice& dut1, const uint32_t trmIds[], size_t trmCount, const uint32_t rcvIds[], size_t rcvCount) {
+        CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+        CANAPI_Message_t trmMsg = {};
+        CANAPI_Message_t rcvMsg = {};
+        CANAPI_Return_t retVal;
+        // CAN message
+        trmMsg.id = 0U;
+        trmMsg.xtd = 1;
+        trmMsg.rtr = 0;
+        trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        trmMsg.esi = 0;
+#endif
+        trmMsg.dlc = 0U;
+        // initialize DUT2 with configured settings
+        retVal = dut2.InitializeChannel();
+        ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+        // start DUT2 with configured bit-rate settings
+        retVal = dut2.StartController();
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        // issue(PeakCAN): why do we need a delay here?
+        PCBUSB_INIT_DELAY();
+        // DUT2 send the extended messages
+        for (size_t i = 0; i < trmCount; i++) {
+            trmMsg.id = trmIds[i];
+            retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+            EXPECT_EQ(CCanApi::NoError, retVal);
+        }
+        // DUT1 read the accepted messages (in order)
+        size_t j = 0;
+        while (j < rcvCount) {
+            retVal = dut1.ReadMessage(rcvMsg, TEST_READ_TIMEOUT);
+            if (retVal != CCanApi::NoError) {
+                EXPECT_EQ(CCanApi::NoError, retVal);
+                break;
+            }
+            // ignore status messages/error frames
+            if (!rcvMsg.sts) {
+                EXPECT_EQ(rcvIds[j], rcvMsg.id);
+                EXPECT_TRUE(rcvMsg.xtd);
+                j++;
+            }
+        }
+        // DUT1 try to read another message (the others must be filtered)
+        do {
+            retVal = dut1.ReadMessage(rcvMsg, 100U);
+        } while ((retVal == CCanApi::NoError) && rcvMsg.sts);
+        EXPECT_EQ(CCanApi::ReceiverEmpty, retVal) << "[  ERROR!  ] unexpected message 0x" << std::hex << rcvMsg.id << std::dec;
+        // tear down DUT2
+        retVal = dut2.TeardownChannel();
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+};
+
+// @gtest TC29.1: Add an 29-bit identifier range to the software filter
+//
+// @expected: CANERR_NOERROR and only messages within the range received
+//
+TEST_F(AddFilter29Bit, GTEST_TESTCASE(WithFromToRange, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    const uint32_t trmIds[] = { 0x00000000U, 0x0FFFFFFFU, 0x10000000U, 0x10000005U, 0x1000FFFFU, 0x10010000U, 0x1FFFFFFFU };
+    const uint32_t rcvIds[] = { 0x10000000U, 0x10000005U, 0x1000FFFFU };
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- add identifier range 0x10000000..0x1000FFFF
+    retVal = dut1.AddFromTo29Bit(0x10000000U, 0x1000FFFFU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send messages, DUT1 receive only those within the range
+    CheckReceived(dut1, trmIds, COUNT(trmIds), rcvIds, COUNT(rcvIds));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC29.2: Add an 29-bit identifier code and mask to the software filter
+//
+// @expected: CANERR_NOERROR and only messages matching code and mask received
+//
+TEST_F(AddFilter29Bit, GTEST_TESTCASE(WithCodeAndMask, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    const uint32_t trmIds[] = { 0x10000001U, 0x10000002U, 0x10000011U, 0x10000101U, 0x100000F1U, 0x00000001U };
+    const uint32_t rcvIds[] = { 0x10000001U, 0x10000011U, 0x100000F1U };
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- add code 0x10000001 and mask 0x1FFFFF0F (not an identifier range)
+    retVal = dut1.AddFilter29Bit(0x10000001U, 0x1FFFFF0FU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send messages, DUT1 receive only those matching code and mask
+    CheckReceived(dut1, trmIds, COUNT(trmIds), rcvIds, COUNT(rcvIds));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC29.3: Add several (overlapping) 29-bit identifier ranges and code and mask to the software filter
+//
+// @expected: CANERR_NOERROR and only messages matching any of the entries received
+//
+TEST_F(AddFilter29Bit, GTEST_TESTCASE(WithSeveralEntries, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    const uint32_t trmIds[] = { 0x00FFFFFFU, 0x01000000U, 0x01000010U, 0x01000020U, 0x01000022U, 0x01000023U,
+                                0x12345600U, 0x123456FFU, 0x12345700U, 0x1FFFFFFEU, 0x1FFFFFFFU };
+    const uint32_t rcvIds[] = { 0x01000000U, 0x01000010U, 0x01000020U, 0x01000022U,
+                                0x12345600U, 0x123456FFU, 0x1FFFFFFFU };
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- add identifier ranges 0x01000008..0x01000020 and 0x01000000..0x01000010 (overlapping)
+    retVal = dut1.AddFromTo29Bit(0x01000008U, 0x01000020U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = dut1.AddFromTo29Bit(0x01000000U, 0x01000010U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- add identifier range 0x01000021..0x01000022 (adjacent)
+    retVal = dut1.AddFromTo29Bit(0x01000021U, 0x01000022U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- add code 0x12345600 and mask 0x1FFFFF00 (an identifier range)
+    retVal = dut1.AddFilter29Bit(0x12345600U, 0x1FFFFF00U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- add identifier range 0x1FFFFFFF..0x1FFFFFFF (a single identifier)
+    retVal = dut1.AddFromTo29Bit(0x1FFFFFFFU, 0x1FFFFFFFU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send messages, DUT1 receive only those matching any entry
+    CheckReceived(dut1, trmIds, COUNT(trmIds), rcvIds, COUNT(rcvIds));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC29.4: Add 29-bit identifier ranges and code and mask with invalid values
+//
+// @expected: CANERR_ILLPARA
+//
+TEST_F(AddFilter29Bit, GTEST_TESTCASE(WithInvalidValues, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @sub(1): first identifier greater than last identifier
+    retVal = dut1.AddFromTo29Bit(0x10000001U, 0x10000000U);
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    // @sub(2): last identifier greater than 0x1FFFFFFF
+    retVal = dut1.AddFromTo29Bit(0x1F000000U, 0x20000000U);
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    // @sub(3): code greater than 0x1FFFFFFF
+    retVal = dut1.AddFilter29Bit(0x20000000U, 0x1FFFFFFFU);
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    // @sub(4): mask greater than 0x1FFFFFFF
+    retVal = dut1.AddFilter29Bit(0x00000000U, 0xFFFFFFFFU);
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC29.5: Add 29-bit identifier ranges and code and mask if CAN controller is started
+//
+// @expected: CANERR_ONLINE, and all messages received after the filter has been reset
+//
+TEST_F(AddFilter29Bit, GTEST_TESTCASE(IfControllerStarted, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    const uint32_t trmIds[] = { 0x00000000U, 0x10000000U, 0x15555555U, 0x1FFFFFFFU };
+    const uint32_t rcvIds[] = { 0x10000000U };
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- add identifier range 0x10000000..0x10000000
+    retVal = dut1.AddFromTo29Bit(0x10000000U, 0x10000000U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @test:
+    // @- add identifier range and code and mask (in RUNNING state)
+    retVal = dut1.AddFromTo29Bit(0x00000000U, 0x1FFFFFFFU);
+    EXPECT_EQ(CCanApi::ControllerOnline, retVal);
+    retVal = dut1.AddFilter29Bit(0x00000000U, 0x00000000U);
+    EXPECT_EQ(CCanApi::ControllerOnline, retVal);
+    // @- DUT2 send messages, DUT1 receive only those of the first range
+    CheckReceived(dut1, trmIds, COUNT(trmIds), rcvIds, COUNT(rcvIds));
+    // @- stop/reset DUT1
+    retVal = dut1.ResetController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- reset the acceptance filter (incl. the software filter)
+    retVal = dut1.ResetFilters();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- restart DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send messages, DUT1 receive all of them
+    CheckReceived(dut1, trmIds, COUNT(trmIds), trmIds, COUNT(trmIds));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+#endif // FEATURE_FILTERING != FEATURE_UNSUPPORTED
+
+//  $Id$  Copyright (c) UV Software, Berlin.
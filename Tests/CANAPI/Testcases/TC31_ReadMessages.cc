@@ -0,0 +1,353 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#include <thread>
+
+#define TC31_BUFFER_SIZE  64
+#define TC31_FRAMES       8
+
+class ReadMessages : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    // ...
+};
+
+// @gtest TC31.1: Read CAN messages into a buffer of capacity zero
+//
+// @expected: CANERR_ILLPARA and no message read
+//
+TEST_F(ReadMessages, GTEST_TESTCASE(WithZeroCapacity, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Message_t buffer[TC31_BUFFER_SIZE] = {};
+    CANAPI_Status_t status = {};
+    CANAPI_Return_t retVal;
+    size_t count = 1U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- get status of DUT1 and check to be in RUNNING state
+    retVal = dut1.GetStatus(status);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_FALSE(status.can_stopped);
+    // @test:
+    // @- DUT1 read messages into a buffer of capacity 0
+    retVal = dut1.ReadMessages(buffer, 0U, count, 0U);
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    EXPECT_EQ(0U, count);
+    // @- DUT1 read messages into a buffer of capacity 0 (blocking)
+    count = 1U;
+    retVal = dut1.ReadMessages(buffer, 0U, count, TEST_READ_TIMEOUT);
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    EXPECT_EQ(0U, count);
+    // @post:
+    // @- get status of DUT1 and check to be in RUNNING state
+    retVal = dut1.GetStatus(status);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_FALSE(status.can_stopped);
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC31.2: Read CAN messages into a buffer smaller than the number of received messages
+//
+// @expected: CANERR_NOERROR and the messages in order of reception (drained in parts)
+//
+TEST_F(ReadMessages, GTEST_TESTCASE(WithPartialDrain, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t buffer[TC31_BUFFER_SIZE] = {};
+    CANAPI_Status_t status = {};
+    CANAPI_Return_t retVal;
+    size_t count = 0U;
+    // CAN message
+    trmMsg.id = 0x310U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY != 0)
+    trmMsg.dlc = 1U;
+    memset(trmMsg.data, 0, CAN_MAX_LEN);
+#else
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+    trmMsg.dlc = 1U;
+    memset(trmMsg.data, 0, CANFD_MAX_LEN);
+#endif
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 send TC31_FRAMES messages with up-counting content
+    for (int i = 0; i < TC31_FRAMES; i++) {
+        trmMsg.data[0] = (uint8_t)i;
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- wait until all messages are received by DUT1
+    CTimer::Delay(100U * CTimer::MSEC);
+    // @- DUT1 read 3 messages (less than received)
+    retVal = dut1.ReadMessages(buffer, 3U, count, 0U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    ASSERT_EQ(3U, count);
+    for (size_t i = 0U; i < count; i++) {
+        EXPECT_EQ(0x310U, buffer[i].id);
+        EXPECT_EQ((uint8_t)i, buffer[i].data[0]);
+    }
+    // @- DUT1 read the remaining messages (buffer larger than received)
+    retVal = dut1.ReadMessages(buffer, TC31_BUFFER_SIZE, count, 0U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    ASSERT_EQ((size_t)(TC31_FRAMES - 3), count);
+    for (size_t i = 0U; i < count; i++) {
+        EXPECT_EQ(0x310U, buffer[i].id);
+        EXPECT_EQ((uint8_t)(i + 3U), buffer[i].data[0]);
+    }
+    // @- DUT1 read from the empty queue
+    retVal = dut1.ReadMessages(buffer, TC31_BUFFER_SIZE, count, 0U);
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    EXPECT_EQ(0U, count);
+    // @post:
+    // @- get status of DUT1 and check to be in RUNNING state
+    retVal = dut1.GetStatus(status);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_FALSE(status.can_stopped);
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC31.3: Read CAN messages with time-out until the first message is received
+//
+// @expected: CANERR_RX_EMPTY after the time-out, or CANERR_NOERROR as soon as a message is received
+//
+TEST_F(ReadMessages, GTEST_TESTCASE(BlockingUntilFirstMessage, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t buffer[TC31_BUFFER_SIZE] = {};
+    CANAPI_Status_t status = {};
+    CANAPI_Return_t retVal;
+    size_t count = 0U;
+    // CAN message
+    trmMsg.id = 0x311U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY != 0)
+    trmMsg.dlc = 0U;
+    memset(trmMsg.data, 0, CAN_MAX_LEN);
+#else
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+    trmMsg.dlc = 0U;
+    memset(trmMsg.data, 0, CANFD_MAX_LEN);
+#endif
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    struct timespec t0 = {}, t1 = {};
+    double dt;
+    // @sub(1): empty queue
+    t0 = CTimer::GetTime();
+    // @- DUT1 try to read messages with time-out 100ms
+    retVal = dut1.ReadMessages(buffer, TC31_BUFFER_SIZE, count, 100U);
+    t1 = CTimer::GetTime();
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    EXPECT_EQ(0U, count);
+    // @- check if expired time is at least 99ms
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.099, dt);
+    // @sub(2): one message received after 50ms
+    // @- DUT2 send a message after 50ms (from another thread)
+    std::thread sender([&dut2, trmMsg]() {
+        CTimer::Delay(50U * CTimer::MSEC);
+        (void)dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    });
+    t0 = CTimer::GetTime();
+    // @- DUT1 read messages with time-out 1000ms
+    retVal = dut1.ReadMessages(buffer, TC31_BUFFER_SIZE, count, 1000U);
+    t1 = CTimer::GetTime();
+    sender.join();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(1U, count);
+    EXPECT_EQ(0x311U, buffer[0].id);
+    // @- check if the read returned with the first message (before the time-out)
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.040, dt);
+    EXPECT_GT((double)0.900, dt);
+    // @post:
+    // @- get status of DUT1 and check to be in RUNNING state
+    retVal = dut1.GetStatus(status);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_FALSE(status.can_stopped);
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC31.4: Read CAN messages and check the receive counter
+//
+// @expected: CANERR_NOERROR and the receive counter incremented by the number of messages read
+//
+TEST_F(ReadMessages, GTEST_TESTCASE(UpdatesReceiveCounter, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t buffer[TC31_BUFFER_SIZE] = {};
+    CANAPI_Return_t retVal;
+    size_t count = 0U, total = 0U;
+    int32_t frames = TC31_BUFFER_SIZE / 2;
+    // CAN message
+    trmMsg.id = 0x312U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY != 0)
+    trmMsg.dlc = CAN_MAX_DLC;
+    memset(trmMsg.data, 0, CAN_MAX_LEN);
+#else
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+    trmMsg.dlc = CAN_MAX_DLC;
+    memset(trmMsg.data, 0, CANFD_MAX_LEN);
+#endif
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @- check if the receive counter of DUT1 is zero
+    EXPECT_EQ(0U, dut1.GetRxCounter());
+    // @test:
+    // @- DUT2 send some messages
+    for (int32_t i = 0; i < frames; i++) {
+        trmMsg.data[0] = (uint8_t)i;
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- DUT1 read the messages in blocks of 5
+    while (total < (size_t)frames) {
+        retVal = dut1.ReadMessages(buffer, 5U, count, TEST_READ_TIMEOUT);
+        if (retVal != CCanApi::NoError)
+            break;
+        EXPECT_LE(count, 5U);
+        EXPECT_EQ((uint8_t)total, buffer[0].data[0]);
+        total += count;
+    }
+    EXPECT_EQ((size_t)frames, total);
+    // @- check if the receive counter of DUT1 equals the number of messages read
+    EXPECT_EQ((uint64_t)frames, dut1.GetRxCounter());
+    // @- check if the transmit counter of DUT2 equals the number of messages sent
+    EXPECT_EQ((uint64_t)frames, dut2.GetTxCounter());
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
@@ -0,0 +1,308 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#define TC32_BATCH_SIZE  256
+
+class WriteMessages : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    // ...
+};
+
+// @gtest TC32.1: Write CAN messages with an illegal message in the array
+//
+// @expected: CANERR_ILLPARA and no message sent
+//
+TEST_F(WriteMessages, GTEST_TESTCASE(WithIllegalMessage, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t batch[4] = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Status_t status = {};
+    CANAPI_Return_t retVal;
+    size_t sent = 4U;
+    // CAN messages
+    for (int i = 0; i < 4; i++) {
+        batch[i].id = 0x320U + (uint32_t)i;
+        batch[i].xtd = 0;
+        batch[i].rtr = 0;
+        batch[i].sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        batch[i].fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        batch[i].brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        batch[i].esi = 0;
+#endif
+        batch[i].dlc = 1U;
+    }
+    // @- the third message with an illegal data length code
+#if (OPTION_CAN_2_0_ONLY != 0)
+    batch[2].dlc = CAN_MAX_DLC + 1U;
+#else
+    batch[2].dlc = (g_Options.GetOpMode(DUT1).fdoe ? CANFD_MAX_DLC : CAN_MAX_DLC) + 1U;
+#endif
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT1 write the messages (the third one is illegal)
+    retVal = dut1.WriteMessages(batch, 4U, sent, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    EXPECT_EQ(0U, sent);
+    // @- check if the transmit counter of DUT1 is zero
+    EXPECT_EQ(0U, dut1.GetTxCounter());
+    // @- DUT2 try to read a message (expect none)
+    retVal = dut2.ReadMessage(rcvMsg, 100U);
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    // @post:
+    // @- get status of DUT1 and check to be in RUNNING state
+    retVal = dut1.GetStatus(status);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_FALSE(status.can_stopped);
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC32.2: Write more CAN messages than the transmit queue can hold (without time-out)
+//
+// @expected: CANERR_TX_BUSY and the number of messages sent, which are all received
+//
+TEST_F(WriteMessages, GTEST_TESTCASE(IfTransmitterBusy, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t batch[TC32_BATCH_SIZE] = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Bitrate_t oldBtr1 = {}, oldBtr2 = {};
+    CANAPI_Bitrate_t newBtr = {};
+    CANAPI_Return_t retVal;
+    size_t sent = 0U;
+    // CAN messages
+    for (int i = 0; i < TC32_BATCH_SIZE; i++) {
+        batch[i].id = 0x321U;
+        batch[i].xtd = 0;
+        batch[i].rtr = 0;
+        batch[i].sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        batch[i].fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        batch[i].brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        batch[i].esi = 0;
+#endif
+        batch[i].dlc = 2U;
+        batch[i].data[0] = (uint8_t)i;
+        batch[i].data[1] = (uint8_t)(i >> 8);
+    }
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- change bit-rate settings: DUT1 and DUT2 w/ slow bit-rate
+    SLOW_BITRATE(newBtr);
+#if (CAN_FD_SUPPORTED == FEATURE_SUPPORTED)
+    if (dut1.GetOpMode().fdoe) SLOW_BITRATE_FD(newBtr);
+#endif
+    oldBtr1 = dut1.GetBitrate();
+    oldBtr2 = dut2.GetBitrate();
+    dut1.SetBitrate(newBtr);
+    dut2.SetBitrate(newBtr);
+    // @- start DUT1 and DUT2 with changed bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT1 write all messages without time-out
+    retVal = dut1.WriteMessages(batch, TC32_BATCH_SIZE, sent, 0U);
+    if (retVal == CCanApi::NoError) {
+        // @- note: the transmit queue can hold all messages -> skip the test
+        EXPECT_EQ((size_t)TC32_BATCH_SIZE, sent);
+        (void)dut1.TeardownChannel();
+        (void)dut2.TeardownChannel();
+        dut1.SetBitrate(oldBtr1);
+        dut2.SetBitrate(oldBtr2);
+        GTEST_SKIP() << "The transmit queue can hold " << TC32_BATCH_SIZE << " messages!";
+    }
+    EXPECT_EQ(CCanApi::TransmitterBusy, retVal);
+    EXPECT_LT(0U, sent);
+    EXPECT_GT((size_t)TC32_BATCH_SIZE, sent);
+    // @- check if the transmit counter of DUT1 equals the number of messages sent
+    EXPECT_EQ((uint64_t)sent, dut1.GetTxCounter());
+    // @- DUT2 read the messages sent (in order)
+    size_t n = 0U;
+    while (n < sent) {
+        retVal = dut2.ReadMessage(rcvMsg, 1000U);
+        if (retVal != CCanApi::NoError)
+            break;
+        EXPECT_EQ((uint8_t)n, rcvMsg.data[0]);
+        EXPECT_EQ((uint8_t)(n >> 8), rcvMsg.data[1]);
+        n++;
+    }
+    EXPECT_EQ(sent, n);
+    // @- DUT2 try to read another message (expect none)
+    retVal = dut2.ReadMessage(rcvMsg, 100U);
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- restore configure bit-rate settings
+    dut1.SetBitrate(oldBtr1);
+    dut2.SetBitrate(oldBtr2);
+    // @end.
+}
+
+// @gtest TC32.3: Write more CAN messages than the transmit queue can hold (with time-out)
+//
+// @expected: CANERR_TX_BUSY when the time-out of the whole call has expired
+//
+TEST_F(WriteMessages, GTEST_TESTCASE(WithTimeoutOfTheWholeCall, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t batch[TC32_BATCH_SIZE] = {};
+    CANAPI_Bitrate_t oldBtr1 = {}, oldBtr2 = {};
+    CANAPI_Bitrate_t newBtr = {};
+    CANAPI_Return_t retVal;
+    size_t sent = 0U;
+    // CAN messages
+    for (int i = 0; i < TC32_BATCH_SIZE; i++) {
+        batch[i].id = 0x322U;
+        batch[i].xtd = 0;
+        batch[i].rtr = 0;
+        batch[i].sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        batch[i].fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        batch[i].brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        batch[i].esi = 0;
+#endif
+        batch[i].dlc = 0U;
+    }
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- change bit-rate settings: DUT1 and DUT2 w/ slow bit-rate
+    SLOW_BITRATE(newBtr);
+#if (CAN_FD_SUPPORTED == FEATURE_SUPPORTED)
+    if (dut1.GetOpMode().fdoe) SLOW_BITRATE_FD(newBtr);
+#endif
+    oldBtr1 = dut1.GetBitrate();
+    oldBtr2 = dut2.GetBitrate();
+    dut1.SetBitrate(newBtr);
+    dut2.SetBitrate(newBtr);
+    // @- start DUT1 and DUT2 with changed bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    struct timespec t0 = {}, t1 = {};
+    double dt;
+    t0 = CTimer::GetTime();
+    // @- DUT1 write all messages with time-out 100ms (for the whole call)
+    retVal = dut1.WriteMessages(batch, TC32_BATCH_SIZE, sent, 100U);
+    t1 = CTimer::GetTime();
+    if (retVal == CCanApi::NoError) {
+        // @- note: the transmit queue can hold all messages -> skip the test
+        (void)dut1.TeardownChannel();
+        (void)dut2.TeardownChannel();
+        dut1.SetBitrate(oldBtr1);
+        dut2.SetBitrate(oldBtr2);
+        GTEST_SKIP() << "The transmit queue can hold " << TC32_BATCH_SIZE << " messages!";
+    }
+    EXPECT_EQ(CCanApi::TransmitterBusy, retVal);
+    EXPECT_GT((size_t)TC32_BATCH_SIZE, sent);
+    // @- check if expired time is at least 99ms, but not a time-out per message
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.099, dt);
+    EXPECT_GT((double)0.500, dt);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- restore configure bit-rate settings
+    dut1.SetBitrate(oldBtr1);
+    dut2.SetBitrate(oldBtr2);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
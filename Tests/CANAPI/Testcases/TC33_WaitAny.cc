@@ -0,0 +1,276 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#include <thread>
+
+class WaitAny : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    // ...
+};
+
+// @gtest TC33.1: Wait for several CAN channels with an illegal number of channels
+//
+// @expected: CANERR_ILLPARA and no channel ready
+//
+TEST_F(WaitAny, GTEST_TESTCASE(WithIllegalNumberOfChannels, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDriver *channels[33];
+    CANAPI_Return_t retVal;
+    uint32_t ready = 0xFFFFFFFFU;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    for (int i = 0; i < 33; i++)
+        channels[i] = &dut1;
+    // @test:
+    // @sub(1): zero channels
+    retVal = CCanDriver::WaitAny(channels, 0, ready, 0U);
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    EXPECT_EQ(0x00000000U, ready);
+    // @sub(2): 33 channels
+    ready = 0xFFFFFFFFU;
+    retVal = CCanDriver::WaitAny(channels, 33, ready, 0U);
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    EXPECT_EQ(0x00000000U, ready);
+    // @sub(3): one channel (valid, but nothing received)
+    ready = 0xFFFFFFFFU;
+    retVal = CCanDriver::WaitAny(channels, 1, ready, 0U);
+    EXPECT_EQ(CCanApi::Timeout, retVal);
+    EXPECT_EQ(0x00000000U, ready);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC33.2: Wait for several CAN channels when no message is received
+//
+// @expected: CANERR_TIMEOUT after the time-out has expired
+//
+TEST_F(WaitAny, GTEST_TESTCASE(WithTimeout, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Return_t retVal;
+    uint32_t ready = 0xFFFFFFFFU;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    CCanDriver *const channels[2] = { &dut1, &dut2 };
+    // @test:
+    struct timespec t0 = {}, t1 = {};
+    double dt;
+    t0 = CTimer::GetTime();
+    // @- wait for DUT1 and DUT2 with time-out 100ms
+    retVal = CCanDriver::WaitAny(channels, 2, ready, 100U);
+    t1 = CTimer::GetTime();
+    EXPECT_EQ(CCanApi::Timeout, retVal);
+    EXPECT_EQ(0x00000000U, ready);
+    // @- check if expired time is at least 99ms
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.099, dt);
+    EXPECT_GT((double)0.500, dt);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC33.3: Wait for several CAN channels when one of them has received a message
+//
+// @expected: CANERR_NOERROR and only the bit of the receiving channel set in the ready mask
+//
+TEST_F(WaitAny, GTEST_TESTCASE(WithReadyMask, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Return_t retVal;
+    uint32_t ready = 0x00000000U;
+    // CAN message
+    trmMsg.id = 0x330U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+#endif
+    trmMsg.dlc = 0U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    CCanDriver *const channels[2] = { &dut1, &dut2 };
+    // @test:
+    // @sub(1): DUT1 send a message, DUT2 has received it
+    retVal = dut1.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = CCanDriver::WaitAny(channels, 2, ready, 1000U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0x00000002U, ready);
+    // @- DUT2 read the message (the ready mask remains valid)
+    retVal = dut2.ReadMessage(rcvMsg, 0U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(trmMsg.id, rcvMsg.id);
+    // @sub(2): DUT2 send a message, DUT1 has received it
+    retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = CCanDriver::WaitAny(channels, 2, ready, 1000U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0x00000001U, ready);
+    // @- DUT1 read the message
+    retVal = dut1.ReadMessage(rcvMsg, 0U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(trmMsg.id, rcvMsg.id);
+    // @sub(3): nothing received (any more)
+    retVal = CCanDriver::WaitAny(channels, 2, ready, 0U);
+    EXPECT_EQ(CCanApi::Timeout, retVal);
+    EXPECT_EQ(0x00000000U, ready);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC33.4: Wait for several CAN channels when one of them is signaled (by another thread)
+//
+// @expected: CANERR_NOERROR and the bit of the signaled channel set in the ready mask
+//
+TEST_F(WaitAny, GTEST_TESTCASE(WakeUpBySignal, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Return_t retVal;
+    uint32_t ready = 0x00000000U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    CCanDriver *const channels[2] = { &dut1, &dut2 };
+    // @test:
+    struct timespec t0 = {}, t1 = {};
+    double dt;
+    // @- signal DUT2 after 50ms (by another thread)
+    std::thread killer([&dut2]() {
+        CTimer::Delay(50U * CTimer::MSEC);
+        (void)dut2.SignalChannel();
+    });
+    t0 = CTimer::GetTime();
+    // @- wait for DUT1 and DUT2 with time-out 1000ms
+    retVal = CCanDriver::WaitAny(channels, 2, ready, 1000U);
+    t1 = CTimer::GetTime();
+    killer.join();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0x00000002U, ready);
+    // @- check if the wait was terminated by the signal (not by the time-out)
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.040, dt);
+    EXPECT_GT((double)0.900, dt);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
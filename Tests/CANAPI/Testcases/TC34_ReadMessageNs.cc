@@ -0,0 +1,247 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#include <thread>
+#include <chrono>
+
+class ReadMessageNs : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    // ...
+};
+
+// @gtest TC34.1: Read a CAN message with a sub-millisecond time-out (nothing received)
+//
+// @expected: CANERR_RX_EMPTY after the time-out has expired (not rounded up to milliseconds)
+//
+TEST_F(ReadMessageNs, GTEST_TESTCASE(WithSubMillisecondTimeout, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @test:
+    struct timespec t0 = {}, t1 = {};
+    double dt;
+    // @sub(1): time-out 500us
+    t0 = CTimer::GetTime();
+    retVal = dut1.ReadMessage(rcvMsg, std::chrono::microseconds(500));
+    t1 = CTimer::GetTime();
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.0005, dt);
+    EXPECT_GT((double)0.0200, dt);
+    // @sub(2): time-out 0ns (polling)
+    t0 = CTimer::GetTime();
+    retVal = dut1.ReadMessage(rcvMsg, std::chrono::nanoseconds(0));
+    t1 = CTimer::GetTime();
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_GT((double)0.0100, dt);
+    // @sub(3): negative time-out (same as polling)
+    t0 = CTimer::GetTime();
+    retVal = dut1.ReadMessage(rcvMsg, std::chrono::nanoseconds(-1));
+    t1 = CTimer::GetTime();
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_GT((double)0.0100, dt);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC34.2: Read a CAN message with a sub-millisecond time-out (message received)
+//
+// @expected: CANERR_NOERROR and the received message
+//
+TEST_F(ReadMessageNs, GTEST_TESTCASE(WithMessageReceived, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Return_t retVal;
+    // CAN message
+    trmMsg.id = 0x340U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+#endif
+    trmMsg.dlc = 1U;
+    trmMsg.data[0] = 0x34U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 send a message to DUT1
+    retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- wait until the message has been received
+    CTimer::Delay(TEST_READ_TIMEOUT * CTimer::MSEC);
+    // @- DUT1 read the message with time-out 100us
+    retVal = dut1.ReadMessage(rcvMsg, std::chrono::microseconds(100));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(trmMsg.id, rcvMsg.id);
+    EXPECT_EQ(trmMsg.dlc, rcvMsg.dlc);
+    EXPECT_EQ(trmMsg.data[0], rcvMsg.data[0]);
+    // @- DUT1 try to read another message with time-out 100us
+    retVal = dut1.ReadMessage(rcvMsg, std::chrono::microseconds(100));
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC34.3: Read a CAN message with infinite time-out (blocking read)
+//
+// @expected: CANERR_NOERROR when a message is received, CANERR_RX_EMPTY when signaled
+//
+TEST_F(ReadMessageNs, GTEST_TESTCASE(WithInfiniteTimeout, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Return_t retVal;
+    // CAN message
+    trmMsg.id = 0x341U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+#endif
+    trmMsg.dlc = 0U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    struct timespec t0 = {}, t1 = {};
+    double dt;
+    // @sub(1): DUT2 send a message to DUT1 after 50ms (by another thread)
+    std::thread sender([&dut2, &trmMsg]() {
+        CTimer::Delay(50U * CTimer::MSEC);
+        (void)dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    });
+    t0 = CTimer::GetTime();
+    // @- DUT1 read a message with infinite time-out
+    retVal = dut1.ReadMessage(rcvMsg, std::chrono::nanoseconds::max());
+    t1 = CTimer::GetTime();
+    sender.join();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(trmMsg.id, rcvMsg.id);
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.040, dt);
+    // @sub(2): signal DUT1 after 50ms (by another thread)
+    std::thread killer([&dut1]() {
+        CTimer::Delay(50U * CTimer::MSEC);
+        (void)dut1.SignalChannel();
+    });
+    t0 = CTimer::GetTime();
+    // @- DUT1 read a message with infinite time-out
+    retVal = dut1.ReadMessage(rcvMsg, std::chrono::nanoseconds::max());
+    t1 = CTimer::GetTime();
+    killer.join();
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    dt = CTimer::DiffTime(t0, t1);
+    EXPECT_LE((double)0.040, dt);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
@@ -0,0 +1,221 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#define TC35_RING_SIZE  16U
+#define TC35_FRAMES  40U
+
+class ReceiveQueue : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    // ...
+};
+
+// @gtest TC35.1: Set the size of the receive queue (wrapper ring) to different values
+//
+// @expected: CANERR_NOERROR and the size rounded up to the next power of two
+//
+TEST_F(ReceiveQueue, GTEST_TESTCASE(SizeRoundedUpToPowerOfTwo, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    const uint32_t values[][2] = {
+        { 1U, 1U }, { 2U, 2U }, { 3U, 4U }, { 100U, 128U }, { 1024U, 1024U }, { 1025U, 2048U }
+    };
+    CANAPI_Return_t retVal;
+    uint32_t size = 0U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- loop over the list of sizes
+    for (size_t i = 0; i < (sizeof(values) / sizeof(values[0])); i++) {
+        // @-- set size of the receive queue (in INIT state)
+        size = values[i][0];
+        retVal = dut1.SetProperty(PEAKCAN_PROPERTY_SET_RCV_QUEUE_SIZE, (void*)&size, sizeof(uint32_t));
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        // @-- start DUT1 with configured bit-rate settings
+        retVal = dut1.StartController();
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        // @-- get size of the receive queue (rounded up)
+        size = 0U;
+        retVal = dut1.GetProperty(PEAKCAN_PROPERTY_RCV_QUEUE_SIZE, (void*)&size, sizeof(uint32_t));
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        EXPECT_EQ(values[i][1], size);
+        // @-- set size of the receive queue (in RUNNING state)
+        size = values[i][0];
+        retVal = dut1.SetProperty(PEAKCAN_PROPERTY_SET_RCV_QUEUE_SIZE, (void*)&size, sizeof(uint32_t));
+        EXPECT_EQ(CCanApi::ControllerOnline, retVal);
+        // @-- stop/reset DUT1
+        retVal = dut1.ResetController();
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- set size of the receive queue greater than maximum (1M)
+    size = 0x100001U;
+    retVal = dut1.SetProperty(PEAKCAN_PROPERTY_SET_RCV_QUEUE_SIZE, (void*)&size, sizeof(uint32_t));
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    // @- set size of the receive queue to zero (w/o receive queue)
+    size = 0U;
+    retVal = dut1.SetProperty(PEAKCAN_PROPERTY_SET_RCV_QUEUE_SIZE, (void*)&size, sizeof(uint32_t));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = dut1.GetProperty(PEAKCAN_PROPERTY_RCV_QUEUE_SIZE, (void*)&size, sizeof(uint32_t));
+    EXPECT_EQ(CCanApi::NotSupported, retVal);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC35.2: Receive more CAN messages than the receive queue (wrapper ring) can hold
+//
+// @expected: CANERR_NOERROR, high-water mark equals the size and overflow counter the messages dropped
+//
+TEST_F(ReceiveQueue, GTEST_TESTCASE(HighWaterMarkAndOverflowCounter, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Status_t status = {};
+    CANAPI_Return_t retVal;
+    uint32_t size = TC35_RING_SIZE;
+    uint32_t high = 0U;
+    uint64_t ovfl = 0U;
+    // CAN message
+    trmMsg.id = 0x350U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+#endif
+    trmMsg.dlc = 1U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- set size of the receive queue of DUT1 to 16 messages
+    retVal = dut1.SetProperty(PEAKCAN_PROPERTY_SET_RCV_QUEUE_SIZE, (void*)&size, sizeof(uint32_t));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @- check high-water mark and overflow counter to be zero
+    retVal = dut1.GetProperty(PEAKCAN_PROPERTY_RCV_QUEUE_HIGH, (void*)&high, sizeof(uint32_t));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0U, high);
+    retVal = dut1.GetProperty(PEAKCAN_PROPERTY_RCV_QUEUE_OVFL, (void*)&ovfl, sizeof(uint64_t));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0U, ovfl);
+    // @test:
+    // @- DUT2 send 40 messages to DUT1 (DUT1 does not read)
+    for (uint32_t i = 0U; i < TC35_FRAMES; i++) {
+        trmMsg.data[0] = (uint8_t)i;
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- wait until all messages have been received
+    CTimer::Delay(TEST_READ_TIMEOUT * CTimer::MSEC);
+    // @- check high-water mark to be the size of the receive queue
+    retVal = dut1.GetProperty(PEAKCAN_PROPERTY_RCV_QUEUE_HIGH, (void*)&high, sizeof(uint32_t));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(TC35_RING_SIZE, high);
+    // @- check overflow counter to be the number of messages dropped
+    retVal = dut1.GetProperty(PEAKCAN_PROPERTY_RCV_QUEUE_OVFL, (void*)&ovfl, sizeof(uint64_t));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ((uint64_t)(TC35_FRAMES - TC35_RING_SIZE), ovfl);
+    // @- check receive counter of DUT1 (updated by the reader thread, incl. the messages dropped)
+    EXPECT_EQ((uint64_t)TC35_FRAMES, dut1.GetRxCounter());
+    // @- check queue overrun flag of DUT1 to be set
+    retVal = dut1.GetStatus(status);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_TRUE(status.queue_overrun);
+    // @- DUT1 read the messages from the receive queue (the first 16)
+    for (uint32_t i = 0U; i < TC35_RING_SIZE; i++) {
+        retVal = dut1.ReadMessage(rcvMsg, 0U);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        EXPECT_EQ((uint8_t)i, rcvMsg.data[0]);
+    }
+    retVal = dut1.ReadMessage(rcvMsg, 0U);
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    // @- restart DUT1 and check high-water mark and overflow counter to be cleared
+    retVal = dut1.ResetController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = dut1.GetProperty(PEAKCAN_PROPERTY_RCV_QUEUE_HIGH, (void*)&high, sizeof(uint32_t));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0U, high);
+    retVal = dut1.GetProperty(PEAKCAN_PROPERTY_RCV_QUEUE_OVFL, (void*)&ovfl, sizeof(uint64_t));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0U, ovfl);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
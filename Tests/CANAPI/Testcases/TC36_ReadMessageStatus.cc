@@ -0,0 +1,282 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#define TC36_RING_SIZE  16U
+#define TC36_FRAMES  40U
+#define TC36_BATCH_SIZE  256
+
+class ReadMessageStatus : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    // ...
+};
+
+// @gtest TC36.1: Read a CAN message and the status register if CAN controller is not started
+//
+// @expected: CANERR_OFFLINE
+//
+TEST_F(ReadMessageStatus, GTEST_TESTCASE(IfControllerNotStarted, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Status_t status = {};
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- read a message and the status register (in INIT state)
+    retVal = dut1.ReadMessage(rcvMsg, status, 0U);
+    EXPECT_EQ(CCanApi::ControllerOffline, retVal);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC36.2: Read a CAN message and the status register when a message has been received
+//
+// @expected: CANERR_NOERROR, the message and the status register (running, receiver not empty)
+//
+TEST_F(ReadMessageStatus, GTEST_TESTCASE(WithMessageReceived, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Status_t status = {};
+    CANAPI_Status_t latched = {};
+    CANAPI_Return_t retVal;
+    // CAN message
+    trmMsg.id = 0x360U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+#endif
+    trmMsg.dlc = 1U;
+    trmMsg.data[0] = 0x36U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 send a message to DUT1
+    retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT1 read the message and the status register
+    retVal = dut1.ReadMessage(rcvMsg, status, TEST_READ_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(trmMsg.id, rcvMsg.id);
+    EXPECT_EQ(trmMsg.dlc, rcvMsg.dlc);
+    EXPECT_EQ(trmMsg.data[0], rcvMsg.data[0]);
+    // @- check the status register (running, not empty, no overrun)
+    EXPECT_FALSE(status.can_stopped);
+    EXPECT_FALSE(status.bus_off);
+    EXPECT_FALSE(status.receiver_empty);
+    EXPECT_FALSE(status.queue_overrun);
+    EXPECT_FALSE(status.message_lost);
+    // @- DUT1 try to read another message and the status register
+    retVal = dut1.ReadMessage(rcvMsg, status, 0U);
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    // @- check the status register (running, receiver empty)
+    EXPECT_FALSE(status.can_stopped);
+    EXPECT_TRUE(status.receiver_empty);
+    // @- check the status register to be the same as of GetStatus()
+    retVal = dut1.GetStatus(latched);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(latched.byte, status.byte);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC36.3: Read a CAN message and the status register after the receive queue has overrun
+//
+// @expected: CANERR_NOERROR and the queue overrun flag set
+//
+TEST_F(ReadMessageStatus, GTEST_TESTCASE(WithQueueOverrun, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Status_t status = {};
+    CANAPI_Return_t retVal;
+    uint32_t size = TC36_RING_SIZE;
+    // CAN message
+    trmMsg.id = 0x361U;
+    trmMsg.xtd = 0;
+    trmMsg.rtr = 0;
+    trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+    trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+    trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+    trmMsg.esi = 0;
+#endif
+    trmMsg.dlc = 0U;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- set size of the receive queue of DUT1 to 16 messages
+    retVal = dut1.SetProperty(PEAKCAN_PROPERTY_SET_RCV_QUEUE_SIZE, (void*)&size, sizeof(uint32_t));
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 send 40 messages to DUT1 (DUT1 does not read)
+    for (uint32_t i = 0U; i < TC36_FRAMES; i++) {
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- wait until all messages have been received
+    CTimer::Delay(TEST_READ_TIMEOUT * CTimer::MSEC);
+    // @- DUT1 read a message and the status register
+    retVal = dut1.ReadMessage(rcvMsg, status, 0U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(trmMsg.id, rcvMsg.id);
+    // @- check the queue overrun flag to be set
+    EXPECT_TRUE(status.queue_overrun);
+    EXPECT_FALSE(status.can_stopped);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC36.4: Read a CAN message and the status register after the transmit queue was full
+//
+// @expected: CANERR_RX_EMPTY and the transmitter busy flag set
+//
+TEST_F(ReadMessageStatus, GTEST_TESTCASE(WithTransmitterBusy, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Message_t batch[TC36_BATCH_SIZE] = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Status_t status = {};
+    CANAPI_Return_t retVal;
+    size_t sent = 0U;
+    // CAN messages
+    for (int i = 0; i < TC36_BATCH_SIZE; i++) {
+        batch[i].id = 0x362U;
+        batch[i].xtd = 0;
+        batch[i].rtr = 0;
+        batch[i].sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        batch[i].fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        batch[i].brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        batch[i].esi = 0;
+#endif
+        batch[i].dlc = 0U;
+    }
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- fill the transmit queue of DUT1 (w/o acknowledge, nothing is sent)
+    retVal = dut1.WriteMessages(batch, TC36_BATCH_SIZE, sent, 0U);
+    if (retVal == CCanApi::NoError) {
+        // @- note: the transmit queue can hold all messages -> skip the test
+        (void)dut1.TeardownChannel();
+        GTEST_SKIP() << "The transmit queue can hold " << TC36_BATCH_SIZE << " messages!";
+    }
+    EXPECT_EQ(CCanApi::TransmitterBusy, retVal);
+    // @test:
+    // @- DUT1 try to read a message and the status register
+    retVal = dut1.ReadMessage(rcvMsg, status, 0U);
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    // @- check the transmitter busy flag to be set (latched)
+    EXPECT_TRUE(status.transmitter_busy);
+    EXPECT_TRUE(status.receiver_empty);
+    EXPECT_FALSE(status.can_stopped);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
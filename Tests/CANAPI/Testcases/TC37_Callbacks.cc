@@ -0,0 +1,360 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#include <atomic>
+
+#define TC37_FRAMES  32U
+#define TC37_BATCH_SIZE  8U
+#define TC37_TIMEOUT  1000U  // [ms]
+
+class Callbacks : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    // wait until the counter has reached the expected value (or time-out)
+    bool WaitFor(const std::atomic<uint32_t> &counter, uint32_t expected, uint32_t timeout = TC37_TIMEOUT) {
+        for (uint32_t i = 0U; (i < timeout) && (counter.load() < expected); i++)
+            CTimer::Delay(CTimer::MSEC);
+        return (counter.load() >= expected) ? true : false;
+    }
+    void Message(CANAPI_Message_t &message, uint32_t id) {
+        message.id = id;
+        message.xtd = 0;
+        message.rtr = 0;
+        message.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        message.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        message.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        message.esi = 0;
+#endif
+        message.dlc = 1U;
+        message.data[0] = 0x37U;
+    }
+};
+
+// @gtest TC37.1: Receive CAN messages by a receive callback
+//
+// @expected: CANERR_NOERROR, each message is delivered once and in order
+//
+TEST_F(Callbacks, GTEST_TESTCASE(ReceiveCallback, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    std::atomic<uint32_t> received(0U);
+    std::atomic<uint32_t> disorder(0U);
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- set a receive callback of DUT1 (counts the messages and checks the order)
+    retVal = dut1.SetReceiveCallback([&](const CANAPI_Message_t &message, uint8_t status) {
+        (void)status;
+        if (message.id != (0x370U + received.load()))
+            disorder++;
+        received++;
+    });
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 send 32 messages to DUT1
+    for (uint32_t i = 0U; i < TC37_FRAMES; i++) {
+        Message(trmMsg, 0x370U + i);
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- wait until the callback of DUT1 has got all of them
+    EXPECT_TRUE(WaitFor(received, TC37_FRAMES));
+    EXPECT_EQ(TC37_FRAMES, received.load());
+    EXPECT_EQ(0U, disorder.load());
+    // @- check the receive counter of DUT1
+    EXPECT_EQ((uint64_t)TC37_FRAMES, dut1.GetRxCounter());
+    // @post:
+    // @- tear down DUT1 (stops the dispatch thread)
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC37.2: Receive CAN messages by a batch callback
+//
+// @expected: CANERR_NOERROR, all messages are delivered in batches of at most 'max' messages
+//
+TEST_F(Callbacks, GTEST_TESTCASE(BatchCallback, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    std::atomic<uint32_t> received(0U);
+    std::atomic<uint32_t> oversized(0U);
+    std::atomic<uint32_t> disorder(0U);
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- set a batch callback of DUT1 with up to 8 messages at once
+    retVal = dut1.SetBatchCallback([&](const CANAPI_Message_t *messages, size_t count) {
+        if ((count == 0U) || (count > TC37_BATCH_SIZE))
+            oversized++;
+        for (size_t i = 0U; i < count; i++) {
+            if (messages[i].id != (0x370U + received.load()))
+                disorder++;
+            received++;
+        }
+    }, TC37_BATCH_SIZE);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 send 32 messages to DUT1
+    for (uint32_t i = 0U; i < TC37_FRAMES; i++) {
+        Message(trmMsg, 0x370U + i);
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- wait until the callback of DUT1 has got all of them
+    EXPECT_TRUE(WaitFor(received, TC37_FRAMES));
+    EXPECT_EQ(TC37_FRAMES, received.load());
+    EXPECT_EQ(0U, disorder.load());
+    // @- check that no batch was empty or exceeded 8 messages
+    EXPECT_EQ(0U, oversized.load());
+    // @post:
+    // @- tear down DUT1 (stops the dispatch thread)
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC37.3: Get status changes by a status callback only while the messages are read by the application
+//
+// @expected: CANERR_NOERROR, no message is consumed by the dispatch thread and the warning level is notified
+//
+TEST_F(Callbacks, GTEST_TESTCASE(StatusCallbackOnly, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    std::atomic<uint32_t> notified(0U);
+    std::atomic<uint32_t> warnings(0U);
+    CANAPI_Return_t retVal;
+    uint32_t i;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- set a status callback of DUT1 (and no receive or batch callback)
+    retVal = dut1.SetStatusCallback([&](CANAPI_Status_t status, uint8_t changed) {
+        if (changed & CANSTAT_EWRN) {
+            if (status.warning_level)
+                warnings++;
+        }
+        notified++;
+    });
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @sub(1): the messages are left to the application
+    // @- DUT2 send 32 messages to DUT1
+    for (i = 0U; i < TC37_FRAMES; i++) {
+        Message(trmMsg, 0x370U + i);
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- give the dispatch thread of DUT1 the chance to steal them
+    CTimer::Delay(100U * CTimer::MSEC);
+    // @- DUT1 read all 32 messages by ReadMessage()
+    for (i = 0U; i < TC37_FRAMES; i++) {
+        retVal = dut1.ReadMessage(rcvMsg, TEST_READ_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        if (CCanApi::NoError != retVal)
+            break;
+        EXPECT_EQ(0x370U + i, rcvMsg.id);
+    }
+    EXPECT_EQ(TC37_FRAMES, i);
+    // @- DUT1 try to read another message
+    retVal = dut1.ReadMessage(rcvMsg, 0U);
+    EXPECT_EQ(CCanApi::ReceiverEmpty, retVal);
+    // @- no status change notified so far
+    EXPECT_EQ(0U, warnings.load());
+    // @sub(2): the warning level is notified
+    // @- tear down DUT2 (no one acknowledges the messages of DUT1)
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT1 send a message (repeated until error passive)
+    Message(trmMsg, 0x37FU);
+    retVal = dut1.WriteMessage(trmMsg, 0U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- wait until the callback of DUT1 has got the warning level
+    EXPECT_TRUE(WaitFor(warnings, 1U));
+    EXPECT_LE(1U, notified.load());
+    // @post:
+    // @- tear down DUT1 (stops the dispatch thread)
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC37.4: Tear down the CAN interface from inside a receive callback
+//
+// @expected: CANERR_NOERROR, no further callback after the teardown and the dispatch restarts with the next initialization
+//
+TEST_F(Callbacks, GTEST_TESTCASE(TeardownFromCallback, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    std::atomic<uint32_t> received(0U);
+    std::atomic<uint32_t> teardown(0U);
+    std::atomic<int> result(CCanApi::FatalError);
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- set a receive callback of DUT1 (tears down DUT1 with the first message)
+    retVal = dut1.SetReceiveCallback([&](const CANAPI_Message_t &message, uint8_t status) {
+        (void)message;
+        (void)status;
+        received++;
+        if (teardown.fetch_add(1U) == 0U)
+            result = dut1.TeardownChannel();
+    });
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @sub(1): teardown from inside the callback
+    // @- DUT2 send a message to DUT1
+    Message(trmMsg, 0x370U);
+    retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- wait until the callback of DUT1 has torn down DUT1
+    EXPECT_TRUE(WaitFor(teardown, 1U));
+    CTimer::Delay(10U * CTimer::MSEC);
+    EXPECT_EQ(CCanApi::NoError, result.load());
+    // @- DUT2 send another message (no one receives it)
+    Message(trmMsg, 0x371U);
+    retVal = dut2.WriteMessage(trmMsg, 0U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    CTimer::Delay(100U * CTimer::MSEC);
+    EXPECT_EQ(1U, received.load());
+    // @- DUT1 is torn down already
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::InvalidHandle, retVal);
+    // @sub(2): the dispatch restarts with the next initialization
+    // @- initialize DUT1 with configured settings again (joins the stopped thread)
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    PCBUSB_INIT_DELAY();
+    // @- DUT2 send a message to DUT1
+    Message(trmMsg, 0x372U);
+    retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- wait until the callback of DUT1 has got it (without a further teardown)
+    EXPECT_TRUE(WaitFor(received, 2U));
+    EXPECT_EQ(2U, received.load());
+    // @post:
+    // @- tear down DUT1 (stops the dispatch thread)
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
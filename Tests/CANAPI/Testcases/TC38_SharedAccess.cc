@@ -0,0 +1,511 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#ifndef FEATURE_FILTERING
+#define FEATURE_FILTERING  FEATURE_UNSUPPORTED
+#ifdef _MSC_VER
+#pragma message ( "FEATURE_FILTERING not set, default = FEATURE_UNSUPPORTED" )
+#else
+#warning FEATURE_FILTERING not set, default = FEATURE_UNSUPPORTED
+#endif
+#endif
+#define TC38_FRAMES  32U
+
+//  @note: a shared handle is opened with the configured settings of DUT1 and CANMODE_SHRD
+#define SHARED_DEVICE(dut, mode)  g_Options.GetLibraryId(dut), g_Options.GetChannelNo(dut), mode, g_Options.GetBitrate(dut), g_Options.GetParameter(dut)
+
+class SharedAccess : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    CANAPI_OpMode_t SharedMode(int dut) {
+        CANAPI_OpMode_t opMode = g_Options.GetOpMode(dut);
+        opMode.byte |= CANMODE_SHRD;
+        return opMode;
+    }
+    void Message(CANAPI_Message_t &message, uint32_t id) {
+        message.id = id;
+        message.xtd = 0;
+        message.rtr = 0;
+        message.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        message.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        message.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        message.esi = 0;
+#endif
+        message.dlc = 1U;
+        message.data[0] = (uint8_t)id;
+    }
+    // read all messages from a device within the time-out (and check their order)
+    uint32_t ReadAll(CCanDevice &dut, uint32_t first, uint32_t expected) {
+        CANAPI_Message_t rcvMsg = {};
+        uint32_t n = 0U;
+        while (n < expected) {
+            if (dut.ReadMessage(rcvMsg, TEST_READ_TIMEOUT) != CCanApi::NoError)
+                break;
+            EXPECT_EQ(first + n, rcvMsg.id);
+            n++;
+        }
+        // note: no more than expected
+        if (dut.ReadMessage(rcvMsg, 0U) == CCanApi::NoError)
+            n++;
+        return n;
+    }
+};
+
+// @gtest TC38.1: Get operation capability of the CAN interface
+//
+// @expected: CANERR_NOERROR and shared access reported
+//
+TEST_F(SharedAccess, GTEST_TESTCASE(CapabilityReported, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_OpMode_t opCapa = {};
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- get operation capability of DUT1
+    retVal = dut1.GetOpCapabilities(opCapa);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- check that shared access is supported
+    EXPECT_EQ(CANMODE_SHRD, opCapa.byte & CANMODE_SHRD);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC38.2: Initialize a CAN channel in use w/ and w/o shared access
+//
+// @expected: CANERR_YETINIT if one of the handles is not shared, otherwise CANERR_NOERROR
+//
+TEST_F(SharedAccess, GTEST_TESTCASE(ExclusiveAccessRejected, GTEST_ENABLED)) {
+    CCanDevice shr1 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice shr2 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Return_t retVal;
+    // @test:
+    // @sub(1): exclusive first, then shared
+    // @- initialize DUT1 exclusively
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- initialize the channel of DUT1 shared
+    retVal = shr1.InitializeChannel();
+    EXPECT_EQ(CCanApi::AlreadyInitialized, retVal);
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @sub(2): shared first, then exclusive
+    // @- initialize the channel of DUT1 shared (twice)
+    retVal = shr1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr1.InitializeChannel() failed with error code " << retVal;
+    retVal = shr2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr2.InitializeChannel() failed with error code " << retVal;
+    // @- initialize DUT1 exclusively
+    retVal = dut1.InitializeChannel();
+    EXPECT_EQ(CCanApi::AlreadyInitialized, retVal);
+    // @post:
+    // @- tear down both shared handles
+    retVal = shr1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC38.3: Receive CAN messages by two shared handles of one CAN channel
+//
+// @expected: CANERR_NOERROR, each handle receives all messages
+//
+TEST_F(SharedAccess, GTEST_TESTCASE(BothHandlesReceive, GTEST_ENABLED)) {
+    CCanDevice shr1 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice shr2 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize and start two shared handles of DUT1
+    retVal = shr1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr1.InitializeChannel() failed with error code " << retVal;
+    retVal = shr1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr2.InitializeChannel() failed with error code " << retVal;
+    retVal = shr2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 send 32 messages to DUT1
+    for (uint32_t i = 0U; i < TC38_FRAMES; i++) {
+        Message(trmMsg, 0x380U + i);
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- both shared handles read all 32 messages (in order)
+    EXPECT_EQ(TC38_FRAMES, ReadAll(shr1, 0x380U, TC38_FRAMES));
+    EXPECT_EQ(TC38_FRAMES, ReadAll(shr2, 0x380U, TC38_FRAMES));
+    // @- check the receive counters of both
+    EXPECT_EQ((uint64_t)TC38_FRAMES, shr1.GetRxCounter());
+    EXPECT_EQ((uint64_t)TC38_FRAMES, shr2.GetRxCounter());
+    // @post:
+    // @- tear down both shared handles
+    retVal = shr1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+#if (FEATURE_FILTERING != FEATURE_UNSUPPORTED)
+// @gtest TC38.4: Receive CAN messages by two shared handles with different acceptance filters
+//
+// @expected: CANERR_NOERROR, each handle receives the messages accepted by its own filter
+//
+TEST_F(SharedAccess, GTEST_TESTCASE(FilterPerHandle, GTEST_ENABLED)) {
+    CCanDevice shr1 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice shr2 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize two shared handles of DUT1
+    retVal = shr1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr1.InitializeChannel() failed with error code " << retVal;
+    retVal = shr2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr2.InitializeChannel() failed with error code " << retVal;
+    // @- set 11-bit filter of the first handle: 0x380..0x387
+    retVal = shr1.SetFilter11Bit(0x380U, 0x7F8U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- set 11-bit filter of the second handle: 0x388..0x38F
+    retVal = shr2.SetFilter11Bit(0x388U, 0x7F8U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start both shared handles
+    retVal = shr1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- DUT2 send 16 messages (0x380..0x38F) to DUT1
+    for (uint32_t i = 0U; i < 16U; i++) {
+        Message(trmMsg, 0x380U + i);
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- the first handle reads 0x380..0x387 only
+    EXPECT_EQ(8U, ReadAll(shr1, 0x380U, 8U));
+    // @- the second handle reads 0x388..0x38F only
+    EXPECT_EQ(8U, ReadAll(shr2, 0x388U, 8U));
+    // @post:
+    // @- tear down both shared handles
+    retVal = shr1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+#endif // FEATURE_FILTERING != FEATURE_UNSUPPORTED
+
+// @gtest TC38.5: Send CAN messages by two shared handles of one CAN channel
+//
+// @expected: CANERR_NOERROR, the messages of both handles are on the bus (in order per handle)
+//
+TEST_F(SharedAccess, GTEST_TESTCASE(MergedWrites, GTEST_ENABLED)) {
+    CCanDevice shr1 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice shr2 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Return_t retVal;
+    uint32_t next[2] = { 0x380U, 0x3C0U };
+    uint32_t i;
+    // @pre:
+    // @- initialize and start two shared handles of DUT1
+    retVal = shr1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr1.InitializeChannel() failed with error code " << retVal;
+    retVal = shr1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr2.InitializeChannel() failed with error code " << retVal;
+    retVal = shr2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @- both shared handles send 16 messages each (alternately)
+    for (i = 0U; i < (TC38_FRAMES / 2U); i++) {
+        Message(trmMsg, 0x380U + i);
+        retVal = shr1.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        Message(trmMsg, 0x3C0U + i);
+        retVal = shr2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- DUT2 read all 32 messages (in order per handle)
+    for (i = 0U; i < TC38_FRAMES; i++) {
+        retVal = dut2.ReadMessage(rcvMsg, TEST_READ_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        if (CCanApi::NoError != retVal)
+            break;
+        if (rcvMsg.id < 0x3C0U)
+            EXPECT_EQ(next[0]++, rcvMsg.id);
+        else
+            EXPECT_EQ(next[1]++, rcvMsg.id);
+    }
+    EXPECT_EQ(TC38_FRAMES, i);
+    EXPECT_EQ(0x380U + (TC38_FRAMES / 2U), next[0]);
+    EXPECT_EQ(0x3C0U + (TC38_FRAMES / 2U), next[1]);
+    // @- check the transmit counters of both
+    EXPECT_EQ((uint64_t)(TC38_FRAMES / 2U), shr1.GetTxCounter());
+    EXPECT_EQ((uint64_t)(TC38_FRAMES / 2U), shr2.GetTxCounter());
+    // @post:
+    // @- tear down both shared handles
+    retVal = shr1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC38.6: Start a shared handle with a bit-rate other than the running one
+//
+// @expected: CANERR_BAUDRATE
+//
+TEST_F(SharedAccess, GTEST_TESTCASE(MismatchedBitrate, GTEST_ENABLED)) {
+    CCanDevice shr1 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice shr2 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CANAPI_Bitrate_t bitrate = g_Options.GetBitrate(DUT1);
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize and start the first shared handle of DUT1
+    retVal = shr1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr1.InitializeChannel() failed with error code " << retVal;
+    retVal = shr1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize the second shared handle of DUT1
+    retVal = shr2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr2.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- start the second handle with another bit-rate
+    if (bitrate.index <= 0)
+        bitrate.index = (bitrate.index != CANBTR_INDEX_125K) ? CANBTR_INDEX_125K : CANBTR_INDEX_250K;
+    else
+        bitrate.btr.nominal.brp = (bitrate.btr.nominal.brp != 2U) ? 2U : 4U;
+    retVal = shr2.StartController(bitrate);
+    EXPECT_EQ(CCanApi::InvalidBaudrate, retVal);
+    // @- start the second handle with the same bit-rate
+    retVal = shr2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @post:
+    // @- tear down both shared handles
+    retVal = shr1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC38.7: Initialize a shared handle with an operation mode other than the first one
+//
+// @expected: CANERR_ILLPARA
+//
+TEST_F(SharedAccess, GTEST_TESTCASE(MismatchedMode, GTEST_ENABLED)) {
+    CANAPI_OpMode_t opMode = SharedMode(DUT1);
+    CCanDevice shr1 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize the first shared handle of DUT1
+    retVal = shr1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- initialize a second shared handle with monitor mode toggled
+    opMode.byte ^= CANMODE_MON;
+    CCanDevice shr2 = CCanDevice(SHARED_DEVICE(DUT1, opMode));
+    retVal = shr2.InitializeChannel();
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    if (CCanApi::NoError == retVal)
+        (void)shr2.TeardownChannel();
+    // @post:
+    // @- tear down the first shared handle
+    retVal = shr1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC38.8: Close the first shared handle of a CAN channel while others stay open
+//
+// @expected: CANERR_NOERROR, the other handles keep on running and the channel can be shared further
+//
+TEST_F(SharedAccess, GTEST_TESTCASE(CloseFirstOpener, GTEST_ENABLED)) {
+    CCanDevice shr1 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice shr2 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice shr3 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice shr4 = CCanDevice(SHARED_DEVICE(DUT1, SharedMode(DUT1)));
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_OpMode_t opMode = SharedMode(DUT1);
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Return_t retVal;
+    uint32_t i;
+    // @pre:
+    // @- initialize and start three shared handles of DUT1
+    retVal = shr1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr1.InitializeChannel() failed with error code " << retVal;
+    retVal = shr1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr2.InitializeChannel() failed with error code " << retVal;
+    retVal = shr2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr3.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr3.InitializeChannel() failed with error code " << retVal;
+    retVal = shr3.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @test:
+    // @sub(1): close the first opener
+    // @- tear down the first shared handle
+    retVal = shr1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send 32 messages to DUT1
+    for (i = 0U; i < TC38_FRAMES; i++) {
+        Message(trmMsg, 0x380U + i);
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- the other two handles read all 32 messages
+    EXPECT_EQ(TC38_FRAMES, ReadAll(shr2, 0x380U, TC38_FRAMES));
+    EXPECT_EQ(TC38_FRAMES, ReadAll(shr3, 0x380U, TC38_FRAMES));
+    // @sub(2): the channel is still shared (by one of the remaining handles)
+    // @- initialize DUT1 exclusively
+    retVal = dut1.InitializeChannel();
+    EXPECT_EQ(CCanApi::AlreadyInitialized, retVal);
+    // @- initialize a shared handle with monitor mode toggled
+    opMode.byte ^= CANMODE_MON;
+    CCanDevice shr5 = CCanDevice(SHARED_DEVICE(DUT1, opMode));
+    retVal = shr5.InitializeChannel();
+    EXPECT_EQ(CCanApi::IllegalParameter, retVal);
+    // @- initialize and start a fourth shared handle
+    retVal = shr4.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] shr4.InitializeChannel() failed with error code " << retVal;
+    retVal = shr4.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send 32 messages to DUT1
+    for (i = 0U; i < TC38_FRAMES; i++) {
+        Message(trmMsg, 0x3A0U + i);
+        retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+    // @- all three handles read all 32 messages
+    EXPECT_EQ(TC38_FRAMES, ReadAll(shr2, 0x3A0U, TC38_FRAMES));
+    EXPECT_EQ(TC38_FRAMES, ReadAll(shr3, 0x3A0U, TC38_FRAMES));
+    EXPECT_EQ(TC38_FRAMES, ReadAll(shr4, 0x3A0U, TC38_FRAMES));
+    // @sub(3): the channel is free after the last handle is closed
+    // @- tear down the remaining shared handles
+    retVal = shr2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr3.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = shr4.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT1 exclusively
+    retVal = dut1.InitializeChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
@@ -0,0 +1,184 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+#if (OPTION_PCAN_VIRTUAL_BUS != OPTION_DISABLED) && defined(__linux__)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TC39_FRAMES  32U
+#define TC39_ATTACH_TIMEOUT  2000U  // [ms]
+#define TC39_PEER_TIMEOUT  5000U  // [ms]
+
+//  @note: a virtual CAN bus is attached once per process (and channel), so the
+//  @      second attachment of PCAN_VIRTUAL1 is made by a child process of the test
+#define VIRTUAL_DEVICE(dut)  g_Options.GetLibraryId(dut), PCAN_VIRTUAL1, g_Options.GetOpMode(dut), g_Options.GetBitrate(dut), NULL
+
+class VirtualBus : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    void Message(CANAPI_Message_t &message, uint32_t id) {
+        message.id = id;
+        message.xtd = 0;
+        message.rtr = 0;
+        message.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        message.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        message.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        message.esi = 0;
+#endif
+        message.dlc = 1U;
+        message.data[0] = (uint8_t)id;
+    }
+    // the peer: waits for a request, replies and sends 32 messages (exit code 0 on success)
+    int Peer() {
+        CCanDevice peer = CCanDevice(VIRTUAL_DEVICE(DUT1));
+        CANAPI_Message_t trmMsg = {};
+        CANAPI_Message_t rcvMsg = {};
+        uint32_t i;
+        if (peer.InitializeChannel() != CCanApi::NoError)
+            return 1;
+        if (peer.StartController() != CCanApi::NoError)
+            return 2;
+        for (i = 0U; i < TC39_PEER_TIMEOUT; i += 10U) {
+            if ((peer.ReadMessage(rcvMsg, 10U) == CCanApi::NoError) && (rcvMsg.id == 0x390U))
+                break;
+        }
+        if (i >= TC39_PEER_TIMEOUT)
+            return 3;
+        Message(trmMsg, 0x391U);
+        if (peer.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT) != CCanApi::NoError)
+            return 4;
+        for (i = 0U; i < TC39_FRAMES; i++) {
+            Message(trmMsg, 0x3A0U + i);
+            if (peer.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT) != CCanApi::NoError)
+                return 5;
+        }
+        // note: wait for the acknowledge of the test, then detach
+        for (i = 0U; i < TC39_PEER_TIMEOUT; i += 10U) {
+            if ((peer.ReadMessage(rcvMsg, 10U) == CCanApi::NoError) && (rcvMsg.id == 0x392U))
+                break;
+        }
+        (void)peer.TeardownChannel();
+        return (i < TC39_PEER_TIMEOUT) ? 0 : 6;
+    }
+};
+
+// @gtest TC39.1: Exchange CAN messages over a virtual CAN bus between two attachments of PCAN_VIRTUAL1
+//
+// @expected: CANERR_NOERROR, the messages of the other attachment are received in order
+//
+TEST_F(VirtualBus, GTEST_TESTCASE(TwoAttachments, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(VIRTUAL_DEVICE(DUT1));
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    CANAPI_Return_t retVal;
+    bool replied = false;
+    uint32_t i;
+    pid_t pid;
+    int status = -1;
+    // @pre:
+    // @- attach a peer to PCAN_VIRTUAL1 (in a child process)
+    fflush(NULL);
+    pid = fork();
+    ASSERT_NE(-1, pid) << "[  ERROR!  ] fork() failed";
+    if (pid == 0)
+        _exit(Peer());
+    // @- initialize PCAN_VIRTUAL1 with configured settings of DUT1
+    retVal = dut1.InitializeChannel();
+    if (CCanApi::NoError != retVal) {
+        (void)kill(pid, SIGKILL);
+        (void)waitpid(pid, NULL, 0);
+    }
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- start PCAN_VIRTUAL1 with configured bit-rate settings of DUT1
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @test:
+    // @- send a request until the peer has replied (it is attached then)
+    Message(trmMsg, 0x390U);
+    for (i = 0U; (i < TC39_ATTACH_TIMEOUT) && !replied; i += 10U) {
+        retVal = dut1.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        while (!replied && (dut1.ReadMessage(rcvMsg, 10U) == CCanApi::NoError))
+            replied = (rcvMsg.id == 0x391U);
+    }
+    EXPECT_TRUE(replied);
+    // @- read the 32 messages of the peer (in order)
+    for (i = 0U; replied && (i < TC39_FRAMES); i++) {
+        retVal = dut1.ReadMessage(rcvMsg, TC39_PEER_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        if (CCanApi::NoError != retVal)
+            break;
+        EXPECT_EQ(0x3A0U + i, rcvMsg.id);
+        EXPECT_EQ(1U, rcvMsg.dlc);
+        EXPECT_EQ((uint8_t)(0x3A0U + i), rcvMsg.data[0]);
+    }
+    EXPECT_EQ(TC39_FRAMES, i);
+    // @- acknowledge the messages to the peer
+    Message(trmMsg, 0x392U);
+    retVal = dut1.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- the peer has terminated successfully
+    EXPECT_EQ(pid, waitpid(pid, &status, 0));
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+    // @post:
+    // @- tear down PCAN_VIRTUAL1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+#endif // OPTION_PCAN_VIRTUAL_BUS != OPTION_DISABLED
+
+//  $Id$  Copyright (c) UV Software, Berlin.
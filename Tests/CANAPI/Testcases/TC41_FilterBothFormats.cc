@@ -0,0 +1,381 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+//  @note: This test suite tests the following methods:
+//  @      - CPeakCAN::SetFilter11Bit() with CPeakCAN::SetFilter29Bit()  [TC41.*]
+//  @      - CPeakCAN::GetFilter11Bit() with CPeakCAN::GetFilter29Bit()  [TC41.*]
+//  @
+//  @note: The hardware filter is read back from the PCANBasic simulation.
+//  @
+#ifndef FEATURE_FILTERING
+#define FEATURE_FILTERING  FEATURE_UNSUPPORTED
+#ifdef _MSC_VER
+#pragma message ( "FEATURE_FILTERING not set, default = FEATURE_UNSUPPORTED" )
+#else
+#warning FEATURE_FILTERING not set, default = FEATURE_UNSUPPORTED
+#endif
+#endif
+#if (FEATURE_FILTERING != FEATURE_UNSUPPORTED)
+#if (OPTION_PCAN_SIMULATION != 0)
+#include "PCANBasic.h"
+#endif
+
+#define COUNT(array)  (sizeof(array) / sizeof(array[0]))
+
+#define STD_CODE  0x120U
+#define STD_MASK  0x7F0U
+#define XTD_CODE  0x1234500U
+#define XTD_MASK  0x1FFFFF00U
+
+typedef struct {
+    uint32_t id;
+    uint8_t xtd;
+} Identifier_t;
+
+class FilterBothFormats : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    void CheckReceived(CCanDevice& dut1, const Identifier_t trmIds[], size_t trmCount, const Identifier_t rcvIds[], size_t rcvCount) {
+        CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+        CANAPI_Message_t trmMsg = {};
+        CANAPI_Message_t rcvMsg = {};
+        CANAPI_Return_t retVal;
+        // CAN message
+        trmMsg.id = 0U;
+        trmMsg.xtd = 0;
+        trmMsg.rtr = 0;
+        trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        trmMsg.esi = 0;
+#endif
+        trmMsg.dlc = 0U;
+        // initialize DUT2 with configured settings
+        retVal = dut2.InitializeChannel();
+        ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+        // start DUT2 with configured bit-rate settings
+        retVal = dut2.StartController();
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        // issue(PeakCAN): why do we need a delay here?
+        PCBUSB_INIT_DELAY();
+        // DUT2 send the standard and extended messages
+        for (size_t i = 0; i < trmCount; i++) {
+            trmMsg.id = trmIds[i].id;
+            trmMsg.xtd = trmIds[i].xtd;
+            retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+            EXPECT_EQ(CCanApi::NoError, retVal);
+        }
+        // DUT1 read the accepted messages (in order)
+        size_t j = 0;
+        while (j < rcvCount) {
+            retVal = dut1.ReadMessage(rcvMsg, TEST_READ_TIMEOUT);
+            if (retVal != CCanApi::NoError) {
+                EXPECT_EQ(CCanApi::NoError, retVal);
+                break;
+            }
+            // ignore status messages/error frames
+            if (!rcvMsg.sts) {
+                EXPECT_EQ(rcvIds[j].id, rcvMsg.id);
+                EXPECT_EQ(rcvIds[j].xtd, rcvMsg.xtd);
+                j++;
+            }
+        }
+        // DUT1 try to read another message (the others must be filtered)
+        do {
+            retVal = dut1.ReadMessage(rcvMsg, 100U);
+        } while ((retVal == CCanApi::NoError) && rcvMsg.sts);
+        EXPECT_EQ(CCanApi::ReceiverEmpty, retVal) << "[  ERROR!  ] unexpected message 0x" << std::hex << rcvMsg.id << std::dec;
+        // tear down DUT2
+        retVal = dut2.TeardownChannel();
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+#if (OPTION_PCAN_SIMULATION != 0)
+    // note: code in the upper, mask in the lower 32 bits (mask bits set are don't care)
+    uint64_t HardwareFilter(bool xtd) {
+        UINT64 value = 0U;
+        TPCANStatus sts = CAN_GetValue((TPCANHandle)g_Options.GetChannelNo(DUT1),
+                                       xtd ? PCAN_ACCEPTANCE_FILTER_29BIT : PCAN_ACCEPTANCE_FILTER_11BIT,
+                                       (void*)&value, sizeof(value));
+        EXPECT_EQ(PCAN_ERROR_OK, sts);
+        return (uint64_t)value;
+    }
+#endif
+};
+
+// @gtest TC41.1: Set an 11-bit and a 29-bit acceptance filter at the same time
+//
+// @expected: CANERR_NOERROR and only messages matching the filter of their format received
+//
+TEST_F(FilterBothFormats, GTEST_TESTCASE(BothFormatsActive, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    const Identifier_t trmIds[] = { { 0x11FU, 0 }, { 0x120U, 0 }, { 0x12FU, 0 }, { 0x130U, 0 },
+                                    { 0x12344FFU, 1 }, { 0x1234500U, 1 }, { 0x12345FFU, 1 }, { 0x1234600U, 1 },
+                                    { 0x125U, 1 }, { 0x500U, 0 } };
+    const Identifier_t rcvIds[] = { { 0x120U, 0 }, { 0x12FU, 0 }, { 0x1234500U, 1 }, { 0x12345FFU, 1 } };
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- set 11-bit filter code 0x120 and mask 0x7F0
+    retVal = dut1.SetFilter11Bit(STD_CODE, STD_MASK);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- set 29-bit filter code 0x1234500 and mask 0x1FFFFF00
+    retVal = dut1.SetFilter29Bit(XTD_CODE, XTD_MASK);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send messages, DUT1 receive only those matching the filter of their format
+    CheckReceived(dut1, trmIds, COUNT(trmIds), rcvIds, COUNT(rcvIds));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+#if (OPTION_PCAN_SIMULATION != 0)
+// @gtest TC41.2: Set an 11-bit and a 29-bit acceptance filter and read back the hardware filter
+//
+// @expected: the more selective filter (more relevant bits) is set in the hardware, the other one is open
+//
+TEST_F(FilterBothFormats, GTEST_TESTCASE(MoreSelectiveInHardware, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @sub(1): 29-bit filter more selective
+    // @- set 11-bit filter code 0x120 and mask 0x7F0 (7 relevant bits)
+    retVal = dut1.SetFilter11Bit(STD_CODE, STD_MASK);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: 11-bit filter set (the only one)
+    EXPECT_EQ(((uint64_t)STD_CODE << 32) | (uint64_t)(STD_MASK ^ 0x7FFU), HardwareFilter(false));
+    // @- set 29-bit filter code 0x1234500 and mask 0x1FFFFF00 (21 relevant bits)
+    retVal = dut1.SetFilter29Bit(XTD_CODE, XTD_MASK);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: 29-bit filter set, 11-bit filter open
+    EXPECT_EQ(((uint64_t)XTD_CODE << 32) | (uint64_t)(XTD_MASK ^ 0x1FFFFFFFU), HardwareFilter(true));
+    EXPECT_EQ((uint64_t)0x7FFU, HardwareFilter(false));
+    // @sub(2): 11-bit filter more selective
+    // @- set 11-bit filter code 0x123 and mask 0x7FF (11 relevant bits)
+    retVal = dut1.SetFilter11Bit(0x123U, 0x7FFU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- set 29-bit filter code 0x10000000 and mask 0x1F000000 (5 relevant bits)
+    retVal = dut1.SetFilter29Bit(0x10000000U, 0x1F000000U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: 11-bit filter set, 29-bit filter open
+    EXPECT_EQ(((uint64_t)0x123U << 32) | (uint64_t)0x000U, HardwareFilter(false));
+    EXPECT_EQ((uint64_t)0x1FFFFFFFU, HardwareFilter(true));
+    // @sub(3): both filters equally selective
+    // @- set 29-bit filter code 0x00000123 and mask 0x000007FF (11 relevant bits)
+    retVal = dut1.SetFilter29Bit(0x123U, 0x7FFU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: 29-bit filter set, 11-bit filter open
+    EXPECT_EQ(((uint64_t)0x123U << 32) | (uint64_t)(0x7FFU ^ 0x1FFFFFFFU), HardwareFilter(true));
+    EXPECT_EQ((uint64_t)0x7FFU, HardwareFilter(false));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC41.3: Set an 11-bit and a 29-bit acceptance filter, the less selective one is open in the hardware
+//
+// @expected: CANERR_NOERROR and the messages of the other format filtered by software
+//
+TEST_F(FilterBothFormats, GTEST_TESTCASE(OtherInSoftware, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    const Identifier_t trmIds[] = { { 0x000U, 0 }, { 0x11FU, 0 }, { 0x120U, 0 }, { 0x12FU, 0 }, { 0x130U, 0 }, { 0x7FFU, 0 } };
+    const Identifier_t rcvIds[] = { { 0x120U, 0 }, { 0x12FU, 0 } };
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- set 11-bit filter code 0x120 and mask 0x7F0
+    retVal = dut1.SetFilter11Bit(STD_CODE, STD_MASK);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- set 29-bit filter code 0x1234500 and mask 0x1FFFFF00
+    retVal = dut1.SetFilter29Bit(XTD_CODE, XTD_MASK);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: 11-bit filter open (all 11-bit messages pass the hardware)
+    EXPECT_EQ((uint64_t)0x7FFU, HardwareFilter(false));
+    // @test:
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send 11-bit messages, DUT1 receive only those matching the 11-bit filter
+    CheckReceived(dut1, trmIds, COUNT(trmIds), rcvIds, COUNT(rcvIds));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+#endif
+
+// @gtest TC41.4: Get the 11-bit and the 29-bit acceptance filter when both are set
+//
+// @expected: CANERR_NOERROR and the code and mask as set (not the one of the hardware)
+//
+TEST_F(FilterBothFormats, GTEST_TESTCASE(GetStoredValues, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    uint32_t code = 0U, mask = 0U;
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- set 11-bit filter code 0x120 and mask 0x7F0
+    retVal = dut1.SetFilter11Bit(STD_CODE, STD_MASK);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- set 29-bit filter code 0x1234500 and mask 0x1FFFFF00
+    retVal = dut1.SetFilter29Bit(XTD_CODE, XTD_MASK);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- add 29-bit code 0x1234567 and mask 0x1FFFFFFF to the software filter
+    retVal = dut1.AddFilter29Bit(0x1234567U, 0x1FFFFFFFU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @test:
+    // @- get 11-bit filter: code 0x120 and mask 0x7F0
+    retVal = dut1.GetFilter11Bit(code, mask);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(STD_CODE, code);
+    EXPECT_EQ(STD_MASK, mask);
+    // @- get 29-bit filter: code 0x1234500 and mask 0x1FFFFF00
+    retVal = dut1.GetFilter29Bit(code, mask);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(XTD_CODE, code);
+    EXPECT_EQ(XTD_MASK, mask);
+#if (OPTION_PCAN_SIMULATION != 0)
+    // @- hardware: 29-bit filter combined with the software filter (code 0x1234567 and mask 0x1FFFFFFF)
+    EXPECT_EQ(((uint64_t)0x1234567U << 32) | (uint64_t)0x00000000U, HardwareFilter(true));
+#endif
+    // @- reset both filters
+    retVal = dut1.ResetFilters();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- get 11-bit filter: code 0x000 and mask 0x000
+    retVal = dut1.GetFilter11Bit(code, mask);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0x000U, code);
+    EXPECT_EQ(0x000U, mask);
+    // @- get 29-bit filter: code 0x00000000 and mask 0x00000000
+    retVal = dut1.GetFilter29Bit(code, mask);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0x00000000U, code);
+    EXPECT_EQ(0x00000000U, mask);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+#if (OPTION_PCAN_SIMULATION != 0)
+// @gtest TC41.5: Set an acceptance filter when the hardware rejects it
+//
+// @expected: an error and the previous filters are reported as before
+//
+TEST_F(FilterBothFormats, GTEST_TESTCASE(RestoreOnError, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    TPCANHandle channel = (TPCANHandle)g_Options.GetChannelNo(DUT1);
+    uint32_t code = 0U, mask = 0U;
+    CANAPI_Return_t retVal;
+    TPCANStatus sts;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @- set 11-bit filter code 0x120 and mask 0x7F0
+    retVal = dut1.SetFilter11Bit(STD_CODE, STD_MASK);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- uninitialize the channel behind the wrapper (the hardware rejects all filters)
+    sts = CAN_Uninitialize(channel);
+    ASSERT_EQ(PCAN_ERROR_OK, sts);
+    // @test:
+    // @sub(1): the same filter format in the hardware
+    // @- set 11-bit filter code 0x340 and mask 0x7FF: error
+    retVal = dut1.SetFilter11Bit(0x340U, 0x7FFU);
+    EXPECT_NE(CCanApi::NoError, retVal);
+    // @sub(2): the other filter format in the hardware
+    // @- set 29-bit filter code 0x1234500 and mask 0x1FFFFF00: error
+    retVal = dut1.SetFilter29Bit(XTD_CODE, XTD_MASK);
+    EXPECT_NE(CCanApi::NoError, retVal);
+    // @- get 11-bit filter: code 0x120 and mask 0x7F0 (as before)
+    retVal = dut1.GetFilter11Bit(code, mask);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(STD_CODE, code);
+    EXPECT_EQ(STD_MASK, mask);
+    // @- get 29-bit filter: code 0x00000000 and mask 0x00000000 (as before)
+    retVal = dut1.GetFilter29Bit(code, mask);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(0x00000000U, code);
+    EXPECT_EQ(0x00000000U, mask);
+    // @post:
+    // @- re-initialize the channel behind the wrapper
+    sts = CAN_Initialize(channel, PCAN_BAUD_250K, 0U, 0U, 0U);
+    EXPECT_EQ(PCAN_ERROR_OK, sts);
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+#endif
+#endif // FEATURE_FILTERING != FEATURE_UNSUPPORTED
+
+//  $Id$  Copyright (c) UV Software, Berlin.
@@ -0,0 +1,301 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+
+//  @note: This test suite tests the following methods:
+//  @      - CPeakCAN::AddFromTo11Bit() with CPeakCAN::SetFilter11Bit()  [TC42.*]
+//  @      - CPeakCAN::AddFilter11Bit() with CPeakCAN::SetFilter11Bit()  [TC42.*]
+//  @      - CPeakCAN::AddFromTo29Bit() with CPeakCAN::AddFilter29Bit()  [TC42.*]
+//  @
+//  @note: The hardware filter is read back from the PCANBasic simulation.
+//  @
+#ifndef FEATURE_FILTERING
+#define FEATURE_FILTERING  FEATURE_UNSUPPORTED
+#ifdef _MSC_VER
+#pragma message ( "FEATURE_FILTERING not set, default = FEATURE_UNSUPPORTED" )
+#else
+#warning FEATURE_FILTERING not set, default = FEATURE_UNSUPPORTED
+#endif
+#endif
+#if (FEATURE_FILTERING != FEATURE_UNSUPPORTED)
+#if (OPTION_PCAN_SIMULATION != 0)
+#include "PCANBasic.h"
+#endif
+
+#define COUNT(array)  (sizeof(array) / sizeof(array[0]))
+
+// note: code in the upper, mask in the lower 32 bits (mask bits set are don't care)
+#define HW_FILTER_11BIT(code,mask)  (((uint64_t)(code) << 32) | (uint64_t)((mask) ^ 0x7FFU))
+#define HW_FILTER_29BIT(code,mask)  (((uint64_t)(code) << 32) | (uint64_t)((mask) ^ 0x1FFFFFFFU))
+
+class FilterCover : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    void CheckReceived(CCanDevice& dut1, const uint32_t trmIds[], size_t trmCount, const uint32_t rcvIds[], size_t rcvCount) {
+        CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+        CANAPI_Message_t trmMsg = {};
+        CANAPI_Message_t rcvMsg = {};
+        CANAPI_Return_t retVal;
+        // CAN message
+        trmMsg.id = 0U;
+        trmMsg.xtd = 0;
+        trmMsg.rtr = 0;
+        trmMsg.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        trmMsg.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        trmMsg.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        trmMsg.esi = 0;
+#endif
+        trmMsg.dlc = 0U;
+        // initialize DUT2 with configured settings
+        retVal = dut2.InitializeChannel();
+        ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+        // start DUT2 with configured bit-rate settings
+        retVal = dut2.StartController();
+        EXPECT_EQ(CCanApi::NoError, retVal);
+        // issue(PeakCAN): why do we need a delay here?
+        PCBUSB_INIT_DELAY();
+        // DUT2 send the standard messages
+        for (size_t i = 0; i < trmCount; i++) {
+            trmMsg.id = trmIds[i];
+            retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+            EXPECT_EQ(CCanApi::NoError, retVal);
+        }
+        // DUT1 read the accepted messages (in order)
+        size_t j = 0;
+        while (j < rcvCount) {
+            retVal = dut1.ReadMessage(rcvMsg, TEST_READ_TIMEOUT);
+            if (retVal != CCanApi::NoError) {
+                EXPECT_EQ(CCanApi::NoError, retVal);
+                break;
+            }
+            // ignore status messages/error frames
+            if (!rcvMsg.sts) {
+                EXPECT_EQ(rcvIds[j], rcvMsg.id);
+                EXPECT_FALSE(rcvMsg.xtd);
+                j++;
+            }
+        }
+        // DUT1 try to read another message (the others must be filtered)
+        do {
+            retVal = dut1.ReadMessage(rcvMsg, 100U);
+        } while ((retVal == CCanApi::NoError) && rcvMsg.sts);
+        EXPECT_EQ(CCanApi::ReceiverEmpty, retVal) << "[  ERROR!  ] unexpected message 0x" << std::hex << rcvMsg.id << std::dec;
+        // tear down DUT2
+        retVal = dut2.TeardownChannel();
+        EXPECT_EQ(CCanApi::NoError, retVal);
+    }
+#if (OPTION_PCAN_SIMULATION != 0)
+    uint64_t HardwareFilter(bool xtd) {
+        UINT64 value = 0U;
+        TPCANStatus sts = CAN_GetValue((TPCANHandle)g_Options.GetChannelNo(DUT1),
+                                       xtd ? PCAN_ACCEPTANCE_FILTER_29BIT : PCAN_ACCEPTANCE_FILTER_11BIT,
+                                       (void*)&value, sizeof(value));
+        EXPECT_EQ(PCAN_ERROR_OK, sts);
+        return (uint64_t)value;
+    }
+#endif
+};
+
+#if (OPTION_PCAN_SIMULATION != 0)
+// @gtest TC42.1: Add 11-bit identifier ranges and code and mask and read back the hardware filter
+//
+// @expected: the tightest code and mask that accepts all entries is set in the hardware
+//
+TEST_F(FilterCover, GTEST_TESTCASE(TightestCover11Bit, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- add identifier 0x123 (code 0x123 and mask 0x7FF)
+    retVal = dut1.AddFilter11Bit(0x123U, 0x7FFU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: code 0x123 and mask 0x7FF (exact match)
+    EXPECT_EQ(HW_FILTER_11BIT(0x123U, 0x7FFU), HardwareFilter(false));
+    // @- add identifier range 0x120..0x127
+    retVal = dut1.AddFromTo11Bit(0x120U, 0x127U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: code 0x120 and mask 0x7F8 (bits 0..2 vary)
+    EXPECT_EQ(HW_FILTER_11BIT(0x120U, 0x7F8U), HardwareFilter(false));
+    // @- add identifier 0x130 (code 0x130 and mask 0x7FF)
+    retVal = dut1.AddFilter11Bit(0x130U, 0x7FFU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: code 0x120 and mask 0x7E8 (bits 0..2 and 4 vary)
+    EXPECT_EQ(HW_FILTER_11BIT(0x120U, 0x7E8U), HardwareFilter(false));
+    // @- add identifier 0x520 (code 0x520 and mask 0x7FF)
+    retVal = dut1.AddFilter11Bit(0x520U, 0x7FFU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: code 0x120 and mask 0x3E8 (bits 0..2, 4 and 10 vary)
+    EXPECT_EQ(HW_FILTER_11BIT(0x120U, 0x3E8U), HardwareFilter(false));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC42.2: Add 29-bit identifier ranges and code and mask and read back the hardware filter
+//
+// @expected: the tightest code and mask that accepts all entries is set in the hardware
+//
+TEST_F(FilterCover, GTEST_TESTCASE(TightestCover29Bit, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- add identifier range 0x1000000..0x10000FF
+    retVal = dut1.AddFromTo29Bit(0x1000000U, 0x10000FFU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: code 0x1000000 and mask 0x1FFFFF00 (bits 0..7 vary)
+    EXPECT_EQ(HW_FILTER_29BIT(0x1000000U, 0x1FFFFF00U), HardwareFilter(true));
+    // @- add identifier range 0x1000010..0x1000011 (within the first range)
+    retVal = dut1.AddFromTo29Bit(0x1000010U, 0x1000011U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: code 0x1000000 and mask 0x1FFFFF00 (unchanged)
+    EXPECT_EQ(HW_FILTER_29BIT(0x1000000U, 0x1FFFFF00U), HardwareFilter(true));
+    // @- add code 0x1000300 and mask 0x1FFFFF00
+    retVal = dut1.AddFilter29Bit(0x1000300U, 0x1FFFFF00U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: code 0x1000000 and mask 0x1FFFFC00 (bits 0..9 vary)
+    EXPECT_EQ(HW_FILTER_29BIT(0x1000000U, 0x1FFFFC00U), HardwareFilter(true));
+    // @- hardware: 11-bit filter open
+    EXPECT_EQ((uint64_t)0x7FFU, HardwareFilter(false));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC42.3: Add an 11-bit identifier range with a code and mask set by the user
+//
+// @expected: the combined code and mask in the hardware, or the user's one only if they contradict
+//
+TEST_F(FilterCover, GTEST_TESTCASE(WithUserFilter, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    const uint32_t trmIds[] = { 0x100U, 0x105U, 0x200U, 0x205U, 0x2FFU };
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @sub(1): code and mask do not contradict
+    // @- set 11-bit filter code 0x100 and mask 0x700
+    retVal = dut1.SetFilter11Bit(0x100U, 0x700U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- add identifier range 0x100..0x10F
+    retVal = dut1.AddFromTo11Bit(0x100U, 0x10FU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: code 0x100 and mask 0x7F0 (relevant bits of both)
+    EXPECT_EQ(HW_FILTER_11BIT(0x100U, 0x7F0U), HardwareFilter(false));
+    // @sub(2): code and mask contradict
+    // @- set 11-bit filter code 0x200 and mask 0x700
+    retVal = dut1.SetFilter11Bit(0x200U, 0x700U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- hardware: code 0x200 and mask 0x700 (the user's one only)
+    EXPECT_EQ(HW_FILTER_11BIT(0x200U, 0x700U), HardwareFilter(false));
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send messages, DUT1 receive none (both must match)
+    CheckReceived(dut1, trmIds, COUNT(trmIds), NULL, 0);
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+#endif
+
+// @gtest TC42.4: Add 11-bit identifier ranges with a gap in the hardware filter
+//
+// @expected: CANERR_NOERROR and messages with identifiers in the gap are rejected by the software filter
+//
+TEST_F(FilterCover, GTEST_TESTCASE(ExactMatchInCover, GTEST_ENABLED)) {
+    CCanDevice dut1 = CCanDevice(TEST_DEVICE(DUT1));
+    const uint32_t trmIds[] = { 0x0FFU, 0x100U, 0x101U, 0x102U, 0x105U, 0x10AU, 0x10DU, 0x10EU, 0x10FU, 0x110U };
+    const uint32_t rcvIds[] = { 0x100U, 0x101U, 0x10EU, 0x10FU };
+    CANAPI_Return_t retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings
+    retVal = dut1.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut1.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- add identifier ranges 0x100..0x101 and 0x10E..0x10F
+    retVal = dut1.AddFromTo11Bit(0x100U, 0x101U);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    retVal = dut1.AddFromTo11Bit(0x10EU, 0x10FU);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+#if (OPTION_PCAN_SIMULATION != 0)
+    // @- hardware: code 0x100 and mask 0x7F0 (the gap 0x102..0x10D passes)
+    EXPECT_EQ(HW_FILTER_11BIT(0x100U, 0x7F0U), HardwareFilter(false));
+#endif
+    // @- start DUT1 with configured bit-rate settings
+    retVal = dut1.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- DUT2 send messages, DUT1 receive only those within the ranges
+    CheckReceived(dut1, trmIds, COUNT(trmIds), rcvIds, COUNT(rcvIds));
+    // @post:
+    // @- tear down DUT1
+    retVal = dut1.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+#endif // FEATURE_FILTERING != FEATURE_UNSUPPORTED
+
+//  $Id$  Copyright (c) UV Software, Berlin.
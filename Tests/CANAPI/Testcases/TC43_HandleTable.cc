@@ -0,0 +1,199 @@
+//  SPDX-License-Identifier: BSD-2-Clause OR GPL-2.0-or-later
+//
+//  CAN Interface API, Version 3 (Testing)
+//
+//  Copyright (c) 2004-2025 Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+//  All rights reserved.
+//
+//  This file is part of CAN API V3.
+//
+//  CAN API V3 is dual-licensed under the BSD 2-Clause "Simplified" License
+//  and under the GNU General Public License v2.0 (or any later version).
+//  You can choose between one of them if you use this file.
+//
+//  (1) BSD 2-Clause "Simplified" License
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//  1. Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  CAN API V3 IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+//  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+//  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+//  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+//  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+//  OF CAN API V3, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//  (2) GNU General Public License v2.0 or later
+//
+//  CAN API V3 is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  CAN API V3 is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with CAN API V3; if not, see <https://www.gnu.org/licenses/>.
+//
+#include "pch.h"
+#include "can_api.h"
+
+//  @note: This test suite tests the handle table of the C API:
+//  @      - can_init() / can_exit() with a stale handle  [TC43.1]
+//  @      - can_init() with more handles than one chunk of the table  [TC43.2]
+//  @
+//  @note: The handles are opened by the C API, the class CPeakCAN does not
+//  @      expose its handle. More than 16 handles are opened with shared
+//  @      access of one CAN channel (CANMODE_SHRD).
+//  @
+#define TC43_HANDLES  20
+
+class HandleTable : public testing::Test {
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+protected:
+    void Message(CANAPI_Message_t &message, uint32_t id) {
+        message.id = id;
+        message.xtd = 0;
+        message.rtr = 0;
+        message.sts = 0;
+#if (OPTION_CAN_2_0_ONLY == 0)
+        message.fdf = g_Options.GetOpMode(DUT1).fdoe ? 1 : 0;
+        message.brs = g_Options.GetOpMode(DUT1).brse ? 1 : 0;
+        message.esi = 0;
+#endif
+        message.dlc = 1U;
+        message.data[0] = (uint8_t)id;
+    }
+};
+
+// @gtest TC43.1: Use a stale handle after the slot of the handle was used again
+//
+// @expected: CANERR_HANDLE for the stale handle, CANERR_NOERROR for the new one
+//
+TEST_F(HandleTable, GTEST_TESTCASE(StaleHandleRejected, GTEST_ENABLED)) {
+    CANAPI_Bitrate_t bitrate = g_Options.GetBitrate(DUT1);
+    uint8_t status = 0U;
+    int handle1, handle2;
+    int retVal;
+    // @pre:
+    // @- initialize DUT1 with configured settings (first handle)
+    handle1 = can_init(g_Options.GetChannelNo(DUT1), g_Options.GetOpMode(DUT1).byte, g_Options.GetParameter(DUT1));
+    ASSERT_LE(0, handle1) << "[  ERROR!  ] can_init() failed with error code " << handle1;
+    // @- tear down DUT1 (the first handle becomes stale)
+    retVal = can_exit(handle1);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- initialize DUT1 with configured settings (second handle)
+    handle2 = can_init(g_Options.GetChannelNo(DUT1), g_Options.GetOpMode(DUT1).byte, g_Options.GetParameter(DUT1));
+    ASSERT_LE(0, handle2) << "[  ERROR!  ] can_init() failed with error code " << handle2;
+    // @test:
+    // @- the slot is used again (lower 16 bits), but the handle is another one
+    EXPECT_EQ(handle1 & 0xFFFF, handle2 & 0xFFFF);
+    EXPECT_NE(handle1, handle2);
+    // @- get status with the stale handle: CANERR_HANDLE
+    retVal = can_status(handle1, &status);
+    EXPECT_EQ(CCanApi::InvalidHandle, retVal);
+    // @- start the controller with the stale handle: CANERR_HANDLE
+    retVal = can_start(handle1, &bitrate);
+    EXPECT_EQ(CCanApi::InvalidHandle, retVal);
+    // @- tear down with the stale handle: CANERR_HANDLE
+    retVal = can_exit(handle1);
+    EXPECT_EQ(CCanApi::InvalidHandle, retVal);
+    // @- get status with the second handle: CANERR_NOERROR and controller stopped
+    retVal = can_status(handle2, &status);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    EXPECT_EQ(CANSTAT_RESET, status & CANSTAT_RESET);
+    // @post:
+    // @- tear down DUT1 (second handle)
+    retVal = can_exit(handle2);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+// @gtest TC43.2: Open more than 16 handles (more than one chunk of the handle table)
+//
+// @expected: CANERR_NOERROR, all handles are distinct and usable
+//
+TEST_F(HandleTable, GTEST_TESTCASE(MoreThan16Handles, GTEST_ENABLED)) {
+    CCanDevice dut2 = CCanDevice(TEST_DEVICE(DUT2));
+    CANAPI_Bitrate_t bitrate = g_Options.GetBitrate(DUT1);
+    CANAPI_OpMode_t opMode = g_Options.GetOpMode(DUT1);
+    CANAPI_Message_t trmMsg = {};
+    CANAPI_Message_t rcvMsg = {};
+    int handles[TC43_HANDLES];
+    uint8_t status = 0U;
+    int retVal;
+    int i, j;
+    // @pre:
+    // @- initialize DUT1 with configured settings and shared access (20 handles)
+    opMode.byte |= CANMODE_SHRD;
+    for (i = 0; i < TC43_HANDLES; i++) {
+        handles[i] = can_init(g_Options.GetChannelNo(DUT1), opMode.byte, g_Options.GetParameter(DUT1));
+        ASSERT_LE(0, handles[i]) << "[  ERROR!  ] can_init() failed with error code " << handles[i] << " (handle #" << i << ")";
+    }
+    // @- initialize DUT2 with configured settings
+    retVal = dut2.InitializeChannel();
+    ASSERT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] dut2.InitializeChannel() failed with error code " << retVal;
+    // @test:
+    // @- all handles are distinct
+    for (i = 0; i < TC43_HANDLES; i++) {
+        for (j = i + 1; j < TC43_HANDLES; j++)
+            EXPECT_NE(handles[i], handles[j]);
+    }
+    // @- start all handles with configured bit-rate settings
+    for (i = 0; i < TC43_HANDLES; i++) {
+        retVal = can_start(handles[i], &bitrate);
+        EXPECT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] handle #" << i;
+    }
+    // @- start DUT2 with configured bit-rate settings
+    retVal = dut2.StartController();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // issue(PeakCAN): why do we need a delay here?
+    PCBUSB_INIT_DELAY();
+    // @- DUT2 send a message, all handles receive it
+    Message(trmMsg, 0x430U);
+    retVal = dut2.WriteMessage(trmMsg, TEST_WRITE_TIMEOUT);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    for (i = 0; i < TC43_HANDLES; i++) {
+        retVal = can_read(handles[i], &rcvMsg, TEST_READ_TIMEOUT);
+        EXPECT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] handle #" << i;
+        if (retVal == CCanApi::NoError) {
+            EXPECT_EQ(0x430U, rcvMsg.id) << "[  ERROR!  ] handle #" << i;
+        }
+    }
+    // @- tear down all handles but the last one
+    for (i = 0; i < (TC43_HANDLES - 1); i++) {
+        retVal = can_exit(handles[i]);
+        EXPECT_EQ(CCanApi::NoError, retVal) << "[  ERROR!  ] handle #" << i;
+    }
+    // @- get status with the closed handles: CANERR_HANDLE
+    for (i = 0; i < (TC43_HANDLES - 1); i++) {
+        retVal = can_status(handles[i], &status);
+        EXPECT_EQ(CCanApi::InvalidHandle, retVal) << "[  ERROR!  ] handle #" << i;
+    }
+    // @- get status with the last handle: CANERR_NOERROR
+    retVal = can_status(handles[TC43_HANDLES - 1], &status);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @post:
+    // @- tear down the last handle
+    retVal = can_exit(handles[TC43_HANDLES - 1]);
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @- tear down DUT2
+    retVal = dut2.TeardownChannel();
+    EXPECT_EQ(CCanApi::NoError, retVal);
+    // @end.
+}
+
+//  $Id$  Copyright (c) UV Software, Berlin.
@@ -449,7 +449,6 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
             EChannelState state;
             CANAPI_Return_t retVal = CCanDevice::ProbeChannel(library.m_nLibraryId, channel.m_nChannelNo, opMode, state);
             if ((retVal == CCanApi::NoError) || (retVal == CCanApi::IllegalParameter)) {
-                CTimer::Delay(333U * CTimer::MSEC);  // to fake probing a hardware
                 switch (state) {
                     case CCanApi::ChannelOccupied: fprintf(stdout, "occupied\n"); n++; break;
                     case CCanApi::ChannelAvailable: fprintf(stdout, "available\n"); n++; break;
@@ -465,6 +464,9 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
         iterLibrary = CCanDevice::GetNextLibrary(library);
     }
 #else
+    // note: all channels are probed at once, ProbeChannel() takes the results from a cache
+    EChannelState states[PCAN_BOARDS];
+    (void)CCanDevice::ProbeChannels(states, PCAN_BOARDS);
     CCanDevice::SChannelInfo channel = { (-1), "", "", (-1), "" };
     bool iterChannel = CCanDevice::GetFirstChannel(channel);
     while (iterChannel) {
@@ -473,7 +475,6 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
         EChannelState state;
         CANAPI_Return_t retVal = CCanDevice::ProbeChannel(channel.m_nChannelNo, opMode, state);
         if ((retVal == CCanApi::NoError) || (retVal == CCanApi::IllegalParameter)) {
-            CTimer::Delay(333U * CTimer::MSEC);  // to fake probing a hardware
             switch (state) {
                 case CCanApi::ChannelOccupied: fprintf(stdout, "occupied\n"); n++; break;
                 case CCanApi::ChannelAvailable: fprintf(stdout, "available\n"); n++; break;
@@ -101,11 +101,8 @@ static int TransmitMessage(const void* data, size_t size, void *param) {
     double latency = CTimer::DiffTime(ipc_msg->timestamp, CTimer::GetTime());
     fprintf(stderr, "%.4f\n", latency * 1e6);
 #endif
-    /* transmit the message on the CAN bus (retry if busy) */
-    CTimer timer = CTimer(CAN_TX_TIMEOUT * CTimer::MSEC);
-    do {
-        retVal = canDevice->WriteMessage(can_msg);
-    } while ((retVal == CANERR_TX_BUSY) && !timer.Timeout());
+    /* transmit the message on the CAN bus (wait if busy) */
+    retVal = canDevice->WriteMessage(can_msg, (uint16_t)CAN_TX_TIMEOUT);
     /* return result */
     return (int)retVal;
 }
@@ -463,7 +460,9 @@ uint64_t CCanDevice::ReceptionLoop() {
     uint64_t frames = 0U;
 	uint8_t status = 0x80U;
 
+#if (OPTION_CANAPI_LIBRARY != 0)
 	static uint8_t lastStatus = status;
+#endif
 
 #if !defined(_WIN32) && !defined(_WIN64)
     fprintf(stdout, "\nPress ^C to abort or execute `kill -15 <pid>' to exit the program properly.\n\n");
@@ -471,15 +470,24 @@ uint64_t CCanDevice::ReceptionLoop() {
 	fprintf(stdout, "\nPress ^C to abort or execute `taskkill /F /PID <pid>' to exit the program properly.\n\n");
 #endif
     while(running) {
+#if (OPTION_CANAPI_LIBRARY == 0)
+        /* note: the CAN status register (8-bit) is delivered with the message */
+        CANAPI_Status_t canStatus = CANAPI_Status_t();
+        if ((retVal = ReadMessage(message, canStatus)) == CCanApi::NoError) {
+            status = canStatus.byte;
+#else
         if ((retVal = ReadMessage(message)) == CCanApi::NoError) {
             /* get CAN status register (8-bit) */
             if (GetProperty(CANPROP_GET_STATUS, (void*)&status, sizeof(uint8_t)) != CCanApi::NoError) {
                 /* this should never happen, but we send the last status */
                 status = lastStatus;
             }
+#endif
             /* send RocketCAN message to all clients */
             (void)ipcServer.Send(message, status);
+#if (OPTION_CANAPI_LIBRARY != 0)
 			lastStatus = status;
+#endif
             frames++;
         } 
         else if ((retVal == CCanApi::ResourceError) || (retVal == CCanApi::FatalError)) {
@@ -558,7 +566,6 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
             EChannelState state;
             CANAPI_Return_t retVal = CCanDevice::ProbeChannel(library.m_nLibraryId, channel.m_nChannelNo, opMode, state);
             if ((retVal == CCanApi::NoError) || (retVal == CCanApi::IllegalParameter)) {
-                CTimer::Delay(333U * CTimer::MSEC);  // to fake probing a hardware
                 switch (state) {
                     case CCanApi::ChannelOccupied: fprintf(stdout, "occupied\n"); n++; break;
                     case CCanApi::ChannelAvailable: fprintf(stdout, "available\n"); n++; break;
@@ -574,6 +581,9 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
         iterLibrary = CCanDevice::GetNextLibrary(library);
     }
 #else
+    // note: all channels are probed at once, ProbeChannel() takes the results from a cache
+    EChannelState states[PCAN_BOARDS];
+    (void)CCanDevice::ProbeChannels(states, PCAN_BOARDS);
     CCanDevice::SChannelInfo channel = { (-1), "", "", (-1), "" };
     bool iterChannel = CCanDevice::GetFirstChannel(channel);
     while (iterChannel) {
@@ -582,7 +592,6 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
         EChannelState state;
         CANAPI_Return_t retVal = CCanDevice::ProbeChannel(channel.m_nChannelNo, opMode, state);
         if ((retVal == CCanApi::NoError) || (retVal == CCanApi::IllegalParameter)) {
-            CTimer::Delay(333U * CTimer::MSEC);  // to fake probing a hardware
             switch (state) {
                 case CCanApi::ChannelOccupied: fprintf(stdout, "occupied\n"); n++; break;
                 case CCanApi::ChannelAvailable: fprintf(stdout, "available\n"); n++; break;
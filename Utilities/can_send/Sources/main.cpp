@@ -508,7 +508,6 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
             EChannelState state;
             CANAPI_Return_t retVal = CCanDevice::ProbeChannel(library.m_nLibraryId, channel.m_nChannelNo, opMode, state);
             if ((retVal == CCanApi::NoError) || (retVal == CCanApi::IllegalParameter)) {
-                CTimer::Delay(333U * CTimer::MSEC);  // to fake probing a hardware
                 switch (state) {
                     case CCanApi::ChannelOccupied: fprintf(stdout, "occupied\n"); n++; break;
                     case CCanApi::ChannelAvailable: fprintf(stdout, "available\n"); n++; break;
@@ -524,6 +523,9 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
         iterLibrary = CCanDevice::GetNextLibrary(library);
     }
 #else
+    // note: all channels are probed at once, ProbeChannel() takes the results from a cache
+    EChannelState states[PCAN_BOARDS];
+    (void)CCanDevice::ProbeChannels(states, PCAN_BOARDS);
     CCanDevice::SChannelInfo channel = { (-1), "", "", (-1), "" };
     bool iterChannel = CCanDevice::GetFirstChannel(channel);
     while (iterChannel) {
@@ -532,7 +534,6 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
         EChannelState state;
         CANAPI_Return_t retVal = CCanDevice::ProbeChannel(channel.m_nChannelNo, opMode, state);
         if ((retVal == CCanApi::NoError) || (retVal == CCanApi::IllegalParameter)) {
-            CTimer::Delay(333U * CTimer::MSEC);  // to fake probing a hardware
             switch (state) {
                 case CCanApi::ChannelOccupied: fprintf(stdout, "occupied\n"); n++; break;
                 case CCanApi::ChannelAvailable: fprintf(stdout, "available\n"); n++; break;
@@ -53,6 +53,9 @@
 #define strncasecmp _strnicmp
 #define strcasecmp _stricmp
 #endif
+#ifndef CAN_TX_TIMEOUT
+#define CAN_TX_TIMEOUT  100UL
+#endif
 
 class CCanDevice : public CCanDriver {
 public:
@@ -449,7 +452,6 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
             EChannelState state;
             CANAPI_Return_t retVal = CCanDevice::ProbeChannel(library.m_nLibraryId, channel.m_nChannelNo, opMode, state);
             if ((retVal == CCanApi::NoError) || (retVal == CCanApi::IllegalParameter)) {
-                CTimer::Delay(333U * CTimer::MSEC);  // to fake probing a hardware
                 switch (state) {
                     case CCanApi::ChannelOccupied: fprintf(stdout, "occupied\n"); n++; break;
                     case CCanApi::ChannelAvailable: fprintf(stdout, "available\n"); n++; break;
@@ -465,6 +467,9 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
         iterLibrary = CCanDevice::GetNextLibrary(library);
     }
 #else
+    // note: all channels are probed at once, ProbeChannel() takes the results from a cache
+    EChannelState states[PCAN_BOARDS];
+    (void)CCanDevice::ProbeChannels(states, PCAN_BOARDS);
     CCanDevice::SChannelInfo channel = { (-1), "", "", (-1), "" };
     bool iterChannel = CCanDevice::GetFirstChannel(channel);
     while (iterChannel) {
@@ -473,7 +478,6 @@ int CCanDevice::TestCanDevices(CANAPI_OpMode_t opMode) {
         EChannelState state;
         CANAPI_Return_t retVal = CCanDevice::ProbeChannel(channel.m_nChannelNo, opMode, state);
         if ((retVal == CCanApi::NoError) || (retVal == CCanApi::IllegalParameter)) {
-            CTimer::Delay(333U * CTimer::MSEC);  // to fake probing a hardware
             switch (state) {
                 case CCanApi::ChannelOccupied: fprintf(stdout, "occupied\n"); n++; break;
                 case CCanApi::ChannelAvailable: fprintf(stdout, "available\n"); n++; break;
@@ -732,11 +736,11 @@ uint64_t CCanDevice::TransmitterTest(time_t duration, CANAPI_OpMode_t opMode, ui
 #if (CAN_FD_SUPPORTED != 0)
         memset(&message.data[8], 0, CANFD_MAX_LEN - 8);
 #endif
-        /* transmit message (repeat when busy) */
+        /* transmit message (wait and repeat when busy) */
         t0 = CTimer::GetTime();
 retry_tx_test:
         calls++;
-        retVal = WriteMessage(message);
+        retVal = WriteMessage(message, (uint16_t)CAN_TX_TIMEOUT);
         if (retVal == CCanApi::NoError)
             fprintf(stderr, "%s", prompt[(frames++ % 4)]);
         else if ((retVal == CCanApi::TransmitterBusy) && running)
@@ -823,11 +827,11 @@ uint64_t CCanDevice::TransmitterTest(uint64_t count, CANAPI_OpMode_t opMode, boo
         if (random)
             message.dlc = dlc + (uint8_t)(rand() % ((CAN_MAX_DLC - dlc) + 1));
 #endif
-        /* transmit message (repeat when busy) */
+        /* transmit message (wait and repeat when busy) */
         t0 = CTimer::GetTime();
 retry_tx_test:
         calls++;
-        retVal = WriteMessage(message);
+        retVal = WriteMessage(message, (uint16_t)CAN_TX_TIMEOUT);
         if (retVal == CCanApi::NoError)
             fprintf(stderr, "%s", prompt[(frames++ % 4)]);
         else if ((retVal == CCanApi::TransmitterBusy) && running)